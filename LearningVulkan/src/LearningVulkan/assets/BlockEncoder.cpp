@@ -0,0 +1,954 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VULKANO_BC_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define VULKANO_BC_NEON
+	#include <arm_neon.h>
+#endif
+
+#include "vulkano/graphics/BlockCompression.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "BlockEncoder.hpp"
+
+namespace vulkano::bc
+{
+	namespace
+	{
+		///
+		/// Block rows are handed to worker threads in groups this size.
+		///
+		constexpr std::uint32_t BLOCK_ROWS_PER_TASK = 4;
+
+		///
+		/// Rounds of +-1 endpoint tweaks tried by EncodeQuality::SLOW.
+		///
+		constexpr std::uint32_t NEIGHBOUR_ROUNDS = 8;
+
+		constexpr std::array<std::uint32_t, 16> BC7_WEIGHTS_4 {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+		using Colour  = std::array<float, 4>;
+		using Indices = std::array<std::uint8_t, 16>;
+
+		///
+		/// One 4x4 block, channel major so four texels can be processed per SIMD register.
+		///
+		struct BlockTexels final
+		{
+			alignas(16) float m_channels[4][16];
+		};
+
+		[[nodiscard]] std::uint32_t refine_passes(EncodeQuality quality)
+		{
+			switch (quality)
+			{
+				case EncodeQuality::FAST:
+					return 0;
+
+				case EncodeQuality::NORMAL:
+					return 2;
+
+				default:
+					return 4;
+			}
+		}
+
+		///
+		/// Picks the closest palette entry for every texel, comparing the first `channels` channels.
+		/// Ties resolve to the lowest index so the result does not depend on the code path taken.
+		///
+		float fit_indices(const BlockTexels& texels, const Colour* palette, std::uint32_t count, std::uint32_t channels, Indices& indices)
+		{
+			float total = 0.0f;
+
+#if defined(VULKANO_BC_SSE2)
+			for (std::uint32_t p = 0; p < 16; p += 4)
+			{
+				__m128 best        = _mm_set1_ps(FLT_MAX);
+				__m128i best_index = _mm_setzero_si128();
+
+				for (std::uint32_t k = 0; k < count; k++)
+				{
+					__m128 dist = _mm_setzero_ps();
+					for (std::uint32_t c = 0; c < channels; c++)
+					{
+						const __m128 d = _mm_sub_ps(_mm_load_ps(&texels.m_channels[c][p]), _mm_set1_ps(palette[k][c]));
+						dist           = _mm_add_ps(dist, _mm_mul_ps(d, d));
+					}
+
+					const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(dist, best));
+					best                 = _mm_min_ps(dist, best);
+					best_index           = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(k))), _mm_andnot_si128(closer, best_index));
+				}
+
+				alignas(16) std::int32_t lanes[4];
+				alignas(16) float errors[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(lanes), best_index);
+				_mm_store_ps(errors, best);
+
+				for (std::uint32_t l = 0; l < 4; l++)
+				{
+					indices[p + l] = static_cast<std::uint8_t>(lanes[l]);
+					total += errors[l];
+				}
+			}
+#elif defined(VULKANO_BC_NEON)
+			for (std::uint32_t p = 0; p < 16; p += 4)
+			{
+				float32x4_t best       = vdupq_n_f32(FLT_MAX);
+				uint32x4_t best_index = vdupq_n_u32(0);
+
+				for (std::uint32_t k = 0; k < count; k++)
+				{
+					float32x4_t dist = vdupq_n_f32(0.0f);
+					for (std::uint32_t c = 0; c < channels; c++)
+					{
+						const float32x4_t d = vsubq_f32(vld1q_f32(&texels.m_channels[c][p]), vdupq_n_f32(palette[k][c]));
+						dist                = vaddq_f32(dist, vmulq_f32(d, d));
+					}
+
+					const uint32x4_t closer = vcltq_f32(dist, best);
+					best                    = vminq_f32(dist, best);
+					best_index              = vbslq_u32(closer, vdupq_n_u32(k), best_index);
+				}
+
+				std::uint32_t lanes[4];
+				float errors[4];
+				vst1q_u32(lanes, best_index);
+				vst1q_f32(errors, best);
+
+				for (std::uint32_t l = 0; l < 4; l++)
+				{
+					indices[p + l] = static_cast<std::uint8_t>(lanes[l]);
+					total += errors[l];
+				}
+			}
+#else
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				float best            = FLT_MAX;
+				std::uint8_t best_idx = 0;
+
+				for (std::uint32_t k = 0; k < count; k++)
+				{
+					float dist = 0.0f;
+					for (std::uint32_t c = 0; c < channels; c++)
+					{
+						const float d = texels.m_channels[c][p] - palette[k][c];
+						dist += d * d;
+					}
+
+					if (dist < best)
+					{
+						best     = dist;
+						best_idx = static_cast<std::uint8_t>(k);
+					}
+				}
+
+				indices[p] = best_idx;
+				total += best;
+			}
+#endif
+
+			return total;
+		}
+
+		///
+		/// Endpoints spanning the texels along their principal axis, found with a few power iterations.
+		///
+		void principal_endpoints(const BlockTexels& texels, std::uint32_t channels, Colour& e0, Colour& e1)
+		{
+			Colour mean {};
+			for (std::uint32_t c = 0; c < channels; c++)
+			{
+				mean[c] = std::accumulate(texels.m_channels[c], texels.m_channels[c] + 16, 0.0f) / 16.0f;
+			}
+
+			float covariance[4][4] {};
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				for (std::uint32_t i = 0; i < channels; i++)
+				{
+					for (std::uint32_t j = i; j < channels; j++)
+					{
+						covariance[i][j] += (texels.m_channels[i][p] - mean[i]) * (texels.m_channels[j][p] - mean[j]);
+					}
+				}
+			}
+
+			// Start from the channel with the largest variance, which is never orthogonal to the answer.
+			std::uint32_t largest = 0;
+			for (std::uint32_t i = 0; i < channels; i++)
+			{
+				for (std::uint32_t j = 0; j < i; j++)
+				{
+					covariance[i][j] = covariance[j][i];
+				}
+
+				if (covariance[i][i] > covariance[largest][largest])
+				{
+					largest = i;
+				}
+			}
+
+			Colour axis {};
+			for (std::uint32_t c = 0; c < channels; c++)
+			{
+				axis[c] = covariance[largest][c];
+			}
+
+			for (std::uint32_t iteration = 0; iteration < 8; iteration++)
+			{
+				Colour next {};
+				float scale = 0.0f;
+				for (std::uint32_t i = 0; i < channels; i++)
+				{
+					for (std::uint32_t j = 0; j < channels; j++)
+					{
+						next[i] += covariance[i][j] * axis[j];
+					}
+
+					scale = std::max(scale, std::abs(next[i]));
+				}
+
+				if (scale < 1e-6f)
+				{
+					break;
+				}
+
+				for (std::uint32_t c = 0; c < channels; c++)
+				{
+					axis[c] = next[c] / scale;
+				}
+			}
+
+			float length = 0.0f;
+			for (std::uint32_t c = 0; c < channels; c++)
+			{
+				length += axis[c] * axis[c];
+			}
+
+			float min_t = 0.0f;
+			float max_t = 0.0f;
+			if (length > 1e-12f)
+			{
+				length = std::sqrt(length);
+				for (std::uint32_t c = 0; c < channels; c++)
+				{
+					axis[c] /= length;
+				}
+
+				min_t = FLT_MAX;
+				max_t = -FLT_MAX;
+				for (std::uint32_t p = 0; p < 16; p++)
+				{
+					float t = 0.0f;
+					for (std::uint32_t c = 0; c < channels; c++)
+					{
+						t += (texels.m_channels[c][p] - mean[c]) * axis[c];
+					}
+
+					min_t = std::min(min_t, t);
+					max_t = std::max(max_t, t);
+				}
+			}
+
+			for (std::uint32_t c = 0; c < channels; c++)
+			{
+				e0[c] = std::clamp(mean[c] + min_t * axis[c], 0.0f, 255.0f);
+				e1[c] = std::clamp(mean[c] + max_t * axis[c], 0.0f, 255.0f);
+			}
+		}
+
+		///
+		/// Solves for the endpoints that best reproduce the texels with the given indices, where `weights` maps an
+		/// index to its position between e0 (0) and e1 (1). Returns false when the indices do not constrain both ends.
+		///
+		[[nodiscard]] bool least_squares(const BlockTexels& texels, std::uint32_t channels, const Indices& indices, const float* weights, Colour& e0, Colour& e1)
+		{
+			float aa = 0.0f;
+			float ab = 0.0f;
+			float bb = 0.0f;
+			Colour ax {};
+			Colour bx {};
+
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				const float w = weights[indices[p]];
+				const float v = 1.0f - w;
+
+				aa += v * v;
+				ab += v * w;
+				bb += w * w;
+				for (std::uint32_t c = 0; c < channels; c++)
+				{
+					ax[c] += v * texels.m_channels[c][p];
+					bx[c] += w * texels.m_channels[c][p];
+				}
+			}
+
+			const float det = aa * bb - ab * ab;
+			if (std::abs(det) < 1e-6f)
+			{
+				return false;
+			}
+
+			for (std::uint32_t c = 0; c < channels; c++)
+			{
+				e0[c] = std::clamp((bb * ax[c] - ab * bx[c]) / det, 0.0f, 255.0f);
+				e1[c] = std::clamp((aa * bx[c] - ab * ax[c]) / det, 0.0f, 255.0f);
+			}
+
+			return true;
+		}
+
+		///
+		/// Shared greedy search: tweak each endpoint component by +-step and keep any change that lowers the error.
+		///
+		template<typename Endpoints, typename Evaluate>
+		void neighbour_search(Endpoints& endpoints, float& error, int step, const Endpoints& limits, Evaluate&& evaluate)
+		{
+			for (std::uint32_t round = 0; round < NEIGHBOUR_ROUNDS; round++)
+			{
+				bool improved = false;
+				for (std::size_t i = 0; i < endpoints.size(); i++)
+				{
+					for (const int delta : {-step, step})
+					{
+						const int value = endpoints[i] + delta;
+						if (value < 0 || value > limits[i])
+						{
+							continue;
+						}
+
+						Endpoints candidate = endpoints;
+						candidate[i]        = value;
+
+						const float candidate_error = evaluate(candidate);
+						if (candidate_error < error)
+						{
+							endpoints = candidate;
+							error     = candidate_error;
+							improved  = true;
+						}
+					}
+				}
+
+				if (!improved)
+				{
+					break;
+				}
+			}
+		}
+
+		[[nodiscard]] std::uint16_t pack_565(const std::array<int, 3>& c)
+		{
+			return static_cast<std::uint16_t>((c[0] << 11) | (c[1] << 5) | c[2]);
+		}
+
+		[[nodiscard]] std::array<int, 3> quantise_565(const Colour& c)
+		{
+			return {static_cast<int>(c[0] * 31.0f / 255.0f + 0.5f), static_cast<int>(c[1] * 63.0f / 255.0f + 0.5f), static_cast<int>(c[2] * 31.0f / 255.0f + 0.5f)};
+		}
+
+		[[nodiscard]] std::array<int, 3> expand_565(const std::array<int, 3>& c)
+		{
+			return {(c[0] << 3) | (c[0] >> 2), (c[1] << 2) | (c[1] >> 4), (c[2] << 3) | (c[2] >> 2)};
+		}
+
+		///
+		/// Mirrors the palette built by decode_colour() in BlockCompression.cpp.
+		///
+		void bc1_palette(const std::array<int, 3>& q0, const std::array<int, 3>& q1, bool three_colour, Colour* palette)
+		{
+			const auto a = expand_565(q0);
+			const auto b = expand_565(q1);
+
+			for (std::size_t c = 0; c < 3; c++)
+			{
+				palette[0][c] = static_cast<float>(a[c]);
+				palette[1][c] = static_cast<float>(b[c]);
+
+				if (three_colour)
+				{
+					palette[2][c] = static_cast<float>((a[c] + b[c] + 1) / 2);
+				}
+				else
+				{
+					palette[2][c] = static_cast<float>((2 * a[c] + b[c] + 1) / 3);
+					palette[3][c] = static_cast<float>((a[c] + 2 * b[c] + 1) / 3);
+				}
+			}
+		}
+
+		///
+		/// BC1 colour block. Uses the four colour palette, unless `punch_through` is set and the block has texels with
+		/// alpha below 128, in which case those texels use the transparent index of the three colour palette.
+		///
+		void encode_bc1(BlockTexels texels, EncodeQuality quality, bool punch_through, std::uint8_t* out)
+		{
+			std::uint32_t transparent = 0;
+			if (punch_through)
+			{
+				for (std::uint32_t p = 0; p < 16; p++)
+				{
+					transparent |= (texels.m_channels[3][p] < 128.0f ? 1u : 0u) << p;
+				}
+			}
+
+			// Transparent texels are moved onto the opaque mean so they do not pull the endpoints around.
+			if (transparent && transparent != 0xFFFF)
+			{
+				for (std::uint32_t c = 0; c < 3; c++)
+				{
+					float sum = 0.0f;
+					for (std::uint32_t p = 0; p < 16; p++)
+					{
+						sum += (transparent & (1u << p)) ? 0.0f : texels.m_channels[c][p];
+					}
+
+					const float mean = sum / static_cast<float>(16 - std::popcount(transparent));
+					for (std::uint32_t p = 0; p < 16; p++)
+					{
+						if (transparent & (1u << p))
+						{
+							texels.m_channels[c][p] = mean;
+						}
+					}
+				}
+			}
+
+			const bool three_colour = transparent != 0;
+			const std::uint32_t count = three_colour ? 3 : 4;
+			const float weights_four[4] {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+			const float weights_three[3] {0.0f, 1.0f, 0.5f};
+			const float* weights = three_colour ? weights_three : weights_four;
+
+			std::array<int, 6> best {};
+			Indices best_indices {};
+
+			const auto evaluate = [&](const std::array<int, 6>& q, Indices& indices) {
+				Colour palette[4] {};
+				bc1_palette({q[0], q[1], q[2]}, {q[3], q[4], q[5]}, three_colour, palette);
+
+				return fit_indices(texels, palette, count, 3, indices);
+			};
+
+			const auto quantise = [](const Colour& e0, const Colour& e1) {
+				const auto q0 = quantise_565(e0);
+				const auto q1 = quantise_565(e1);
+				return std::array<int, 6> {q0[0], q0[1], q0[2], q1[0], q1[1], q1[2]};
+			};
+
+			Colour e0 {};
+			Colour e1 {};
+			principal_endpoints(texels, 3, e0, e1);
+
+			best             = quantise(e0, e1);
+			float best_error = evaluate(best, best_indices);
+
+			for (std::uint32_t pass = 0; pass < refine_passes(quality) && best_error > 0.0f; pass++)
+			{
+				if (!least_squares(texels, 3, best_indices, weights, e0, e1))
+				{
+					break;
+				}
+
+				Indices indices;
+				const auto candidate = quantise(e0, e1);
+				const float error    = evaluate(candidate, indices);
+				if (error >= best_error)
+				{
+					break;
+				}
+
+				best         = candidate;
+				best_error   = error;
+				best_indices = indices;
+			}
+
+			if (quality == EncodeQuality::SLOW && best_error > 0.0f)
+			{
+				Indices scratch;
+				neighbour_search(best, best_error, 1, {31, 63, 31, 31, 63, 31}, [&](const std::array<int, 6>& candidate) {
+					return evaluate(candidate, scratch);
+				});
+
+				static_cast<void>(evaluate(best, best_indices));
+			}
+
+			std::uint16_t c0 = pack_565({best[0], best[1], best[2]});
+			std::uint16_t c1 = pack_565({best[3], best[4], best[5]});
+
+			// The decoder picks the palette from the endpoint order, so order them to match and remap the indices.
+			const bool swap = three_colour ? (c0 > c1) : (c0 < c1);
+			if (swap)
+			{
+				std::swap(c0, c1);
+				for (auto& index : best_indices)
+				{
+					index = (three_colour && index == 2) ? index : static_cast<std::uint8_t>(index ^ 1);
+				}
+			}
+			else if (c0 == c1 && !three_colour)
+			{
+				best_indices.fill(0);
+			}
+
+			std::uint32_t packed = 0;
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				const std::uint32_t index = (transparent & (1u << p)) ? 3 : best_indices[p];
+				packed |= index << (2 * p);
+			}
+
+			out[0] = static_cast<std::uint8_t>(c0 & 0xFF);
+			out[1] = static_cast<std::uint8_t>(c0 >> 8);
+			out[2] = static_cast<std::uint8_t>(c1 & 0xFF);
+			out[3] = static_cast<std::uint8_t>(c1 >> 8);
+			std::memcpy(out + 4, &packed, sizeof(packed));
+		}
+
+		///
+		/// Mirrors the palette built by decode_channel() in BlockCompression.cpp.
+		///
+		void bc4_palette(int a0, int a1, std::array<int, 8>& palette)
+		{
+			palette[0] = a0;
+			palette[1] = a1;
+			if (a0 > a1)
+			{
+				for (int i = 1; i < 7; i++)
+				{
+					palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+				}
+			}
+			else
+			{
+				for (int i = 1; i < 5; i++)
+				{
+					palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+				}
+
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+		}
+
+		[[nodiscard]] int bc4_fit(const std::array<int, 16>& values, int a0, int a1, std::array<std::uint8_t, 16>& indices)
+		{
+			std::array<int, 8> palette;
+			bc4_palette(a0, a1, palette);
+
+			int total = 0;
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				int best = INT_MAX;
+				for (std::uint8_t k = 0; k < 8; k++)
+				{
+					const int d = (values[p] - palette[k]) * (values[p] - palette[k]);
+					if (d < best)
+					{
+						best       = d;
+						indices[p] = k;
+					}
+				}
+
+				total += best;
+			}
+
+			return total;
+		}
+
+		///
+		/// BC4 single channel block. Searches endpoint insets around the block range, and with EncodeQuality::SLOW
+		/// also the six value mode for blocks that contain exact 0 or 255 texels.
+		///
+		void encode_bc4(const float* channel, EncodeQuality quality, std::uint8_t* out)
+		{
+			std::array<int, 16> values;
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				values[p] = static_cast<int>(channel[p] + 0.5f);
+			}
+
+			const auto [lo_it, hi_it] = std::minmax_element(values.begin(), values.end());
+			const int lo              = *lo_it;
+			const int hi              = *hi_it;
+
+			int best_a0 = hi;
+			int best_a1 = lo;
+			Indices best_indices {};
+			int best_error = bc4_fit(values, best_a0, best_a1, best_indices);
+
+			const auto consider = [&](int a0, int a1) {
+				Indices indices;
+				const int error = bc4_fit(values, a0, a1, indices);
+				if (error < best_error)
+				{
+					best_a0      = a0;
+					best_a1      = a1;
+					best_error   = error;
+					best_indices = indices;
+				}
+			};
+
+			const int radius = (quality == EncodeQuality::FAST) ? 0 : ((quality == EncodeQuality::NORMAL) ? 2 : 6);
+			for (int i = 0; i <= radius && best_error > 0; i++)
+			{
+				for (int j = 0; j <= radius; j++)
+				{
+					if (hi - i > lo + j)
+					{
+						consider(hi - i, lo + j);
+					}
+				}
+			}
+
+			if (quality == EncodeQuality::SLOW && best_error > 0)
+			{
+				int inner_lo = 255;
+				int inner_hi = 0;
+				for (const int v : values)
+				{
+					if (v != 0 && v != 255)
+					{
+						inner_lo = std::min(inner_lo, v);
+						inner_hi = std::max(inner_hi, v);
+					}
+				}
+
+				if (inner_lo <= inner_hi)
+				{
+					for (int i = 0; i <= radius; i++)
+					{
+						for (int j = 0; j <= radius; j++)
+						{
+							if (inner_lo + i <= inner_hi - j)
+							{
+								consider(inner_lo + i, inner_hi - j);
+							}
+						}
+					}
+				}
+			}
+
+			std::uint64_t packed = 0;
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				packed |= static_cast<std::uint64_t>(best_indices[p]) << (3 * p);
+			}
+
+			out[0] = static_cast<std::uint8_t>(best_a0);
+			out[1] = static_cast<std::uint8_t>(best_a1);
+			std::memcpy(out + 2, &packed, 6);
+		}
+
+		///
+		/// Little endian writer over a single 128 bit block.
+		///
+		class BitWriter final
+		{
+		public:
+			BitWriter()
+			    : m_low {0}, m_high {0}, m_pos {0}
+			{
+			}
+
+			void write(std::uint32_t value, std::uint32_t count)
+			{
+				const std::uint64_t bits = value & ((std::uint64_t {1} << count) - 1);
+				if (m_pos >= 64)
+				{
+					m_high |= bits << (m_pos - 64);
+				}
+				else
+				{
+					m_low |= bits << m_pos;
+					if (m_pos + count > 64)
+					{
+						m_high |= bits >> (64 - m_pos);
+					}
+				}
+
+				m_pos += count;
+			}
+
+			void store(std::uint8_t* out) const
+			{
+				std::memcpy(out, &m_low, sizeof(m_low));
+				std::memcpy(out + sizeof(m_low), &m_high, sizeof(m_high));
+			}
+
+		private:
+			std::uint64_t m_low;
+			std::uint64_t m_high;
+			std::uint32_t m_pos;
+		};
+
+		///
+		/// BC7 endpoints for mode 6: RGBA for e0 then e1, each channel 8 bits with the shared p-bit as its LSB.
+		///
+		using Bc7Endpoints = std::array<int, 8>;
+
+		void bc7_palette(const Bc7Endpoints& endpoints, Colour* palette)
+		{
+			for (std::uint32_t i = 0; i < 16; i++)
+			{
+				const int w = static_cast<int>(BC7_WEIGHTS_4[i]);
+				for (std::uint32_t c = 0; c < 4; c++)
+				{
+					palette[i][c] = static_cast<float>(((64 - w) * endpoints[c] + w * endpoints[4 + c] + 32) >> 6);
+				}
+			}
+		}
+
+		[[nodiscard]] int bc7_quantise(float value, int pbit)
+		{
+			const int q = std::clamp(static_cast<int>((value - static_cast<float>(pbit)) / 2.0f + 0.5f), 0, 127);
+			return (q << 1) | pbit;
+		}
+
+		[[nodiscard]] Bc7Endpoints bc7_quantise(const Colour& e0, const Colour& e1, int p0, int p1)
+		{
+			Bc7Endpoints endpoints;
+			for (std::uint32_t c = 0; c < 4; c++)
+			{
+				endpoints[c]     = bc7_quantise(e0[c], p0);
+				endpoints[4 + c] = bc7_quantise(e1[c], p1);
+			}
+
+			return endpoints;
+		}
+
+		///
+		/// Closest p-bit for one endpoint on its own, used when the full search is skipped.
+		///
+		[[nodiscard]] int bc7_best_pbit(const Colour& e)
+		{
+			float error[2] {};
+			for (int p = 0; p < 2; p++)
+			{
+				for (std::uint32_t c = 0; c < 4; c++)
+				{
+					const float d = static_cast<float>(bc7_quantise(e[c], p)) - e[c];
+					error[p] += d * d;
+				}
+			}
+
+			return error[1] < error[0] ? 1 : 0;
+		}
+
+		///
+		/// BC7 mode 6, a single subset with 7.7.7.7 endpoints, per endpoint p-bits and 4 bit indices.
+		///
+		void encode_bc7(const BlockTexels& texels, EncodeQuality quality, std::uint8_t* out)
+		{
+			float weights[16];
+			for (std::uint32_t i = 0; i < 16; i++)
+			{
+				weights[i] = static_cast<float>(BC7_WEIGHTS_4[i]) / 64.0f;
+			}
+
+			const auto evaluate = [&](const Bc7Endpoints& endpoints, Indices& indices) {
+				Colour palette[16];
+				bc7_palette(endpoints, palette);
+
+				return fit_indices(texels, palette, 16, 4, indices);
+			};
+
+			Colour e0 {};
+			Colour e1 {};
+			principal_endpoints(texels, 4, e0, e1);
+
+			Bc7Endpoints best {};
+			Indices best_indices {};
+			float best_error = FLT_MAX;
+
+			const auto consider_pbits = [&](const Colour& a, const Colour& b) {
+				bool improved = false;
+				for (int p = 0; p < 4; p++)
+				{
+					int p0 = p & 1;
+					int p1 = p >> 1;
+					if (quality == EncodeQuality::FAST)
+					{
+						p0 = bc7_best_pbit(a);
+						p1 = bc7_best_pbit(b);
+					}
+
+					Indices indices;
+					const auto candidate = bc7_quantise(a, b, p0, p1);
+					const float error    = evaluate(candidate, indices);
+					if (error < best_error)
+					{
+						best         = candidate;
+						best_error   = error;
+						best_indices = indices;
+						improved     = true;
+					}
+
+					if (quality == EncodeQuality::FAST)
+					{
+						break;
+					}
+				}
+
+				return improved;
+			};
+
+			consider_pbits(e0, e1);
+
+			for (std::uint32_t pass = 0; pass < refine_passes(quality) && best_error > 0.0f; pass++)
+			{
+				if (!least_squares(texels, 4, best_indices, weights, e0, e1) || !consider_pbits(e0, e1))
+				{
+					break;
+				}
+			}
+
+			if (quality == EncodeQuality::SLOW && best_error > 0.0f)
+			{
+				// Steps of two keep each endpoint's p-bit intact.
+				Indices scratch;
+				neighbour_search(best, best_error, 2, {255, 255, 255, 255, 255, 255, 255, 255}, [&](const Bc7Endpoints& candidate) {
+					return evaluate(candidate, scratch);
+				});
+
+				static_cast<void>(evaluate(best, best_indices));
+			}
+
+			// The anchor index drops its top bit, so texel 0 must use the first half of the palette.
+			if (best_indices[0] & 8)
+			{
+				std::swap_ranges(best.begin(), best.begin() + 4, best.begin() + 4);
+				for (auto& index : best_indices)
+				{
+					index = static_cast<std::uint8_t>(15 - index);
+				}
+			}
+
+			BitWriter writer;
+			writer.write(1 << 6, 7);
+			for (std::uint32_t c = 0; c < 4; c++)
+			{
+				writer.write(static_cast<std::uint32_t>(best[c] >> 1), 7);
+				writer.write(static_cast<std::uint32_t>(best[4 + c] >> 1), 7);
+			}
+
+			writer.write(static_cast<std::uint32_t>(best[0] & 1), 1);
+			writer.write(static_cast<std::uint32_t>(best[4] & 1), 1);
+
+			for (std::uint32_t p = 0; p < 16; p++)
+			{
+				writer.write(best_indices[p], p == 0 ? 3 : 4);
+			}
+
+			writer.store(out);
+		}
+
+		void load_block(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, std::uint32_t bx, std::uint32_t by, BlockTexels& texels)
+		{
+			// Edge blocks replicate the last row and column.
+			for (std::uint32_t y = 0; y < 4; y++)
+			{
+				const std::uint32_t sy = std::min(by * 4 + y, height - 1);
+				for (std::uint32_t x = 0; x < 4; x++)
+				{
+					const std::uint32_t sx     = std::min(bx * 4 + x, width - 1);
+					const std::uint8_t* texel = rgba + (static_cast<std::size_t>(sy) * width + sx) * 4;
+
+					for (std::uint32_t c = 0; c < 4; c++)
+					{
+						texels.m_channels[c][y * 4 + x] = static_cast<float>(texel[c]);
+					}
+				}
+			}
+		}
+
+		void encode_block(VkFormat format, const BlockTexels& texels, EncodeQuality quality, std::uint8_t* out)
+		{
+			switch (format)
+			{
+				case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+					encode_bc1(texels, quality, false, out);
+					break;
+
+				case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+					encode_bc1(texels, quality, true, out);
+					break;
+
+				case VK_FORMAT_BC3_UNORM_BLOCK:
+				case VK_FORMAT_BC3_SRGB_BLOCK:
+					encode_bc4(texels.m_channels[3], quality, out);
+					encode_bc1(texels, quality, false, out + 8);
+					break;
+
+				case VK_FORMAT_BC4_UNORM_BLOCK:
+					encode_bc4(texels.m_channels[0], quality, out);
+					break;
+
+				case VK_FORMAT_BC5_UNORM_BLOCK:
+					encode_bc4(texels.m_channels[0], quality, out);
+					encode_bc4(texels.m_channels[1], quality, out + 8);
+					break;
+
+				default:
+					encode_bc7(texels, quality, out);
+					break;
+			}
+		}
+	} // namespace
+
+	void compress(VkFormat format, std::span<const std::byte> rgba, std::uint32_t width, std::uint32_t height, std::span<std::byte> blocks, EncodeQuality quality)
+	{
+		if (!is_block_compressed(format))
+		{
+			VK_LOG(VK_THROW, "Not a supported block compressed format: {0}.", static_cast<int>(format));
+		}
+
+		if (width == 0 || height == 0 || rgba.size() < static_cast<std::size_t>(width) * height * 4 || blocks.size() < level_size(format, width, height))
+		{
+			VK_LOG(VK_THROW, "Buffer too small to compress {0}x{1} level.", width, height);
+		}
+
+		const std::uint32_t blocks_x   = (width + 3) / 4;
+		const std::uint32_t blocks_y   = (height + 3) / 4;
+		const std::uint32_t block_step = block_size(format);
+
+		const auto* src = reinterpret_cast<const std::uint8_t*>(rgba.data());
+		auto* dst       = reinterpret_cast<std::uint8_t*>(blocks.data());
+
+		std::vector<std::uint32_t> tasks((blocks_y + BLOCK_ROWS_PER_TASK - 1) / BLOCK_ROWS_PER_TASK);
+		std::iota(tasks.begin(), tasks.end(), 0);
+
+		// Every block is encoded independently, so the output does not depend on scheduling.
+		std::for_each(std::execution::par, tasks.begin(), tasks.end(), [&](std::uint32_t task) {
+			const std::uint32_t begin = task * BLOCK_ROWS_PER_TASK;
+			const std::uint32_t end   = std::min(blocks_y, begin + BLOCK_ROWS_PER_TASK);
+
+			BlockTexels texels;
+			for (std::uint32_t by = begin; by < end; by++)
+			{
+				for (std::uint32_t bx = 0; bx < blocks_x; bx++)
+				{
+					load_block(src, width, height, bx, by, texels);
+					encode_block(format, texels, quality, dst + (static_cast<std::size_t>(by) * blocks_x + bx) * block_step);
+				}
+			}
+		});
+	}
+} // namespace vulkano::bc
\ No newline at end of file
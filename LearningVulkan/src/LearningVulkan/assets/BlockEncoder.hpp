@@ -0,0 +1,39 @@
+#ifndef VULKANO_ASSETS_BLOCKENCODER_HPP_
+#define VULKANO_ASSETS_BLOCKENCODER_HPP_
+
+#include <cstddef>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano::bc
+{
+	///
+	/// Speed/quality trade off of the encoder. Output is deterministic for a given preset and input.
+	///
+	enum class EncodeQuality
+	{
+		///
+		/// Principal axis endpoints only.
+		///
+		FAST,
+
+		///
+		/// Adds least squares endpoint refinement and a wider BC4 and BC7 p-bit search.
+		///
+		NORMAL,
+
+		///
+		/// Adds a local search over the quantised endpoints.
+		///
+		SLOW
+	};
+
+	///
+	/// Encodes a tightly packed RGBA8 level to BC1, BC3, BC4, BC5 or BC7 (mode 6). Blocks are encoded in parallel.
+	/// BC4 reads the red channel and BC5 the red and green channels.
+	///
+	void compress(VkFormat format, std::span<const std::byte> rgba, std::uint32_t width, std::uint32_t height, std::span<std::byte> blocks, EncodeQuality quality);
+} // namespace vulkano::bc
+
+#endif
\ No newline at end of file
@@ -0,0 +1,816 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "vulkano/assets/MeshOptimizer.hpp"
+#include "vulkano/assets/MeshSimplifier.hpp"
+#include "vulkano/core/JobSystem.hpp"
+#include "vulkano/utils/Json.hpp"
+#include "vulkano/utils/Log.hpp"
+#include "vulkano/utils/MappedFile.hpp"
+
+#include "MeshImporter.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr std::uint32_t NONE = UINT32_MAX;
+
+		constexpr std::uint32_t GLB_MAGIC      = 0x46546C67;
+		constexpr std::uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+		constexpr std::uint32_t GLB_CHUNK_BIN  = 0x004E4942;
+
+		constexpr std::uint32_t GLTF_MODE_TRIANGLES = 4;
+
+		constexpr std::uint32_t GLTF_BYTE           = 5120;
+		constexpr std::uint32_t GLTF_UNSIGNED_BYTE  = 5121;
+		constexpr std::uint32_t GLTF_SHORT          = 5122;
+		constexpr std::uint32_t GLTF_UNSIGNED_SHORT = 5123;
+		constexpr std::uint32_t GLTF_UNSIGNED_INT   = 5125;
+		constexpr std::uint32_t GLTF_FLOAT          = 5126;
+
+		[[nodiscard]] std::uint32_t read_u32(std::span<const std::byte> bytes, std::size_t offset)
+		{
+			std::uint32_t value = 0;
+			std::memcpy(&value, bytes.data() + offset, sizeof(value));
+			return value;
+		}
+
+		[[nodiscard]] std::uint32_t component_size(std::uint32_t component_type)
+		{
+			switch (component_type)
+			{
+				case GLTF_BYTE:
+				case GLTF_UNSIGNED_BYTE:
+					return 1;
+
+				case GLTF_SHORT:
+				case GLTF_UNSIGNED_SHORT:
+					return 2;
+
+				case GLTF_UNSIGNED_INT:
+				case GLTF_FLOAT:
+					return 4;
+
+				default:
+					return 0;
+			}
+		}
+
+		[[nodiscard]] std::uint32_t component_count(std::string_view type)
+		{
+			if (type == "SCALAR")
+			{
+				return 1;
+			}
+
+			if (type.starts_with("VEC") && type.size() == 4)
+			{
+				return static_cast<std::uint32_t>(type[3] - '0');
+			}
+
+			return 0;
+		}
+
+		///
+		/// One accessor, read straight out of the mapped buffer. Converts any component type glTF allows for
+		/// vertex attributes (including KHR_mesh_quantization) to float.
+		///
+		struct Accessor final
+		{
+			const std::byte* m_data        = nullptr;
+			std::uint32_t m_count          = 0;
+			std::uint32_t m_stride         = 0;
+			std::uint32_t m_components     = 0;
+			std::uint32_t m_component_type = 0;
+			bool m_normalized              = false;
+
+			[[nodiscard]] glm::vec4 read(std::uint32_t index, glm::vec4 value) const
+			{
+				const std::byte* element = m_data + static_cast<std::size_t>(index) * m_stride;
+				const std::uint32_t size = component_size(m_component_type);
+
+				for (std::uint32_t c = 0; c < m_components; c++)
+				{
+					value[c] = read_component(element + c * size);
+				}
+
+				return value;
+			}
+
+			[[nodiscard]] std::uint32_t read_index(std::uint32_t index) const
+			{
+				const std::byte* element = m_data + static_cast<std::size_t>(index) * m_stride;
+				switch (m_component_type)
+				{
+					case GLTF_UNSIGNED_BYTE:
+						return std::to_integer<std::uint32_t>(*element);
+
+					case GLTF_UNSIGNED_SHORT:
+					{
+						std::uint16_t value = 0;
+						std::memcpy(&value, element, sizeof(value));
+						return value;
+					}
+
+					default:
+					{
+						std::uint32_t value = 0;
+						std::memcpy(&value, element, sizeof(value));
+						return value;
+					}
+				}
+			}
+
+		private:
+			template<typename Type>
+			[[nodiscard]] static Type load(const std::byte* data)
+			{
+				Type value;
+				std::memcpy(&value, data, sizeof(Type));
+				return value;
+			}
+
+			[[nodiscard]] float read_component(const std::byte* data) const
+			{
+				// Normalized conversions follow the Vulkan rules, which glTF adopts.
+				switch (m_component_type)
+				{
+					case GLTF_BYTE:
+						return m_normalized ? std::max(load<std::int8_t>(data) / 127.0f, -1.0f) : load<std::int8_t>(data);
+
+					case GLTF_UNSIGNED_BYTE:
+						return m_normalized ? load<std::uint8_t>(data) / 255.0f : load<std::uint8_t>(data);
+
+					case GLTF_SHORT:
+						return m_normalized ? std::max(load<std::int16_t>(data) / 32767.0f, -1.0f) : load<std::int16_t>(data);
+
+					case GLTF_UNSIGNED_SHORT:
+						return m_normalized ? load<std::uint16_t>(data) / 65535.0f : load<std::uint16_t>(data);
+
+					case GLTF_UNSIGNED_INT:
+						return static_cast<float>(load<std::uint32_t>(data));
+
+					default:
+						return load<float>(data);
+				}
+			}
+		};
+
+		///
+		/// Copies out an array's elements once, since JsonValue indexing is linear.
+		///
+		[[nodiscard]] std::vector<JsonValue> elements(JsonValue array)
+		{
+			std::vector<JsonValue> result;
+			result.reserve(array.size());
+
+			for (JsonValue element = array.first(); !element.is_null(); element = element.next())
+			{
+				result.push_back(element);
+			}
+
+			return result;
+		}
+
+		[[nodiscard]] std::string decode_uri(std::string_view uri)
+		{
+			std::string result;
+			result.reserve(uri.size());
+
+			for (std::size_t i = 0; i < uri.size(); i++)
+			{
+				std::uint32_t value = 0;
+				if (uri[i] == '%' && i + 2 < uri.size() && std::from_chars(uri.data() + i + 1, uri.data() + i + 3, value, 16).ptr == uri.data() + i + 3)
+				{
+					result.push_back(static_cast<char>(value));
+					i += 2;
+				}
+				else
+				{
+					result.push_back(uri[i]);
+				}
+			}
+
+			return result;
+		}
+
+		///
+		/// Cursor over one line of an OBJ file.
+		///
+		struct ObjLine final
+		{
+			std::string_view m_text;
+
+			void skip_spaces()
+			{
+				const std::size_t begin = m_text.find_first_not_of(" \t");
+				m_text.remove_prefix(std::min(begin, m_text.size()));
+			}
+
+			[[nodiscard]] std::string_view token()
+			{
+				skip_spaces();
+				const std::size_t end        = std::min(m_text.find_first_of(" \t"), m_text.size());
+				const std::string_view value = m_text.substr(0, end);
+				m_text.remove_prefix(end);
+				return value;
+			}
+
+			[[nodiscard]] bool number(float& value)
+			{
+				skip_spaces();
+				const auto result = std::from_chars(m_text.data(), m_text.data() + m_text.size(), value);
+				m_text.remove_prefix(static_cast<std::size_t>(result.ptr - m_text.data()));
+				return result.ec == std::errc {};
+			}
+
+			[[nodiscard]] bool integer(std::int64_t& value)
+			{
+				const auto result = std::from_chars(m_text.data(), m_text.data() + m_text.size(), value);
+				m_text.remove_prefix(static_cast<std::size_t>(result.ptr - m_text.data()));
+				return result.ec == std::errc {};
+			}
+		};
+
+		///
+		/// Position, UV and normal indices of one face corner. Missing ones are NONE.
+		///
+		struct ObjCorner final
+		{
+			std::uint32_t m_position;
+			std::uint32_t m_uv;
+			std::uint32_t m_normal;
+
+			[[nodiscard]] bool operator==(const ObjCorner&) const = default;
+		};
+
+		struct ObjCornerHash final
+		{
+			[[nodiscard]] std::size_t operator()(const ObjCorner& corner) const
+			{
+				const std::uint64_t hash = (static_cast<std::uint64_t>(corner.m_position) * 0x9E3779B97F4A7C15ull) ^ (static_cast<std::uint64_t>(corner.m_uv) * 0xC2B2AE3D27D4EB4Full) ^ corner.m_normal;
+				return static_cast<std::size_t>(hash ^ (hash >> 29));
+			}
+		};
+
+		[[nodiscard]] std::uint32_t resolve_obj_index(std::int64_t index, std::size_t count)
+		{
+			// One based, negative counts back from the most recent element.
+			const std::int64_t resolved = (index < 0) ? static_cast<std::int64_t>(count) + index : index - 1;
+			if (resolved < 0 || resolved >= static_cast<std::int64_t>(count))
+			{
+				VK_LOG(VK_THROW, "OBJ index {0} out of range ({1} elements).", index, count);
+			}
+
+			return static_cast<std::uint32_t>(resolved);
+		}
+	} // namespace
+
+	PackedMesh MeshData::pack(const VertexLayout& layout) const
+	{
+		PackedMesh packed;
+		packed.m_streams      = layout.pack(m_vertices);
+		packed.m_index_count  = m_lods.empty() ? static_cast<std::uint32_t>(m_indices.size()) : m_lods.front().m_index_count;
+		packed.m_vertex_count = static_cast<std::uint32_t>(m_vertices.size());
+		packed.m_lods         = m_lods;
+
+		if (m_vertices.size() <= UINT16_MAX + 1ull)
+		{
+			packed.m_index_type = VK_INDEX_TYPE_UINT16;
+			packed.m_indices.resize(m_indices.size() * sizeof(std::uint16_t));
+
+			for (std::size_t i = 0; i < m_indices.size(); i++)
+			{
+				const auto index = static_cast<std::uint16_t>(m_indices[i]);
+				std::memcpy(packed.m_indices.data() + i * sizeof(std::uint16_t), &index, sizeof(index));
+			}
+		}
+		else
+		{
+			packed.m_index_type = VK_INDEX_TYPE_UINT32;
+			packed.m_indices.resize(m_indices.size() * sizeof(std::uint32_t));
+			std::memcpy(packed.m_indices.data(), m_indices.data(), packed.m_indices.size());
+		}
+
+		return packed;
+	}
+
+	std::span<const std::uint32_t> MeshData::lod_indices(std::size_t lod) const
+	{
+		return std::span {m_indices}.subspan(m_lods[lod].m_first_index, m_lods[lod].m_index_count);
+	}
+
+	MeshImporter::MeshImporter(const MeshImporter::Settings& settings, JobSystem* jobs)
+	    : m_settings {settings}, m_jobs {jobs}
+	{
+	}
+
+	template<typename Body>
+	void MeshImporter::for_each(std::uint32_t count, Body&& body) const
+	{
+		if (!m_jobs)
+		{
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				body(i);
+			}
+
+			return;
+		}
+
+		// Jobs must not throw into the worker threads, so keep the first error and rethrow it here.
+		std::exception_ptr error;
+		std::mutex error_mutex;
+
+		m_jobs->parallel_for(count, 1, [&](std::uint32_t begin, std::uint32_t end) {
+			for (std::uint32_t i = begin; i < end; i++)
+			{
+				try
+				{
+					body(i);
+				}
+				catch (...)
+				{
+					std::scoped_lock lock {error_mutex};
+					if (!error)
+					{
+						error = std::current_exception();
+					}
+				}
+			}
+		});
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	std::vector<MeshData> MeshImporter::import(std::string_view path) const
+	{
+		std::string extension = std::filesystem::path {path}.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+			return static_cast<char>(std::tolower(c));
+		});
+
+		if (extension == ".gltf" || extension == ".glb")
+		{
+			return import_gltf(path);
+		}
+
+		if (extension == ".obj")
+		{
+			return import_obj(path);
+		}
+
+		VK_LOG(VK_THROW, "Unsupported mesh format: {0}.", path);
+		return {};
+	}
+
+	std::vector<MeshData> MeshImporter::import_gltf(std::string_view path) const
+	{
+		const MappedFile file {path};
+		const auto bytes = file.data();
+
+		std::string_view json;
+		std::span<const std::byte> glb_bin;
+
+		if (bytes.size() >= 12 && read_u32(bytes, 0) == GLB_MAGIC)
+		{
+			// Header, then 8 byte aligned chunks: the JSON first, then an optional binary buffer.
+			for (std::size_t offset = 12; offset + 8 <= bytes.size();)
+			{
+				const std::uint32_t length = read_u32(bytes, offset);
+				const std::uint32_t type   = read_u32(bytes, offset + 4);
+				if (offset + 8 + length > bytes.size())
+				{
+					VK_LOG(VK_THROW, "Truncated GLB chunk in {0}.", path);
+				}
+
+				const auto chunk = bytes.subspan(offset + 8, length);
+				if (type == GLB_CHUNK_JSON)
+				{
+					json = {reinterpret_cast<const char*>(chunk.data()), chunk.size()};
+				}
+				else if (type == GLB_CHUNK_BIN && glb_bin.empty())
+				{
+					glb_bin = chunk;
+				}
+
+				offset += 8 + length;
+			}
+		}
+		else
+		{
+			json = {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+		}
+
+		const JsonDocument document {json};
+		const JsonValue root = document.root();
+
+		const auto directory = std::filesystem::path {path}.parent_path();
+
+		std::vector<std::unique_ptr<MappedFile>> mapped;
+		std::vector<std::span<const std::byte>> buffers;
+		for (const auto& buffer : elements(root["buffers"]))
+		{
+			const std::string_view uri = buffer["uri"].string();
+			if (uri.empty())
+			{
+				buffers.push_back(glb_bin);
+			}
+			else if (uri.starts_with("data:"))
+			{
+				VK_LOG(VK_THROW, "Embedded base64 buffers are not supported, re-export {0} as .glb or with a .bin file.", path);
+			}
+			else
+			{
+				mapped.push_back(std::make_unique<MappedFile>((directory / decode_uri(uri)).string()));
+				buffers.push_back(mapped.back()->data());
+			}
+
+			if (buffer["byteLength"].uint() > buffers.back().size())
+			{
+				VK_LOG(VK_THROW, "Buffer {0} of {1} is shorter than its byteLength.", buffers.size() - 1, path);
+			}
+		}
+
+		const auto accessors    = elements(root["accessors"]);
+		const auto buffer_views = elements(root["bufferViews"]);
+
+		const auto accessor = [&](JsonValue index) {
+			Accessor result;
+			if (index.is_null())
+			{
+				return result;
+			}
+
+			const JsonValue json_accessor = accessors.at(index.uint());
+			const JsonValue view          = buffer_views.at(json_accessor["bufferView"].uint());
+
+			result.m_count          = json_accessor["count"].uint();
+			result.m_components     = component_count(json_accessor["type"].string());
+			result.m_component_type = json_accessor["componentType"].uint();
+			result.m_normalized     = json_accessor["normalized"].boolean();
+
+			const std::uint32_t element_size = result.m_components * component_size(result.m_component_type);
+			result.m_stride                  = view["byteStride"].uint(element_size);
+
+			if (!json_accessor["sparse"].is_null() || json_accessor["bufferView"].is_null() || element_size == 0 || result.m_components > 4)
+			{
+				VK_LOG(VK_THROW, "Unsupported accessor {0} in {1}.", index.uint(), path);
+			}
+
+			const auto buffer         = buffers.at(view["buffer"].uint());
+			const std::size_t offset  = static_cast<std::size_t>(view["byteOffset"].uint()) + json_accessor["byteOffset"].uint();
+			const std::size_t extent  = (result.m_count > 0) ? static_cast<std::size_t>(result.m_count - 1) * result.m_stride + element_size : 0;
+			const std::size_t in_view = view["byteLength"].uint();
+
+			if (offset + extent > buffer.size() || json_accessor["byteOffset"].uint() + extent > in_view)
+			{
+				VK_LOG(VK_THROW, "Accessor {0} reads past the end of its buffer in {1}.", index.uint(), path);
+			}
+
+			result.m_data = buffer.data() + offset;
+			return result;
+		};
+
+		struct Primitive final
+		{
+			std::string m_name;
+			JsonValue m_json;
+		};
+
+		std::vector<Primitive> primitives;
+		for (const auto& json_mesh : elements(root["meshes"]))
+		{
+			const std::string_view name = json_mesh["name"].string("mesh");
+			const auto mesh_primitives  = elements(json_mesh["primitives"]);
+
+			for (std::size_t i = 0; i < mesh_primitives.size(); i++)
+			{
+				if (mesh_primitives[i]["mode"].uint(GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES)
+				{
+					VK_LOG(VK_NO_THROW, "Skipping non-triangle primitive {0} of {1} in {2}.", i, name, path);
+					continue;
+				}
+
+				primitives.push_back({(mesh_primitives.size() > 1) ? fmt::format("{0}#{1}", name, i) : std::string {name}, mesh_primitives[i]});
+			}
+		}
+
+		std::vector<MeshData> meshes(primitives.size());
+		for_each(static_cast<std::uint32_t>(primitives.size()), [&](std::uint32_t i) {
+			const JsonValue attributes = primitives[i].m_json["attributes"];
+
+			const Accessor positions = accessor(attributes["POSITION"]);
+			const Accessor normals   = accessor(attributes["NORMAL"]);
+			const Accessor tangents  = accessor(attributes["TANGENT"]);
+			const Accessor uvs       = accessor(attributes["TEXCOORD_0"]);
+			const Accessor colours   = accessor(attributes["COLOR_0"]);
+			const Accessor indices   = accessor(primitives[i].m_json["indices"]);
+
+			if (!positions.m_data)
+			{
+				VK_LOG(VK_THROW, "Primitive {0} of {1} has no positions.", primitives[i].m_name, path);
+			}
+
+			MeshData& mesh = meshes[i];
+			mesh.m_name    = primitives[i].m_name;
+			mesh.m_vertices.resize(positions.m_count);
+
+			for (std::uint32_t v = 0; v < positions.m_count; v++)
+			{
+				Vertex& vertex    = mesh.m_vertices[v];
+				vertex.m_position = positions.read(v, glm::vec4 {0.0f});
+
+				// Attributes with fewer elements than positions are malformed, the defaults stand in.
+				if (v < normals.m_count)
+				{
+					vertex.m_normal = normals.read(v, glm::vec4 {vertex.m_normal, 0.0f});
+				}
+
+				if (v < tangents.m_count)
+				{
+					vertex.m_tangent = tangents.read(v, vertex.m_tangent);
+				}
+
+				if (v < uvs.m_count)
+				{
+					vertex.m_uv = uvs.read(v, glm::vec4 {0.0f});
+				}
+
+				if (v < colours.m_count)
+				{
+					vertex.m_colour = colours.read(v, vertex.m_colour);
+				}
+			}
+
+			if (indices.m_data)
+			{
+				mesh.m_indices.resize(indices.m_count - indices.m_count % 3);
+				for (std::uint32_t index = 0; index < mesh.m_indices.size(); index++)
+				{
+					mesh.m_indices[index] = indices.read_index(index);
+					if (mesh.m_indices[index] >= positions.m_count)
+					{
+						VK_LOG(VK_THROW, "Primitive {0} of {1} indexes past its vertices.", primitives[i].m_name, path);
+					}
+				}
+			}
+			else
+			{
+				mesh.m_indices.resize(positions.m_count - positions.m_count % 3);
+				std::iota(mesh.m_indices.begin(), mesh.m_indices.end(), 0u);
+			}
+
+			process(mesh, normals.m_data != nullptr);
+		});
+
+		return meshes;
+	}
+
+	std::vector<MeshData> MeshImporter::import_obj(std::string_view path) const
+	{
+		const MappedFile file {path};
+		const std::string_view text {reinterpret_cast<const char*>(file.data().data()), file.data().size()};
+
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec4> colours;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+
+		std::vector<MeshData> meshes(1);
+		std::vector<bool> has_normals(1, true);
+		meshes.back().m_name = std::filesystem::path {path}.stem().string();
+
+		// Corners are deduplicated exactly on their index triple while parsing, welding catches the rest.
+		std::unordered_map<ObjCorner, std::uint32_t, ObjCornerHash> lookup;
+		std::vector<std::uint32_t> polygon;
+
+		std::size_t line_number = 0;
+		for (std::size_t begin = 0; begin < text.size();)
+		{
+			const std::size_t end = std::min(text.find('\n', begin), text.size());
+			ObjLine line {text.substr(begin, end - begin)};
+			begin = end + 1;
+			line_number++;
+
+			if (!line.m_text.empty() && line.m_text.back() == '\r')
+			{
+				line.m_text.remove_suffix(1);
+			}
+
+			const std::string_view keyword = line.token();
+			if (keyword == "v")
+			{
+				glm::vec3 position {0.0f};
+				glm::vec4 colour {1.0f};
+				if (!line.number(position.x) || !line.number(position.y) || !line.number(position.z))
+				{
+					VK_LOG(VK_THROW, "Malformed vertex at {0}:{1}.", path, line_number);
+				}
+
+				// Vertex colours are a common extension: v x y z r g b.
+				if (!line.number(colour.x) || !line.number(colour.y) || !line.number(colour.z))
+				{
+					colour = glm::vec4 {1.0f};
+				}
+
+				positions.push_back(position);
+				colours.push_back(colour);
+			}
+			else if (keyword == "vt")
+			{
+				glm::vec2 uv {0.0f};
+				if (!line.number(uv.x))
+				{
+					VK_LOG(VK_THROW, "Malformed texture coordinate at {0}:{1}.", path, line_number);
+				}
+
+				// OBJ puts the UV origin bottom left, Vulkan samples from the top left.
+				static_cast<void>(line.number(uv.y));
+				uvs.push_back({uv.x, 1.0f - uv.y});
+			}
+			else if (keyword == "vn")
+			{
+				glm::vec3 normal {0.0f};
+				if (!line.number(normal.x) || !line.number(normal.y) || !line.number(normal.z))
+				{
+					VK_LOG(VK_THROW, "Malformed normal at {0}:{1}.", path, line_number);
+				}
+
+				normals.push_back(normal);
+			}
+			else if (keyword == "f")
+			{
+				MeshData& mesh = meshes.back();
+				polygon.clear();
+
+				for (std::string_view corner_text = line.token(); !corner_text.empty(); corner_text = line.token())
+				{
+					ObjLine corner_line {corner_text};
+					ObjCorner corner {NONE, NONE, NONE};
+
+					std::int64_t index = 0;
+					if (!corner_line.integer(index))
+					{
+						VK_LOG(VK_THROW, "Malformed face at {0}:{1}.", path, line_number);
+					}
+
+					corner.m_position = resolve_obj_index(index, positions.size());
+
+					// v, v/vt, v//vn or v/vt/vn.
+					if (corner_line.m_text.starts_with('/'))
+					{
+						corner_line.m_text.remove_prefix(1);
+						if (corner_line.integer(index))
+						{
+							corner.m_uv = resolve_obj_index(index, uvs.size());
+						}
+
+						if (corner_line.m_text.starts_with('/'))
+						{
+							corner_line.m_text.remove_prefix(1);
+							if (corner_line.integer(index))
+							{
+								corner.m_normal = resolve_obj_index(index, normals.size());
+							}
+						}
+					}
+
+					has_normals.back() = has_normals.back() && corner.m_normal != NONE;
+
+					const auto [entry, inserted] = lookup.try_emplace(corner, static_cast<std::uint32_t>(mesh.m_vertices.size()));
+					if (inserted)
+					{
+						Vertex vertex;
+						vertex.m_position = positions[corner.m_position];
+						vertex.m_colour   = colours[corner.m_position];
+						vertex.m_uv       = (corner.m_uv != NONE) ? uvs[corner.m_uv] : glm::vec2 {0.0f};
+						vertex.m_normal   = (corner.m_normal != NONE) ? normals[corner.m_normal] : vertex.m_normal;
+						mesh.m_vertices.push_back(vertex);
+					}
+
+					polygon.push_back(entry->second);
+				}
+
+				// Polygons are assumed convex and fanned from their first corner.
+				for (std::size_t i = 2; i < polygon.size(); i++)
+				{
+					mesh.m_indices.insert(mesh.m_indices.end(), {polygon[0], polygon[i - 1], polygon[i]});
+				}
+			}
+			else if (keyword == "o" || keyword == "g")
+			{
+				line.skip_spaces();
+				if (!meshes.back().m_indices.empty())
+				{
+					meshes.emplace_back();
+					has_normals.push_back(true);
+					lookup.clear();
+				}
+
+				if (!line.m_text.empty())
+				{
+					meshes.back().m_name = std::string {line.m_text};
+				}
+			}
+		}
+
+		std::erase_if(meshes, [](const MeshData& mesh) {
+			return mesh.m_indices.empty();
+		});
+
+		for_each(static_cast<std::uint32_t>(meshes.size()), [&](std::uint32_t i) {
+			process(meshes[i], has_normals[i]);
+		});
+
+		return meshes;
+	}
+
+	void MeshImporter::process(MeshData& mesh, bool has_normals) const
+	{
+		if (!has_normals)
+		{
+			mesh::compute_normals(mesh.m_vertices, mesh.m_indices);
+		}
+
+		if (m_settings.m_weld)
+		{
+			mesh::weld(mesh.m_vertices, mesh.m_indices);
+		}
+
+		if (m_settings.m_optimize)
+		{
+			mesh::optimize_vertex_cache(mesh.m_indices, static_cast<std::uint32_t>(mesh.m_vertices.size()));
+			mesh::optimize_overdraw(mesh.m_indices, mesh.m_vertices, m_settings.m_overdraw_threshold);
+		}
+
+		mesh.m_min = glm::vec3 {std::numeric_limits<float>::max()};
+		mesh.m_max = glm::vec3 {std::numeric_limits<float>::lowest()};
+		for (const auto& vertex : mesh.m_vertices)
+		{
+			mesh.m_min = glm::min(mesh.m_min, vertex.m_position);
+			mesh.m_max = glm::max(mesh.m_max, vertex.m_position);
+		}
+
+		build_lods(mesh);
+
+		// Last, so vertices follow the first use across every level.
+		if (m_settings.m_optimize)
+		{
+			mesh::optimize_vertex_fetch(mesh.m_vertices, mesh.m_indices);
+		}
+	}
+
+	void MeshImporter::build_lods(MeshData& mesh) const
+	{
+		const auto full_count = static_cast<std::uint32_t>(mesh.m_indices.size());
+		mesh.m_lods.push_back({0, full_count, 0.0f});
+
+		if (full_count == 0)
+		{
+			return;
+		}
+
+		// Every level is simplified from full detail, so its error is measured against the real surface.
+		const std::vector<std::uint32_t> full {mesh.m_indices};
+		const float max_error = m_settings.m_lod_max_error * glm::length(mesh.m_max - mesh.m_min) * 0.5f;
+
+		double target = full_count;
+		for (std::uint32_t level = 1; level <= m_settings.m_lod_count; level++)
+		{
+			target *= m_settings.m_lod_ratio;
+
+			auto simplified = mesh::simplify(mesh.m_vertices, full, static_cast<std::size_t>(target) / 3 * 3, max_error);
+
+			// A level that is hardly smaller than the last costs memory and saves nothing.
+			if (simplified.m_indices.empty() || simplified.m_indices.size() > mesh.m_lods.back().m_index_count * 9 / 10)
+			{
+				break;
+			}
+
+			if (m_settings.m_optimize)
+			{
+				mesh::optimize_vertex_cache(simplified.m_indices, static_cast<std::uint32_t>(mesh.m_vertices.size()));
+			}
+
+			mesh.m_lods.push_back({static_cast<std::uint32_t>(mesh.m_indices.size()), static_cast<std::uint32_t>(simplified.m_indices.size()), simplified.m_error});
+			mesh.m_indices.insert(mesh.m_indices.end(), simplified.m_indices.begin(), simplified.m_indices.end());
+		}
+	}
+} // namespace vulkano
\ No newline at end of file
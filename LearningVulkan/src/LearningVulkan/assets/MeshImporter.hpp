@@ -0,0 +1,139 @@
+#ifndef VULKANO_ASSETS_MESHIMPORTER_HPP_
+#define VULKANO_ASSETS_MESHIMPORTER_HPP_
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "vulkano/graphics/VertexLayout.hpp"
+
+namespace vulkano
+{
+	class JobSystem;
+
+	///
+	/// One level of detail: a range of the mesh's index buffer over the shared vertices.
+	///
+	struct MeshLod final
+	{
+		std::uint32_t m_first_index;
+		std::uint32_t m_index_count;
+
+		///
+		/// Largest deviation from the full detail surface, in mesh units. 0 for the full detail level.
+		///
+		float m_error;
+	};
+
+	///
+	/// Vertex and index streams encoded for the GPU, ready for BufferUploader.
+	///
+	struct PackedMesh final
+	{
+		std::array<std::vector<std::byte>, VertexLayout::MAX_STREAMS> m_streams;
+		std::vector<std::byte> m_indices;
+		std::vector<MeshLod> m_lods;
+		VkIndexType m_index_type;
+
+		///
+		/// Indices of full detail only; m_indices holds every LOD back to back.
+		///
+		std::uint32_t m_index_count;
+		std::uint32_t m_vertex_count;
+	};
+
+	///
+	/// One imported triangle list at full precision, kept around for further processing (LODs, meshlets, bounds).
+	///
+	struct MeshData final
+	{
+		std::string m_name;
+		std::vector<Vertex> m_vertices;
+		std::vector<std::uint32_t> m_indices;
+
+		///
+		/// Ranges of m_indices from full detail down, each with a larger error than the one before.
+		///
+		std::vector<MeshLod> m_lods;
+		glm::vec3 m_min;
+		glm::vec3 m_max;
+
+		[[nodiscard]] std::span<const std::uint32_t> lod_indices(std::size_t lod) const;
+
+		///
+		/// 16 bit indices whenever the vertex count allows.
+		///
+		[[nodiscard]] PackedMesh pack(const VertexLayout& layout) const;
+	};
+
+	///
+	/// Loads glTF 2.0 (.gltf with external .bin, or .glb) and Wavefront OBJ triangle meshes. Binary buffers are
+	/// memory mapped and read in place, and each mesh is decoded and optimized as its own job.
+	///
+	class MeshImporter final
+	{
+	public:
+		struct Settings final
+		{
+			///
+			/// Merge duplicate vertices. Exporters split vertices freely, and welding is what makes reordering pay off.
+			///
+			bool m_weld = true;
+
+			///
+			/// Reorder triangles for the vertex cache and overdraw, then vertices for fetch locality.
+			///
+			bool m_optimize = true;
+
+			///
+			/// Cache miss ratio the overdraw pass may give up, relative to the cache optimized order.
+			///
+			float m_overdraw_threshold = 1.05f;
+
+			///
+			/// Simplified levels generated below full detail. The chain stops early once a level barely shrinks.
+			///
+			std::uint32_t m_lod_count = 4;
+
+			///
+			/// Index count of each level relative to the one above. 0.4 leaves under a tenth of the triangles by
+			/// the third level.
+			///
+			float m_lod_ratio = 0.4f;
+
+			///
+			/// Largest simplification error accepted, relative to the mesh's bounding radius.
+			///
+			float m_lod_max_error = 0.1f;
+		};
+
+		MeshImporter(const MeshImporter::Settings& settings, JobSystem* jobs = nullptr);
+		~MeshImporter() = default;
+
+		///
+		/// One MeshData per glTF primitive or OBJ object. Non-triangle primitives are skipped with a warning.
+		///
+		[[nodiscard]] std::vector<MeshData> import(std::string_view path) const;
+
+	private:
+		MeshImporter() = delete;
+
+		[[nodiscard]] std::vector<MeshData> import_gltf(std::string_view path) const;
+		[[nodiscard]] std::vector<MeshData> import_obj(std::string_view path) const;
+
+		///
+		/// Runs body(i) for i in [0, count), across the job system when there is one.
+		///
+		template<typename Body>
+		void for_each(std::uint32_t count, Body&& body) const;
+
+		void process(MeshData& mesh, bool has_normals) const;
+		void build_lods(MeshData& mesh) const;
+
+		MeshImporter::Settings m_settings;
+		JobSystem* m_jobs;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#include <glm/geometric.hpp>
+
+#include "MeshOptimizer.hpp"
+
+namespace vulkano::mesh
+{
+	namespace
+	{
+		constexpr std::uint32_t NONE = UINT32_MAX;
+
+		///
+		/// Forsyth's tuning: a 32 entry LRU model, with the last triangle's vertices scored flat so the next
+		/// triangle does not always reuse the same edge.
+		///
+		constexpr std::uint32_t CACHE_SIZE  = 32;
+		constexpr float CACHE_DECAY_POWER   = 1.5f;
+		constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+		constexpr float VALENCE_BOOST_SCALE = 2.0f;
+		constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+		///
+		/// FIFO size modelled when measuring and splitting clusters, a typical hardware batch.
+		///
+		constexpr std::uint32_t OVERDRAW_CACHE = 16;
+
+		static_assert(sizeof(Vertex) == 16 * sizeof(float), "Vertex is hashed and compared bytewise, so it must have no padding.");
+
+		[[nodiscard]] std::uint64_t hash_vertex(const Vertex& vertex)
+		{
+			std::array<std::uint32_t, sizeof(Vertex) / sizeof(std::uint32_t)> words;
+			std::memcpy(words.data(), &vertex, sizeof(Vertex));
+
+			// FNV-1a over words rather than bytes, with a final avalanche for the power of two table.
+			std::uint64_t hash = 0xCBF29CE484222325ull;
+			for (const auto word : words)
+			{
+				hash = (hash ^ word) * 0x100000001B3ull;
+			}
+
+			return hash ^ (hash >> 32);
+		}
+
+		[[nodiscard]] float vertex_score(std::uint32_t cache_position, std::uint32_t remaining)
+		{
+			if (remaining == 0)
+			{
+				return -1.0f;
+			}
+
+			float score = 0.0f;
+			if (cache_position < 3)
+			{
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else if (cache_position < CACHE_SIZE)
+			{
+				const float scale = 1.0f / (CACHE_SIZE - 3);
+				score             = std::pow(1.0f - (cache_position - 3) * scale, CACHE_DECAY_POWER);
+			}
+
+			return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining), -VALENCE_BOOST_POWER);
+		}
+
+		[[nodiscard]] glm::vec3 face_normal(std::span<const Vertex> vertices, const std::uint32_t* triangle)
+		{
+			const glm::vec3& a = vertices[triangle[0]].m_position;
+			const glm::vec3& b = vertices[triangle[1]].m_position;
+			const glm::vec3& c = vertices[triangle[2]].m_position;
+
+			// Length is twice the area, so sums are area weighted.
+			return glm::cross(b - a, c - a);
+		}
+	} // namespace
+
+	void compute_normals(std::span<Vertex> vertices, std::span<const std::uint32_t> indices)
+	{
+		for (auto& vertex : vertices)
+		{
+			vertex.m_normal = {0.0f, 0.0f, 0.0f};
+		}
+
+		for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const glm::vec3 normal = face_normal(vertices, &indices[i]);
+			for (std::size_t corner = 0; corner < 3; corner++)
+			{
+				vertices[indices[i + corner]].m_normal += normal;
+			}
+		}
+
+		for (auto& vertex : vertices)
+		{
+			const float length = glm::length(vertex.m_normal);
+			vertex.m_normal    = (length > 0.0f) ? vertex.m_normal / length : glm::vec3 {0.0f, 0.0f, 1.0f};
+		}
+	}
+
+	std::uint32_t weld(std::vector<Vertex>& vertices, std::span<std::uint32_t> indices)
+	{
+		const std::size_t count = vertices.size();
+		const std::size_t mask  = std::bit_ceil(std::max<std::size_t>(count * 2, 16)) - 1;
+
+		// Open addressing with linear probing, storing indices into the compacted front of vertices.
+		std::vector<std::uint32_t> table(mask + 1, NONE);
+		std::vector<std::uint32_t> remap(count);
+
+		std::uint32_t unique = 0;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			std::size_t slot = hash_vertex(vertices[i]) & mask;
+			while (table[slot] != NONE && std::memcmp(&vertices[table[slot]], &vertices[i], sizeof(Vertex)) != 0)
+			{
+				slot = (slot + 1) & mask;
+			}
+
+			if (table[slot] == NONE)
+			{
+				vertices[unique] = vertices[i];
+				table[slot]      = unique++;
+			}
+
+			remap[i] = table[slot];
+		}
+
+		for (auto& index : indices)
+		{
+			index = remap[index];
+		}
+
+		vertices.resize(unique);
+		return unique;
+	}
+
+	void optimize_vertex_cache(std::span<std::uint32_t> indices, std::uint32_t vertex_count)
+	{
+		const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3);
+		if (triangle_count == 0)
+		{
+			return;
+		}
+
+		// Triangles using each vertex. The first remaining[v] entries at offsets[v] are the ones not yet emitted.
+		std::vector<std::uint32_t> remaining(vertex_count, 0);
+		for (std::uint32_t i = 0; i < triangle_count * 3; i++)
+		{
+			remaining[indices[i]]++;
+		}
+
+		std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+		std::inclusive_scan(remaining.begin(), remaining.end(), offsets.begin() + 1);
+
+		std::vector<std::uint32_t> adjacency(triangle_count * 3);
+		std::vector<std::uint32_t> filled(vertex_count, 0);
+		for (std::uint32_t i = 0; i < triangle_count * 3; i++)
+		{
+			const std::uint32_t v             = indices[i];
+			adjacency[offsets[v] + filled[v]] = i / 3;
+			filled[v]++;
+		}
+
+		std::vector<std::uint32_t> cache_position(vertex_count, NONE);
+		std::vector<float> vertex_scores(vertex_count);
+		for (std::uint32_t v = 0; v < vertex_count; v++)
+		{
+			vertex_scores[v] = vertex_score(NONE, remaining[v]);
+		}
+
+		std::vector<float> triangle_scores(triangle_count);
+		for (std::uint32_t t = 0; t < triangle_count; t++)
+		{
+			triangle_scores[t] = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+		}
+
+		std::vector<bool> emitted(triangle_count, false);
+		std::vector<std::uint32_t> output;
+		output.reserve(triangle_count * 3);
+
+		std::vector<std::uint32_t> cache;
+		std::vector<std::uint32_t> next_cache;
+		cache.reserve(CACHE_SIZE + 3);
+		next_cache.reserve(CACHE_SIZE + 3);
+
+		std::uint32_t best   = static_cast<std::uint32_t>(std::max_element(triangle_scores.begin(), triangle_scores.end()) - triangle_scores.begin());
+		std::uint32_t cursor = 0;
+
+		for (std::uint32_t emitted_count = 0; emitted_count < triangle_count; emitted_count++)
+		{
+			// Nothing in the cache has triangles left, restart from the next unemitted one in input order.
+			if (best == NONE)
+			{
+				while (emitted[cursor])
+				{
+					cursor++;
+				}
+
+				best = cursor;
+			}
+
+			emitted[best]                 = true;
+			const std::uint32_t* triangle = &indices[best * 3];
+
+			next_cache.clear();
+			for (std::uint32_t corner = 0; corner < 3; corner++)
+			{
+				const std::uint32_t v = triangle[corner];
+				output.push_back(v);
+
+				auto* begin = &adjacency[offsets[v]];
+				auto* end   = begin + remaining[v];
+				std::iter_swap(std::find(begin, end, best), end - 1);
+				remaining[v]--;
+
+				if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end())
+				{
+					next_cache.push_back(v);
+				}
+			}
+
+			for (const auto v : cache)
+			{
+				if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end())
+				{
+					next_cache.push_back(v);
+				}
+			}
+
+			// Rescore everything that moved in or fell out of the cache, and pick the best triangle touching it.
+			best             = NONE;
+			float best_score = -1.0f;
+			for (std::uint32_t position = 0; position < next_cache.size(); position++)
+			{
+				const std::uint32_t v = next_cache[position];
+				cache_position[v]     = (position < CACHE_SIZE) ? position : NONE;
+
+				const float score = vertex_score(cache_position[v], remaining[v]);
+				const float delta = score - vertex_scores[v];
+				vertex_scores[v]  = score;
+
+				for (std::uint32_t i = offsets[v]; i < offsets[v] + remaining[v]; i++)
+				{
+					const std::uint32_t t = adjacency[i];
+					triangle_scores[t] += delta;
+
+					if (position < CACHE_SIZE && triangle_scores[t] > best_score)
+					{
+						best       = t;
+						best_score = triangle_scores[t];
+					}
+				}
+			}
+
+			next_cache.resize(std::min<std::size_t>(next_cache.size(), CACHE_SIZE));
+			std::swap(cache, next_cache);
+		}
+
+		std::copy(output.begin(), output.end(), indices.begin());
+	}
+
+	void optimize_overdraw(std::span<std::uint32_t> indices, std::span<const Vertex> vertices, float threshold)
+	{
+		const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3);
+		if (triangle_count < 2)
+		{
+			return;
+		}
+
+		const float target = acmr(indices, static_cast<std::uint32_t>(vertices.size()), OVERDRAW_CACHE) * threshold;
+
+		// Split into clusters at cache restarts: always where a triangle misses on all three vertices, and where it
+		// misses on two once the cluster so far is already within the target miss ratio.
+		std::vector<std::uint32_t> cluster_starts {0};
+		std::vector<std::uint32_t> stamps(vertices.size(), 0);
+		std::uint32_t time           = OVERDRAW_CACHE + 1;
+		std::uint32_t cluster_misses = 0;
+
+		for (std::uint32_t t = 0; t < triangle_count; t++)
+		{
+			std::uint32_t misses = 0;
+			for (std::uint32_t corner = 0; corner < 3; corner++)
+			{
+				const std::uint32_t v = indices[t * 3 + corner];
+				if (time - stamps[v] > OVERDRAW_CACHE)
+				{
+					stamps[v] = time++;
+					misses++;
+				}
+			}
+
+			const std::uint32_t cluster_triangles = t - cluster_starts.back();
+			const bool hard                       = misses == 3;
+			const bool soft                       = misses >= 2 && static_cast<float>(cluster_misses) <= target * static_cast<float>(cluster_triangles);
+			if (cluster_triangles > 0 && (hard || soft))
+			{
+				cluster_starts.push_back(t);
+				cluster_misses = 0;
+			}
+
+			cluster_misses += misses;
+		}
+
+		if (cluster_starts.size() < 2)
+		{
+			return;
+		}
+
+		cluster_starts.push_back(triangle_count);
+		const auto cluster_count = static_cast<std::uint32_t>(cluster_starts.size() - 1);
+
+		std::vector<glm::vec3> centroids(cluster_count, glm::vec3 {0.0f});
+		std::vector<glm::vec3> normals(cluster_count, glm::vec3 {0.0f});
+		glm::vec3 mesh_centroid {0.0f};
+		float mesh_area = 0.0f;
+
+		for (std::uint32_t c = 0; c < cluster_count; c++)
+		{
+			float area = 0.0f;
+			for (std::uint32_t t = cluster_starts[c]; t < cluster_starts[c + 1]; t++)
+			{
+				const std::uint32_t* triangle = &indices[t * 3];
+				const glm::vec3 normal        = face_normal(vertices, triangle);
+				const float triangle_area     = glm::length(normal);
+				const glm::vec3 centre        = (vertices[triangle[0]].m_position + vertices[triangle[1]].m_position + vertices[triangle[2]].m_position) / 3.0f;
+
+				centroids[c] += centre * triangle_area;
+				normals[c] += normal;
+				area += triangle_area;
+			}
+
+			mesh_centroid += centroids[c];
+			mesh_area += area;
+			centroids[c] = (area > 0.0f) ? centroids[c] / area : centroids[c];
+		}
+
+		mesh_centroid = (mesh_area > 0.0f) ? mesh_centroid / mesh_area : mesh_centroid;
+
+		// Clusters facing away from the centre are on the silhouette of the mesh and most likely to occlude the rest.
+		std::vector<float> keys(cluster_count);
+		std::vector<std::uint32_t> order(cluster_count);
+		for (std::uint32_t c = 0; c < cluster_count; c++)
+		{
+			const float length = glm::length(normals[c]);
+			keys[c]            = (length > 0.0f) ? glm::dot(centroids[c] - mesh_centroid, normals[c] / length) : 0.0f;
+			order[c]           = c;
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs) {
+			return keys[lhs] > keys[rhs];
+		});
+
+		std::vector<std::uint32_t> output;
+		output.reserve(indices.size());
+		for (const auto c : order)
+		{
+			output.insert(output.end(), indices.begin() + cluster_starts[c] * 3, indices.begin() + cluster_starts[c + 1] * 3);
+		}
+
+		std::copy(output.begin(), output.end(), indices.begin());
+	}
+
+	void optimize_vertex_fetch(std::vector<Vertex>& vertices, std::span<std::uint32_t> indices)
+	{
+		std::vector<std::uint32_t> remap(vertices.size(), NONE);
+		std::vector<Vertex> ordered;
+		ordered.reserve(vertices.size());
+
+		for (auto& index : indices)
+		{
+			if (remap[index] == NONE)
+			{
+				remap[index] = static_cast<std::uint32_t>(ordered.size());
+				ordered.push_back(vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		vertices = std::move(ordered);
+	}
+
+	float acmr(std::span<const std::uint32_t> indices, std::uint32_t vertex_count, std::uint32_t cache_size)
+	{
+		if (indices.size() < 3)
+		{
+			return 0.0f;
+		}
+
+		// A vertex is in the FIFO if fewer than cache_size misses happened since it was last loaded.
+		std::vector<std::uint32_t> stamps(vertex_count, 0);
+		std::uint32_t time = cache_size + 1;
+
+		for (const auto v : indices)
+		{
+			if (time - stamps[v] > cache_size)
+			{
+				stamps[v] = time++;
+			}
+		}
+
+		const auto misses = time - (cache_size + 1);
+		return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+	}
+} // namespace vulkano::mesh
\ No newline at end of file
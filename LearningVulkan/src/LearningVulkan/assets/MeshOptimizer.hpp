@@ -0,0 +1,50 @@
+#ifndef VULKANO_ASSETS_MESHOPTIMIZER_HPP_
+#define VULKANO_ASSETS_MESHOPTIMIZER_HPP_
+
+#include <span>
+#include <vector>
+
+#include "vulkano/graphics/VertexLayout.hpp"
+
+///
+/// Offline processing of indexed triangle lists, run by the importer before meshes are packed for the GPU. Run them
+/// in declaration order: welding first, fetch order last.
+///
+namespace vulkano::mesh
+{
+	///
+	/// Area weighted smooth normals, for sources that ship none.
+	///
+	void compute_normals(std::span<Vertex> vertices, std::span<const std::uint32_t> indices);
+
+	///
+	/// Merges bitwise identical vertices through a hash table and remaps indices. Returns the new vertex count.
+	///
+	std::uint32_t weld(std::vector<Vertex>& vertices, std::span<std::uint32_t> indices);
+
+	///
+	/// Reorders triangles for the post-transform vertex cache with Forsyth's linear-speed algorithm: greedily
+	/// emits the triangle whose vertices score best on cache position and remaining valence.
+	///
+	void optimize_vertex_cache(std::span<std::uint32_t> indices, std::uint32_t vertex_count);
+
+	///
+	/// Reorders clusters of cache optimized triangles so outward facing clusters draw first and occlude the rest
+	/// (Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"). Clusters are only split
+	/// where the cache miss ratio stays within threshold of the input's, so threshold trades cache hits for overdraw.
+	///
+	void optimize_overdraw(std::span<std::uint32_t> indices, std::span<const Vertex> vertices, float threshold = 1.05f);
+
+	///
+	/// Reorders vertices by first use so fetches walk memory linearly, dropping unreferenced ones.
+	///
+	void optimize_vertex_fetch(std::vector<Vertex>& vertices, std::span<std::uint32_t> indices);
+
+	///
+	/// Average cache miss ratio: vertex shader invocations per triangle with a FIFO cache. 0.5 is ideal for large
+	/// regular grids, 3 means no reuse at all.
+	///
+	[[nodiscard]] float acmr(std::span<const std::uint32_t> indices, std::uint32_t vertex_count, std::uint32_t cache_size = 16);
+} // namespace vulkano::mesh
+
+#endif
\ No newline at end of file
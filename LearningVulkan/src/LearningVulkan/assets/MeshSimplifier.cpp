@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+
+#include <glm/geometric.hpp>
+
+#include "MeshSimplifier.hpp"
+
+namespace vulkano::mesh
+{
+	namespace
+	{
+		///
+		/// Border planes are weighted well above faces so open edges keep their outline.
+		///
+		constexpr double BORDER_WEIGHT = 10.0;
+
+		///
+		/// Scales |n0 - n1|^2 * |p0 - p1|^2, roughly the shading change a collapse causes, into the distance error.
+		///
+		constexpr double NORMAL_WEIGHT = 0.5;
+
+		///
+		/// Cosine of the largest rotation a collapse may give a triangle's normal, about 75 degrees.
+		///
+		constexpr float MAX_NORMAL_TURN = 0.25f;
+
+		enum class VertexKind
+		{
+			///
+			/// Interior vertex with a position of its own, free to collapse onto any neighbour.
+			///
+			MANIFOLD,
+
+			///
+			/// On an open edge. Only collapses along the border, onto another border or locked vertex.
+			///
+			BORDER,
+
+			///
+			/// Seam or non-manifold vertex. Never moves, though others may collapse onto it.
+			///
+			LOCKED
+		};
+
+		///
+		/// Sum of squared distances to a set of weighted planes, divided by the total weight so it reads as a mean
+		/// squared distance.
+		///
+		struct Quadric final
+		{
+			double m_a00 = 0.0, m_a11 = 0.0, m_a22 = 0.0, m_a01 = 0.0, m_a02 = 0.0, m_a12 = 0.0;
+			double m_b0 = 0.0, m_b1 = 0.0, m_b2 = 0.0;
+			double m_c      = 0.0;
+			double m_weight = 0.0;
+
+			void add_plane(const glm::dvec3& normal, double distance, double weight)
+			{
+				m_a00 += weight * normal.x * normal.x;
+				m_a11 += weight * normal.y * normal.y;
+				m_a22 += weight * normal.z * normal.z;
+				m_a01 += weight * normal.x * normal.y;
+				m_a02 += weight * normal.x * normal.z;
+				m_a12 += weight * normal.y * normal.z;
+				m_b0 += weight * normal.x * distance;
+				m_b1 += weight * normal.y * distance;
+				m_b2 += weight * normal.z * distance;
+				m_c += weight * distance * distance;
+				m_weight += weight;
+			}
+
+			Quadric& operator+=(const Quadric& other)
+			{
+				m_a00 += other.m_a00;
+				m_a11 += other.m_a11;
+				m_a22 += other.m_a22;
+				m_a01 += other.m_a01;
+				m_a02 += other.m_a02;
+				m_a12 += other.m_a12;
+				m_b0 += other.m_b0;
+				m_b1 += other.m_b1;
+				m_b2 += other.m_b2;
+				m_c += other.m_c;
+				m_weight += other.m_weight;
+
+				return *this;
+			}
+
+			[[nodiscard]] double error(const glm::vec3& point) const
+			{
+				const double x = point.x;
+				const double y = point.y;
+				const double z = point.z;
+
+				const double sum = m_a00 * x * x + m_a11 * y * y + m_a22 * z * z + 2.0 * (m_a01 * x * y + m_a02 * x * z + m_a12 * y * z) + 2.0 * (m_b0 * x + m_b1 * y + m_b2 * z) + m_c;
+				return (m_weight > 0.0) ? std::max(sum, 0.0) / m_weight : 0.0;
+			}
+		};
+
+		struct Collapse final
+		{
+			std::uint32_t m_from;
+			std::uint32_t m_to;
+			double m_cost;
+		};
+
+		[[nodiscard]] std::uint64_t edge_key(std::uint32_t a, std::uint32_t b)
+		{
+			return (static_cast<std::uint64_t>(a) << 32) | b;
+		}
+
+		///
+		/// Lowest vertex at the same position as each vertex, found by sorting rather than hashing positions.
+		///
+		[[nodiscard]] std::vector<std::uint32_t> position_ids(std::span<const Vertex> vertices)
+		{
+			std::vector<std::uint32_t> order(vertices.size());
+			std::iota(order.begin(), order.end(), 0u);
+
+			const auto less = [&](std::uint32_t a, std::uint32_t b) {
+				const glm::vec3& pa = vertices[a].m_position;
+				const glm::vec3& pb = vertices[b].m_position;
+				return std::tie(pa.x, pa.y, pa.z, a) < std::tie(pb.x, pb.y, pb.z, b);
+			};
+
+			std::sort(order.begin(), order.end(), less);
+
+			std::vector<std::uint32_t> ids(vertices.size());
+			for (std::size_t i = 0; i < order.size(); i++)
+			{
+				const bool same = i > 0 && vertices[order[i]].m_position == vertices[order[i - 1]].m_position;
+				ids[order[i]]   = same ? ids[order[i - 1]] : order[i];
+			}
+
+			return ids;
+		}
+
+		void add_triangle_quadrics(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::vector<Quadric>& quadrics)
+		{
+			for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				const glm::dvec3 a {vertices[indices[i]].m_position};
+				const glm::dvec3 b {vertices[indices[i + 1]].m_position};
+				const glm::dvec3 c {vertices[indices[i + 2]].m_position};
+
+				const glm::dvec3 normal = glm::cross(b - a, c - a);
+				const double length     = glm::length(normal);
+				if (length <= 0.0)
+				{
+					continue;
+				}
+
+				Quadric plane;
+				plane.add_plane(normal / length, -glm::dot(normal / length, a), length * 0.5);
+
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					quadrics[indices[i + k]] += plane;
+				}
+			}
+		}
+
+		///
+		/// Planes through each open edge, perpendicular to its triangle, keep borders from shrinking inwards.
+		///
+		void add_border_quadrics(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::span<const std::uint32_t> ids, std::span<const std::uint64_t> edges, std::vector<Quadric>& quadrics)
+		{
+			for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					const std::uint32_t a = indices[i + k];
+					const std::uint32_t b = indices[i + (k + 1) % 3];
+					if (std::binary_search(edges.begin(), edges.end(), edge_key(ids[b], ids[a])))
+					{
+						continue;
+					}
+
+					const glm::dvec3 pa {vertices[a].m_position};
+					const glm::dvec3 pb {vertices[b].m_position};
+					const glm::dvec3 pc {vertices[indices[i + (k + 2) % 3]].m_position};
+
+					const glm::dvec3 normal = glm::cross(glm::cross(pb - pa, pc - pa), pb - pa);
+					const double length     = glm::length(normal);
+					if (length <= 0.0)
+					{
+						continue;
+					}
+
+					Quadric plane;
+					plane.add_plane(normal / length, -glm::dot(normal / length, pa), glm::dot(pb - pa, pb - pa) * BORDER_WEIGHT);
+
+					quadrics[a] += plane;
+					quadrics[b] += plane;
+				}
+			}
+		}
+
+		///
+		/// Directed edges between position ids, sorted. An edge whose reverse is missing is open.
+		///
+		[[nodiscard]] std::vector<std::uint64_t> directed_edges(std::span<const std::uint32_t> indices, std::span<const std::uint32_t> ids)
+		{
+			std::vector<std::uint64_t> edges;
+			edges.reserve(indices.size());
+
+			for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					edges.push_back(edge_key(ids[indices[i + k]], ids[indices[i + (k + 1) % 3]]));
+				}
+			}
+
+			std::sort(edges.begin(), edges.end());
+			return edges;
+		}
+
+		///
+		/// Refines kinds, which start out with seams locked, from the current triangles.
+		///
+		[[nodiscard]] std::vector<VertexKind> classify(std::span<const std::uint32_t> indices, std::span<const std::uint32_t> ids, std::span<const std::uint64_t> edges, std::vector<VertexKind> kinds)
+		{
+			for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					const std::uint32_t a = indices[i + k];
+					const std::uint32_t b = indices[i + (k + 1) % 3];
+
+					const auto [first, last] = std::equal_range(edges.begin(), edges.end(), edge_key(ids[a], ids[b]));
+					const bool open          = !std::binary_search(edges.begin(), edges.end(), edge_key(ids[b], ids[a]));
+
+					// The same directed edge twice means more than two triangles meet there, or one is flipped.
+					const VertexKind kind = (last - first > 1) ? VertexKind::LOCKED : open ? VertexKind::BORDER : VertexKind::MANIFOLD;
+					for (const auto v : {a, b})
+					{
+						kinds[v] = std::max(kinds[v], kind);
+					}
+				}
+			}
+
+			return kinds;
+		}
+
+		///
+		/// True when moving from onto to would turn one of from's remaining triangles over, or near enough on
+		/// its edge that it becomes a sliver.
+		///
+		[[nodiscard]] bool flips(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::span<const std::uint32_t> triangles, std::span<const std::uint32_t> remap, std::uint32_t from, std::uint32_t to)
+		{
+			for (const auto triangle : triangles)
+			{
+				std::array<std::uint32_t, 3> corners {remap[indices[triangle * 3]], remap[indices[triangle * 3 + 1]], remap[indices[triangle * 3 + 2]]};
+				if (corners[0] == to || corners[1] == to || corners[2] == to)
+				{
+					continue;
+				}
+
+				std::array<glm::vec3, 3> positions {vertices[corners[0]].m_position, vertices[corners[1]].m_position, vertices[corners[2]].m_position};
+				const glm::vec3 before = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+
+				for (std::size_t k = 0; k < 3; k++)
+				{
+					if (corners[k] == from)
+					{
+						positions[k] = vertices[to].m_position;
+					}
+				}
+
+				const glm::vec3 after = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+				if (glm::dot(before, after) <= MAX_NORMAL_TURN * glm::length(before) * glm::length(after))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	} // namespace
+
+	SimplifiedMesh simplify(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::size_t target_index_count, float target_error)
+	{
+		SimplifiedMesh result {{indices.begin(), indices.end()}, 0.0f};
+
+		const auto vertex_count = static_cast<std::uint32_t>(vertices.size());
+		const auto ids          = position_ids(vertices);
+
+		// Vertices sharing a position differ in some attribute, and moving one would tear the surface open.
+		std::vector<VertexKind> seams(vertex_count, VertexKind::MANIFOLD);
+		for (std::uint32_t v = 0; v < vertex_count; v++)
+		{
+			if (ids[v] != v)
+			{
+				seams[v]      = VertexKind::LOCKED;
+				seams[ids[v]] = VertexKind::LOCKED;
+			}
+		}
+
+		std::vector<Quadric> quadrics(vertex_count);
+		add_triangle_quadrics(vertices, indices, quadrics);
+		add_border_quadrics(vertices, indices, ids, directed_edges(indices, ids), quadrics);
+
+		const double max_cost = static_cast<double>(target_error) * target_error;
+		double worst          = 0.0;
+
+		std::vector<std::uint32_t> remap(vertex_count);
+		std::vector<bool> locked(vertex_count);
+		std::vector<std::uint32_t> offsets(vertex_count + 1);
+		std::vector<std::uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+
+		while (result.m_indices.size() > target_index_count)
+		{
+			const std::vector<std::uint32_t>& current = result.m_indices;
+			const auto triangle_count                  = static_cast<std::uint32_t>(current.size() / 3);
+
+			const auto edges = directed_edges(current, ids);
+			const auto kinds = classify(current, ids, edges, seams);
+
+			// Triangles around each vertex, as in optimize_vertex_cache().
+			std::fill(offsets.begin(), offsets.end(), 0u);
+			for (const auto index : current)
+			{
+				offsets[index + 1]++;
+			}
+
+			std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+			adjacency.resize(current.size());
+			std::vector<std::uint32_t> filled(offsets.begin(), offsets.end() - 1);
+			for (std::uint32_t i = 0; i < current.size(); i++)
+			{
+				adjacency[filled[current[i]]++] = i / 3;
+			}
+
+			collapses.clear();
+			for (std::uint32_t i = 0; i < current.size(); i++)
+			{
+				const std::uint32_t a = current[i];
+				const std::uint32_t b = current[i - i % 3 + (i + 1) % 3];
+				const bool open       = !std::binary_search(edges.begin(), edges.end(), edge_key(ids[b], ids[a]));
+
+				for (const auto& [from, to] : {std::pair {a, b}, std::pair {b, a}})
+				{
+					const bool allowed = kinds[from] == VertexKind::MANIFOLD || (kinds[from] == VertexKind::BORDER && open && kinds[to] != VertexKind::MANIFOLD);
+					if (!allowed)
+					{
+						continue;
+					}
+
+					Quadric quadric = quadrics[from];
+					quadric += quadrics[to];
+
+					const glm::dvec3 normal_delta {vertices[from].m_normal - vertices[to].m_normal};
+					const glm::dvec3 edge {vertices[from].m_position - vertices[to].m_position};
+					const double cost = quadric.error(vertices[to].m_position) + NORMAL_WEIGHT * glm::dot(normal_delta, normal_delta) * glm::dot(edge, edge);
+
+					if (cost <= max_cost)
+					{
+						collapses.push_back({from, to, cost});
+					}
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.m_cost < b.m_cost; });
+
+			std::iota(remap.begin(), remap.end(), 0u);
+			std::fill(locked.begin(), locked.end(), false);
+
+			std::uint32_t removed   = 0;
+			std::uint32_t collapsed = 0;
+			for (const auto& collapse : collapses)
+			{
+				if ((triangle_count - removed) * 3 <= target_index_count)
+				{
+					break;
+				}
+
+				if (locked[collapse.m_from] || locked[collapse.m_to])
+				{
+					continue;
+				}
+
+				const std::span<const std::uint32_t> triangles {adjacency.data() + offsets[collapse.m_from], offsets[collapse.m_from + 1] - offsets[collapse.m_from]};
+				if (flips(vertices, current, triangles, remap, collapse.m_from, collapse.m_to))
+				{
+					continue;
+				}
+
+				for (const auto triangle : triangles)
+				{
+					const std::uint32_t* corners = &current[triangle * 3];
+					removed += (remap[corners[0]] == collapse.m_to || remap[corners[1]] == collapse.m_to || remap[corners[2]] == collapse.m_to);
+				}
+
+				remap[collapse.m_from] = collapse.m_to;
+				quadrics[collapse.m_to] += quadrics[collapse.m_from];
+				locked[collapse.m_from] = true;
+				locked[collapse.m_to]   = true;
+
+				worst = std::max(worst, collapse.m_cost);
+				collapsed++;
+			}
+
+			if (collapsed == 0)
+			{
+				break;
+			}
+
+			// Neither end of a collapse moves again in the same pass, so remap never chains.
+			std::vector<std::uint32_t> next;
+			next.reserve(current.size() - removed * 3);
+			for (std::size_t i = 0; i < current.size(); i += 3)
+			{
+				const std::uint32_t a = remap[current[i]];
+				const std::uint32_t b = remap[current[i + 1]];
+				const std::uint32_t c = remap[current[i + 2]];
+				if (a != b && b != c && c != a)
+				{
+					next.insert(next.end(), {a, b, c});
+				}
+			}
+
+			result.m_indices = std::move(next);
+		}
+
+		result.m_error = static_cast<float>(std::sqrt(worst));
+		return result;
+	}
+} // namespace vulkano::mesh
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef VULKANO_ASSETS_MESHSIMPLIFIER_HPP_
+#define VULKANO_ASSETS_MESHSIMPLIFIER_HPP_
+
+#include <span>
+#include <vector>
+
+#include "vulkano/graphics/VertexLayout.hpp"
+
+namespace vulkano::mesh
+{
+	struct SimplifiedMesh final
+	{
+		///
+		/// Triangles over the original vertices, which are never moved or added.
+		///
+		std::vector<std::uint32_t> m_indices;
+
+		///
+		/// Largest deviation from the input surface accepted, in mesh units.
+		///
+		float m_error;
+	};
+
+	///
+	/// Edge collapse simplification with quadric error metrics (Garland and Heckbert). Each pass collapses an
+	/// independent set of the cheapest edges, each vertex onto one of its neighbours, until the index count reaches
+	/// target_index_count or the next collapse would exceed target_error.
+	///
+	/// Attributes survive because vertices keep theirs: vertices sharing a position with another (UV, normal or
+	/// colour seams) never move, borders only collapse along themselves, and the cost of merging different normals
+	/// grows with the edge length. Collapses that would flip a triangle are rejected.
+	///
+	[[nodiscard]] SimplifiedMesh simplify(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::size_t target_index_count, float target_error);
+} // namespace vulkano::mesh
+
+#endif
\ No newline at end of file
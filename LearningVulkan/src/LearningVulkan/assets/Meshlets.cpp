@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+#include "vulkano/utils/Log.hpp"
+
+#include "Meshlets.hpp"
+
+namespace vulkano::mesh
+{
+	namespace
+	{
+		constexpr std::uint32_t NONE = UINT32_MAX;
+
+		///
+		/// Ritter's sphere: start from the two points farthest apart along a rough diameter, then grow to fit the rest.
+		/// Within a few percent of optimal, which is plenty for culling.
+		///
+		void bounding_sphere(std::span<const Vertex> vertices, std::span<const std::uint32_t> points, MeshletBounds& bounds)
+		{
+			const auto farthest = [&](const glm::vec3& from) {
+				std::uint32_t best = points[0];
+				float distance     = -1.0f;
+				for (const auto point : points)
+				{
+					const glm::vec3 d = vertices[point].m_position - from;
+					if (glm::dot(d, d) > distance)
+					{
+						best     = point;
+						distance = glm::dot(d, d);
+					}
+				}
+
+				return vertices[best].m_position;
+			};
+
+			const glm::vec3 a = farthest(vertices[points[0]].m_position);
+			const glm::vec3 b = farthest(a);
+
+			glm::vec3 centre = (a + b) * 0.5f;
+			float radius     = glm::length(b - a) * 0.5f;
+
+			for (const auto point : points)
+			{
+				const glm::vec3& p   = vertices[point].m_position;
+				const float distance = glm::length(p - centre);
+				if (distance > radius)
+				{
+					const float grown = (radius + distance) * 0.5f;
+					centre += (p - centre) * ((grown - radius) / distance);
+					radius = grown;
+				}
+			}
+
+			bounds.m_centre = centre;
+			bounds.m_radius = radius;
+		}
+
+		void normal_cone(std::span<const Vertex> vertices, const MeshletData& data, const Meshlet& meshlet, MeshletBounds& bounds)
+		{
+			bounds.m_cone_apex   = bounds.m_centre;
+			bounds.m_cone_axis   = glm::vec3 {0.0f};
+			bounds.m_cone_cutoff = 1.0f;
+
+			std::vector<glm::vec3> corners;
+			std::vector<glm::vec3> normals;
+
+			glm::vec3 axis {0.0f};
+			for (std::uint32_t t = 0; t < meshlet.m_triangle_count; t++)
+			{
+				const std::uint8_t* triangle = &data.m_triangles[(meshlet.m_triangle_offset + t) * 3];
+				const glm::vec3& a           = vertices[data.m_vertices[meshlet.m_vertex_offset + triangle[0]]].m_position;
+				const glm::vec3& b           = vertices[data.m_vertices[meshlet.m_vertex_offset + triangle[1]]].m_position;
+				const glm::vec3& c           = vertices[data.m_vertices[meshlet.m_vertex_offset + triangle[2]]].m_position;
+
+				const glm::vec3 normal = glm::cross(b - a, c - a);
+				const float length     = glm::length(normal);
+				if (length > 0.0f)
+				{
+					corners.push_back(a);
+					normals.push_back(normal / length);
+					axis += normals.back();
+				}
+			}
+
+			const float axis_length = glm::length(axis);
+			if (normals.empty() || axis_length <= 0.0f)
+			{
+				return;
+			}
+
+			axis /= axis_length;
+
+			float min_dot = 1.0f;
+			for (const auto& normal : normals)
+			{
+				min_dot = std::min(min_dot, glm::dot(axis, normal));
+			}
+
+			// Normals spread over a hemisphere or more, no view direction sees only back faces.
+			if (min_dot <= 0.0f)
+			{
+				return;
+			}
+
+			// Move the apex back along the axis until every triangle's plane is in front of it, so the test holds for
+			// cameras close to the meshlet as well as distant ones.
+			float max_t = 0.0f;
+			for (std::size_t i = 0; i < normals.size(); i++)
+			{
+				const float t = glm::dot(bounds.m_centre - corners[i], normals[i]) / glm::dot(axis, normals[i]);
+				max_t         = std::max(max_t, t);
+			}
+
+			bounds.m_cone_apex   = bounds.m_centre - axis * max_t;
+			bounds.m_cone_axis   = axis;
+			bounds.m_cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+		}
+	} // namespace
+
+	MeshletData build_meshlets(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::uint32_t max_vertices, std::uint32_t max_triangles)
+	{
+		if (max_vertices < 3 || max_vertices > 256 || max_triangles == 0)
+		{
+			VK_LOG(VK_THROW, "Invalid meshlet limits: {0} vertices, {1} triangles.", max_vertices, max_triangles);
+		}
+
+		MeshletData data;
+		std::vector<std::uint32_t> local(vertices.size(), NONE);
+
+		Meshlet current {0, 0, 0, 0};
+		const auto finish = [&]() {
+			if (current.m_triangle_count == 0)
+			{
+				return;
+			}
+
+			MeshletBounds bounds;
+			bounding_sphere(vertices, std::span {data.m_vertices}.subspan(current.m_vertex_offset, current.m_vertex_count), bounds);
+
+			data.m_meshlets.push_back(current);
+			normal_cone(vertices, data, current, bounds);
+			data.m_bounds.push_back(bounds);
+
+			for (std::uint32_t i = 0; i < current.m_vertex_count; i++)
+			{
+				local[data.m_vertices[current.m_vertex_offset + i]] = NONE;
+			}
+
+			current = {static_cast<std::uint32_t>(data.m_vertices.size()), current.m_triangle_offset + current.m_triangle_count, 0, 0};
+		};
+
+		for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const std::uint32_t a = indices[i];
+			const std::uint32_t b = indices[i + 1];
+			const std::uint32_t c = indices[i + 2];
+
+			const std::uint32_t added = (local[a] == NONE) + (local[b] == NONE && b != a) + (local[c] == NONE && c != a && c != b);
+			if (current.m_vertex_count + added > max_vertices || current.m_triangle_count == max_triangles)
+			{
+				finish();
+			}
+
+			for (const auto v : {a, b, c})
+			{
+				if (local[v] == NONE)
+				{
+					local[v] = current.m_vertex_count++;
+					data.m_vertices.push_back(v);
+				}
+
+				data.m_triangles.push_back(static_cast<std::uint8_t>(local[v]));
+			}
+
+			current.m_triangle_count++;
+		}
+
+		finish();
+		return data;
+	}
+
+	bool meshlet_visible(const MeshletBounds& bounds, std::span<const glm::vec4, 6> planes, const glm::vec3& camera)
+	{
+		// Planes are not normalised once moved into mesh space, so scale the radius instead of the distance.
+		for (const auto& plane : planes)
+		{
+			if (glm::dot(glm::vec3 {plane}, bounds.m_centre) + plane.w < -bounds.m_radius * glm::length(glm::vec3 {plane}))
+			{
+				return false;
+			}
+		}
+
+		const glm::vec3 view = bounds.m_cone_apex - camera;
+		const float length   = glm::length(view);
+		return length <= 0.0f || glm::dot(view / length, bounds.m_cone_axis) < bounds.m_cone_cutoff;
+	}
+} // namespace vulkano::mesh
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef VULKANO_ASSETS_MESHLETS_HPP_
+#define VULKANO_ASSETS_MESHLETS_HPP_
+
+#include <span>
+#include <vector>
+
+#include "vulkano/graphics/VertexLayout.hpp"
+
+namespace vulkano::mesh
+{
+	///
+	/// Limits that suit both NVIDIA and AMD mesh shader hardware. 124 rather than 128 triangles keeps the index
+	/// block of a meshlet within 372 bytes.
+	///
+	constexpr std::uint32_t MAX_MESHLET_VERTICES  = 64;
+	constexpr std::uint32_t MAX_MESHLET_TRIANGLES = 124;
+
+	///
+	/// A run of triangles sharing at most MAX_MESHLET_VERTICES vertices. Triangles keep the order of the index buffer
+	/// they were built from, so meshlet triangle m_triangle_offset + i is triangle m_triangle_offset + i of the mesh and
+	/// the indexed path can draw a meshlet straight from the original index buffer.
+	///
+	struct Meshlet final
+	{
+		std::uint32_t m_vertex_offset;
+		std::uint32_t m_triangle_offset;
+		std::uint32_t m_vertex_count;
+		std::uint32_t m_triangle_count;
+	};
+
+	///
+	/// Bounding sphere and normal cone. The meshlet faces away from any camera with
+	/// dot(normalize(m_cone_apex - camera), m_cone_axis) >= m_cone_cutoff, so it can be skipped.
+	///
+	struct MeshletBounds final
+	{
+		glm::vec3 m_centre;
+		float m_radius;
+		glm::vec3 m_cone_apex;
+		glm::vec3 m_cone_axis;
+
+		///
+		/// Sine of the cone's half angle. 1 when the triangles spread over more than a hemisphere and the cone
+		/// cannot cull.
+		///
+		float m_cone_cutoff;
+	};
+
+	struct MeshletData final
+	{
+		std::vector<Meshlet> m_meshlets;
+		std::vector<MeshletBounds> m_bounds;
+
+		///
+		/// Mesh vertex index of each meshlet vertex.
+		///
+		std::vector<std::uint32_t> m_vertices;
+
+		///
+		/// Three meshlet-local vertex indices per triangle.
+		///
+		std::vector<std::uint8_t> m_triangles;
+	};
+
+	///
+	/// Splits an index buffer into meshlets in a single scan. Run it after optimize_vertex_cache(), whose locality is
+	/// what keeps meshlets full.
+	///
+	[[nodiscard]] MeshletData build_meshlets(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::uint32_t max_vertices = MAX_MESHLET_VERTICES, std::uint32_t max_triangles = MAX_MESHLET_TRIANGLES);
+
+	///
+	/// CPU version of the test the culling shaders run, with the camera and planes in the mesh's space. Planes point
+	/// inwards: a point is inside when dot(plane.xyz, p) + plane.w >= 0.
+	///
+	[[nodiscard]] bool meshlet_visible(const MeshletBounds& bounds, std::span<const glm::vec4, 6> planes, const glm::vec3& camera);
+} // namespace vulkano::mesh
+
+#endif
\ No newline at end of file
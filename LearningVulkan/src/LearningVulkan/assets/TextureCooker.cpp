@@ -0,0 +1,239 @@
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stb/stb_image.h>
+
+#include "vulkano/graphics/BlockCompression.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "TextureCooker.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr std::array<std::uint8_t, 12> KTX2_IDENTIFIER {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+		///
+		/// Identifier, 9 header fields, then the dfd/kvd/sgd index.
+		///
+		constexpr std::size_t KTX2_LEVEL_INDEX_OFFSET = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+
+		///
+		/// Khronos Data Format colour models, transfer functions and primaries.
+		///
+		constexpr std::uint32_t KHR_DF_MODEL_BC1A      = 128;
+		constexpr std::uint32_t KHR_DF_MODEL_BC3       = 130;
+		constexpr std::uint32_t KHR_DF_MODEL_BC4       = 131;
+		constexpr std::uint32_t KHR_DF_MODEL_BC5       = 132;
+		constexpr std::uint32_t KHR_DF_MODEL_BC7       = 134;
+		constexpr std::uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+		constexpr std::uint32_t KHR_DF_TRANSFER_SRGB   = 2;
+		constexpr std::uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+		constexpr std::uint32_t KHR_DF_BLOCK_SIZE      = 24;
+		constexpr std::uint32_t KHR_DF_SAMPLE_SIZE     = 16;
+
+		///
+		/// One sample of a basic data format descriptor: which bits of the block hold which channel.
+		///
+		struct DfdSample final
+		{
+			std::uint32_t m_bit_offset;
+			std::uint32_t m_bit_length;
+			std::uint32_t m_channel;
+		};
+
+		void append_u32(std::vector<std::byte>& out, std::uint32_t value)
+		{
+			const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+			out.insert(out.end(), bytes, bytes + sizeof(value));
+		}
+
+		void write_u64(std::vector<std::byte>& out, std::size_t offset, std::uint64_t value)
+		{
+			std::memcpy(out.data() + offset, &value, sizeof(value));
+		}
+
+		void write_u32(std::vector<std::byte>& out, std::size_t offset, std::uint32_t value)
+		{
+			std::memcpy(out.data() + offset, &value, sizeof(value));
+		}
+
+		///
+		/// Basic descriptor block for the block compressed formats bc::compress() produces.
+		///
+		[[nodiscard]] std::vector<std::byte> make_dfd(VkFormat format)
+		{
+			std::uint32_t model = 0;
+			std::vector<DfdSample> samples;
+
+			switch (format)
+			{
+				case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+					model   = KHR_DF_MODEL_BC1A;
+					samples = {{0, 64, 0}};
+					break;
+
+				case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+					model   = KHR_DF_MODEL_BC1A;
+					samples = {{0, 64, 1}};
+					break;
+
+				case VK_FORMAT_BC3_UNORM_BLOCK:
+				case VK_FORMAT_BC3_SRGB_BLOCK:
+					model   = KHR_DF_MODEL_BC3;
+					samples = {{0, 64, 15}, {64, 64, 0}};
+					break;
+
+				case VK_FORMAT_BC4_UNORM_BLOCK:
+					model   = KHR_DF_MODEL_BC4;
+					samples = {{0, 64, 0}};
+					break;
+
+				case VK_FORMAT_BC5_UNORM_BLOCK:
+					model   = KHR_DF_MODEL_BC5;
+					samples = {{0, 64, 0}, {64, 64, 1}};
+					break;
+
+				default:
+					model   = KHR_DF_MODEL_BC7;
+					samples = {{0, 128, 0}};
+					break;
+			}
+
+			const bool srgb                = bc::decompressed_format(format) == VK_FORMAT_R8G8B8A8_SRGB;
+			const std::uint32_t block_size = KHR_DF_BLOCK_SIZE + KHR_DF_SAMPLE_SIZE * static_cast<std::uint32_t>(samples.size());
+
+			std::vector<std::byte> dfd;
+			append_u32(dfd, sizeof(std::uint32_t) + block_size);
+			append_u32(dfd, 0);
+			append_u32(dfd, 2 | (block_size << 16));
+			append_u32(dfd, model | (KHR_DF_PRIMARIES_BT709 << 8) | ((srgb ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR) << 16));
+			append_u32(dfd, 3 | (3 << 8));
+			append_u32(dfd, bc::block_size(format));
+			append_u32(dfd, 0);
+
+			for (const auto& sample : samples)
+			{
+				append_u32(dfd, sample.m_bit_offset | ((sample.m_bit_length - 1) << 16) | (sample.m_channel << 24));
+				append_u32(dfd, 0);
+				append_u32(dfd, 0);
+				append_u32(dfd, UINT32_MAX);
+			}
+
+			return dfd;
+		}
+	} // namespace
+
+	TextureCooker::TextureCooker(const TextureCooker::Settings& settings)
+	    : m_settings {settings}
+	{
+		if (!bc::is_block_compressed(m_settings.m_format))
+		{
+			VK_LOG(VK_THROW, "Texture cooker only writes block compressed formats: {0}.", static_cast<int>(m_settings.m_format));
+		}
+	}
+
+	void TextureCooker::cook(std::string_view source, std::string_view destination) const
+	{
+		int width    = 0;
+		int height   = 0;
+		int channels = 0;
+
+		const std::string source_path {source};
+		std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels {stbi_load(source_path.c_str(), &width, &height, &channels, STBI_rgb_alpha), &stbi_image_free};
+		if (!pixels)
+		{
+			VK_LOG(VK_THROW, "Failed to load {0}: {1}.", source, stbi_failure_reason());
+		}
+
+		// sRGB sources are filtered in linear space by MipChain.
+		// clang-format off
+		MipChain::Settings mip_settings
+		{
+			.m_format = bc::decompressed_format(m_settings.m_format),
+			.m_filter = m_settings.m_filter,
+			.m_width = static_cast<std::uint32_t>(width),
+			.m_height = static_cast<std::uint32_t>(height),
+			.m_max_levels = m_settings.m_mipmaps ? 0u : 1u
+		};
+		// clang-format on
+
+		const std::size_t base_size = static_cast<std::size_t>(width) * height * 4;
+		const MipChain mips {{reinterpret_cast<const std::byte*>(pixels.get()), base_size}, mip_settings};
+		pixels.reset();
+
+		std::vector<std::vector<std::byte>> levels(mips.level_count());
+		for (std::uint32_t i = 0; i < mips.level_count(); i++)
+		{
+			const MipLevel& level = mips.level(i);
+
+			levels[i].resize(bc::level_size(m_settings.m_format, level.m_width, level.m_height));
+			bc::compress(m_settings.m_format, mips.level_data(i), level.m_width, level.m_height, levels[i], m_settings.m_quality);
+		}
+
+		const std::vector<std::byte> dfd = make_dfd(m_settings.m_format);
+		const std::size_t dfd_offset     = KTX2_LEVEL_INDEX_OFFSET + levels.size() * 3 * sizeof(std::uint64_t);
+
+		std::vector<std::byte> header(dfd_offset);
+		std::memcpy(header.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size());
+		write_u32(header, 12, static_cast<std::uint32_t>(m_settings.m_format));
+		write_u32(header, 16, 1);
+		write_u32(header, 20, static_cast<std::uint32_t>(width));
+		write_u32(header, 24, static_cast<std::uint32_t>(height));
+		write_u32(header, 28, 0);
+		write_u32(header, 32, 0);
+		write_u32(header, 36, 1);
+		write_u32(header, 40, mips.level_count());
+		write_u32(header, 44, 0);
+		write_u32(header, 48, static_cast<std::uint32_t>(dfd_offset));
+		write_u32(header, 52, static_cast<std::uint32_t>(dfd.size()));
+		header.insert(header.end(), dfd.begin(), dfd.end());
+
+		// Level data is stored smallest first, each level aligned to the block size.
+		const std::size_t alignment = bc::block_size(m_settings.m_format);
+		std::vector<std::size_t> offsets(levels.size());
+
+		std::size_t offset = header.size();
+		for (std::size_t i = levels.size(); i-- > 0;)
+		{
+			offset     = (offset + alignment - 1) / alignment * alignment;
+			offsets[i] = offset;
+			offset += levels[i].size();
+
+			const std::size_t entry = KTX2_LEVEL_INDEX_OFFSET + i * 3 * sizeof(std::uint64_t);
+			write_u64(header, entry, offsets[i]);
+			write_u64(header, entry + sizeof(std::uint64_t), levels[i].size());
+			write_u64(header, entry + 2 * sizeof(std::uint64_t), levels[i].size());
+		}
+
+		std::ofstream file {std::string {destination}, std::ios::binary | std::ios::trunc};
+		if (!file)
+		{
+			VK_LOG(VK_THROW, "Failed to open {0} for writing.", destination);
+		}
+
+		file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+		std::size_t written = header.size();
+		for (std::size_t i = levels.size(); i-- > 0;)
+		{
+			const std::vector<char> padding(offsets[i] - written, 0);
+			file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+			file.write(reinterpret_cast<const char*>(levels[i].data()), static_cast<std::streamsize>(levels[i].size()));
+
+			written = offsets[i] + levels[i].size();
+		}
+
+		if (!file)
+		{
+			VK_LOG(VK_THROW, "Failed to write {0}.", destination);
+		}
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef VULKANO_ASSETS_TEXTURECOOKER_HPP_
+#define VULKANO_ASSETS_TEXTURECOOKER_HPP_
+
+#include <string_view>
+
+#include "vulkano/assets/BlockEncoder.hpp"
+#include "vulkano/graphics/MipChain.hpp"
+
+namespace vulkano
+{
+	///
+	/// Offline conversion of source images (anything stb_image reads) to block compressed KTX2 files that
+	/// TextureFile can load.
+	///
+	class TextureCooker final
+	{
+	public:
+		struct Settings final
+		{
+			VkFormat m_format;
+			bc::EncodeQuality m_quality = bc::EncodeQuality::NORMAL;
+			MipFilter m_filter          = MipFilter::KAISER;
+
+			///
+			/// False writes the base level only.
+			///
+			bool m_mipmaps = true;
+		};
+
+		TextureCooker(const TextureCooker::Settings& settings);
+		~TextureCooker() = default;
+
+		void cook(std::string_view source, std::string_view destination) const;
+
+	private:
+		TextureCooker() = delete;
+
+		TextureCooker::Settings m_settings;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+#include "vulkano/utils/Log.hpp"
+
+#include "EntityWorld.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		std::mutex s_components_mutex;
+		std::array<ComponentInfo, MAX_COMPONENT_TYPES> s_components;
+		std::uint32_t s_component_count = 0;
+
+		[[nodiscard]] std::uint32_t align_up(std::uint32_t value, std::uint32_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		///
+		/// Bytes a chunk of capacity rows needs, with each array aligned for its type.
+		///
+		[[nodiscard]] std::uint32_t chunk_bytes(const std::vector<std::uint32_t>& components, std::uint32_t capacity)
+		{
+			std::uint32_t bytes = capacity * static_cast<std::uint32_t>(sizeof(Entity));
+			for (const auto component : components)
+			{
+				const ComponentInfo& info = component_info(component);
+				bytes = align_up(bytes, info.m_alignment) + capacity * info.m_size;
+			}
+
+			return bytes;
+		}
+	} // namespace
+
+	std::uint32_t register_component(const ComponentInfo& info)
+	{
+		std::lock_guard lock {s_components_mutex};
+		if (s_component_count == MAX_COMPONENT_TYPES)
+		{
+			VK_LOG(VK_THROW, "Only {0} component types are supported.", MAX_COMPONENT_TYPES);
+		}
+
+		if (info.m_alignment > alignof(Archetype::Chunk))
+		{
+			VK_LOG(VK_THROW, "Component alignment of {0} is more than a chunk's.", info.m_alignment);
+		}
+
+		s_components[s_component_count] = info;
+		return s_component_count++;
+	}
+
+	const ComponentInfo& component_info(std::uint32_t component)
+	{
+		return s_components[component];
+	}
+
+	Entity* Archetype::entities(std::uint32_t chunk) const
+	{
+		return reinterpret_cast<Entity*>(m_chunks[chunk]->m_data);
+	}
+
+	std::byte* Archetype::column(std::uint32_t chunk, std::uint32_t component) const
+	{
+		return m_chunks[chunk]->m_data + m_offsets[component];
+	}
+
+	std::byte* Archetype::component(std::uint32_t row, std::uint32_t component) const
+	{
+		return column(row / m_capacity, component) + (row % m_capacity) * component_info(component).m_size;
+	}
+
+	std::uint32_t Archetype::chunk_count(std::uint32_t chunk) const
+	{
+		return std::min(m_capacity, m_count - chunk * m_capacity);
+	}
+
+	EntityWorld::EntityWorld()
+	    : m_size {0}
+	{
+	}
+
+	void EntityWorld::destroy(Entity entity)
+	{
+		if (!alive(entity))
+		{
+			return;
+		}
+
+		Record& record = m_records[entity.m_index];
+		erase_row(*record.m_archetype, record.m_row);
+
+		record.m_archetype = nullptr;
+		record.m_generation++;
+		m_free.push_back(entity.m_index);
+		m_size--;
+	}
+
+	bool EntityWorld::alive(Entity entity) const
+	{
+		return entity.m_index < m_records.size() && m_records[entity.m_index].m_archetype && m_records[entity.m_index].m_generation == entity.m_generation;
+	}
+
+	std::uint32_t EntityWorld::size() const
+	{
+		return m_size;
+	}
+
+	std::size_t EntityWorld::archetype_count() const
+	{
+		return m_archetypes.size();
+	}
+
+	Archetype& EntityWorld::archetype(ComponentMask mask)
+	{
+		if (const auto it = m_archetype_lookup.find(mask); it != m_archetype_lookup.end())
+		{
+			return *it->second;
+		}
+
+		auto archetype    = std::make_unique<Archetype>();
+		archetype->m_mask = mask;
+		for (ComponentMask bits = mask; bits; bits &= bits - 1)
+		{
+			archetype->m_components.push_back(static_cast<std::uint32_t>(std::countr_zero(bits)));
+		}
+
+		// Widest alignment first wastes the least padding between arrays.
+		std::stable_sort(archetype->m_components.begin(), archetype->m_components.end(), [](std::uint32_t a, std::uint32_t b) {
+			return component_info(a).m_alignment > component_info(b).m_alignment;
+		});
+
+		std::uint32_t row_size = sizeof(Entity);
+		for (const auto component : archetype->m_components)
+		{
+			row_size += component_info(component).m_size;
+		}
+
+		archetype->m_capacity = static_cast<std::uint32_t>(Archetype::CHUNK_SIZE) / row_size;
+		while (chunk_bytes(archetype->m_components, archetype->m_capacity) > Archetype::CHUNK_SIZE)
+		{
+			archetype->m_capacity--;
+		}
+
+		if (archetype->m_capacity == 0)
+		{
+			VK_LOG(VK_THROW, "Components of {0} bytes per entity do not fit in a chunk.", row_size);
+		}
+
+		std::uint32_t offset = archetype->m_capacity * static_cast<std::uint32_t>(sizeof(Entity));
+		archetype->m_offsets.fill(0);
+		for (const auto component : archetype->m_components)
+		{
+			const ComponentInfo& info = component_info(component);
+
+			offset                          = align_up(offset, info.m_alignment);
+			archetype->m_offsets[component] = offset;
+			offset                          = offset + archetype->m_capacity * info.m_size;
+		}
+
+		archetype->m_count = 0;
+
+		Archetype& result = *archetype;
+		m_archetype_lookup.emplace(mask, archetype.get());
+		m_archetypes.push_back(std::move(archetype));
+
+		return result;
+	}
+
+	const EntityWorld::Record& EntityWorld::live_record(Entity entity) const
+	{
+		if (!alive(entity))
+		{
+			VK_LOG(VK_THROW, "Entity {0} (generation {1}) is not alive.", entity.m_index, entity.m_generation);
+		}
+
+		return m_records[entity.m_index];
+	}
+
+	Entity EntityWorld::allocate(ComponentMask mask)
+	{
+		Entity entity;
+		if (m_free.empty())
+		{
+			entity = {static_cast<std::uint32_t>(m_records.size()), 0};
+			m_records.push_back({nullptr, 0, 0});
+		}
+		else
+		{
+			entity = {m_free.back(), m_records[m_free.back()].m_generation};
+			m_free.pop_back();
+		}
+
+		Archetype& target = archetype(mask);
+
+		m_records[entity.m_index].m_archetype = &target;
+		m_records[entity.m_index].m_row       = append_row(target, entity);
+		m_size++;
+
+		return entity;
+	}
+
+	void EntityWorld::move(Entity entity, ComponentMask mask)
+	{
+		Record& record     = m_records[entity.m_index];
+		Archetype& source  = *record.m_archetype;
+		Archetype& target  = archetype(mask);
+		const auto old_row = record.m_row;
+
+		const std::uint32_t row = append_row(target, entity);
+
+		for (ComponentMask shared = source.m_mask & mask; shared; shared &= shared - 1)
+		{
+			const auto component = static_cast<std::uint32_t>(std::countr_zero(shared));
+			std::memcpy(target.component(row, component), source.component(old_row, component), component_info(component).m_size);
+		}
+
+		erase_row(source, old_row);
+
+		record.m_archetype = &target;
+		record.m_row       = row;
+	}
+
+	std::uint32_t EntityWorld::append_row(Archetype& archetype, Entity entity)
+	{
+		if (archetype.m_count == archetype.m_chunks.size() * archetype.m_capacity)
+		{
+			archetype.m_chunks.push_back(std::make_unique<Archetype::Chunk>());
+		}
+
+		const std::uint32_t row = archetype.m_count++;
+		archetype.entities(row / archetype.m_capacity)[row % archetype.m_capacity] = entity;
+
+		return row;
+	}
+
+	void EntityWorld::erase_row(Archetype& archetype, std::uint32_t row)
+	{
+		const std::uint32_t last = archetype.m_count - 1;
+		if (row != last)
+		{
+			const Entity moved = archetype.entities(last / archetype.m_capacity)[last % archetype.m_capacity];
+
+			archetype.entities(row / archetype.m_capacity)[row % archetype.m_capacity] = moved;
+			for (const auto component : archetype.m_components)
+			{
+				std::memcpy(archetype.component(row, component), archetype.component(last, component), component_info(component).m_size);
+			}
+
+			m_records[moved.m_index].m_row = row;
+		}
+
+		archetype.m_count--;
+		if (archetype.m_count == (archetype.m_chunks.size() - 1) * archetype.m_capacity)
+		{
+			archetype.m_chunks.pop_back();
+		}
+	}
+
+	std::vector<EntityWorld::ChunkRef> EntityWorld::matching_chunks(ComponentMask mask) const
+	{
+		std::vector<ChunkRef> chunks;
+		for (const auto& archetype : m_archetypes)
+		{
+			if ((archetype->m_mask & mask) != mask)
+			{
+				continue;
+			}
+
+			for (std::uint32_t chunk = 0; chunk < archetype->m_chunks.size(); chunk++)
+			{
+				chunks.push_back({archetype.get(), chunk});
+			}
+		}
+
+		return chunks;
+	}
+} // namespace vulkano
\ No newline at end of file
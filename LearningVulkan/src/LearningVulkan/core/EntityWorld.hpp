@@ -0,0 +1,299 @@
+#ifndef VULKANO_CORE_ENTITYWORLD_HPP_
+#define VULKANO_CORE_ENTITYWORLD_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "vulkano/core/JobSystem.hpp"
+
+namespace vulkano
+{
+	struct Entity final
+	{
+		std::uint32_t m_index;
+
+		///
+		/// Bumped when the index is freed, so handles to a destroyed entity stop matching.
+		///
+		std::uint32_t m_generation;
+
+		[[nodiscard]] bool operator==(const Entity& other) const = default;
+	};
+
+	///
+	/// Bit per component type in an archetype.
+	///
+	using ComponentMask = std::uint64_t;
+
+	struct ComponentInfo final
+	{
+		std::uint32_t m_size;
+		std::uint32_t m_alignment;
+	};
+
+	static constexpr std::uint32_t MAX_COMPONENT_TYPES = 64;
+
+	///
+	/// Assigns the next component id. Called once per type, by component_id().
+	///
+	[[nodiscard]] std::uint32_t register_component(const ComponentInfo& info);
+	[[nodiscard]] const ComponentInfo& component_info(std::uint32_t component);
+
+	template<typename Component>
+	[[nodiscard]] inline std::uint32_t component_id()
+	{
+		// Components are moved between chunks with memcpy.
+		static_assert(std::is_trivially_copyable_v<Component> && std::is_trivially_destructible_v<Component>);
+
+		static const std::uint32_t id = register_component({sizeof(Component), alignof(Component)});
+		return id;
+	}
+
+	template<typename... Components>
+	[[nodiscard]] inline ComponentMask component_mask()
+	{
+		return (ComponentMask {0} | ... | (ComponentMask {1} << component_id<std::remove_const_t<Components>>()));
+	}
+
+	///
+	/// Entities with exactly one set of component types, stored in fixed size chunks. Each chunk holds an array of
+	/// entities and one tightly packed array per component, all capacity long. Rows are kept dense: only the last
+	/// chunk is ever partly filled.
+	///
+	struct Archetype final
+	{
+		static constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+
+		struct alignas(64) Chunk final
+		{
+			std::byte m_data[CHUNK_SIZE];
+		};
+
+		ComponentMask m_mask;
+		std::vector<std::uint32_t> m_components;
+
+		///
+		/// Byte offset of each component's array in a chunk, indexed by component id.
+		///
+		std::array<std::uint32_t, MAX_COMPONENT_TYPES> m_offsets;
+		std::uint32_t m_capacity;
+
+		std::vector<std::unique_ptr<Chunk>> m_chunks;
+		std::uint32_t m_count;
+
+		[[nodiscard]] Entity* entities(std::uint32_t chunk) const;
+		[[nodiscard]] std::byte* column(std::uint32_t chunk, std::uint32_t component) const;
+		[[nodiscard]] std::byte* component(std::uint32_t row, std::uint32_t component) const;
+
+		///
+		/// Entities in chunk.
+		///
+		[[nodiscard]] std::uint32_t chunk_count(std::uint32_t chunk) const;
+	};
+
+	///
+	/// Archetype based entity component system. Entities with the same component types share an archetype, and
+	/// queries walk the chunks of every archetype that has the requested types, handing the body whole component
+	/// arrays. Adding or removing a component moves the entity to another archetype.
+	///
+	/// Components must be trivially copyable. Entities may not be created, destroyed or change components while a
+	/// query runs.
+	///
+	class EntityWorld final
+	{
+	public:
+		///
+		/// Chunks each job of a parallel query takes.
+		///
+		static constexpr std::uint32_t CHUNKS_PER_JOB = 4;
+
+		EntityWorld();
+		~EntityWorld() = default;
+
+		template<typename... Components>
+		Entity create(const Components&... components);
+
+		void destroy(Entity entity);
+		[[nodiscard]] bool alive(Entity entity) const;
+
+		///
+		/// Overwrites the component if the entity already has one. Throws if the entity is not alive.
+		///
+		template<typename Component>
+		void add(Entity entity, const Component& component);
+
+		///
+		/// Throws if the entity is not alive.
+		///
+		template<typename Component>
+		void remove(Entity entity);
+
+		///
+		/// Null when the entity is not alive or does not have the component. Valid until the entity's components change.
+		///
+		template<typename Component>
+		[[nodiscard]] Component* get(Entity entity);
+
+		///
+		/// Calls body(std::span<const Entity>, std::span<Components>...) for every chunk of every archetype with all
+		/// of Components, in order. Const components document read only access.
+		///
+		template<typename... Components, typename Body>
+		void each(Body&& body);
+
+		///
+		/// As each(), with chunks split across the job system. body must be safe to call concurrently.
+		///
+		template<typename... Components, typename Body>
+		void each(JobSystem& jobs, Body&& body);
+
+		[[nodiscard]] std::uint32_t size() const;
+		[[nodiscard]] std::size_t archetype_count() const;
+
+	private:
+		EntityWorld(const EntityWorld&) = delete;
+		EntityWorld& operator=(const EntityWorld&) = delete;
+
+		struct Record final
+		{
+			Archetype* m_archetype;
+			std::uint32_t m_row;
+			std::uint32_t m_generation;
+		};
+
+		struct ChunkRef final
+		{
+			Archetype* m_archetype;
+			std::uint32_t m_chunk;
+		};
+
+		[[nodiscard]] Archetype& archetype(ComponentMask mask);
+
+		///
+		/// Throws if the entity is not alive.
+		///
+		[[nodiscard]] const Record& live_record(Entity entity) const;
+
+		///
+		/// Allocates an entity in the archetype for mask, with its components left uninitialised.
+		///
+		[[nodiscard]] Entity allocate(ComponentMask mask);
+
+		///
+		/// Moves the entity to the archetype for mask, keeping the components both have.
+		///
+		void move(Entity entity, ComponentMask mask);
+
+		///
+		/// Returns the entity's row, with its components left uninitialised.
+		///
+		[[nodiscard]] std::uint32_t append_row(Archetype& archetype, Entity entity);
+
+		///
+		/// Fills the row with the archetype's last entity, keeping rows dense, and frees a chunk left empty.
+		///
+		void erase_row(Archetype& archetype, std::uint32_t row);
+
+		[[nodiscard]] std::vector<ChunkRef> matching_chunks(ComponentMask mask) const;
+
+		template<typename... Components, typename Body>
+		static void visit(const ChunkRef& chunk, Body& body);
+
+		std::vector<std::unique_ptr<Archetype>> m_archetypes;
+		std::unordered_map<ComponentMask, Archetype*> m_archetype_lookup;
+
+		std::vector<Record> m_records;
+		std::vector<std::uint32_t> m_free;
+		std::uint32_t m_size;
+	};
+
+	template<typename... Components>
+	inline Entity EntityWorld::create(const Components&... components)
+	{
+		const Entity entity  = allocate(component_mask<Components...>());
+		const Record& record = m_records[entity.m_index];
+
+		(std::memcpy(record.m_archetype->component(record.m_row, component_id<Components>()), &components, sizeof(Components)), ...);
+		return entity;
+	}
+
+	template<typename Component>
+	inline void EntityWorld::add(Entity entity, const Component& component)
+	{
+		const Record& record     = live_record(entity);
+		const ComponentMask mask = record.m_archetype->m_mask | component_mask<Component>();
+		if (mask != record.m_archetype->m_mask)
+		{
+			move(entity, mask);
+		}
+
+		std::memcpy(record.m_archetype->component(record.m_row, component_id<Component>()), &component, sizeof(Component));
+	}
+
+	template<typename Component>
+	inline void EntityWorld::remove(Entity entity)
+	{
+		const Record& record     = live_record(entity);
+		const ComponentMask mask = record.m_archetype->m_mask & ~component_mask<Component>();
+		if (mask != record.m_archetype->m_mask)
+		{
+			move(entity, mask);
+		}
+	}
+
+	template<typename Component>
+	inline Component* EntityWorld::get(Entity entity)
+	{
+		if (!alive(entity))
+		{
+			return nullptr;
+		}
+
+		const Record& record = m_records[entity.m_index];
+		if (!(record.m_archetype->m_mask & component_mask<Component>()))
+		{
+			return nullptr;
+		}
+
+		return reinterpret_cast<Component*>(record.m_archetype->component(record.m_row, component_id<Component>()));
+	}
+
+	template<typename... Components, typename Body>
+	inline void EntityWorld::visit(const ChunkRef& chunk, Body& body)
+	{
+		const Archetype& archetype = *chunk.m_archetype;
+		const std::uint32_t count  = archetype.chunk_count(chunk.m_chunk);
+
+		body(std::span<const Entity> {archetype.entities(chunk.m_chunk), count}, std::span<Components> {reinterpret_cast<Components*>(archetype.column(chunk.m_chunk, component_id<std::remove_const_t<Components>>())), count}...);
+	}
+
+	template<typename... Components, typename Body>
+	inline void EntityWorld::each(Body&& body)
+	{
+		for (const ChunkRef& chunk : matching_chunks(component_mask<Components...>()))
+		{
+			visit<Components...>(chunk, body);
+		}
+	}
+
+	template<typename... Components, typename Body>
+	inline void EntityWorld::each(JobSystem& jobs, Body&& body)
+	{
+		const std::vector<ChunkRef> chunks = matching_chunks(component_mask<Components...>());
+
+		jobs.parallel_for(static_cast<std::uint32_t>(chunks.size()), CHUNKS_PER_JOB, [&chunks, &body](std::uint32_t begin, std::uint32_t end) {
+			for (std::uint32_t i = begin; i < end; i++)
+			{
+				visit<Components...>(chunks[i], body);
+			}
+		});
+	}
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,326 @@
+#include <array>
+#include <random>
+#include <utility>
+
+#include "vulkano/utils/Log.hpp"
+
+#include "JobSystem.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		thread_local std::uint32_t s_thread_index = UINT32_MAX;
+
+		///
+		/// Spins (yielding) this many times on an empty system before sleeping.
+		///
+		constexpr std::uint32_t IDLE_SPINS = 64;
+	} // namespace
+
+	///
+	/// Fixed capacity Chase-Lev deque, with the memory orderings from Le et al. "Correct and Efficient Work-Stealing
+	/// for Weak Memory Models". push and pop are owner only, steal may be called from any thread.
+	///
+	class WorkQueue final
+	{
+	public:
+		static constexpr std::int64_t CAPACITY = 4096;
+
+		WorkQueue()
+		    : m_top {0}, m_bottom {0}
+		{
+		}
+
+		///
+		/// False when full, in which case the owner should just run the job itself.
+		///
+		[[nodiscard]] bool push(void* job)
+		{
+			const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+			const std::int64_t top    = m_top.load(std::memory_order_acquire);
+			if (bottom - top >= CAPACITY)
+			{
+				return false;
+			}
+
+			// Releasing bottom publishes the job (and everything it captured) to thieves that acquire it.
+			m_jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		[[nodiscard]] void* pop()
+		{
+			const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			void* job = m_jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// Last job, race any thief for it.
+				if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					job = nullptr;
+				}
+
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return job;
+		}
+
+		[[nodiscard]] void* steal()
+		{
+			std::int64_t top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			void* job = m_jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return nullptr;
+			}
+
+			return job;
+		}
+
+	private:
+		// Thieves hammer top and the owner bottom, keep them on separate cache lines.
+		alignas(64) std::atomic<std::int64_t> m_top;
+		alignas(64) std::atomic<std::int64_t> m_bottom;
+		alignas(64) std::array<std::atomic<void*>, CAPACITY> m_jobs;
+	};
+
+	JobCounter::JobCounter()
+	    : m_pending {0}, m_failed {false}, m_exception {nullptr}
+	{
+	}
+
+	bool JobCounter::done() const
+	{
+		return m_pending.load(std::memory_order_acquire) == 0;
+	}
+
+	JobSystem::JobSystem(std::uint32_t threads)
+	    : m_queued {0}, m_running {true}
+	{
+		if (threads == 0)
+		{
+			threads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		for (std::uint32_t i = 0; i < threads; i++)
+		{
+			m_queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		s_thread_index = 0;
+		for (std::uint32_t i = 1; i < threads; i++)
+		{
+			m_threads.emplace_back(&JobSystem::worker, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		m_running.store(false, std::memory_order_release);
+
+		// Wake sleepers, they check m_running once m_queued changes.
+		m_queued.fetch_add(1, std::memory_order_release);
+		m_queued.notify_all();
+
+		for (auto& thread : m_threads)
+		{
+			thread.join();
+		}
+
+		s_thread_index = UINT32_MAX;
+	}
+
+	void JobSystem::run(std::function<void()> work, JobCounter* counter)
+	{
+		if (s_thread_index >= m_queues.size())
+		{
+			VK_LOG(VK_THROW, "Jobs can only be submitted from the thread that created the job system or from a job.");
+		}
+
+		if (counter)
+		{
+			counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		auto job = new Job {std::move(work), counter};
+		if (!m_queues[s_thread_index]->push(job))
+		{
+			// Queue full: running inline still makes progress and keeps the counter correct.
+			execute(job);
+			return;
+		}
+
+		m_queued.fetch_add(1, std::memory_order_release);
+		m_queued.notify_one();
+	}
+
+	void JobSystem::wait(JobCounter& counter)
+	{
+		if (s_thread_index >= m_queues.size())
+		{
+			VK_LOG(VK_THROW, "Jobs can only be waited on from the thread that created the job system or from a job.");
+		}
+
+		while (!counter.done())
+		{
+			if (!execute_one())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		if (counter.m_failed.load(std::memory_order_relaxed))
+		{
+			const std::exception_ptr exception = std::exchange(counter.m_exception, nullptr);
+			counter.m_failed.store(false, std::memory_order_relaxed);
+			std::rethrow_exception(exception);
+		}
+	}
+
+	std::uint32_t JobSystem::thread_count() const
+	{
+		return static_cast<std::uint32_t>(m_queues.size());
+	}
+
+	std::uint32_t JobSystem::thread_index()
+	{
+		return s_thread_index;
+	}
+
+	void JobSystem::worker(std::uint32_t index)
+	{
+		s_thread_index = index;
+
+		std::uint32_t idle = 0;
+		while (m_running.load(std::memory_order_acquire))
+		{
+			if (execute_one())
+			{
+				idle = 0;
+				continue;
+			}
+
+			if (++idle < IDLE_SPINS)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Sleeps only while nothing is queued. A push between the check and the wait changes the value,
+			// so the wakeup cannot be missed.
+			const std::uint32_t queued = m_queued.load(std::memory_order_acquire);
+			if (queued == 0)
+			{
+				m_queued.wait(0, std::memory_order_acquire);
+			}
+
+			idle = 0;
+		}
+	}
+
+	bool JobSystem::execute_one()
+	{
+		Job* job = find_job();
+		if (!job)
+		{
+			return false;
+		}
+
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+		execute(job);
+
+		return true;
+	}
+
+	void JobSystem::execute(Job* job)
+	{
+		JobCounter* counter = job->m_counter;
+
+		try
+		{
+			job->m_work();
+		}
+		catch (const std::exception& exception)
+		{
+			if (!counter)
+			{
+				VK_LOG(VK_NO_THROW, "Job without a counter threw: {0}", exception.what());
+			}
+			else if (!counter->m_failed.exchange(true, std::memory_order_relaxed))
+			{
+				counter->m_exception = std::current_exception();
+			}
+		}
+		catch (...)
+		{
+			if (!counter)
+			{
+				VK_LOG(VK_NO_THROW, "Job without a counter threw an unknown exception.");
+			}
+			else if (!counter->m_failed.exchange(true, std::memory_order_relaxed))
+			{
+				counter->m_exception = std::current_exception();
+			}
+		}
+
+		delete job;
+
+		// Releases the stored exception along with the job's other writes, to the waiter's acquire in done().
+		if (counter)
+		{
+			counter->m_pending.fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+	JobSystem::Job* JobSystem::find_job()
+	{
+		const auto self = s_thread_index;
+		if (void* job = m_queues[self]->pop())
+		{
+			return static_cast<Job*>(job);
+		}
+
+		// Start at a random victim so thieves spread out instead of all hitting the same queue.
+		thread_local std::minstd_rand random {std::random_device {}()};
+
+		const auto count = static_cast<std::uint32_t>(m_queues.size());
+		const auto start = static_cast<std::uint32_t>(random() % count);
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			const std::uint32_t victim = (start + i) % count;
+			if (victim == self)
+			{
+				continue;
+			}
+
+			if (void* job = m_queues[victim]->steal())
+			{
+				return static_cast<Job*>(job);
+			}
+		}
+
+		return nullptr;
+	}
+} // namespace vulkano
\ No newline at end of file
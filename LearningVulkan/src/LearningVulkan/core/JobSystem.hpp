@@ -0,0 +1,148 @@
+#ifndef VULKANO_CORE_JOBSYSTEM_HPP_
+#define VULKANO_CORE_JOBSYSTEM_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace vulkano
+{
+	class WorkQueue;
+
+	///
+	/// Counts unfinished jobs. Pass one to JobSystem::run and wait on it to join a group of jobs.
+	/// Also holds the first exception any of them threw, until wait() rethrows it.
+	///
+	class JobCounter final
+	{
+	public:
+		JobCounter();
+		~JobCounter() = default;
+
+		[[nodiscard]] bool done() const;
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<std::uint32_t> m_pending;
+
+		///
+		/// Set by the first job to throw, which stores m_exception before its decrement publishes it.
+		///
+		std::atomic<bool> m_failed;
+		std::exception_ptr m_exception;
+	};
+
+	///
+	/// Work-stealing job system. Each thread owns a Chase-Lev deque: it pushes and pops its own jobs at one end
+	/// (LIFO, so work stays in cache), while idle threads steal from the other end of a random victim.
+	///
+	/// The constructing thread is thread 0 and takes part in the work while it waits. Jobs may only be submitted
+	/// and waited on from that thread or from inside other jobs.
+	///
+	/// A job that throws still counts as finished, and wait() on its counter rethrows once every job has run.
+	/// Exceptions from jobs without a counter have nowhere to go, so they are logged and dropped.
+	///
+	/// Systems take the job system as an optional pointer; given null they do all their work on the calling thread.
+	///
+	class JobSystem final
+	{
+	public:
+		///
+		/// Zero uses one thread per hardware thread, including the calling one.
+		///
+		JobSystem(std::uint32_t threads = 0);
+		~JobSystem();
+
+		///
+		/// Queues work. The counter, if given, is incremented now and decremented once the work has run.
+		///
+		void run(std::function<void()> work, JobCounter* counter = nullptr);
+
+		///
+		/// Runs other jobs until counter reaches zero, so waiting never blocks a thread the jobs could use.
+		/// Rethrows the first exception a job counted by it threw, and resets the counter for reuse.
+		///
+		void wait(JobCounter& counter);
+
+		///
+		/// Calls body(begin, end) over [0, count) in chunks of at most grain items, and returns once all have run.
+		/// Rethrows the first exception a chunk threw.
+		///
+		template<typename Body>
+		void parallel_for(std::uint32_t count, std::uint32_t grain, Body&& body);
+
+		[[nodiscard]] std::uint32_t thread_count() const;
+
+		///
+		/// Index of the calling thread in [0, thread_count()), for indexing per thread data (command pools etc.).
+		///
+		[[nodiscard]] static std::uint32_t thread_index();
+
+	private:
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		struct Job final
+		{
+			std::function<void()> m_work;
+			JobCounter* m_counter;
+		};
+
+		void worker(std::uint32_t index);
+
+		///
+		/// Runs and deletes the job, then counts it as finished whether or not it threw.
+		///
+		void execute(Job* job);
+		[[nodiscard]] bool execute_one();
+		[[nodiscard]] Job* find_job();
+
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::vector<std::thread> m_threads;
+
+		///
+		/// Jobs queued but not yet taken. Idle workers sleep on it.
+		///
+		std::atomic<std::uint32_t> m_queued;
+		std::atomic<bool> m_running;
+	};
+
+	template<typename Body>
+	inline void JobSystem::parallel_for(std::uint32_t count, std::uint32_t grain, Body&& body)
+	{
+		grain = std::max(grain, 1u);
+		if (count <= grain)
+		{
+			body(0u, count);
+			return;
+		}
+
+		// Keep the first chunk for this thread rather than queueing it and immediately popping it back.
+		JobCounter counter;
+		for (std::uint32_t begin = grain; begin < count; begin += grain)
+		{
+			const std::uint32_t end = std::min(count, begin + grain);
+			run([&body, begin, end]() { body(begin, end); }, &counter);
+		}
+
+		try
+		{
+			body(0u, grain);
+		}
+		catch (...)
+		{
+			// The queued chunks still reference body and counter, so they must finish before either goes away.
+			wait(counter);
+			throw;
+		}
+
+		wait(counter);
+	}
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
+#include <algorithm>
+#include <array>
 #include <filesystem>
 #include <fstream>
-#include <span>
 
 #include "vulkano/utils/Log.hpp"
 
@@ -9,63 +10,64 @@
 namespace vulkano
 {
 	Shader::Shader(VkDevice logical, std::string_view vertex, std::string_view fragment)
-	    : m_logical(logical)
+	    : Shader(logical, std::array {ShaderStage {VK_SHADER_STAGE_VERTEX_BIT, vertex}, ShaderStage {VK_SHADER_STAGE_FRAGMENT_BIT, fragment}})
 	{
-		const auto vert_shader = read(vertex);
-		const auto frag_shader = read(fragment);
-
-		VkShaderModule vert_shader_module = create_module(vert_shader);
-		VkShaderModule frag_shader_module = create_module(frag_shader);
+	}
 
-		// clang-format off
-		VkPipelineShaderStageCreateInfo vert_create_info
+	Shader::Shader(VkDevice logical, std::span<const ShaderStage> stages)
+	    : m_logical(logical)
+	{
+		for (const auto& stage : stages)
 		{
-			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-			.pNext = nullptr,
-			.flags = VK_NULL_HANDLE,
-			.stage = VK_SHADER_STAGE_VERTEX_BIT,
-			.module = vert_shader_module,
-			.pName = "main",
-			.pSpecializationInfo = nullptr
-
-		};
+			const auto code = read(stage.m_path);
+			if (stage.m_stage == VK_SHADER_STAGE_VERTEX_BIT)
+			{
+				m_vertex_reflection = ShaderReflection {code};
+			}
+
+			m_modules.push_back(create_module(code));
+
+			// clang-format off
+			m_stages.push_back(VkPipelineShaderStageCreateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = VK_NULL_HANDLE,
+				.stage = stage.m_stage,
+				.module = m_modules.back(),
+				.pName = "main",
+				.pSpecializationInfo = nullptr
+			});
+			// clang-format on
+		}
+	}
 
-		VkPipelineShaderStageCreateInfo frag_create_info
+	Shader::~Shader()
+	{
+		for (const auto module : m_modules)
 		{
-			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-			.pNext = nullptr,
-			.flags = VK_NULL_HANDLE,
-			.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-			.module = frag_shader_module,
-			.pName = "main",
-			.pSpecializationInfo = nullptr
-		};
-		// clang-format on
-
-		VkPipelineShaderStageCreateInfo stages[] = {vert_create_info, frag_create_info};
+			vkDestroyShaderModule(m_logical, module, nullptr);
+		}
+	}
 
-		vkDestroyShaderModule(m_logical, vert_shader_module, nullptr);
-		vkDestroyShaderModule(m_logical, frag_shader_module, nullptr);
+	std::span<const VkPipelineShaderStageCreateInfo> Shader::stages() const
+	{
+		return m_stages;
+	}
 
-		// clang-format off
-		VkPipelineVertexInputStateCreateInfo vertex_input_info 
-		{
-			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-			.pNext = nullptr,
-			.flags = VK_NULL_HANDLE,
-			.vertexBindingDescriptionCount = 0,
-			.pVertexBindingDescriptions = nullptr,
-			.vertexAttributeDescriptionCount = 0,
-			.pVertexAttributeDescriptions = nullptr
-		};
-		// clang-format on
+	bool Shader::has_stage(VkShaderStageFlagBits stage) const
+	{
+		return std::any_of(m_stages.begin(), m_stages.end(), [&](const VkPipelineShaderStageCreateInfo& info) {
+			return info.stage == stage;
+		});
 	}
 
-	Shader::~Shader()
+	const ShaderReflection& Shader::vertex_reflection() const
 	{
+		return m_vertex_reflection;
 	}
 
-	std::span<char> Shader::read(std::string_view path)
+	std::vector<std::uint32_t> Shader::read(std::string_view path)
 	{
 		auto file = std::filesystem::path {path};
 		std::ifstream ifs;
@@ -76,17 +78,22 @@ namespace vulkano
 			VK_LOG(VK_THROW, "Failed to open shader: {0}.", path);
 		}
 		const std::size_t size = static_cast<std::size_t>(ifs.tellg());
+		if (size % sizeof(std::uint32_t) != 0)
+		{
+			VK_LOG(VK_THROW, "Shader is not a whole number of SPIR-V words: {0}.", path);
+		}
 
-		std::vector<char> buffer;
-		buffer.resize(size);
+		// Read straight into words, so the code is aligned for pCode.
+		std::vector<std::uint32_t> buffer;
+		buffer.resize(size / sizeof(std::uint32_t));
 		ifs.seekg(0);
-		ifs.read(buffer.data(), size);
+		ifs.read(reinterpret_cast<char*>(buffer.data()), size);
 		ifs.close();
 
 		return buffer;
 	}
 
-	VkShaderModule Shader::create_module(std::span<char> code)
+	VkShaderModule Shader::create_module(std::span<const std::uint32_t> code)
 	{
 		// clang-format off
 		VkShaderModuleCreateInfo create_info
@@ -94,8 +101,8 @@ namespace vulkano
 			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
 			.pNext = nullptr,
 			.flags = VK_NULL_HANDLE,
-			.codeSize = code.size(),
-			.pCode = reinterpret_cast<const std::uint32_t*>(code.data())
+			.codeSize = code.size_bytes(),
+			.pCode = code.data()
 		};
 		// clang-format on
 
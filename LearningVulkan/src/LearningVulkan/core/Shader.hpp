@@ -3,23 +3,58 @@
 
 #include <vulkan/vulkan.h>
 
+#include <span>
 #include <string_view>
+#include <vector>
+
+#include "vulkano/core/ShaderReflection.hpp"
 
 namespace vulkano
 {
+	///
+	/// One SPIR-V file and the stage it runs in.
+	///
+	struct ShaderStage final
+	{
+		VkShaderStageFlagBits m_stage;
+		std::string_view m_path;
+	};
+
 	class Shader
 	{
 	public:
 		Shader(VkDevice logical, std::string_view vertex, std::string_view fragment);
+
+		///
+		/// Any set of stages: a single compute stage, vertex and fragment, or task, mesh and fragment.
+		///
+		Shader(VkDevice logical, std::span<const ShaderStage> stages);
 		~Shader();
 
 		//void define_specialization();
 
+		///
+		/// Stages in the order given, ready for VkGraphicsPipelineCreateInfo or VkComputePipelineCreateInfo.
+		///
+		[[nodiscard]] std::span<const VkPipelineShaderStageCreateInfo> stages() const;
+		[[nodiscard]] bool has_stage(VkShaderStageFlagBits stage) const;
+
+		///
+		/// Inputs the vertex stage reads, so a VertexLayout binds only those. Empty without a vertex stage.
+		///
+		[[nodiscard]] const ShaderReflection& vertex_reflection() const;
+
 	private:
-		std::span<char> read(std::string_view path);
-		VkShaderModule create_module(std::span<char> code);
+		Shader(const Shader&) = delete;
+		Shader& operator=(const Shader&) = delete;
+
+		std::vector<std::uint32_t> read(std::string_view path);
+		VkShaderModule create_module(std::span<const std::uint32_t> code);
 
 		VkDevice m_logical;
+		std::vector<VkShaderModule> m_modules;
+		std::vector<VkPipelineShaderStageCreateInfo> m_stages;
+		ShaderReflection m_vertex_reflection;
 	};
 } // namespace vulkano
 
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "vulkano/utils/Log.hpp"
+
+#include "ShaderReflection.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr std::uint32_t SPIRV_MAGIC = 0x07230203;
+		constexpr std::size_t HEADER_WORDS  = 5;
+
+		// Opcodes, decorations and storage classes from the SPIR-V specification.
+		constexpr std::uint32_t OP_NAME         = 5;
+		constexpr std::uint32_t OP_TYPE_INT     = 21;
+		constexpr std::uint32_t OP_TYPE_FLOAT   = 22;
+		constexpr std::uint32_t OP_TYPE_VECTOR  = 23;
+		constexpr std::uint32_t OP_TYPE_POINTER = 32;
+		constexpr std::uint32_t OP_VARIABLE     = 59;
+		constexpr std::uint32_t OP_DECORATE     = 71;
+
+		constexpr std::uint32_t DECORATION_BUILT_IN = 11;
+		constexpr std::uint32_t DECORATION_LOCATION = 30;
+
+		constexpr std::uint32_t STORAGE_INPUT = 1;
+
+		///
+		/// Literal string operand, nul terminated and packed four characters per word.
+		///
+		[[nodiscard]] std::string read_string(std::span<const std::uint32_t> words)
+		{
+			std::string result;
+			for (const auto word : words)
+			{
+				for (std::uint32_t byte = 0; byte < 4; byte++)
+				{
+					const char c = static_cast<char>((word >> (byte * 8)) & 0xFF);
+					if (c == '\0')
+					{
+						return result;
+					}
+
+					result.push_back(c);
+				}
+			}
+
+			return result;
+		}
+	} // namespace
+
+	ShaderReflection::ShaderReflection(std::span<const std::uint32_t> spirv)
+	{
+		if (spirv.size() < HEADER_WORDS || spirv[0] != SPIRV_MAGIC)
+		{
+			VK_LOG(VK_THROW, "Shader is not SPIR-V ({0} words).", spirv.size());
+		}
+
+		std::unordered_map<std::uint32_t, std::string> names;
+		std::unordered_map<std::uint32_t, std::uint32_t> locations;
+		std::unordered_set<std::uint32_t> built_ins;
+
+		// Type id to component count, and pointer type id to pointee.
+		std::unordered_map<std::uint32_t, std::uint32_t> components;
+		std::unordered_map<std::uint32_t, std::uint32_t> pointees;
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> variables;
+
+		for (std::size_t i = HEADER_WORDS; i < spirv.size();)
+		{
+			const std::uint32_t opcode = spirv[i] & 0xFFFF;
+			const std::uint32_t count  = spirv[i] >> 16;
+			if (count == 0 || i + count > spirv.size())
+			{
+				VK_LOG(VK_THROW, "Malformed SPIR-V instruction at word {0}.", i);
+			}
+
+			const auto operands = spirv.subspan(i + 1, count - 1);
+			switch (opcode)
+			{
+				case OP_NAME:
+					names[operands[0]] = read_string(operands.subspan(1));
+					break;
+
+				case OP_DECORATE:
+					if (operands[1] == DECORATION_LOCATION && operands.size() > 2)
+					{
+						locations[operands[0]] = operands[2];
+					}
+					else if (operands[1] == DECORATION_BUILT_IN)
+					{
+						built_ins.insert(operands[0]);
+					}
+					break;
+
+				case OP_TYPE_INT:
+				case OP_TYPE_FLOAT:
+					components[operands[0]] = 1;
+					break;
+
+				case OP_TYPE_VECTOR:
+					components[operands[0]] = operands[2];
+					break;
+
+				case OP_TYPE_POINTER:
+					pointees[operands[0]] = operands[2];
+					break;
+
+				case OP_VARIABLE:
+					if (operands[2] == STORAGE_INPUT)
+					{
+						variables.emplace_back(operands[1], operands[0]);
+					}
+					break;
+
+				default:
+					break;
+			}
+
+			i += count;
+		}
+
+		for (const auto& [id, pointer_type] : variables)
+		{
+			const auto location = locations.find(id);
+			if (built_ins.contains(id) || location == locations.end())
+			{
+				continue;
+			}
+
+			// Matrices and arrays span several locations and are not vertex attributes here, count them as one.
+			const auto pointee = pointees.find(pointer_type);
+			const auto count   = (pointee != pointees.end()) ? components.find(pointee->second) : components.end();
+
+			m_inputs.push_back({location->second, (count != components.end()) ? count->second : 1, names[id]});
+		}
+
+		std::sort(m_inputs.begin(), m_inputs.end(), [](const ShaderInput& lhs, const ShaderInput& rhs) {
+			return lhs.m_location < rhs.m_location;
+		});
+	}
+
+	std::span<const ShaderInput> ShaderReflection::inputs() const
+	{
+		return m_inputs;
+	}
+
+	bool ShaderReflection::reads(std::uint32_t location) const
+	{
+		return std::any_of(m_inputs.begin(), m_inputs.end(), [&](const ShaderInput& input) {
+			return input.m_location == location;
+		});
+	}
+} // namespace vulkano
\ No newline at end of file
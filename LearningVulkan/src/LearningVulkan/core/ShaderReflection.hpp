@@ -0,0 +1,43 @@
+#ifndef VULKANO_CORE_SHADERREFLECTION_HPP_
+#define VULKANO_CORE_SHADERREFLECTION_HPP_
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vulkano
+{
+	///
+	/// User defined stage input, i.e. a vertex attribute.
+	///
+	struct ShaderInput final
+	{
+		std::uint32_t m_location;
+		std::uint32_t m_components;
+		std::string m_name;
+	};
+
+	///
+	/// Minimal SPIR-V parser: walks the module once and keeps the decorated Input variables. Built-ins such as
+	/// gl_VertexIndex are skipped.
+	///
+	class ShaderReflection final
+	{
+	public:
+		ShaderReflection() = default;
+		ShaderReflection(std::span<const std::uint32_t> spirv);
+		~ShaderReflection() = default;
+
+		///
+		/// Sorted by location.
+		///
+		[[nodiscard]] std::span<const ShaderInput> inputs() const;
+		[[nodiscard]] bool reads(std::uint32_t location) const;
+
+	private:
+		std::vector<ShaderInput> m_inputs;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
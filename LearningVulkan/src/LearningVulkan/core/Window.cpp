@@ -33,7 +33,7 @@ namespace vulkano
 		};
 		// clang-format on
 
-		m_instance = std::make_shared<Instance>(instance_settings);
+		m_instance = std::make_unique<Instance>(instance_settings);
 
 		int w = 0, h = 0;
 		glfwGetFramebufferSize(m_window, &w, &h);
@@ -37,7 +37,7 @@ namespace vulkano
 	private:
 		GLFWwindow* m_window;
 
-		std::shared_ptr<Instance> m_instance;
+		std::unique_ptr<Instance> m_instance;
 		std::shared_ptr<SwapChain> m_swapchain;
 	};
 } // namespace vulkano
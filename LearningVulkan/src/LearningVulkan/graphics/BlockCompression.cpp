@@ -0,0 +1,603 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#include "vulkano/utils/Log.hpp"
+
+#include "BlockCompression.hpp"
+
+namespace vulkano::bc
+{
+	namespace
+	{
+		///
+		/// Block rows are handed to worker threads in groups this size.
+		///
+		constexpr std::uint32_t BLOCK_ROWS_PER_TASK = 8;
+
+		///
+		/// One decoded 4x4 block, 16 RGBA8 texels in row order.
+		///
+		using Texels = std::array<std::uint8_t, 64>;
+
+		///
+		/// BC7 mode descriptions, see the "BC7 Format" section of the Khronos Data Format Specification.
+		///
+		struct Bc7Mode final
+		{
+			std::uint8_t m_subsets;
+			std::uint8_t m_partition_bits;
+			std::uint8_t m_rotation_bits;
+			std::uint8_t m_index_selection_bits;
+			std::uint8_t m_colour_bits;
+			std::uint8_t m_alpha_bits;
+			std::uint8_t m_endpoint_pbits;
+			std::uint8_t m_shared_pbits;
+			std::uint8_t m_index_bits;
+			std::uint8_t m_index_bits2;
+		};
+
+		// clang-format off
+		constexpr std::array<Bc7Mode, 8> BC7_MODES
+		{{
+			{3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+			{2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+			{3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+			{2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+			{1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+			{1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+			{1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+			{2, 6, 0, 0, 5, 5, 1, 0, 2, 0}
+		}};
+
+		///
+		/// Two subset partitions, bit N set means texel N belongs to subset 1.
+		///
+		constexpr std::array<std::uint16_t, 64> BC7_PARTITIONS_2
+		{
+			0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+			0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+			0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+			0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+			0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+			0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+			0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+			0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+		};
+
+		///
+		/// Three subset partitions, two bits per texel with texel 0 in the low bits.
+		///
+		constexpr std::array<std::uint32_t, 64> BC7_PARTITIONS_3
+		{
+			0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+			0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+			0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+			0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+			0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+			0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+			0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+			0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254
+		};
+
+		///
+		/// Anchor texels, whose index drops its most significant bit. Subset 0 is always anchored at texel 0.
+		///
+		constexpr std::array<std::uint8_t, 64> BC7_ANCHORS_2
+		{
+			15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+			15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+			15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+			 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+		};
+
+		constexpr std::array<std::uint8_t, 64> BC7_ANCHORS_3A
+		{
+			 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+			 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+			 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+			 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3
+		};
+
+		constexpr std::array<std::uint8_t, 64> BC7_ANCHORS_3B
+		{
+			15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+			15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+			15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+			15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8
+		};
+
+		constexpr std::array<std::uint8_t, 4> BC7_WEIGHTS_2 {0, 21, 43, 64};
+		constexpr std::array<std::uint8_t, 8> BC7_WEIGHTS_3 {0, 9, 18, 27, 37, 46, 55, 64};
+		constexpr std::array<std::uint8_t, 16> BC7_WEIGHTS_4 {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+		// clang-format on
+
+		///
+		/// Little endian reader over a single 128 bit block.
+		///
+		class BitReader final
+		{
+		public:
+			BitReader(const std::uint8_t* block)
+			    : m_low {0}, m_high {0}, m_pos {0}
+			{
+				std::memcpy(&m_low, block, sizeof(m_low));
+				std::memcpy(&m_high, block + sizeof(m_low), sizeof(m_high));
+			}
+
+			[[nodiscard]] std::uint32_t read(std::uint32_t count)
+			{
+				std::uint64_t bits = 0;
+				if (m_pos >= 64)
+				{
+					bits = m_high >> (m_pos - 64);
+				}
+				else if (m_pos == 0)
+				{
+					bits = m_low;
+				}
+				else
+				{
+					bits = (m_low >> m_pos) | (m_high << (64 - m_pos));
+				}
+
+				m_pos += count;
+				return static_cast<std::uint32_t>(bits & ((std::uint64_t {1} << count) - 1));
+			}
+
+		private:
+			std::uint64_t m_low;
+			std::uint64_t m_high;
+			std::uint32_t m_pos;
+		};
+
+		[[nodiscard]] std::uint16_t load_u16(const std::uint8_t* data)
+		{
+			return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
+		}
+
+		[[nodiscard]] std::array<std::uint8_t, 4> expand_565(std::uint16_t colour)
+		{
+			const std::uint32_t r = (colour >> 11) & 0x1F;
+			const std::uint32_t g = (colour >> 5) & 0x3F;
+			const std::uint32_t b = colour & 0x1F;
+
+			return {static_cast<std::uint8_t>((r << 3) | (r >> 2)), static_cast<std::uint8_t>((g << 2) | (g >> 4)), static_cast<std::uint8_t>((b << 3) | (b >> 2)), 255};
+		}
+
+		///
+		/// BC1 colour block. BC2/BC3 always use the four colour palette, BC1 picks it by endpoint order.
+		///
+		void decode_colour(const std::uint8_t* block, Texels& out, bool four_colour_only, bool punch_through)
+		{
+			const std::uint16_t c0 = load_u16(block);
+			const std::uint16_t c1 = load_u16(block + 2);
+
+			std::array<std::array<std::uint8_t, 4>, 4> palette {expand_565(c0), expand_565(c1)};
+			for (std::size_t c = 0; c < 3; c++)
+			{
+				const std::uint32_t a = palette[0][c];
+				const std::uint32_t b = palette[1][c];
+
+				if (four_colour_only || c0 > c1)
+				{
+					palette[2][c] = static_cast<std::uint8_t>((2 * a + b + 1) / 3);
+					palette[3][c] = static_cast<std::uint8_t>((a + 2 * b + 1) / 3);
+				}
+				else
+				{
+					palette[2][c] = static_cast<std::uint8_t>((a + b + 1) / 2);
+					palette[3][c] = 0;
+				}
+			}
+
+			palette[2][3] = 255;
+			palette[3][3] = (!four_colour_only && c0 <= c1 && punch_through) ? 0 : 255;
+
+			std::uint32_t indices = 0;
+			std::memcpy(&indices, block + 4, sizeof(indices));
+
+			for (std::size_t i = 0; i < 16; i++)
+			{
+				const auto& colour = palette[(indices >> (2 * i)) & 3];
+				std::copy(colour.begin(), colour.end(), out.begin() + i * 4);
+			}
+		}
+
+		///
+		/// BC4 style single channel block, written to one channel of the texels.
+		///
+		void decode_channel(const std::uint8_t* block, Texels& out, std::size_t channel)
+		{
+			const std::uint32_t a0 = block[0];
+			const std::uint32_t a1 = block[1];
+
+			std::array<std::uint8_t, 8> palette {static_cast<std::uint8_t>(a0), static_cast<std::uint8_t>(a1)};
+			if (a0 > a1)
+			{
+				for (std::uint32_t i = 1; i < 7; i++)
+				{
+					palette[i + 1] = static_cast<std::uint8_t>(((7 - i) * a0 + i * a1 + 3) / 7);
+				}
+			}
+			else
+			{
+				for (std::uint32_t i = 1; i < 5; i++)
+				{
+					palette[i + 1] = static_cast<std::uint8_t>(((5 - i) * a0 + i * a1 + 2) / 5);
+				}
+
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+
+			std::uint64_t indices = 0;
+			std::memcpy(&indices, block + 2, 6);
+
+			for (std::size_t i = 0; i < 16; i++)
+			{
+				out[i * 4 + channel] = palette[(indices >> (3 * i)) & 7];
+			}
+		}
+
+		[[nodiscard]] std::uint8_t bc7_interpolate(std::uint32_t e0, std::uint32_t e1, std::uint32_t index, std::uint32_t bits)
+		{
+			std::uint32_t weight = 0;
+			switch (bits)
+			{
+				case 2:
+					weight = BC7_WEIGHTS_2[index];
+					break;
+
+				case 3:
+					weight = BC7_WEIGHTS_3[index];
+					break;
+
+				default:
+					weight = BC7_WEIGHTS_4[index];
+					break;
+			}
+
+			return static_cast<std::uint8_t>(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+		}
+
+		void decode_bc7(const std::uint8_t* block, Texels& out)
+		{
+			if (block[0] == 0)
+			{
+				// Reserved mode, defined to decode as transparent black.
+				out.fill(0);
+				return;
+			}
+
+			std::uint32_t mode_index = 0;
+			while (!(block[0] & (1 << mode_index)))
+			{
+				mode_index++;
+			}
+
+			const Bc7Mode& mode = BC7_MODES[mode_index];
+			BitReader reader {block};
+			static_cast<void>(reader.read(mode_index + 1));
+
+			const std::uint32_t partition = reader.read(mode.m_partition_bits);
+			const std::uint32_t rotation  = reader.read(mode.m_rotation_bits);
+			const std::uint32_t selection = reader.read(mode.m_index_selection_bits);
+
+			// Endpoints are stored channel major: all red values for every subset, then green, and so on.
+			const std::uint32_t endpoint_count = mode.m_subsets * 2u;
+			std::array<std::array<std::uint32_t, 4>, 6> endpoints {};
+			for (std::size_t c = 0; c < 3; c++)
+			{
+				for (std::uint32_t e = 0; e < endpoint_count; e++)
+				{
+					endpoints[e][c] = reader.read(mode.m_colour_bits);
+				}
+			}
+
+			if (mode.m_alpha_bits)
+			{
+				for (std::uint32_t e = 0; e < endpoint_count; e++)
+				{
+					endpoints[e][3] = reader.read(mode.m_alpha_bits);
+				}
+			}
+
+			std::uint32_t colour_bits = mode.m_colour_bits;
+			std::uint32_t alpha_bits  = mode.m_alpha_bits;
+			if (mode.m_endpoint_pbits || mode.m_shared_pbits)
+			{
+				std::array<std::uint32_t, 6> pbits {};
+				if (mode.m_endpoint_pbits)
+				{
+					for (std::uint32_t e = 0; e < endpoint_count; e++)
+					{
+						pbits[e] = reader.read(1);
+					}
+				}
+				else
+				{
+					for (std::uint32_t s = 0; s < mode.m_subsets; s++)
+					{
+						pbits[s * 2] = pbits[s * 2 + 1] = reader.read(1);
+					}
+				}
+
+				for (std::uint32_t e = 0; e < endpoint_count; e++)
+				{
+					for (std::size_t c = 0; c < 4; c++)
+					{
+						endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+					}
+				}
+
+				colour_bits++;
+				if (alpha_bits)
+				{
+					alpha_bits++;
+				}
+			}
+
+			for (std::uint32_t e = 0; e < endpoint_count; e++)
+			{
+				for (std::size_t c = 0; c < 3; c++)
+				{
+					endpoints[e][c] <<= (8 - colour_bits);
+					endpoints[e][c] |= endpoints[e][c] >> colour_bits;
+				}
+
+				if (alpha_bits)
+				{
+					endpoints[e][3] <<= (8 - alpha_bits);
+					endpoints[e][3] |= endpoints[e][3] >> alpha_bits;
+				}
+				else
+				{
+					endpoints[e][3] = 255;
+				}
+			}
+
+			std::array<std::uint32_t, 16> subsets {};
+			for (std::uint32_t i = 0; i < 16; i++)
+			{
+				if (mode.m_subsets == 2)
+				{
+					subsets[i] = (BC7_PARTITIONS_2[partition] >> i) & 1;
+				}
+				else if (mode.m_subsets == 3)
+				{
+					subsets[i] = (BC7_PARTITIONS_3[partition] >> (2 * i)) & 3;
+				}
+			}
+
+			const auto is_anchor = [&](std::uint32_t texel) {
+				switch (mode.m_subsets)
+				{
+					case 2:
+						return texel == 0 || texel == BC7_ANCHORS_2[partition];
+
+					case 3:
+						return texel == 0 || texel == BC7_ANCHORS_3A[partition] || texel == BC7_ANCHORS_3B[partition];
+
+					default:
+						return texel == 0;
+				}
+			};
+
+			std::array<std::uint32_t, 16> primary {};
+			for (std::uint32_t i = 0; i < 16; i++)
+			{
+				primary[i] = reader.read(mode.m_index_bits - (is_anchor(i) ? 1 : 0));
+			}
+
+			std::array<std::uint32_t, 16> secondary {};
+			if (mode.m_index_bits2)
+			{
+				for (std::uint32_t i = 0; i < 16; i++)
+				{
+					secondary[i] = reader.read(mode.m_index_bits2 - (i == 0 ? 1 : 0));
+				}
+			}
+
+			for (std::uint32_t i = 0; i < 16; i++)
+			{
+				const auto& e0 = endpoints[subsets[i] * 2];
+				const auto& e1 = endpoints[subsets[i] * 2 + 1];
+
+				std::uint32_t colour_index = primary[i];
+				std::uint32_t colour_width = mode.m_index_bits;
+				std::uint32_t alpha_index  = primary[i];
+				std::uint32_t alpha_width  = mode.m_index_bits;
+
+				if (mode.m_index_bits2)
+				{
+					if (selection)
+					{
+						colour_index = secondary[i];
+						colour_width = mode.m_index_bits2;
+					}
+					else
+					{
+						alpha_index = secondary[i];
+						alpha_width = mode.m_index_bits2;
+					}
+				}
+
+				std::uint8_t* texel = out.data() + i * 4;
+				for (std::size_t c = 0; c < 3; c++)
+				{
+					texel[c] = bc7_interpolate(e0[c], e1[c], colour_index, colour_width);
+				}
+
+				texel[3] = bc7_interpolate(e0[3], e1[3], alpha_index, alpha_width);
+
+				if (rotation)
+				{
+					std::swap(texel[3], texel[rotation - 1]);
+				}
+			}
+		}
+
+		void decode_block(VkFormat format, const std::uint8_t* block, Texels& out)
+		{
+			switch (format)
+			{
+				case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+					decode_colour(block, out, false, false);
+					break;
+
+				case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+					decode_colour(block, out, false, true);
+					break;
+
+				case VK_FORMAT_BC3_UNORM_BLOCK:
+				case VK_FORMAT_BC3_SRGB_BLOCK:
+					decode_colour(block + 8, out, true, false);
+					decode_channel(block, out, 3);
+					break;
+
+				case VK_FORMAT_BC4_UNORM_BLOCK:
+					out.fill(0);
+					decode_channel(block, out, 0);
+					for (std::size_t i = 0; i < 16; i++)
+					{
+						out[i * 4 + 3] = 255;
+					}
+					break;
+
+				case VK_FORMAT_BC5_UNORM_BLOCK:
+					out.fill(0);
+					decode_channel(block, out, 0);
+					decode_channel(block + 8, out, 1);
+					for (std::size_t i = 0; i < 16; i++)
+					{
+						out[i * 4 + 3] = 255;
+					}
+					break;
+
+				default:
+					decode_bc7(block, out);
+					break;
+			}
+		}
+	} // namespace
+
+	bool is_block_compressed(VkFormat format)
+	{
+		switch (format)
+		{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+			case VK_FORMAT_BC4_UNORM_BLOCK:
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK:
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	std::uint32_t block_size(VkFormat format)
+	{
+		switch (format)
+		{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+			case VK_FORMAT_BC4_UNORM_BLOCK:
+				return 8;
+
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK:
+				return 16;
+
+			default:
+				VK_LOG(VK_THROW, "Not a supported block compressed format: {0}.", static_cast<int>(format));
+				return 0;
+		}
+	}
+
+	std::size_t level_size(VkFormat format, std::uint32_t width, std::uint32_t height)
+	{
+		const std::size_t blocks_x = (std::max(width, 1u) + 3) / 4;
+		const std::size_t blocks_y = (std::max(height, 1u) + 3) / 4;
+
+		return blocks_x * blocks_y * block_size(format);
+	}
+
+	VkFormat decompressed_format(VkFormat format)
+	{
+		switch (format)
+		{
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK:
+				return VK_FORMAT_R8G8B8A8_SRGB;
+
+			default:
+				return VK_FORMAT_R8G8B8A8_UNORM;
+		}
+	}
+
+	void decompress(VkFormat format, std::span<const std::byte> blocks, std::uint32_t width, std::uint32_t height, std::span<std::byte> rgba)
+	{
+		if (!is_block_compressed(format))
+		{
+			VK_LOG(VK_THROW, "Not a supported block compressed format: {0}.", static_cast<int>(format));
+		}
+
+		if (blocks.size() < level_size(format, width, height) || rgba.size() < static_cast<std::size_t>(width) * height * 4)
+		{
+			VK_LOG(VK_THROW, "Buffer too small to decompress {0}x{1} level.", width, height);
+		}
+
+		const std::uint32_t blocks_x   = (width + 3) / 4;
+		const std::uint32_t blocks_y   = (height + 3) / 4;
+		const std::uint32_t block_step = block_size(format);
+
+		const auto* src = reinterpret_cast<const std::uint8_t*>(blocks.data());
+		auto* dst       = reinterpret_cast<std::uint8_t*>(rgba.data());
+
+		std::vector<std::uint32_t> tasks((blocks_y + BLOCK_ROWS_PER_TASK - 1) / BLOCK_ROWS_PER_TASK);
+		std::iota(tasks.begin(), tasks.end(), 0);
+
+		std::for_each(std::execution::par, tasks.begin(), tasks.end(), [&](std::uint32_t task) {
+			const std::uint32_t begin = task * BLOCK_ROWS_PER_TASK;
+			const std::uint32_t end   = std::min(blocks_y, begin + BLOCK_ROWS_PER_TASK);
+
+			Texels texels;
+			for (std::uint32_t by = begin; by < end; by++)
+			{
+				for (std::uint32_t bx = 0; bx < blocks_x; bx++)
+				{
+					decode_block(format, src + (static_cast<std::size_t>(by) * blocks_x + bx) * block_step, texels);
+
+					// Edge blocks are clipped to the level size.
+					const std::uint32_t rows = std::min(4u, height - by * 4);
+					const std::uint32_t cols = std::min(4u, width - bx * 4);
+					for (std::uint32_t row = 0; row < rows; row++)
+					{
+						std::uint8_t* out = dst + ((static_cast<std::size_t>(by) * 4 + row) * width + bx * 4) * 4;
+						std::memcpy(out, texels.data() + row * 16, cols * 4);
+					}
+				}
+			}
+		});
+	}
+} // namespace vulkano::bc
\ No newline at end of file
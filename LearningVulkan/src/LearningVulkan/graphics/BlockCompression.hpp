@@ -0,0 +1,40 @@
+#ifndef VULKANO_GRAPHICS_BLOCKCOMPRESSION_HPP_
+#define VULKANO_GRAPHICS_BLOCKCOMPRESSION_HPP_
+
+#include <cstddef>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+///
+/// Helpers for the BCn block compressed formats, including a CPU decoder for devices that cannot sample them.
+///
+namespace vulkano::bc
+{
+	///
+	/// True for the BC1, BC3, BC4, BC5 and BC7 formats this module understands.
+	///
+	[[nodiscard]] bool is_block_compressed(VkFormat format);
+
+	///
+	/// Size in bytes of one 4x4 block.
+	///
+	[[nodiscard]] std::uint32_t block_size(VkFormat format);
+
+	///
+	/// Size in bytes of a whole level, rounding partial blocks up.
+	///
+	[[nodiscard]] std::size_t level_size(VkFormat format, std::uint32_t width, std::uint32_t height);
+
+	///
+	/// RGBA8 format produced by decompress(). sRGB formats stay sRGB.
+	///
+	[[nodiscard]] VkFormat decompressed_format(VkFormat format);
+
+	///
+	/// Decodes one level to tightly packed RGBA8. BC4 and BC5 fill the unused channels with 0 and alpha with 255.
+	///
+	void decompress(VkFormat format, std::span<const std::byte> blocks, std::uint32_t width, std::uint32_t height, std::span<std::byte> rgba);
+} // namespace vulkano::bc
+
+#endif
\ No newline at end of file
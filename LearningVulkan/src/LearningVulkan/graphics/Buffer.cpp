@@ -0,0 +1,127 @@
+#include <cstring>
+#include <utility>
+
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "Buffer.hpp"
+
+namespace vulkano
+{
+	Buffer::Buffer(Instance* instance, const BufferInfo& info)
+	    : m_instance {instance}, m_info {info}, m_buffer {nullptr}, m_allocation {}, m_state {}
+	{
+		// clang-format off
+		VkBufferCreateInfo buffer_info
+		{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.size = info.m_size,
+			.usage = info.m_usage,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+			.queueFamilyIndexCount = 0,
+			.pQueueFamilyIndices = nullptr
+		};
+		// clang-format on
+
+		if (vkCreateBuffer(m_instance->logical_device(), &buffer_info, nullptr, &m_buffer) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create buffer of {0} bytes.", info.m_size);
+		}
+
+		VkMemoryRequirements requirements;
+		vkGetBufferMemoryRequirements(m_instance->logical_device(), m_buffer, &requirements);
+
+		m_allocation = m_instance->allocator().allocate(requirements, info.m_memory);
+		if (vkBindBufferMemory(m_instance->logical_device(), m_buffer, m_allocation.m_memory, m_allocation.m_offset) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to bind buffer memory.");
+		}
+	}
+
+	Buffer::Buffer(Buffer&& buffer) noexcept
+	    : m_instance {buffer.m_instance}, m_info {buffer.m_info}, m_buffer {std::exchange(buffer.m_buffer, nullptr)}, m_allocation {std::exchange(buffer.m_allocation, {})}, m_state {buffer.m_state}
+	{
+	}
+
+	Buffer& Buffer::operator=(Buffer&& buffer) noexcept
+	{
+		if (this != &buffer)
+		{
+			release();
+
+			m_instance   = buffer.m_instance;
+			m_info       = buffer.m_info;
+			m_buffer     = std::exchange(buffer.m_buffer, nullptr);
+			m_allocation = std::exchange(buffer.m_allocation, {});
+			m_state      = buffer.m_state;
+		}
+
+		return *this;
+	}
+
+	Buffer::~Buffer()
+	{
+		release();
+	}
+
+	void Buffer::write(VkDeviceSize offset, std::span<const std::byte> data)
+	{
+		std::memcpy(m_allocation.m_mapped + offset, data.data(), data.size());
+		flush(offset, data.size());
+	}
+
+	void Buffer::flush(VkDeviceSize offset, VkDeviceSize size) const
+	{
+		m_instance->allocator().flush(m_allocation, offset, size);
+	}
+
+	void Buffer::invalidate(VkDeviceSize offset, VkDeviceSize size) const
+	{
+		m_instance->allocator().invalidate(m_allocation, offset, size);
+	}
+
+	VkBuffer Buffer::vk_handle() const
+	{
+		return m_buffer;
+	}
+
+	const BufferInfo& Buffer::info() const
+	{
+		return m_info;
+	}
+
+	VkDeviceSize Buffer::size() const
+	{
+		return m_info.m_size;
+	}
+
+	std::byte* Buffer::mapped() const
+	{
+		return m_allocation.m_mapped;
+	}
+
+	ResourceState& Buffer::state()
+	{
+		return m_state;
+	}
+
+	void Buffer::release()
+	{
+		if (!m_buffer)
+		{
+			return;
+		}
+
+		// The memory range goes back to the allocator at the same point the buffer is destroyed.
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		deletion.release(m_buffer);
+		deletion.release([allocator = &m_instance->allocator(), allocation = m_allocation]() {
+			allocator->free(allocation);
+		});
+
+		m_buffer     = nullptr;
+		m_allocation = {};
+	}
+} // namespace vulkano
\ No newline at end of file
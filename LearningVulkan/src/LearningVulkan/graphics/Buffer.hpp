@@ -0,0 +1,79 @@
+#ifndef VULKANO_GRAPHICS_BUFFER_HPP_
+#define VULKANO_GRAPHICS_BUFFER_HPP_
+
+#include <span>
+
+#include "vulkano/graphics/MemoryAllocator.hpp"
+#include "vulkano/pipeline/Barriers.hpp"
+
+namespace vulkano
+{
+	class Instance;
+
+	struct BufferInfo final
+	{
+		VkDeviceSize m_size;
+		VkBufferUsageFlags m_usage;
+		MemoryUsage m_memory = MemoryUsage::GPU_ONLY;
+	};
+
+	///
+	/// Vertex, index, uniform, storage, indirect or staging buffer placed in a sub-allocation of the instance's
+	/// MemoryAllocator. Host visible buffers stay mapped for their whole life.
+	///
+	class Buffer final
+	{
+	public:
+		Buffer(Instance* instance, const BufferInfo& info);
+
+		///
+		/// Moving leaves the source empty, so buffers can live by value in a ResourcePool.
+		///
+		Buffer(Buffer&& buffer) noexcept;
+		Buffer& operator=(Buffer&& buffer) noexcept;
+		~Buffer();
+
+		///
+		/// Copies into mapped memory and flushes if the memory is not coherent. Only valid when mapped() is not null.
+		///
+		void write(VkDeviceSize offset, std::span<const std::byte> data);
+
+		///
+		/// For writes made through mapped() directly.
+		///
+		void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+		///
+		/// Call before reading GPU written data through mapped().
+		///
+		void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+		[[nodiscard]] VkBuffer vk_handle() const;
+		[[nodiscard]] const BufferInfo& info() const;
+		[[nodiscard]] VkDeviceSize size() const;
+
+		///
+		/// Null unless the memory is host visible.
+		///
+		[[nodiscard]] std::byte* mapped() const;
+
+		///
+		/// Tracked state, for BarrierBatch::buffer() and RenderGraph::import_buffer().
+		///
+		[[nodiscard]] ResourceState& state();
+
+	private:
+		Buffer(const Buffer&) = delete;
+		Buffer& operator=(const Buffer&) = delete;
+
+		void release();
+
+		Instance* m_instance;
+		BufferInfo m_info;
+		VkBuffer m_buffer;
+		Allocation m_allocation;
+		ResourceState m_state;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
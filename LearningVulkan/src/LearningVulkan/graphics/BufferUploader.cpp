@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+#include "vulkano/graphics/BlockCompression.hpp"
+#include "vulkano/graphics/Image.hpp"
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "BufferUploader.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Keeps copy sources aligned for the fastest DMA path.
+		///
+		constexpr VkDeviceSize COPY_ALIGNMENT = 16;
+
+		///
+		/// Size in bytes of one texel, or of one block for block compressed formats.
+		///
+		[[nodiscard]] VkDeviceSize texel_size(VkFormat format)
+		{
+			if (bc::is_block_compressed(format))
+			{
+				return bc::block_size(format);
+			}
+
+			switch (format)
+			{
+				case VK_FORMAT_R8_UNORM:
+				case VK_FORMAT_R8_SNORM:
+				case VK_FORMAT_R8_UINT:
+				case VK_FORMAT_R8_SRGB:
+					return 1;
+
+				case VK_FORMAT_R8G8_UNORM:
+				case VK_FORMAT_R8G8_SNORM:
+				case VK_FORMAT_R8G8_UINT:
+				case VK_FORMAT_R16_UNORM:
+				case VK_FORMAT_R16_SFLOAT:
+				case VK_FORMAT_R16_UINT:
+				case VK_FORMAT_D16_UNORM:
+					return 2;
+
+				case VK_FORMAT_R8G8B8A8_UNORM:
+				case VK_FORMAT_R8G8B8A8_SNORM:
+				case VK_FORMAT_R8G8B8A8_UINT:
+				case VK_FORMAT_R8G8B8A8_SRGB:
+				case VK_FORMAT_B8G8R8A8_UNORM:
+				case VK_FORMAT_B8G8R8A8_SRGB:
+				case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+				case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+				case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+				case VK_FORMAT_R16G16_UNORM:
+				case VK_FORMAT_R16G16_SNORM:
+				case VK_FORMAT_R16G16_SFLOAT:
+				case VK_FORMAT_R32_SFLOAT:
+				case VK_FORMAT_R32_UINT:
+				case VK_FORMAT_D32_SFLOAT:
+					return 4;
+
+				case VK_FORMAT_R16G16B16A16_UNORM:
+				case VK_FORMAT_R16G16B16A16_SFLOAT:
+				case VK_FORMAT_R32G32_SFLOAT:
+				case VK_FORMAT_R32G32_UINT:
+					return 8;
+
+				case VK_FORMAT_R32G32B32_SFLOAT:
+				case VK_FORMAT_R32G32B32_UINT:
+					return 12;
+
+				case VK_FORMAT_R32G32B32A32_SFLOAT:
+				case VK_FORMAT_R32G32B32A32_UINT:
+					return 16;
+
+				default:
+					VK_LOG(VK_THROW, "Unknown texel size for image format {0}.", static_cast<int>(format));
+					return 0;
+			}
+		}
+	} // namespace
+
+	BufferUploader::BufferUploader(Instance* instance, VkDeviceSize staging_size)
+	    : m_instance {instance}, m_staging_size {staging_size}, m_staging_used {0}
+	{
+	}
+
+	bool BufferUploader::upload(Buffer& destination, VkDeviceSize offset, std::span<const std::byte> data)
+	{
+		// Once recorded GPU work has touched the buffer nothing says it has finished, and an earlier staged copy
+		// would land on top of a direct write. Either way the copy's barrier orders the new data correctly.
+		const bool gpu_used = destination.state().m_stages & ~VK_PIPELINE_STAGE_2_HOST_BIT;
+		const bool copying  = std::any_of(m_copies.begin(), m_copies.end(), [&destination](const Copy& copy) {
+			return copy.m_destination == &destination;
+		});
+
+		if (destination.mapped() && !gpu_used && !copying)
+		{
+			destination.write(offset, data);
+			return true;
+		}
+
+		if (!(destination.info().m_usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+		{
+			VK_LOG(VK_THROW, "Buffer of {0} bytes may still be read by the GPU and has no TRANSFER_DST usage to stage into.", destination.size());
+		}
+
+		const VkDeviceSize begin = allocate(data.size(), COPY_ALIGNMENT);
+
+		Buffer& staging = *m_staging.back();
+		staging.write(begin, data);
+
+		m_copies.push_back({&destination, staging.vk_handle(), {begin, offset, data.size()}});
+		return false;
+	}
+
+	std::span<std::byte> BufferUploader::upload(Image& destination, std::uint32_t mip, VkDeviceSize size)
+	{
+		const ImageInfo& info = destination.info();
+		if (!(info.m_usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+		{
+			VK_LOG(VK_THROW, "Image has no TRANSFER_DST usage to upload mip {0} into.", mip);
+		}
+
+		// Image copy offsets must be a multiple of both 4 and the texel size, which a 12 byte texel's is not of 16.
+		const VkDeviceSize begin = allocate(size, std::lcm(COPY_ALIGNMENT, texel_size(info.m_format)));
+		const Buffer& staging    = *m_staging.back();
+
+		// clang-format off
+		m_image_copies.push_back({&destination, staging.vk_handle(), VkBufferImageCopy
+		{
+			.bufferOffset = begin,
+			.bufferRowLength = 0,
+			.bufferImageHeight = 0,
+			.imageSubresource = {info.m_aspect, mip, 0, info.m_array_layers},
+			.imageOffset = {0, 0, 0},
+			.imageExtent = {std::max(info.m_extent.width >> mip, 1u), std::max(info.m_extent.height >> mip, 1u), 1}
+		}});
+		// clang-format on
+
+		return {staging.mapped() + begin, static_cast<std::size_t>(size)};
+	}
+
+	void BufferUploader::record(VkCommandBuffer cmd)
+	{
+		if (m_copies.empty() && m_image_copies.empty())
+		{
+			return;
+		}
+
+		// Group by destination, then source, so each pair becomes one copy command.
+		std::sort(m_copies.begin(), m_copies.end(), [](const Copy& lhs, const Copy& rhs) {
+			return std::tie(lhs.m_destination, lhs.m_source) < std::tie(rhs.m_destination, rhs.m_source);
+		});
+		std::sort(m_image_copies.begin(), m_image_copies.end(), [](const ImageCopy& lhs, const ImageCopy& rhs) {
+			return std::tie(lhs.m_destination, lhs.m_source) < std::tie(rhs.m_destination, rhs.m_source);
+		});
+
+		// Image levels are written through the staging buffers' mapping directly, which may not be coherent.
+		if (!m_image_copies.empty())
+		{
+			for (const auto& staging : m_staging)
+			{
+				staging->flush();
+			}
+		}
+
+		BarrierBatch barriers;
+		for (std::size_t i = 0; i < m_copies.size(); i++)
+		{
+			if (i == 0 || m_copies[i].m_destination != m_copies[i - 1].m_destination)
+			{
+				barriers.buffer(m_copies[i].m_destination->state(), ResourceUsage::TRANSFER_DST);
+			}
+		}
+
+		for (const ImageCopy& copy : m_image_copies)
+		{
+			barriers.image(*copy.m_destination, ResourceUsage::TRANSFER_DST, copy.m_region.imageSubresource.mipLevel, 1, true);
+		}
+
+		barriers.flush(cmd);
+
+		std::vector<VkBufferCopy> regions;
+		for (std::size_t begin = 0; begin < m_copies.size();)
+		{
+			const Copy& first = m_copies[begin];
+
+			regions.clear();
+			std::size_t end = begin;
+			while (end < m_copies.size() && m_copies[end].m_destination == first.m_destination && m_copies[end].m_source == first.m_source)
+			{
+				regions.push_back(m_copies[end].m_region);
+				end++;
+			}
+
+			vkCmdCopyBuffer(cmd, first.m_source, first.m_destination->vk_handle(), static_cast<std::uint32_t>(regions.size()), regions.data());
+			begin = end;
+		}
+
+		std::vector<VkBufferImageCopy> image_regions;
+		for (std::size_t begin = 0; begin < m_image_copies.size();)
+		{
+			const ImageCopy& first = m_image_copies[begin];
+
+			image_regions.clear();
+			std::size_t end = begin;
+			while (end < m_image_copies.size() && m_image_copies[end].m_destination == first.m_destination && m_image_copies[end].m_source == first.m_source)
+			{
+				image_regions.push_back(m_image_copies[end].m_region);
+				end++;
+			}
+
+			vkCmdCopyBufferToImage(cmd, first.m_source, first.m_destination->vk_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<std::uint32_t>(image_regions.size()), image_regions.data());
+			begin = end;
+		}
+
+		// Staging buffers go through the deletion queue, so they outlive the submission that reads them.
+		m_copies.clear();
+		m_image_copies.clear();
+		m_staging.clear();
+		m_staging_used = 0;
+	}
+
+	std::size_t BufferUploader::pending() const
+	{
+		return m_copies.size() + m_image_copies.size();
+	}
+
+	VkDeviceSize BufferUploader::allocate(VkDeviceSize size, VkDeviceSize alignment)
+	{
+		VkDeviceSize begin = (m_staging_used + alignment - 1) / alignment * alignment;
+		if (m_staging.empty() || begin + size > m_staging.back()->size())
+		{
+			// clang-format off
+			BufferInfo info
+			{
+				.m_size = std::max(m_staging_size, size),
+				.m_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				.m_memory = MemoryUsage::STAGING
+			};
+			// clang-format on
+
+			m_staging.push_back(std::make_unique<Buffer>(m_instance, info));
+			begin = 0;
+		}
+
+		m_staging_used = begin + size;
+		return begin;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef VULKANO_GRAPHICS_BUFFERUPLOADER_HPP_
+#define VULKANO_GRAPHICS_BUFFERUPLOADER_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "vulkano/graphics/Buffer.hpp"
+
+namespace vulkano
+{
+	class Image;
+	class Instance;
+
+	///
+	/// Fills buffers with CPU data by the cheapest route available. Mapped destinations (resizable BAR, unified memory
+	/// or UPLOAD buffers) are written in place until the GPU first uses them, since a frame in flight may still read
+	/// them after that. Everything else is copied into staging memory and batched, then record() emits one barrier
+	/// batch and one vkCmdCopyBuffer per destination for the lot, ordered after the destination's earlier uses.
+	/// Image levels are always staged, and copied with one vkCmdCopyBufferToImage per image.
+	///
+	class BufferUploader final
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 16ull * 1024 * 1024;
+
+		BufferUploader(Instance* instance, VkDeviceSize staging_size = DEFAULT_STAGING_SIZE);
+		~BufferUploader() = default;
+
+		///
+		/// Returns true when the data was written directly and no copy is pending for it. Staged uploads to one
+		/// destination must not overlap until record(), since copies in a batch are unordered. Staging needs the
+		/// destination to have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT.
+		///
+		bool upload(Buffer& destination, VkDeviceSize offset, std::span<const std::byte> data);
+
+		template<typename Type>
+		bool upload(Buffer& destination, VkDeviceSize offset, std::span<const Type> data);
+
+		///
+		/// Staging memory for the whole of one mip level (every layer of a single layer image), tightly packed, to be
+		/// filled before record(). The level's previous contents are discarded. Stage each level at most once per
+		/// record(). Needs the image to have been created with VK_IMAGE_USAGE_TRANSFER_DST_BIT.
+		///
+		[[nodiscard]] std::span<std::byte> upload(Image& destination, std::uint32_t mip, VkDeviceSize size);
+
+		///
+		/// Records every pending copy. Destinations (and image levels) are left in the TRANSFER_DST state, so their next
+		/// BarrierBatch declaration waits for the copy. Staging memory is released once this submission completes.
+		///
+		void record(VkCommandBuffer cmd);
+
+		[[nodiscard]] std::size_t pending() const;
+
+	private:
+		BufferUploader() = delete;
+
+		struct Copy final
+		{
+			Buffer* m_destination;
+			VkBuffer m_source;
+			VkBufferCopy m_region;
+		};
+
+		struct ImageCopy final
+		{
+			Image* m_destination;
+			VkBuffer m_source;
+			VkBufferImageCopy m_region;
+		};
+
+		///
+		/// Space aligned to alignment in the last staging buffer, starting a new one when it is full. Returns its offset.
+		///
+		[[nodiscard]] VkDeviceSize allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+		Instance* m_instance;
+		VkDeviceSize m_staging_size;
+
+		///
+		/// Staging buffers filled since the last record(). Only the last has free space.
+		///
+		std::vector<std::unique_ptr<Buffer>> m_staging;
+		VkDeviceSize m_staging_used;
+
+		std::vector<Copy> m_copies;
+		std::vector<ImageCopy> m_image_copies;
+	};
+
+	template<typename Type>
+	inline bool BufferUploader::upload(Buffer& destination, VkDeviceSize offset, std::span<const Type> data)
+	{
+		return upload(destination, offset, std::as_bytes(data));
+	}
+} // namespace vulkano
+
+#endif
\ No newline at end of file
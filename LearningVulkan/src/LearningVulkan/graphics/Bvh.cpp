@@ -0,0 +1,506 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "Bvh.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr std::uint32_t NONE = UINT32_MAX;
+
+		///
+		/// Centroid bins per axis in the SAH search. More buys little once there are a dozen or so.
+		///
+		constexpr std::uint32_t SAH_BINS = 16;
+
+		///
+		/// Traversal stack depth. Below MAX_SAH_DEPTH nodes are halved by count instead, which no realistic item
+		/// count can take past this.
+		///
+		constexpr std::uint32_t MAX_DEPTH     = 64;
+		constexpr std::uint32_t MAX_SAH_DEPTH = 32;
+
+		enum class Containment
+		{
+			OUTSIDE,
+			INTERSECTS,
+			INSIDE
+		};
+
+		[[nodiscard]] Containment classify(const glm::vec3& min, const glm::vec3& max, const std::array<glm::vec4, 6>& planes)
+		{
+			// Empty boxes (removed items, or subtrees of nothing but) would make inf - inf below.
+			if (min.x > max.x)
+			{
+				return Containment::OUTSIDE;
+			}
+
+			Containment result = Containment::INSIDE;
+			for (const auto& plane : planes)
+			{
+				const glm::vec3 normal {plane};
+
+				// Corners farthest along and against the normal.
+				const glm::vec3 positive = glm::mix(min, max, glm::greaterThanEqual(normal, glm::vec3 {0.0f}));
+				const glm::vec3 negative = glm::mix(max, min, glm::greaterThanEqual(normal, glm::vec3 {0.0f}));
+
+				if (glm::dot(normal, positive) + plane.w < 0.0f)
+				{
+					return Containment::OUTSIDE;
+				}
+
+				if (glm::dot(normal, negative) + plane.w < 0.0f)
+				{
+					result = Containment::INTERSECTS;
+				}
+			}
+
+			return result;
+		}
+
+		[[nodiscard]] bool touches(const glm::vec3& min, const glm::vec3& max, const glm::vec3& centre, float radius)
+		{
+			const glm::vec3 offset = glm::clamp(centre, min, max) - centre;
+			return min.x <= max.x && glm::dot(offset, offset) <= radius * radius;
+		}
+
+		///
+		/// Slab test. Returns the entry distance, or infinity on a miss.
+		///
+		[[nodiscard]] float ray_entry(const glm::vec3& min, const glm::vec3& max, const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance)
+		{
+			if (min.x > max.x)
+			{
+				return std::numeric_limits<float>::infinity();
+			}
+
+			const glm::vec3 t0 = (min - origin) * inverse_direction;
+			const glm::vec3 t1 = (max - origin) * inverse_direction;
+
+			const glm::vec3 near = glm::min(t0, t1);
+			const glm::vec3 far  = glm::max(t0, t1);
+
+			const float entry = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+			const float exit  = std::min(std::min(far.x, far.y), std::min(far.z, max_distance));
+
+			return (entry <= exit) ? entry : std::numeric_limits<float>::infinity();
+		}
+
+		[[nodiscard]] glm::vec3 centroid(const Aabb& box)
+		{
+			return (box.m_min + box.m_max) * 0.5f;
+		}
+	} // namespace
+
+	Aabb Aabb::empty()
+	{
+		return {glm::vec3 {FLT_MAX}, glm::vec3 {-FLT_MAX}};
+	}
+
+	void Aabb::merge(const Aabb& other)
+	{
+		m_min = glm::min(m_min, other.m_min);
+		m_max = glm::max(m_max, other.m_max);
+	}
+
+	bool Aabb::is_empty() const
+	{
+		return m_min.x > m_max.x;
+	}
+
+	float Aabb::half_area() const
+	{
+		if (is_empty())
+		{
+			return 0.0f;
+		}
+
+		const glm::vec3 size = m_max - m_min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	void Bvh::build(std::span<const Aabb> boxes, std::vector<std::uint32_t> items)
+	{
+		m_nodes.clear();
+		m_items = std::move(items);
+		m_bounds = Aabb::empty();
+
+		if (m_items.empty())
+		{
+			return;
+		}
+
+		m_nodes.reserve(m_items.size() / 2 + 1);
+		m_nodes.push_back({});
+
+		const auto count = static_cast<std::uint32_t>(m_items.size());
+		if (count <= MAX_LEAF_ITEMS)
+		{
+			build_child(boxes, 0, 0, 0, count, 1);
+			m_nodes[0].m_min[1]   = Aabb::empty().m_min;
+			m_nodes[0].m_max[1]   = Aabb::empty().m_max;
+			m_nodes[0].m_child[1] = NONE;
+			m_nodes[0].m_count[1] = 0;
+		}
+		else
+		{
+			const std::uint32_t middle = split(boxes, 0, count);
+			build_child(boxes, 0, 0, 0, middle, 1);
+			build_child(boxes, 0, 1, middle, count, 1);
+		}
+
+		refit(boxes);
+	}
+
+	void Bvh::build_child(std::span<const Aabb> boxes, std::uint32_t node, std::uint32_t slot, std::uint32_t begin, std::uint32_t end, std::uint32_t depth)
+	{
+		if (end - begin <= MAX_LEAF_ITEMS)
+		{
+			m_nodes[node].m_child[slot] = begin;
+			m_nodes[node].m_count[slot] = end - begin;
+			return;
+		}
+
+		const auto child            = static_cast<std::uint32_t>(m_nodes.size());
+		m_nodes[node].m_child[slot] = child;
+		m_nodes[node].m_count[slot] = 0;
+		m_nodes.push_back({});
+
+		const std::uint32_t middle = (depth < MAX_SAH_DEPTH) ? split(boxes, begin, end) : begin + (end - begin) / 2;
+		build_child(boxes, child, 0, begin, middle, depth + 1);
+		build_child(boxes, child, 1, middle, end, depth + 1);
+	}
+
+	std::uint32_t Bvh::split(std::span<const Aabb> boxes, std::uint32_t begin, std::uint32_t end)
+	{
+		const auto first = m_items.begin() + begin;
+		const auto last  = m_items.begin() + end;
+
+		Aabb centres = Aabb::empty();
+		for (auto item = first; item != last; ++item)
+		{
+			const glm::vec3 centre = centroid(boxes[*item]);
+			centres.merge({centre, centre});
+		}
+
+		struct Bin final
+		{
+			Aabb m_bounds = Aabb::empty();
+			std::uint32_t m_count = 0;
+		};
+
+		float best_cost          = std::numeric_limits<float>::max();
+		std::uint32_t best_axis  = 0;
+		std::uint32_t best_split = 0;
+
+		const glm::vec3 extent = centres.m_max - centres.m_min;
+		for (std::uint32_t axis = 0; axis < 3; axis++)
+		{
+			if (extent[axis] <= 0.0f)
+			{
+				continue;
+			}
+
+			const float scale = SAH_BINS / extent[axis];
+			const auto bin_of = [&](std::uint32_t item) {
+				return std::min(static_cast<std::uint32_t>((centroid(boxes[item])[axis] - centres.m_min[axis]) * scale), SAH_BINS - 1);
+			};
+
+			std::array<Bin, SAH_BINS> bins;
+			for (auto item = first; item != last; ++item)
+			{
+				Bin& bin = bins[bin_of(*item)];
+				bin.m_bounds.merge(boxes[*item]);
+				bin.m_count++;
+			}
+
+			// Sweep from the right to get the cost of every right half, then from the left to combine.
+			std::array<float, SAH_BINS> right_cost {};
+			Aabb right_bounds         = Aabb::empty();
+			std::uint32_t right_count = 0;
+			for (std::uint32_t b = SAH_BINS - 1; b > 0; b--)
+			{
+				right_bounds.merge(bins[b].m_bounds);
+				right_count += bins[b].m_count;
+				right_cost[b] = right_bounds.half_area() * right_count;
+			}
+
+			Aabb left_bounds         = Aabb::empty();
+			std::uint32_t left_count = 0;
+			for (std::uint32_t b = 0; b + 1 < SAH_BINS; b++)
+			{
+				left_bounds.merge(bins[b].m_bounds);
+				left_count += bins[b].m_count;
+
+				const float cost = left_bounds.half_area() * left_count + right_cost[b + 1];
+				if (left_count > 0 && left_count < end - begin && cost < best_cost)
+				{
+					best_cost  = cost;
+					best_axis  = axis;
+					best_split = b + 1;
+				}
+			}
+		}
+
+		// All centroids coincide: any split is as good as another, so halve by count.
+		if (best_split == 0)
+		{
+			return begin + (end - begin) / 2;
+		}
+
+		const float scale = SAH_BINS / extent[best_axis];
+		const auto middle = std::partition(first, last, [&](std::uint32_t item) {
+			return std::min(static_cast<std::uint32_t>((centroid(boxes[item])[best_axis] - centres.m_min[best_axis]) * scale), SAH_BINS - 1) < best_split;
+		});
+
+		return static_cast<std::uint32_t>(middle - m_items.begin());
+	}
+
+	void Bvh::refit(std::span<const Aabb> boxes)
+	{
+		// Children always come after their parent, so walking backwards visits every child first.
+		for (std::size_t n = m_nodes.size(); n-- > 0;)
+		{
+			BvhNode& node = m_nodes[n];
+			for (std::uint32_t slot = 0; slot < 2; slot++)
+			{
+				if (node.m_child[slot] == NONE)
+				{
+					continue;
+				}
+
+				Aabb bounds = Aabb::empty();
+				if (node.m_count[slot] > 0)
+				{
+					for (std::uint32_t i = 0; i < node.m_count[slot]; i++)
+					{
+						bounds.merge(boxes[m_items[node.m_child[slot] + i]]);
+					}
+				}
+				else
+				{
+					const BvhNode& child = m_nodes[node.m_child[slot]];
+					bounds               = {glm::min(child.m_min[0], child.m_min[1]), glm::max(child.m_max[0], child.m_max[1])};
+				}
+
+				node.m_min[slot] = bounds.m_min;
+				node.m_max[slot] = bounds.m_max;
+			}
+		}
+
+		m_bounds = Aabb::empty();
+		if (!m_nodes.empty())
+		{
+			m_bounds = {glm::min(m_nodes[0].m_min[0], m_nodes[0].m_min[1]), glm::max(m_nodes[0].m_max[0], m_nodes[0].m_max[1])};
+		}
+	}
+
+	void Bvh::cull(std::span<const Aabb> boxes, const std::array<glm::vec4, 6>& planes, std::vector<std::uint32_t>& visible) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		struct Entry final
+		{
+			std::uint32_t m_node;
+
+			///
+			/// Set once an ancestor was found entirely inside, so nothing below needs testing.
+			///
+			bool m_inside;
+		};
+
+		std::array<Entry, MAX_DEPTH> stack;
+		std::uint32_t depth = 0;
+		stack[depth++]      = {0, false};
+
+		while (depth > 0)
+		{
+			const Entry entry   = stack[--depth];
+			const BvhNode& node = m_nodes[entry.m_node];
+
+			for (std::uint32_t slot = 0; slot < 2; slot++)
+			{
+				if (node.m_child[slot] == NONE)
+				{
+					continue;
+				}
+
+				const Containment containment = entry.m_inside ? Containment::INSIDE : classify(node.m_min[slot], node.m_max[slot], planes);
+				if (containment == Containment::OUTSIDE)
+				{
+					continue;
+				}
+
+				if (node.m_count[slot] == 0)
+				{
+					stack[depth++] = {node.m_child[slot], containment == Containment::INSIDE};
+					continue;
+				}
+
+				for (std::uint32_t i = 0; i < node.m_count[slot]; i++)
+				{
+					const std::uint32_t item = m_items[node.m_child[slot] + i];
+					const bool inside = (containment == Containment::INSIDE) ? !boxes[item].is_empty() : classify(boxes[item].m_min, boxes[item].m_max, planes) != Containment::OUTSIDE;
+					if (inside)
+					{
+						visible.push_back(item);
+					}
+				}
+			}
+		}
+	}
+
+	void Bvh::overlap(std::span<const Aabb> boxes, const glm::vec3& centre, float radius, std::vector<std::uint32_t>& items) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		std::array<std::uint32_t, MAX_DEPTH> stack;
+		std::uint32_t depth = 0;
+		stack[depth++]      = 0;
+
+		while (depth > 0)
+		{
+			const BvhNode& node = m_nodes[stack[--depth]];
+			for (std::uint32_t slot = 0; slot < 2; slot++)
+			{
+				if (node.m_child[slot] == NONE || !touches(node.m_min[slot], node.m_max[slot], centre, radius))
+				{
+					continue;
+				}
+
+				if (node.m_count[slot] == 0)
+				{
+					stack[depth++] = node.m_child[slot];
+					continue;
+				}
+
+				for (std::uint32_t i = 0; i < node.m_count[slot]; i++)
+				{
+					const std::uint32_t item = m_items[node.m_child[slot] + i];
+					if (touches(boxes[item].m_min, boxes[item].m_max, centre, radius))
+					{
+						items.push_back(item);
+					}
+				}
+			}
+		}
+	}
+
+	std::optional<BvhHit> Bvh::raycast(std::span<const Aabb> boxes, const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+	{
+		if (m_nodes.empty())
+		{
+			return std::nullopt;
+		}
+
+		// Zero components become infinities, which the slab test handles.
+		const glm::vec3 inverse_direction = 1.0f / direction;
+
+		std::optional<BvhHit> best;
+		float limit = max_distance;
+
+		struct Entry final
+		{
+			std::uint32_t m_node;
+			float m_distance;
+		};
+
+		std::array<Entry, MAX_DEPTH> stack;
+		std::uint32_t depth = 0;
+		stack[depth++]      = {0, 0.0f};
+
+		while (depth > 0)
+		{
+			const Entry entry = stack[--depth];
+			if (entry.m_distance > limit)
+			{
+				continue;
+			}
+
+			const BvhNode& node = m_nodes[entry.m_node];
+
+			std::array<float, 2> entries;
+			for (std::uint32_t slot = 0; slot < 2; slot++)
+			{
+				entries[slot] = (node.m_child[slot] == NONE) ? std::numeric_limits<float>::infinity() : ray_entry(node.m_min[slot], node.m_max[slot], origin, inverse_direction, limit);
+			}
+
+			// Push the farther child first so the nearer one is popped next. Misses are infinite, which an unbounded
+			// limit would not reject, so they are skipped explicitly.
+			const std::uint32_t near = (entries[1] < entries[0]) ? 1 : 0;
+			for (const auto slot : {1 - near, near})
+			{
+				if (node.m_child[slot] == NONE || !std::isfinite(entries[slot]) || entries[slot] > limit)
+				{
+					continue;
+				}
+
+				if (node.m_count[slot] == 0)
+				{
+					stack[depth++] = {node.m_child[slot], entries[slot]};
+					continue;
+				}
+
+				for (std::uint32_t i = 0; i < node.m_count[slot]; i++)
+				{
+					const std::uint32_t item = m_items[node.m_child[slot] + i];
+					const float distance     = ray_entry(boxes[item].m_min, boxes[item].m_max, origin, inverse_direction, limit);
+					// Removed objects have empty boxes, which always miss.
+					if (std::isfinite(distance) && distance <= limit)
+					{
+						best  = BvhHit {item, distance};
+						limit = distance;
+					}
+				}
+			}
+		}
+
+		return best;
+	}
+
+	float Bvh::cost() const
+	{
+		const float root_area = m_bounds.half_area();
+		if (root_area <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		// Interior nodes cost a traversal step per unit area, leaves an intersection test per item.
+		float cost = 0.0f;
+		for (const auto& node : m_nodes)
+		{
+			for (std::uint32_t slot = 0; slot < 2; slot++)
+			{
+				if (node.m_child[slot] != NONE)
+				{
+					cost += Aabb {node.m_min[slot], node.m_max[slot]}.half_area() * std::max(node.m_count[slot], 1u);
+				}
+			}
+		}
+
+		return cost / root_area;
+	}
+
+	bool Bvh::empty() const
+	{
+		return m_nodes.empty();
+	}
+
+	std::size_t Bvh::node_count() const
+	{
+		return m_nodes.size();
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,122 @@
+#ifndef VULKANO_GRAPHICS_BVH_HPP_
+#define VULKANO_GRAPHICS_BVH_HPP_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace vulkano
+{
+	struct Aabb final
+	{
+		glm::vec3 m_min;
+		glm::vec3 m_max;
+
+		///
+		/// Inside out, so it contains nothing and merging anything into it gives that thing.
+		///
+		[[nodiscard]] static Aabb empty();
+
+		void merge(const Aabb& other);
+		[[nodiscard]] bool is_empty() const;
+		[[nodiscard]] float half_area() const;
+	};
+
+	///
+	/// Two sibling subtrees in one 64 byte cache line, so a single fetch decides which of them a query visits.
+	///
+	struct alignas(64) BvhNode final
+	{
+		std::array<glm::vec3, 2> m_min;
+		std::array<glm::vec3, 2> m_max;
+
+		///
+		/// Node index of an interior child, or index into the item list of a leaf child.
+		///
+		std::array<std::uint32_t, 2> m_child;
+
+		///
+		/// Items in a leaf child. 0 for an interior child, or for the unused second child of a single leaf root.
+		///
+		std::array<std::uint32_t, 2> m_count;
+	};
+
+	static_assert(sizeof(BvhNode) == 64);
+
+	struct BvhHit final
+	{
+		std::uint32_t m_item;
+		float m_distance;
+	};
+
+	///
+	/// Bounding volume hierarchy over items whose boxes are kept by the caller, indexed by item. The tree stores item
+	/// indices only, so it can be built from a snapshot of the boxes and refitted to their current values later.
+	///
+	/// Built top down with a binned surface area heuristic. Nodes are laid out parent first, so a refit is a single
+	/// backwards pass over them.
+	///
+	class Bvh final
+	{
+	public:
+		static constexpr std::uint32_t MAX_LEAF_ITEMS = 4;
+
+		Bvh() = default;
+		~Bvh() = default;
+
+		void build(std::span<const Aabb> boxes, std::vector<std::uint32_t> items);
+
+		///
+		/// Recomputes every node from the items' current boxes, keeping the topology.
+		///
+		void refit(std::span<const Aabb> boxes);
+
+		///
+		/// Appends the items whose boxes intersect all six inward facing planes. Subtrees found entirely inside are
+		/// appended without testing their items.
+		///
+		void cull(std::span<const Aabb> boxes, const std::array<glm::vec4, 6>& planes, std::vector<std::uint32_t>& visible) const;
+
+		///
+		/// Appends the items whose boxes touch the sphere.
+		///
+		void overlap(std::span<const Aabb> boxes, const glm::vec3& centre, float radius, std::vector<std::uint32_t>& items) const;
+
+		///
+		/// Nearest item box the ray enters within max_distance. Nearer children are visited first, and anything
+		/// farther than the best hit so far is skipped.
+		///
+		[[nodiscard]] std::optional<BvhHit> raycast(std::span<const Aabb> boxes, const glm::vec3& origin, const glm::vec3& direction, float max_distance) const;
+
+		///
+		/// Surface area heuristic cost relative to the root, which refits of moving items drive up.
+		///
+		[[nodiscard]] float cost() const;
+
+		[[nodiscard]] bool empty() const;
+		[[nodiscard]] std::size_t node_count() const;
+
+	private:
+		///
+		/// Fills slot of node with items [begin, end), recursing into a new node unless they fit a leaf. depth is
+		/// the new node's.
+		///
+		void build_child(std::span<const Aabb> boxes, std::uint32_t node, std::uint32_t slot, std::uint32_t begin, std::uint32_t end, std::uint32_t depth);
+
+		///
+		/// Partitions items [begin, end) by the cheapest binned split and returns the first item of the right half.
+		///
+		[[nodiscard]] std::uint32_t split(std::span<const Aabb> boxes, std::uint32_t begin, std::uint32_t end);
+
+		std::vector<BvhNode> m_nodes;
+		std::vector<std::uint32_t> m_items;
+		Aabb m_bounds = Aabb::empty();
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
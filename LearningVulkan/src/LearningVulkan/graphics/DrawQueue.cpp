@@ -0,0 +1,231 @@
+#include <algorithm>
+
+#include "vulkano/core/JobSystem.hpp"
+#include "vulkano/pipeline/Pipeline.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "DrawQueue.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr std::uint32_t PASS_SHIFT     = 56;
+		constexpr std::uint32_t PIPELINE_SHIFT = 40;
+		constexpr std::uint32_t MATERIAL_SHIFT = 16;
+		constexpr float MAX_DEPTH_BUCKET       = 65535.0f;
+
+		///
+		/// Calls body(begin, end) over [0, count) in ranges of grain, on the job system when there is one.
+		///
+		template<typename Body>
+		void for_ranges(JobSystem* jobs, std::uint32_t count, std::uint32_t grain, Body&& body)
+		{
+			if (jobs)
+			{
+				jobs->parallel_for(count, grain, body);
+			}
+			else
+			{
+				body(0u, count);
+			}
+		}
+	} // namespace
+
+	DrawQueue::DrawQueue(JobSystem* jobs)
+	    : m_jobs {jobs}, m_stats {}
+	{
+	}
+
+	std::uint32_t DrawQueue::add_pipeline(const Pipeline* pipeline)
+	{
+		if (m_pipelines.size() == MAX_PIPELINES)
+		{
+			VK_LOG(VK_THROW, "Sort keys have room for {0} pipelines.", MAX_PIPELINES);
+		}
+
+		m_pipelines.push_back(pipeline);
+		return static_cast<std::uint32_t>(m_pipelines.size() - 1);
+	}
+
+	std::uint32_t DrawQueue::add_material(VkDescriptorSet set)
+	{
+		if (m_materials.size() == MAX_MATERIALS)
+		{
+			VK_LOG(VK_THROW, "Sort keys have room for {0} materials.", MAX_MATERIALS);
+		}
+
+		m_materials.push_back(set);
+		return static_cast<std::uint32_t>(m_materials.size() - 1);
+	}
+
+	std::uint64_t DrawQueue::make_key(std::uint32_t pass, std::uint32_t pipeline, std::uint32_t material, float depth, bool back_to_front)
+	{
+		if (pass >= MAX_PASSES)
+		{
+			VK_LOG(VK_THROW, "Pass {0} is out of range, sort keys have room for {1} passes.", pass, MAX_PASSES);
+		}
+
+		if (pipeline >= MAX_PIPELINES)
+		{
+			VK_LOG(VK_THROW, "Pipeline {0} is out of range, sort keys have room for {1} pipelines.", pipeline, MAX_PIPELINES);
+		}
+
+		if (material >= MAX_MATERIALS)
+		{
+			VK_LOG(VK_THROW, "Material {0} is out of range, sort keys have room for {1} materials.", material, MAX_MATERIALS);
+		}
+
+		auto bucket = static_cast<std::uint64_t>(std::clamp(depth, 0.0f, 1.0f) * MAX_DEPTH_BUCKET);
+		if (back_to_front)
+		{
+			bucket = static_cast<std::uint64_t>(MAX_DEPTH_BUCKET) - bucket;
+		}
+
+		return (static_cast<std::uint64_t>(pass) << PASS_SHIFT) | (static_cast<std::uint64_t>(pipeline) << PIPELINE_SHIFT) | (static_cast<std::uint64_t>(material) << MATERIAL_SHIFT) | bucket;
+	}
+
+	void DrawQueue::push(const DrawPacket& packet)
+	{
+		m_packets.push_back(packet);
+	}
+
+	void DrawQueue::sort()
+	{
+		const auto count = static_cast<std::uint32_t>(m_packets.size());
+		if (count < 2)
+		{
+			return;
+		}
+
+		m_entries.resize(count);
+		m_scratch.resize(count);
+
+		std::uint64_t differing = 0;
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			m_entries[i] = {m_packets[i].m_key, i};
+			differing |= m_packets[i].m_key ^ m_packets[0].m_key;
+		}
+
+		const std::uint32_t grain = m_jobs ? PACKETS_PER_JOB : count;
+		const std::uint32_t jobs  = (count + grain - 1) / grain;
+		m_job_counts.resize(jobs * RADIX);
+
+		for (std::uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			// A digit every key shares would only copy the entries.
+			if (((differing >> shift) & (RADIX - 1)) == 0)
+			{
+				continue;
+			}
+
+			for_ranges(m_jobs, count, grain, [this, shift, grain](std::uint32_t begin, std::uint32_t end) {
+				std::uint32_t* counts = &m_job_counts[begin / grain * RADIX];
+				std::fill_n(counts, RADIX, 0u);
+
+				for (std::uint32_t i = begin; i < end; i++)
+				{
+					counts[(m_entries[i].m_key >> shift) & (RADIX - 1)]++;
+				}
+			});
+
+			// Digit major, job minor, so each job's entries land after those of earlier jobs with the same digit.
+			std::uint32_t offset = 0;
+			for (std::uint32_t digit = 0; digit < RADIX; digit++)
+			{
+				for (std::uint32_t job = 0; job < jobs; job++)
+				{
+					const std::uint32_t digit_count = m_job_counts[job * RADIX + digit];
+
+					m_job_counts[job * RADIX + digit] = offset;
+					offset += digit_count;
+				}
+			}
+
+			for_ranges(m_jobs, count, grain, [this, shift, grain](std::uint32_t begin, std::uint32_t end) {
+				std::uint32_t* offsets = &m_job_counts[begin / grain * RADIX];
+				for (std::uint32_t i = begin; i < end; i++)
+				{
+					m_scratch[offsets[(m_entries[i].m_key >> shift) & (RADIX - 1)]++] = m_entries[i];
+				}
+			});
+
+			m_entries.swap(m_scratch);
+		}
+
+		m_sorted.resize(count);
+		for_ranges(m_jobs, count, grain, [this](std::uint32_t begin, std::uint32_t end) {
+			for (std::uint32_t i = begin; i < end; i++)
+			{
+				m_sorted[i] = m_packets[m_entries[i].m_packet];
+			}
+		});
+
+		m_packets.swap(m_sorted);
+	}
+
+	void DrawQueue::submit(VkCommandBuffer cmd, std::uint32_t pass)
+	{
+		const auto first = std::partition_point(m_packets.begin(), m_packets.end(), [pass](const DrawPacket& packet) {
+			return (packet.m_key >> PASS_SHIFT) < pass;
+		});
+
+		const auto last = std::partition_point(first, m_packets.end(), [pass](const DrawPacket& packet) {
+			return (packet.m_key >> PASS_SHIFT) == pass;
+		});
+
+		// Sets stay bound across pipelines with the same layout, so only a layout change forces the material again.
+		std::uint32_t bound_pipeline = UINT32_MAX;
+		std::uint32_t bound_material = UINT32_MAX;
+		VkPipelineLayout bound_layout = VK_NULL_HANDLE;
+
+		for (auto packet = first; packet != last; ++packet)
+		{
+			const auto pipeline_id = static_cast<std::uint32_t>(packet->m_key >> PIPELINE_SHIFT) & (MAX_PIPELINES - 1);
+			const auto material_id = static_cast<std::uint32_t>(packet->m_key >> MATERIAL_SHIFT) & (MAX_MATERIALS - 1);
+			const Pipeline& pipeline = *m_pipelines[pipeline_id];
+
+			if (pipeline_id != bound_pipeline)
+			{
+				pipeline.bind(cmd);
+				bound_pipeline = pipeline_id;
+				m_stats.m_pipeline_binds++;
+
+				if (pipeline.layout() != bound_layout)
+				{
+					bound_layout   = pipeline.layout();
+					bound_material = UINT32_MAX;
+				}
+			}
+
+			if (material_id != bound_material)
+			{
+				vkCmdBindDescriptorSets(cmd, pipeline.bind_point(), bound_layout, MATERIAL_SET, 1, &m_materials[material_id], 0, nullptr);
+				bound_material = material_id;
+				m_stats.m_material_binds++;
+			}
+
+			vkCmdDrawIndexed(cmd, packet->m_index_count, packet->m_instance_count, packet->m_first_index, packet->m_vertex_offset, packet->m_first_instance);
+			m_stats.m_draws++;
+		}
+
+		m_stats.m_binds_saved = 2 * m_stats.m_draws - m_stats.m_pipeline_binds - m_stats.m_material_binds;
+	}
+
+	void DrawQueue::clear()
+	{
+		m_packets.clear();
+		m_stats = {};
+	}
+
+	std::span<const DrawPacket> DrawQueue::packets() const
+	{
+		return m_packets;
+	}
+
+	const DrawQueue::Stats& DrawQueue::stats() const
+	{
+		return m_stats;
+	}
+} // namespace vulkano
\ No newline at end of file
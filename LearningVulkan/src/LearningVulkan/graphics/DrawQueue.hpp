@@ -0,0 +1,152 @@
+#ifndef VULKANO_GRAPHICS_DRAWQUEUE_HPP_
+#define VULKANO_GRAPHICS_DRAWQUEUE_HPP_
+
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class JobSystem;
+	class Pipeline;
+
+	///
+	/// One indexed draw and the state it needs, as a sort key.
+	///
+	struct DrawPacket final
+	{
+		std::uint64_t m_key;
+		std::uint32_t m_index_count;
+		std::uint32_t m_first_index;
+		std::int32_t m_vertex_offset;
+		std::uint32_t m_first_instance;
+		std::uint32_t m_instance_count;
+	};
+
+	///
+	/// Draws for a frame, ordered by a 64 bit key so that draws sharing state end up next to each other. From the
+	/// most significant bits down, the key holds:
+	///
+	///     pass        8 bits
+	///     pipeline   16 bits
+	///     material   24 bits
+	///     depth      16 bits, a bucket of the draw's normalised view depth
+	///
+	/// sort() is a least significant digit radix sort over 8 bit digits, split across the job system, which skips
+	/// digits every key shares. submit() then binds a pipeline or material only when it differs from the previous
+	/// draw's and counts the binds it saved.
+	///
+	/// Materials are descriptor sets bound at MATERIAL_SET, after the bindless table's set 0.
+	///
+	class DrawQueue final
+	{
+	public:
+		static constexpr std::uint32_t MATERIAL_SET = 1;
+
+		static constexpr std::uint32_t MAX_PASSES    = 1u << 8;
+		static constexpr std::uint32_t MAX_PIPELINES = 1u << 16;
+		static constexpr std::uint32_t MAX_MATERIALS = 1u << 24;
+
+		///
+		/// Packets each job counts or scatters per radix digit.
+		///
+		static constexpr std::uint32_t PACKETS_PER_JOB = 16384;
+
+		struct Stats final
+		{
+			std::uint32_t m_draws;
+			std::uint32_t m_pipeline_binds;
+			std::uint32_t m_material_binds;
+
+			///
+			/// Binds skipped because the previous draw left the same state bound, against binding both every draw.
+			///
+			std::uint32_t m_binds_saved;
+		};
+
+		DrawQueue(JobSystem* jobs = nullptr);
+		~DrawQueue() = default;
+
+		///
+		/// Returns the pipeline's id for sort keys. The pipeline must outlive the queue.
+		///
+		[[nodiscard]] std::uint32_t add_pipeline(const Pipeline* pipeline);
+
+		///
+		/// Returns the material's id for sort keys.
+		///
+		[[nodiscard]] std::uint32_t add_material(VkDescriptorSet set);
+
+		///
+		/// depth is in [0, 1]. Back to front flips the bucket, for blended passes. Throws if an id does not fit its field.
+		///
+		[[nodiscard]] static std::uint64_t make_key(std::uint32_t pass, std::uint32_t pipeline, std::uint32_t material, float depth, bool back_to_front = false);
+
+		void push(const DrawPacket& packet);
+
+		///
+		/// Orders the packets by key. Packets with equal keys keep the order they were pushed in.
+		///
+		void sort();
+
+		///
+		/// Records the sorted draws of one pass. Vertex and index buffers, and anything bound below MATERIAL_SET,
+		/// must already be bound.
+		///
+		void submit(VkCommandBuffer cmd, std::uint32_t pass);
+
+		///
+		/// Drops every packet and resets the stats. Call once per frame, before pushing.
+		///
+		void clear();
+
+		///
+		/// Sorted after sort().
+		///
+		[[nodiscard]] std::span<const DrawPacket> packets() const;
+
+		///
+		/// Of every submit() since the last clear().
+		///
+		[[nodiscard]] const DrawQueue::Stats& stats() const;
+
+	private:
+		DrawQueue(const DrawQueue&) = delete;
+		DrawQueue& operator=(const DrawQueue&) = delete;
+
+		static constexpr std::uint32_t RADIX = 256;
+
+		///
+		/// Sorting moves these rather than whole packets.
+		///
+		struct SortEntry final
+		{
+			std::uint64_t m_key;
+			std::uint32_t m_packet;
+		};
+
+		JobSystem* m_jobs;
+
+		std::vector<const Pipeline*> m_pipelines;
+		std::vector<VkDescriptorSet> m_materials;
+
+		std::vector<DrawPacket> m_packets;
+
+		///
+		/// Packets are gathered here in key order, then swapped with m_packets.
+		///
+		std::vector<DrawPacket> m_sorted;
+		std::vector<SortEntry> m_entries;
+		std::vector<SortEntry> m_scratch;
+
+		///
+		/// Per job digit counts, then each job's first output position per digit.
+		///
+		std::vector<std::uint32_t> m_job_counts;
+
+		Stats m_stats;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
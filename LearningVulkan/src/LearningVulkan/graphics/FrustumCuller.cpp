@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <array>
+#include <cfloat>
+
+#include "vulkano/utils/CpuFeatures.hpp"
+
+#if defined(VULKANO_X86)
+	#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VULKANO_CULL_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define VULKANO_CULL_NEON
+	#include <arm_neon.h>
+#endif
+
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+#include "vulkano/core/JobSystem.hpp"
+
+#include "FrustumCuller.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+#if defined(VULKANO_X86)
+		// Wide enough for the AVX2 kernel whether or not this CPU ends up running it.
+		constexpr std::uint32_t SIMD_WIDTH = 8;
+#else
+		constexpr std::uint32_t SIMD_WIDTH = 4;
+#endif
+
+		static_assert(FrustumCuller::INSTANCES_PER_JOB % SIMD_WIDTH == 0);
+
+		///
+		/// Padding spheres fail every plane test.
+		///
+		constexpr float PADDING_RADIUS = -FLT_MAX;
+
+		///
+		/// Plane components split out, so each can be broadcast once per job.
+		///
+		struct Planes final
+		{
+			std::array<float, 6> m_x;
+			std::array<float, 6> m_y;
+			std::array<float, 6> m_z;
+			std::array<float, 6> m_w;
+		};
+
+		///
+		/// Writes the index of every sphere in [begin, end) that is on the inner side of, or crosses, all six planes.
+		/// Lanes are appended without branches: each is always written, and the count only advances past visible
+		/// ones. Returns the number written.
+		///
+		std::uint32_t cull_range(const float* x, const float* y, const float* z, const float* radius, const Planes& planes, std::uint32_t begin, std::uint32_t end, std::uint32_t* visible)
+		{
+			std::uint32_t count = 0;
+
+#if defined(VULKANO_CULL_SSE2)
+			__m128 px[6], py[6], pz[6], pw[6];
+			for (std::size_t p = 0; p < 6; p++)
+			{
+				px[p] = _mm_set1_ps(planes.m_x[p]);
+				py[p] = _mm_set1_ps(planes.m_y[p]);
+				pz[p] = _mm_set1_ps(planes.m_z[p]);
+				pw[p] = _mm_set1_ps(planes.m_w[p]);
+			}
+
+			for (std::uint32_t i = begin; i < end; i += 4)
+			{
+				const __m128 cx    = _mm_loadu_ps(x + i);
+				const __m128 cy    = _mm_loadu_ps(y + i);
+				const __m128 cz    = _mm_loadu_ps(z + i);
+				const __m128 min_d = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (std::size_t p = 0; p < 6; p++)
+				{
+					const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)), _mm_add_ps(_mm_mul_ps(pz[p], cz), pw[p]));
+					inside                = _mm_and_ps(inside, _mm_cmpge_ps(distance, min_d));
+				}
+
+				const auto mask = static_cast<std::uint32_t>(_mm_movemask_ps(inside));
+				for (std::uint32_t lane = 0; lane < 4; lane++)
+				{
+					visible[count] = i + lane;
+					count += (mask >> lane) & 1;
+				}
+			}
+#elif defined(VULKANO_CULL_NEON)
+			for (std::uint32_t i = begin; i < end; i += 4)
+			{
+				const float32x4_t cx    = vld1q_f32(x + i);
+				const float32x4_t cy    = vld1q_f32(y + i);
+				const float32x4_t cz    = vld1q_f32(z + i);
+				const float32x4_t min_d = vnegq_f32(vld1q_f32(radius + i));
+
+				uint32x4_t inside = vdupq_n_u32(~0u);
+				for (std::size_t p = 0; p < 6; p++)
+				{
+					float32x4_t distance = vdupq_n_f32(planes.m_w[p]);
+					distance             = vmlaq_n_f32(distance, cx, planes.m_x[p]);
+					distance             = vmlaq_n_f32(distance, cy, planes.m_y[p]);
+					distance             = vmlaq_n_f32(distance, cz, planes.m_z[p]);
+					inside               = vandq_u32(inside, vcgeq_f32(distance, min_d));
+				}
+
+				alignas(16) std::uint32_t lanes[4];
+				vst1q_u32(lanes, inside);
+
+				for (std::uint32_t lane = 0; lane < 4; lane++)
+				{
+					visible[count] = i + lane;
+					count += lanes[lane] & 1;
+				}
+			}
+#else
+			for (std::uint32_t i = begin; i < end; i++)
+			{
+				bool inside = true;
+				for (std::size_t p = 0; p < 6; p++)
+				{
+					inside &= planes.m_x[p] * x[i] + planes.m_y[p] * y[i] + planes.m_z[p] * z[i] + planes.m_w[p] >= -radius[i];
+				}
+
+				visible[count] = i;
+				count += inside;
+			}
+#endif
+
+			return count;
+		}
+
+#if defined(VULKANO_X86)
+		///
+		/// cull_range() eight lanes at a time, for CPUs with AVX2.
+		///
+		VULKANO_TARGET("avx2") std::uint32_t cull_range_avx2(const float* x, const float* y, const float* z, const float* radius, const Planes& planes, std::uint32_t begin, std::uint32_t end, std::uint32_t* visible)
+		{
+			std::uint32_t count = 0;
+
+			__m256 px[6], py[6], pz[6], pw[6];
+			for (std::size_t p = 0; p < 6; p++)
+			{
+				px[p] = _mm256_set1_ps(planes.m_x[p]);
+				py[p] = _mm256_set1_ps(planes.m_y[p]);
+				pz[p] = _mm256_set1_ps(planes.m_z[p]);
+				pw[p] = _mm256_set1_ps(planes.m_w[p]);
+			}
+
+			for (std::uint32_t i = begin; i < end; i += 8)
+			{
+				const __m256 cx    = _mm256_loadu_ps(x + i);
+				const __m256 cy    = _mm256_loadu_ps(y + i);
+				const __m256 cz    = _mm256_loadu_ps(z + i);
+				const __m256 min_d = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i));
+
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (std::size_t p = 0; p < 6; p++)
+				{
+					const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[p], cx), _mm256_mul_ps(py[p], cy)), _mm256_add_ps(_mm256_mul_ps(pz[p], cz), pw[p]));
+					inside                = _mm256_and_ps(inside, _mm256_cmp_ps(distance, min_d, _CMP_GE_OQ));
+				}
+
+				const auto mask = static_cast<std::uint32_t>(_mm256_movemask_ps(inside));
+				for (std::uint32_t lane = 0; lane < 8; lane++)
+				{
+					visible[count] = i + lane;
+					count += (mask >> lane) & 1;
+				}
+			}
+
+			return count;
+		}
+#endif
+	} // namespace
+
+	std::array<glm::vec4, 6> frustum_planes(const glm::mat4& view_projection)
+	{
+		const glm::mat4 rows = glm::transpose(view_projection);
+
+		std::array<glm::vec4, 6> planes {rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[2], rows[3] - rows[2]};
+		for (auto& plane : planes)
+		{
+			plane /= glm::length(glm::vec3 {plane});
+		}
+
+		return planes;
+	}
+
+	FrustumCuller::FrustumCuller(JobSystem* jobs)
+	    : m_count {0}, m_jobs {jobs}
+	{
+	}
+
+	std::uint32_t FrustumCuller::add(const glm::vec3& centre, float radius)
+	{
+		if (m_count == m_x.size())
+		{
+			const std::size_t padded = m_x.size() + SIMD_WIDTH;
+			m_x.resize(padded, 0.0f);
+			m_y.resize(padded, 0.0f);
+			m_z.resize(padded, 0.0f);
+			m_radius.resize(padded, PADDING_RADIUS);
+		}
+
+		update(m_count, centre, radius);
+		return m_count++;
+	}
+
+	void FrustumCuller::update(std::uint32_t instance, const glm::vec3& centre, float radius)
+	{
+		m_x[instance]      = centre.x;
+		m_y[instance]      = centre.y;
+		m_z[instance]      = centre.z;
+		m_radius[instance] = radius;
+	}
+
+	void FrustumCuller::clear()
+	{
+		m_x.clear();
+		m_y.clear();
+		m_z.clear();
+		m_radius.clear();
+		m_count = 0;
+	}
+
+	std::span<const std::uint32_t> FrustumCuller::cull(const glm::mat4& view_projection)
+	{
+		const auto padded = static_cast<std::uint32_t>(m_x.size());
+		const auto jobs   = (padded + INSTANCES_PER_JOB - 1) / INSTANCES_PER_JOB;
+
+		Planes planes;
+		const auto frustum = frustum_planes(view_projection);
+		for (std::size_t p = 0; p < 6; p++)
+		{
+			planes.m_x[p] = frustum[p].x;
+			planes.m_y[p] = frustum[p].y;
+			planes.m_z[p] = frustum[p].z;
+			planes.m_w[p] = frustum[p].w;
+		}
+
+		m_visible.resize(padded);
+		m_job_visible.resize(jobs);
+
+#if defined(VULKANO_X86)
+		const auto kernel = cpu_features().m_avx2 ? cull_range_avx2 : cull_range;
+#else
+		const auto kernel = cull_range;
+#endif
+
+		const auto body = [&](std::uint32_t first_job, std::uint32_t last_job) {
+			for (std::uint32_t job = first_job; job < last_job; job++)
+			{
+				const std::uint32_t begin = job * INSTANCES_PER_JOB;
+				const std::uint32_t end   = std::min(begin + INSTANCES_PER_JOB, padded);
+				m_job_visible[job]        = kernel(m_x.data(), m_y.data(), m_z.data(), m_radius.data(), planes, begin, end, m_visible.data() + begin);
+			}
+		};
+
+		if (m_jobs)
+		{
+			m_jobs->parallel_for(jobs, 1, body);
+		}
+		else
+		{
+			body(0, jobs);
+		}
+
+		// Each run only moves towards the front, onto space earlier runs did not fill.
+		std::uint32_t count = (jobs > 0) ? m_job_visible[0] : 0;
+		for (std::uint32_t job = 1; job < jobs; job++)
+		{
+			const auto run = m_visible.begin() + job * INSTANCES_PER_JOB;
+			if (count != job * INSTANCES_PER_JOB)
+			{
+				std::copy(run, run + m_job_visible[job], m_visible.begin() + count);
+			}
+
+			count += m_job_visible[job];
+		}
+
+		return std::span {m_visible}.first(count);
+	}
+
+	std::uint32_t FrustumCuller::size() const
+	{
+		return m_count;
+	}
+} // namespace vulkano
\ No newline at end of file
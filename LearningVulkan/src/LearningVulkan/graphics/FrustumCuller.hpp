@@ -0,0 +1,71 @@
+#ifndef VULKANO_GRAPHICS_FRUSTUMCULLER_HPP_
+#define VULKANO_GRAPHICS_FRUSTUMCULLER_HPP_
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+namespace vulkano
+{
+	class JobSystem;
+
+	///
+	/// Gribb and Hartmann's extraction for Vulkan's [0, 1] depth range: left, right, bottom, top, near, far. Planes
+	/// point inwards and are normalised, so dot(plane.xyz, p) + plane.w is the signed distance of p.
+	///
+	[[nodiscard]] std::array<glm::vec4, 6> frustum_planes(const glm::mat4& view_projection);
+
+	///
+	/// Bounding spheres of many instances, stored as one array per component so AVX2 tests eight instances per
+	/// instruction and SSE2 or NEON four. AVX2 is used when the CPU has it, checked at run time. Culling splits the
+	/// instances across the job system and returns a compact, ascending list of visible indices.
+	///
+	class FrustumCuller final
+	{
+	public:
+		///
+		/// Instances each job culls. A multiple of the widest SIMD width.
+		///
+		static constexpr std::uint32_t INSTANCES_PER_JOB = 16384;
+
+		FrustumCuller(JobSystem* jobs = nullptr);
+		~FrustumCuller() = default;
+
+		///
+		/// Returns the instance's index.
+		///
+		std::uint32_t add(const glm::vec3& centre, float radius);
+		void update(std::uint32_t instance, const glm::vec3& centre, float radius);
+		void clear();
+
+		///
+		/// World space bounds, tested against the frustum of view_projection. Valid until the next call.
+		///
+		[[nodiscard]] std::span<const std::uint32_t> cull(const glm::mat4& view_projection);
+
+		[[nodiscard]] std::uint32_t size() const;
+
+	private:
+		///
+		/// Arrays are padded to a whole SIMD width with spheres that are never visible, so kernels need no tail loop.
+		///
+		std::vector<float> m_x;
+		std::vector<float> m_y;
+		std::vector<float> m_z;
+		std::vector<float> m_radius;
+		std::uint32_t m_count;
+
+		///
+		/// Each job writes its survivors at its own first instance, then the runs are packed together.
+		///
+		std::vector<std::uint32_t> m_visible;
+		std::vector<std::uint32_t> m_job_visible;
+
+		JobSystem* m_jobs;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
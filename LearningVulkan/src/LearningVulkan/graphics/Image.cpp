@@ -1,3 +1,5 @@
+#include <utility>
+
 #include "vulkano/pipeline/Instance.hpp"
 #include "vulkano/utils/Log.hpp"
 
@@ -5,46 +7,114 @@
 
 namespace vulkano
 {
-	Image::Image(std::shared_ptr<Instance> instance, const ImageInfo& info)
-	    : m_instance {instance}, m_image {nullptr}, m_view {nullptr}
+	namespace
 	{
-	}
+		[[nodiscard]] VkImageCreateInfo image_create_info(const ImageInfo& info)
+		{
+			// clang-format off
+			return VkImageCreateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.imageType = VK_IMAGE_TYPE_2D,
+				.format = info.m_format,
+				.extent = {info.m_extent.width, info.m_extent.height, 1},
+				.mipLevels = info.m_mip_levels,
+				.arrayLayers = info.m_array_layers,
+				.samples = VK_SAMPLE_COUNT_1_BIT,
+				.tiling = VK_IMAGE_TILING_OPTIMAL,
+				.usage = info.m_usage,
+				.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+				.queueFamilyIndexCount = 0,
+				.pQueueFamilyIndices = nullptr,
+				.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+			};
+			// clang-format on
+		}
+	} // namespace
 
-	Image::Image(std::shared_ptr<Instance> instance, const ImageInfo& info, VkImage existing)
-	    : m_instance {instance}, m_image {existing}, m_view {nullptr}
+	Image::Image(Instance* instance, const ImageInfo& info)
+	    : m_instance {instance}, m_info {info}, m_image {nullptr}, m_view {nullptr}, m_memory {nullptr}, m_owns_image {true}, m_states(info.m_mip_levels * info.m_array_layers)
 	{
+		const VkImageCreateInfo image_info = image_create_info(info);
+		if (vkCreateImage(m_instance->logical_device(), &image_info, nullptr, &m_image) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create image.");
+		}
+
+		VkMemoryRequirements requirements;
+		vkGetImageMemoryRequirements(m_instance->logical_device(), m_image, &requirements);
+
 		// clang-format off
-		VkImageViewCreateInfo image_view_info
+		VkMemoryAllocateInfo alloc_info
 		{
-			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
 			.pNext = nullptr,
-			.flags = VK_NULL_HANDLE,
-			.image = m_image,
-			.viewType = info.m_type,
-			.format = info.m_format
+			.allocationSize = requirements.size,
+			.memoryTypeIndex = m_instance->find_memory_type(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
 		};
 		// clang-format on
 
-		image_view_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-		image_view_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-		image_view_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-		image_view_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		if (vkAllocateMemory(m_instance->logical_device(), &alloc_info, nullptr, &m_memory) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to allocate image memory.");
+		}
 
-		image_view_info.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-		image_view_info.subresourceRange.baseMipLevel   = 0;
-		image_view_info.subresourceRange.levelCount     = 1;
-		image_view_info.subresourceRange.baseArrayLayer = 0;
-		image_view_info.subresourceRange.layerCount     = 1;
+		vkBindImageMemory(m_instance->logical_device(), m_image, m_memory, 0);
 
-		if (vkCreateImageView(m_instance->logical_device(), &image_view_info, nullptr, &m_view) != VK_SUCCESS)
+		create_view();
+	}
+
+	Image::Image(Instance* instance, const ImageInfo& info, VkImage existing)
+	    : m_instance {instance}, m_info {info}, m_image {existing}, m_view {nullptr}, m_memory {nullptr}, m_owns_image {false}, m_states(info.m_mip_levels * info.m_array_layers)
+	{
+		create_view();
+	}
+
+	Image::Image(Instance* instance, const ImageInfo& info, VkDeviceMemory memory, VkDeviceSize offset)
+	    : m_instance {instance}, m_info {info}, m_image {nullptr}, m_view {nullptr}, m_memory {nullptr}, m_owns_image {true}, m_states(info.m_mip_levels * info.m_array_layers)
+	{
+		const VkImageCreateInfo image_info = image_create_info(info);
+		if (vkCreateImage(m_instance->logical_device(), &image_info, nullptr, &m_image) != VK_SUCCESS)
 		{
-			VK_LOG(VK_THROW, "Failed to create image view.");
+			VK_LOG(VK_THROW, "Failed to create image.");
+		}
+
+		if (vkBindImageMemory(m_instance->logical_device(), m_image, memory, offset) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to bind image memory at offset {0}.", offset);
 		}
+
+		create_view();
+	}
+
+	Image::Image(Image&& image) noexcept
+	    : m_instance {image.m_instance}, m_info {image.m_info}, m_image {std::exchange(image.m_image, nullptr)}, m_view {std::exchange(image.m_view, nullptr)}, m_memory {std::exchange(image.m_memory, nullptr)}, m_owns_image {std::exchange(image.m_owns_image, false)}, m_states {std::move(image.m_states)}
+	{
+	}
+
+	Image& Image::operator=(Image&& image) noexcept
+	{
+		if (this != &image)
+		{
+			release();
+
+			m_instance   = image.m_instance;
+			m_info       = image.m_info;
+			m_image      = std::exchange(image.m_image, nullptr);
+			m_view       = std::exchange(image.m_view, nullptr);
+			m_memory     = std::exchange(image.m_memory, nullptr);
+			m_owns_image = std::exchange(image.m_owns_image, false);
+			m_states     = std::move(image.m_states);
+		}
+
+		return *this;
 	}
 
 	Image::~Image()
 	{
-		vkDestroyImageView(m_instance->logical_device(), m_view, nullptr);
+		release();
 	}
 
 	VkImage Image::vk_handle() const
@@ -56,4 +126,83 @@ namespace vulkano
 	{
 		return m_view;
 	}
+
+	const ImageInfo& Image::info() const
+	{
+		return m_info;
+	}
+
+	ResourceState& Image::state(std::uint32_t mip, std::uint32_t layer)
+	{
+		return m_states[layer * m_info.m_mip_levels + mip];
+	}
+
+	VkMemoryRequirements Image::memory_requirements(const Instance& instance, const ImageInfo& info)
+	{
+		const VkImageCreateInfo image_info = image_create_info(info);
+
+		// clang-format off
+		VkDeviceImageMemoryRequirements query
+		{
+			.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+			.pNext = nullptr,
+			.pCreateInfo = &image_info
+		};
+
+		VkMemoryRequirements2 requirements
+		{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+			.pNext = nullptr
+		};
+		// clang-format on
+
+		vkGetDeviceImageMemoryRequirements(instance.logical_device(), &query, &requirements);
+		return requirements.memoryRequirements;
+	}
+
+	void Image::release()
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		deletion.release(m_view);
+
+		// Images wrapping an existing handle (i.e. swapchain images) are owned elsewhere, and placed images only
+		// borrow their memory.
+		if (m_owns_image)
+		{
+			deletion.release(m_image);
+		}
+
+		deletion.release(m_memory);
+	}
+
+	void Image::create_view()
+	{
+		// clang-format off
+		VkImageViewCreateInfo image_view_info
+		{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = VK_NULL_HANDLE,
+			.image = m_image,
+			.viewType = m_info.m_type,
+			.format = m_info.m_format
+		};
+		// clang-format on
+
+		image_view_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		image_view_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		image_view_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		image_view_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+		image_view_info.subresourceRange.aspectMask     = m_info.m_aspect;
+		image_view_info.subresourceRange.baseMipLevel   = 0;
+		image_view_info.subresourceRange.levelCount     = m_info.m_mip_levels;
+		image_view_info.subresourceRange.baseArrayLayer = 0;
+		image_view_info.subresourceRange.layerCount     = m_info.m_array_layers;
+
+		if (vkCreateImageView(m_instance->logical_device(), &image_view_info, nullptr, &m_view) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create image view.");
+		}
+	}
 } // namespace vulkano
\ No newline at end of file
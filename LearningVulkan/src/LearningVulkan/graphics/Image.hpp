@@ -2,31 +2,76 @@
 #define VULKANO_GRAPHICS_IMAGE_HPP_
 
 #include <memory>
+#include <vector>
 
-#include <vulkan/vulkan.h>
+#include "vulkano/pipeline/Barriers.hpp"
 
 namespace vulkano
 {
+	class Instance;
+
 	struct ImageInfo final
 	{
 		VkFormat m_format;
 		VkImageViewType m_type;
+
+		///
+		/// Only used when the image is created (and owned) by Image, not when wrapping an existing handle.
+		///
+		VkExtent2D m_extent          = {0, 0};
+		std::uint32_t m_mip_levels   = 1;
+		std::uint32_t m_array_layers = 1;
+		VkImageUsageFlags m_usage    = VK_IMAGE_USAGE_SAMPLED_BIT;
+		VkImageAspectFlags m_aspect  = VK_IMAGE_ASPECT_COLOR_BIT;
 	};
 
 	class Image final
 	{
 	public:
-		Image(std::shared_ptr<Instance> instance, const ImageInfo& info);
-		Image(std::shared_ptr<Instance> instance, const ImageInfo& info, VkImage existing);
+		Image(Instance* instance, const ImageInfo& info);
+		Image(Instance* instance, const ImageInfo& info, VkImage existing);
+
+		///
+		/// Creates the image inside memory owned by the caller, which may be shared with other images (aliasing).
+		///
+		Image(Instance* instance, const ImageInfo& info, VkDeviceMemory memory, VkDeviceSize offset);
+
+		///
+		/// Moving leaves the source empty, so images can live by value in a ResourcePool.
+		///
+		Image(Image&& image) noexcept;
+		Image& operator=(Image&& image) noexcept;
 		~Image();
 
 		[[nodiscard]] VkImage vk_handle() const;
 		[[nodiscard]] VkImageView vk_view() const;
+		[[nodiscard]] const ImageInfo& info() const;
+
+		///
+		/// Tracked state of one subresource, kept up to date by BarrierBatch.
+		///
+		[[nodiscard]] ResourceState& state(std::uint32_t mip, std::uint32_t layer);
+
+		///
+		/// Size, alignment and memory types an image with this info would need, without creating it.
+		///
+		[[nodiscard]] static VkMemoryRequirements memory_requirements(const Instance& instance, const ImageInfo& info);
 
 	private:
-		std::shared_ptr<Instance> m_instance;
+		Image(const Image&) = delete;
+		Image& operator=(const Image&) = delete;
+
+		void create_view();
+		void release();
+
+		Instance* m_instance;
+		ImageInfo m_info;
 		VkImage m_image;
 		VkImageView m_view;
+		VkDeviceMemory m_memory;
+		bool m_owns_image;
+
+		std::vector<ResourceState> m_states;
 	};
 } // namespace vulkano
 
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+#include "LodSelector.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Cameras inside a bounding sphere see it from this far at least, so the nearest level is chosen
+		/// without dividing by zero.
+		///
+		constexpr float MIN_DISTANCE = 1e-4f;
+	} // namespace
+
+	LodSelector::LodSelector(const LodSelector::Settings& settings)
+	    : m_pixels_per_unit {0.0f}, m_pixel_error {0.0f}
+	{
+		reconfigure(settings);
+	}
+
+	void LodSelector::reconfigure(const LodSelector::Settings& settings)
+	{
+		m_pixels_per_unit = settings.m_viewport_height * 0.5f / std::tan(settings.m_vertical_fov * 0.5f);
+		m_pixel_error     = settings.m_pixel_error;
+	}
+
+	std::uint32_t LodSelector::select(std::span<const MeshLod> lods, const glm::vec3& centre, float radius, float scale, const glm::vec3& camera) const
+	{
+		// The nearest point of the bounds is where the error looks largest.
+		const float distance = std::max(glm::length(centre - camera) - radius, MIN_DISTANCE);
+
+		for (auto lod = static_cast<std::uint32_t>(lods.size()); lod-- > 1;)
+		{
+			if (projected_error(lods[lod].m_error * scale, distance) <= m_pixel_error)
+			{
+				return lod;
+			}
+		}
+
+		return 0;
+	}
+
+	float LodSelector::projected_error(float error, float distance) const
+	{
+		return error * m_pixels_per_unit / distance;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef VULKANO_GRAPHICS_LODSELECTOR_HPP_
+#define VULKANO_GRAPHICS_LODSELECTOR_HPP_
+
+#include <span>
+
+#include "vulkano/assets/MeshImporter.hpp"
+
+namespace vulkano
+{
+	///
+	/// Picks each instance's level of detail from how large its simplification error would appear on screen: the
+	/// coarsest level whose error projects to less than m_pixel_error pixels is drawn.
+	///
+	class LodSelector final
+	{
+	public:
+		struct Settings final
+		{
+			float m_vertical_fov;
+			float m_viewport_height;
+
+			///
+			/// Screen-space error allowed, in pixels.
+			///
+			float m_pixel_error = 1.0f;
+		};
+
+		LodSelector(const LodSelector::Settings& settings);
+		~LodSelector() = default;
+
+		///
+		/// Call when the projection or the viewport changes.
+		///
+		void reconfigure(const LodSelector::Settings& settings);
+
+		///
+		/// centre, radius and scale describe the instance's bounding sphere in world space, with scale the largest
+		/// axis scale of its transform, which errors are measured in.
+		///
+		[[nodiscard]] std::uint32_t select(std::span<const MeshLod> lods, const glm::vec3& centre, float radius, float scale, const glm::vec3& camera) const;
+
+		///
+		/// Pixels a world space error covers at distance from the camera.
+		///
+		[[nodiscard]] float projected_error(float error, float distance) const;
+
+	private:
+		LodSelector() = delete;
+
+		///
+		/// Pixels per world unit at distance 1, the projection's vertical scale times half the viewport height.
+		///
+		float m_pixels_per_unit;
+		float m_pixel_error;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
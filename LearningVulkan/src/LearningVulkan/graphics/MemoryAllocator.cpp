@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <bit>
+
+#include "vulkano/utils/Log.hpp"
+
+#include "MemoryAllocator.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Size of the BAR window on GPUs without resizable BAR.
+		///
+		constexpr VkDeviceSize CLASSIC_BAR_SIZE = 256ull * 1024 * 1024;
+
+		[[nodiscard]] VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		[[nodiscard]] VkDeviceSize align_down(VkDeviceSize value, VkDeviceSize alignment)
+		{
+			return value / alignment * alignment;
+		}
+
+		struct TypePreference final
+		{
+			VkMemoryPropertyFlags m_required;
+			VkMemoryPropertyFlags m_preferred;
+			VkMemoryPropertyFlags m_avoided;
+		};
+	} // namespace
+
+	MemoryAllocator::MemoryAllocator(VkDevice device, VkPhysicalDevice gpu, VkDeviceSize block_size)
+	    : m_device {device}, m_block_size {block_size}, m_atom_size {1}, m_unified {false}, m_resizable_bar {false}, m_properties {}, m_allocated {0}
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(gpu, &properties);
+		vkGetPhysicalDeviceMemoryProperties(gpu, &m_properties);
+
+		m_atom_size = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+		m_unified   = properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU;
+
+		const VkMemoryPropertyFlags bar = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+		for (std::uint32_t i = 0; i < m_properties.memoryTypeCount; i++)
+		{
+			const VkMemoryType& type = m_properties.memoryTypes[i];
+			if ((type.propertyFlags & bar) == bar && m_properties.memoryHeaps[type.heapIndex].size > CLASSIC_BAR_SIZE)
+			{
+				m_resizable_bar = true;
+			}
+		}
+
+		m_blocks.resize(m_properties.memoryTypeCount);
+	}
+
+	MemoryAllocator::~MemoryAllocator()
+	{
+		// Every resource is gone by now, see ~Instance.
+		for (const auto& blocks : m_blocks)
+		{
+			for (const auto& block : blocks)
+			{
+				if (block.m_memory)
+				{
+					vkFreeMemory(m_device, block.m_memory, nullptr);
+				}
+			}
+		}
+	}
+
+	Allocation MemoryAllocator::allocate(const VkMemoryRequirements& requirements, MemoryUsage usage)
+	{
+		std::lock_guard lock {m_mutex};
+
+		Allocation allocation;
+		for (const auto type : candidates(requirements.memoryTypeBits, usage))
+		{
+			if (try_allocate(type, requirements, allocation))
+			{
+				m_allocated += allocation.m_size;
+				return allocation;
+			}
+		}
+
+		VK_LOG(VK_THROW, "Failed to allocate {0} bytes of device memory.", requirements.size);
+		return allocation;
+	}
+
+	void MemoryAllocator::free(const Allocation& allocation)
+	{
+		if (!allocation.m_memory)
+		{
+			return;
+		}
+
+		std::lock_guard lock {m_mutex};
+
+		Block& block = m_blocks[allocation.m_type][allocation.m_block];
+		auto next    = std::lower_bound(block.m_free.begin(), block.m_free.end(), allocation.m_offset, [](const Range& range, VkDeviceSize offset) {
+			return range.m_offset < offset;
+		});
+
+		auto it = block.m_free.insert(next, Range {allocation.m_offset, allocation.m_size});
+
+		// Merge with the following range, then the preceding one.
+		if (std::next(it) != block.m_free.end() && it->m_offset + it->m_size == std::next(it)->m_offset)
+		{
+			it->m_size += std::next(it)->m_size;
+			block.m_free.erase(std::next(it));
+		}
+
+		if (it != block.m_free.begin() && std::prev(it)->m_offset + std::prev(it)->m_size == it->m_offset)
+		{
+			std::prev(it)->m_size += it->m_size;
+			block.m_free.erase(it);
+		}
+
+		m_allocated -= allocation.m_size;
+
+		// Dedicated blocks go as soon as they are empty. Shared ones are kept for reuse.
+		const bool empty = block.m_free.size() == 1 && block.m_free.front().m_size == block.m_size;
+		if (empty && block.m_dedicated)
+		{
+			vkFreeMemory(m_device, block.m_memory, nullptr);
+			block = Block {};
+		}
+	}
+
+	void MemoryAllocator::flush(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+	{
+		if (!allocation.m_coherent)
+		{
+			const VkMappedMemoryRange range = atom_range(allocation, offset, size);
+			vkFlushMappedMemoryRanges(m_device, 1, &range);
+		}
+	}
+
+	void MemoryAllocator::invalidate(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+	{
+		if (!allocation.m_coherent)
+		{
+			const VkMappedMemoryRange range = atom_range(allocation, offset, size);
+			vkInvalidateMappedMemoryRanges(m_device, 1, &range);
+		}
+	}
+
+	bool MemoryAllocator::unified() const
+	{
+		return m_unified;
+	}
+
+	bool MemoryAllocator::resizable_bar() const
+	{
+		return m_resizable_bar;
+	}
+
+	VkDeviceSize MemoryAllocator::allocated() const
+	{
+		std::lock_guard lock {m_mutex};
+		return m_allocated;
+	}
+
+	std::size_t MemoryAllocator::block_count() const
+	{
+		std::lock_guard lock {m_mutex};
+
+		std::size_t count = 0;
+		for (const auto& blocks : m_blocks)
+		{
+			count += std::count_if(blocks.begin(), blocks.end(), [](const Block& block) {
+				return block.m_memory != VK_NULL_HANDLE;
+			});
+		}
+
+		return count;
+	}
+
+	std::vector<std::uint32_t> MemoryAllocator::candidates(std::uint32_t type_bits, MemoryUsage usage) const
+	{
+		constexpr VkMemoryPropertyFlags DEVICE   = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		constexpr VkMemoryPropertyFlags VISIBLE  = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+		constexpr VkMemoryPropertyFlags COHERENT = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		constexpr VkMemoryPropertyFlags CACHED   = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+		// Zero copy where the hardware allows it: everything on unified memory, CPU written data on resizable BAR.
+		// Data only the GPU touches stays out of the BAR window on discrete GPUs.
+		TypePreference preference {};
+		switch (usage)
+		{
+			case MemoryUsage::GPU_ONLY:
+				preference = {DEVICE, m_unified ? (VISIBLE | COHERENT) : 0u, m_unified ? 0u : VISIBLE};
+				break;
+
+			case MemoryUsage::UPLOAD:
+				preference = {VISIBLE, COHERENT | ((m_unified || m_resizable_bar) ? DEVICE : 0u), 0u};
+				break;
+
+			case MemoryUsage::READBACK:
+				preference = {VISIBLE, CACHED | COHERENT, 0u};
+				break;
+
+			case MemoryUsage::STAGING:
+				preference = {VISIBLE, COHERENT, m_unified ? 0u : DEVICE};
+				break;
+		}
+
+		std::vector<std::pair<int, std::uint32_t>> scored;
+		for (std::uint32_t i = 0; i < m_properties.memoryTypeCount; i++)
+		{
+			const VkMemoryPropertyFlags flags = m_properties.memoryTypes[i].propertyFlags;
+			if ((type_bits & (1u << i)) && (flags & preference.m_required) == preference.m_required)
+			{
+				const int score = std::popcount(flags & preference.m_preferred) - 2 * std::popcount(flags & preference.m_avoided);
+				scored.emplace_back(score, i);
+			}
+		}
+
+		// Equal scores keep the driver's order, which lists faster types first.
+		std::stable_sort(scored.begin(), scored.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs.first > rhs.first;
+		});
+
+		std::vector<std::uint32_t> types;
+		types.reserve(scored.size());
+		for (const auto& [score, type] : scored)
+		{
+			types.push_back(type);
+		}
+
+		return types;
+	}
+
+	bool MemoryAllocator::try_allocate(std::uint32_t type, const VkMemoryRequirements& requirements, Allocation& allocation)
+	{
+		// Non-coherent allocations are atom aligned so flushing one never touches another's atoms.
+		const bool is_coherent   = coherent(type);
+		const VkDeviceSize align = is_coherent ? requirements.alignment : std::max(requirements.alignment, m_atom_size);
+		const VkDeviceSize size  = is_coherent ? requirements.size : align_up(requirements.size, m_atom_size);
+		auto& blocks             = m_blocks[type];
+
+		const auto place = [&](std::uint32_t index) {
+			Block& block = blocks[index];
+			for (auto it = block.m_free.begin(); it != block.m_free.end(); ++it)
+			{
+				const VkDeviceSize begin = align_up(it->m_offset, align);
+				const VkDeviceSize end   = it->m_offset + it->m_size;
+				if (begin + size > end)
+				{
+					continue;
+				}
+
+				// Split into the alignment padding before and the remainder after.
+				const Range before {it->m_offset, begin - it->m_offset};
+				const Range after {begin + size, end - begin - size};
+
+				it = block.m_free.erase(it);
+				if (after.m_size > 0)
+				{
+					it = block.m_free.insert(it, after);
+				}
+
+				if (before.m_size > 0)
+				{
+					block.m_free.insert(it, before);
+				}
+
+				// clang-format off
+				allocation = Allocation
+				{
+					.m_memory = block.m_memory,
+					.m_offset = begin,
+					.m_size = size,
+					.m_mapped = block.m_mapped ? block.m_mapped + begin : nullptr,
+					.m_type = type,
+					.m_block = index,
+					.m_coherent = is_coherent
+				};
+				// clang-format on
+
+				return true;
+			}
+
+			return false;
+		};
+
+		const bool dedicated = size > m_block_size / 2;
+		if (!dedicated)
+		{
+			for (std::uint32_t i = 0; i < blocks.size(); i++)
+			{
+				if (blocks[i].m_memory && !blocks[i].m_dedicated && place(i))
+				{
+					return true;
+				}
+			}
+		}
+
+		const std::optional<std::uint32_t> block = create_block(type, dedicated ? size : m_block_size, dedicated);
+		return block && place(*block);
+	}
+
+	std::optional<std::uint32_t> MemoryAllocator::create_block(std::uint32_t type, VkDeviceSize size, bool dedicated)
+	{
+		// clang-format off
+		VkMemoryAllocateInfo alloc_info
+		{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.allocationSize = size,
+			.memoryTypeIndex = type
+		};
+		// clang-format on
+
+		Block block;
+		if (vkAllocateMemory(m_device, &alloc_info, nullptr, &block.m_memory) != VK_SUCCESS)
+		{
+			// Heap is full, the caller moves on to the next memory type.
+			return std::nullopt;
+		}
+
+		if (m_properties.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			void* mapped = nullptr;
+			if (vkMapMemory(m_device, block.m_memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS)
+			{
+				vkFreeMemory(m_device, block.m_memory, nullptr);
+				return std::nullopt;
+			}
+
+			block.m_mapped = static_cast<std::byte*>(mapped);
+		}
+
+		block.m_size      = size;
+		block.m_dedicated = dedicated;
+		block.m_free.push_back({0, size});
+
+		auto& blocks    = m_blocks[type];
+		const auto slot = std::find_if(blocks.begin(), blocks.end(), [](const Block& entry) {
+			return entry.m_memory == VK_NULL_HANDLE;
+		});
+
+		if (slot != blocks.end())
+		{
+			*slot = std::move(block);
+			return static_cast<std::uint32_t>(slot - blocks.begin());
+		}
+
+		blocks.push_back(std::move(block));
+		return static_cast<std::uint32_t>(blocks.size() - 1);
+	}
+
+	bool MemoryAllocator::coherent(std::uint32_t type) const
+	{
+		return (m_properties.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+	}
+
+	VkMappedMemoryRange MemoryAllocator::atom_range(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+	{
+		if (size == VK_WHOLE_SIZE)
+		{
+			size = allocation.m_size - offset;
+		}
+
+		// Allocations are atom aligned in non-coherent memory, so rounding out stays inside this one.
+		const VkDeviceSize begin = align_down(allocation.m_offset + offset, m_atom_size);
+		const VkDeviceSize end   = std::min(align_up(allocation.m_offset + offset + size, m_atom_size), allocation.m_offset + allocation.m_size);
+
+		// clang-format off
+		return VkMappedMemoryRange
+		{
+			.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+			.pNext = nullptr,
+			.memory = allocation.m_memory,
+			.offset = begin,
+			.size = end - begin
+		};
+		// clang-format on
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,152 @@
+#ifndef VULKANO_GRAPHICS_MEMORYALLOCATOR_HPP_
+#define VULKANO_GRAPHICS_MEMORYALLOCATOR_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	///
+	/// How the CPU and GPU access a resource. Picks the memory type.
+	///
+	enum class MemoryUsage
+	{
+		///
+		/// Written by the GPU or uploaded once. Host visible only on unified memory, where that costs nothing.
+		///
+		GPU_ONLY,
+
+		///
+		/// Written by the CPU, often every frame, and read by the GPU. Device local when the CPU can reach that
+		/// memory directly (resizable BAR or unified memory).
+		///
+		UPLOAD,
+
+		///
+		/// Written by the GPU and read back by the CPU. Prefers cached memory.
+		///
+		READBACK,
+
+		///
+		/// Source of transfers. Kept out of device local memory on discrete GPUs.
+		///
+		STAGING
+	};
+
+	///
+	/// Range of a memory block. m_mapped is null unless the memory is host visible.
+	///
+	struct Allocation final
+	{
+		VkDeviceMemory m_memory = VK_NULL_HANDLE;
+		VkDeviceSize m_offset   = 0;
+		VkDeviceSize m_size     = 0;
+		std::byte* m_mapped     = nullptr;
+		std::uint32_t m_type    = 0;
+		std::uint32_t m_block   = 0;
+		bool m_coherent         = true;
+	};
+
+	///
+	/// Sub-allocates large VkDeviceMemory blocks, one list of blocks per memory type, so resources don't each cost a
+	/// vkAllocateMemory and stay well under maxMemoryAllocationCount. Host visible blocks are mapped once, when they
+	/// are created, and stay mapped.
+	///
+	/// Thread safe.
+	///
+	class MemoryAllocator final
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+		MemoryAllocator(VkDevice device, VkPhysicalDevice gpu, VkDeviceSize block_size = DEFAULT_BLOCK_SIZE);
+		~MemoryAllocator();
+
+		///
+		/// Requests larger than half a block get a block of their own.
+		///
+		[[nodiscard]] Allocation allocate(const VkMemoryRequirements& requirements, MemoryUsage usage);
+		void free(const Allocation& allocation);
+
+		///
+		/// Make host writes visible to the device, and device writes visible to the host. No-ops on coherent memory.
+		///
+		void flush(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+		void invalidate(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+		///
+		/// True on integrated GPUs, where device local memory is system memory and mapping it is free.
+		///
+		[[nodiscard]] bool unified() const;
+
+		///
+		/// True when a device local, host visible heap is larger than the classic 256MiB BAR window.
+		///
+		[[nodiscard]] bool resizable_bar() const;
+
+		[[nodiscard]] VkDeviceSize allocated() const;
+		[[nodiscard]] std::size_t block_count() const;
+
+	private:
+		MemoryAllocator() = delete;
+
+		struct Range final
+		{
+			VkDeviceSize m_offset;
+			VkDeviceSize m_size;
+		};
+
+		struct Block final
+		{
+			VkDeviceMemory m_memory = VK_NULL_HANDLE;
+			VkDeviceSize m_size     = 0;
+			std::byte* m_mapped     = nullptr;
+
+			///
+			/// Holds one large allocation, is never shared and is freed with it.
+			///
+			bool m_dedicated = false;
+
+			///
+			/// Sorted by offset, adjacent ranges are always merged.
+			///
+			std::vector<Range> m_free;
+		};
+
+		///
+		/// Memory types allowed by type_bits, best first.
+		///
+		[[nodiscard]] std::vector<std::uint32_t> candidates(std::uint32_t type_bits, MemoryUsage usage) const;
+
+		[[nodiscard]] bool try_allocate(std::uint32_t type, const VkMemoryRequirements& requirements, Allocation& allocation);
+
+		///
+		/// Index of the new block, or nothing when the heap is out of memory.
+		///
+		[[nodiscard]] std::optional<std::uint32_t> create_block(std::uint32_t type, VkDeviceSize size, bool dedicated);
+
+		[[nodiscard]] bool coherent(std::uint32_t type) const;
+		[[nodiscard]] VkMappedMemoryRange atom_range(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+		VkDevice m_device;
+		VkDeviceSize m_block_size;
+		VkDeviceSize m_atom_size;
+		bool m_unified;
+		bool m_resizable_bar;
+		VkPhysicalDeviceMemoryProperties m_properties;
+
+		mutable std::mutex m_mutex;
+
+		///
+		/// Indexed [memory type][block].
+		///
+		std::vector<std::vector<Block>> m_blocks;
+		VkDeviceSize m_allocated;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,338 @@
+#include <algorithm>
+
+#include <glm/matrix.hpp>
+
+#include "vulkano/core/Shader.hpp"
+#include "vulkano/graphics/BufferUploader.hpp"
+#include "vulkano/graphics/FrustumCuller.hpp"
+#include "vulkano/pipeline/DescriptorAllocator.hpp"
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/pipeline/Pipeline.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "MeshletCuller.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Workgroup sizes of meshlet_cull.comp and meshlet.task.
+		///
+		constexpr std::uint32_t CULL_GROUP_SIZE = 64;
+		constexpr std::uint32_t TASK_GROUP_SIZE = 32;
+
+		[[nodiscard]] Buffer storage_buffer(Instance* instance, VkDeviceSize size, VkBufferUsageFlags usage = 0, MemoryUsage memory = MemoryUsage::GPU_ONLY)
+		{
+			// clang-format off
+			BufferInfo info
+			{
+				.m_size = std::max<VkDeviceSize>(size, 4),
+				.m_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+				.m_memory = memory
+			};
+			// clang-format on
+
+			return Buffer {instance, info};
+		}
+
+		[[nodiscard]] Buffer readback_buffer(Instance* instance, VkDeviceSize size)
+		{
+			return Buffer {instance, {size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::READBACK}};
+		}
+
+		[[nodiscard]] DescriptorWrite storage_write(std::uint32_t binding, const Buffer& buffer)
+		{
+			return {binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, {buffer.vk_handle(), 0, VK_WHOLE_SIZE}};
+		}
+	} // namespace
+
+	MeshletCuller::MeshletCuller(Instance* instance, DescriptorAllocator& descriptors, const MeshletCuller::Settings& settings)
+	    : m_instance {instance}, m_descriptors {descriptors}, m_settings {settings}, m_mesh_shading {settings.m_mesh_shaders && instance->mesh_shading()}, m_meshlets {storage_buffer(instance, settings.m_max_meshlets * sizeof(GpuMeshlet))}, m_meshlet_count {0}, m_vertex_count {0}, m_triangle_count {0}, m_frame {0}, m_mesh_set_layout {VK_NULL_HANDLE}, m_draw_mesh_tasks {nullptr}
+	{
+		// Instance requires multiDrawIndirect and drawIndirectFirstInstance, the draw count is still limited.
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(m_instance->physical_device(), &properties);
+		if (m_settings.m_max_draws > properties.limits.maxDrawIndirectCount)
+		{
+			VK_LOG(VK_THROW, "Meshlet culler draws up to {0} commands, over the device's limit of {1}.", m_settings.m_max_draws, properties.limits.maxDrawIndirectCount);
+		}
+
+		if (m_mesh_shading)
+		{
+			m_meshlet_vertices  = std::make_unique<Buffer>(storage_buffer(instance, settings.m_max_meshlets * mesh::MAX_MESHLET_VERTICES * sizeof(std::uint32_t)));
+			m_meshlet_triangles = std::make_unique<Buffer>(storage_buffer(instance, settings.m_max_meshlets * mesh::MAX_MESHLET_TRIANGLES * sizeof(std::uint32_t)));
+
+			constexpr VkShaderStageFlags stages = VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+
+			// clang-format off
+			const std::array<VkDescriptorSetLayoutBinding, 7> bindings
+			{
+				VkDescriptorSetLayoutBinding {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages, nullptr},
+				VkDescriptorSetLayoutBinding {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages, nullptr},
+				VkDescriptorSetLayoutBinding {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages, nullptr},
+				VkDescriptorSetLayoutBinding {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages, nullptr},
+				VkDescriptorSetLayoutBinding {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages, nullptr},
+				VkDescriptorSetLayoutBinding {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_MESH_BIT_EXT, nullptr},
+				VkDescriptorSetLayoutBinding {6, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_MESH_BIT_EXT, nullptr}
+			};
+			// clang-format on
+
+			m_mesh_set_layout = m_descriptors.create_layout(bindings);
+			m_draw_mesh_tasks = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(vkGetDeviceProcAddr(m_instance->logical_device(), "vkCmdDrawMeshTasksEXT"));
+			if (!m_draw_mesh_tasks)
+			{
+				VK_LOG(VK_THROW, "Mesh shading is enabled but vkCmdDrawMeshTasksEXT could not be loaded.");
+			}
+
+			return;
+		}
+
+		// clang-format off
+		const std::array<VkDescriptorSetLayoutBinding, 3> bindings
+		{
+			VkDescriptorSetLayoutBinding {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+		};
+		// clang-format on
+
+		const VkDescriptorSetLayout layout = m_descriptors.create_layout(bindings);
+
+		// Modules are only needed while the pipeline is created.
+		const std::array<ShaderStage, 1> stages {ShaderStage {VK_SHADER_STAGE_COMPUTE_BIT, settings.m_cull_shader}};
+		const Shader shader {m_instance->logical_device(), stages};
+		m_cull_pipeline = std::make_unique<Pipeline>(m_instance, shader, std::span {&layout, 1}, static_cast<std::uint32_t>(sizeof(MeshletCullConstants)));
+
+		m_frames.reserve(settings.m_frames_in_flight);
+		for (std::uint32_t i = 0; i < settings.m_frames_in_flight; i++)
+		{
+			Frame frame {storage_buffer(instance, settings.m_max_draws * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT), storage_buffer(instance, sizeof(std::uint32_t), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT), readback_buffer(instance, sizeof(std::uint32_t)), VK_NULL_HANDLE};
+
+			const std::array<DescriptorWrite, 3> writes {storage_write(0, m_meshlets), storage_write(1, frame.m_draws), storage_write(2, frame.m_count)};
+			frame.m_set = m_descriptors.cached(layout, writes);
+
+			m_frames.push_back(std::move(frame));
+		}
+	}
+
+	MeshletCuller::~MeshletCuller()
+	{
+		// Every set this culler writes reads the meshlets.
+		m_descriptors.invalidate(m_meshlets.vk_handle());
+	}
+
+	MeshletCuller::MeshRange MeshletCuller::add(const mesh::MeshletData& meshlets, std::uint32_t first_index, BufferUploader& uploader)
+	{
+		const auto count = static_cast<std::uint32_t>(meshlets.m_meshlets.size());
+		if (m_meshlet_count + count > m_settings.m_max_meshlets)
+		{
+			VK_LOG(VK_THROW, "Meshlet buffer is full: {0} meshlets do not fit after {1} of {2}.", count, m_meshlet_count, m_settings.m_max_meshlets);
+		}
+
+		std::vector<GpuMeshlet> gpu_meshlets;
+		gpu_meshlets.reserve(count);
+
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			const mesh::Meshlet& meshlet      = meshlets.m_meshlets[i];
+			const mesh::MeshletBounds& bounds = meshlets.m_bounds[i];
+
+			// clang-format off
+			gpu_meshlets.push_back(GpuMeshlet {
+				.m_sphere = glm::vec4 {bounds.m_centre, bounds.m_radius},
+				.m_cone_apex = glm::vec4 {bounds.m_cone_apex, 0.0f},
+				.m_cone = glm::vec4 {bounds.m_cone_axis, bounds.m_cone_cutoff},
+				.m_first_index = first_index + meshlet.m_triangle_offset * 3,
+				.m_vertex_offset = m_vertex_count + meshlet.m_vertex_offset,
+				.m_triangle_offset = m_triangle_count + meshlet.m_triangle_offset,
+				.m_counts = meshlet.m_vertex_count | (meshlet.m_triangle_count << 8)
+			});
+			// clang-format on
+		}
+
+		uploader.upload(m_meshlets, m_meshlet_count * sizeof(GpuMeshlet), std::span<const GpuMeshlet> {gpu_meshlets});
+
+		if (m_mesh_shading)
+		{
+			const auto triangle_count = static_cast<std::uint32_t>(meshlets.m_triangles.size() / 3);
+
+			std::vector<std::uint32_t> triangles(triangle_count);
+			for (std::uint32_t i = 0; i < triangle_count; i++)
+			{
+				const std::uint8_t* triangle = &meshlets.m_triangles[i * 3];
+				triangles[i]                 = triangle[0] | (triangle[1] << 8) | (triangle[2] << 16);
+			}
+
+			uploader.upload(*m_meshlet_vertices, m_vertex_count * sizeof(std::uint32_t), std::span<const std::uint32_t> {meshlets.m_vertices});
+			uploader.upload(*m_meshlet_triangles, m_triangle_count * sizeof(std::uint32_t), std::span<const std::uint32_t> {triangles});
+
+			m_vertex_count += static_cast<std::uint32_t>(meshlets.m_vertices.size());
+			m_triangle_count += triangle_count;
+		}
+
+		const MeshRange range {m_meshlet_count, count};
+		m_meshlet_count += count;
+
+		return range;
+	}
+
+	void MeshletCuller::begin_frame(VkCommandBuffer cmd, std::uint32_t frame)
+	{
+		m_frame = frame;
+
+		BarrierBatch barriers;
+		if (m_mesh_shading)
+		{
+			barriers.buffer(m_meshlets.state(), ResourceUsage::MESH_STORAGE_READ);
+			barriers.buffer(m_meshlet_vertices->state(), ResourceUsage::MESH_STORAGE_READ);
+			barriers.buffer(m_meshlet_triangles->state(), ResourceUsage::MESH_STORAGE_READ);
+			barriers.flush(cmd);
+
+			return;
+		}
+
+		Frame& current = m_frames[frame];
+		barriers.buffer(current.m_count.state(), ResourceUsage::TRANSFER_DST);
+		barriers.buffer(current.m_draws.state(), ResourceUsage::TRANSFER_DST);
+		barriers.flush(cmd);
+
+		vkCmdFillBuffer(cmd, current.m_count.vk_handle(), 0, VK_WHOLE_SIZE, 0);
+
+		// Without an indirect count every command is drawn, and the unwritten ones have to be empty.
+		if (!m_instance->draw_indirect_count())
+		{
+			vkCmdFillBuffer(cmd, current.m_draws.vk_handle(), 0, VK_WHOLE_SIZE, 0);
+		}
+
+		barriers.buffer(m_meshlets.state(), ResourceUsage::STORAGE_READ);
+		barriers.buffer(current.m_count.state(), ResourceUsage::STORAGE_READ_WRITE);
+		barriers.buffer(current.m_draws.state(), ResourceUsage::STORAGE_WRITE);
+		barriers.flush(cmd);
+
+		m_cull_pipeline->bind(cmd);
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cull_pipeline->layout(), 0, 1, &current.m_set, 0, nullptr);
+	}
+
+	void MeshletCuller::cull(VkCommandBuffer cmd, const MeshletCuller::MeshRange& mesh, const glm::mat4& model, const glm::mat4& view_projection, const glm::vec3& camera, std::uint32_t instance, std::int32_t base_vertex)
+	{
+		if (mesh.m_meshlet_count == 0)
+		{
+			return;
+		}
+
+		// Dispatches only append through the atomic count, so they need no barriers between them.
+		MeshletCullConstants push = constants(mesh, model, view_projection, camera);
+		push.m_instance           = instance;
+		push.m_base_vertex        = base_vertex;
+
+		vkCmdPushConstants(cmd, m_cull_pipeline->layout(), VK_SHADER_STAGE_ALL, 0, sizeof(push), &push);
+		vkCmdDispatch(cmd, (mesh.m_meshlet_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+	}
+
+	void MeshletCuller::end_frame(VkCommandBuffer cmd)
+	{
+		if (m_mesh_shading)
+		{
+			return;
+		}
+
+		Frame& current = m_frames[m_frame];
+
+		BarrierBatch barriers;
+		barriers.buffer(current.m_count.state(), ResourceUsage::TRANSFER_SRC);
+		barriers.buffer(current.m_readback.state(), ResourceUsage::TRANSFER_DST);
+		barriers.flush(cmd);
+
+		const VkBufferCopy copy {0, 0, sizeof(std::uint32_t)};
+		vkCmdCopyBuffer(cmd, current.m_count.vk_handle(), current.m_readback.vk_handle(), 1, &copy);
+
+		barriers.buffer(current.m_draws.state(), ResourceUsage::INDIRECT_BUFFER);
+		barriers.buffer(current.m_count.state(), ResourceUsage::INDIRECT_BUFFER);
+		barriers.buffer(current.m_readback.state(), ResourceUsage::HOST_READ);
+		barriers.flush(cmd);
+	}
+
+	void MeshletCuller::draw(VkCommandBuffer cmd) const
+	{
+		const Frame& current = m_frames[m_frame];
+
+		if (m_instance->draw_indirect_count())
+		{
+			vkCmdDrawIndexedIndirectCount(cmd, current.m_draws.vk_handle(), 0, current.m_count.vk_handle(), 0, m_settings.m_max_draws, sizeof(VkDrawIndexedIndirectCommand));
+		}
+		else
+		{
+			vkCmdDrawIndexedIndirect(cmd, current.m_draws.vk_handle(), 0, m_settings.m_max_draws, sizeof(VkDrawIndexedIndirectCommand));
+		}
+	}
+
+	void MeshletCuller::draw_mesh_tasks(VkCommandBuffer cmd, const Pipeline& pipeline, VkDescriptorSet set, const MeshletCuller::MeshRange& mesh, const glm::mat4& model, std::uint32_t transform, const glm::mat4& view_projection, const glm::vec3& camera, std::int32_t base_vertex) const
+	{
+		if (mesh.m_meshlet_count == 0)
+		{
+			return;
+		}
+
+		MeshletCullConstants push = constants(mesh, model, view_projection, camera);
+		push.m_instance           = transform;
+		push.m_base_vertex        = base_vertex;
+
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout(), 0, 1, &set, 0, nullptr);
+		vkCmdPushConstants(cmd, pipeline.layout(), VK_SHADER_STAGE_ALL, 0, sizeof(push), &push);
+		m_draw_mesh_tasks(cmd, (mesh.m_meshlet_count + TASK_GROUP_SIZE - 1) / TASK_GROUP_SIZE, 1, 1);
+	}
+
+	VkDescriptorSet MeshletCuller::mesh_set(const Buffer& positions, const Buffer& attributes, const Buffer& transforms, const Buffer& view)
+	{
+		const std::array<DescriptorWrite, 7> writes {storage_write(0, m_meshlets), storage_write(1, *m_meshlet_vertices), storage_write(2, *m_meshlet_triangles), storage_write(3, positions), storage_write(4, attributes), storage_write(5, transforms), DescriptorWrite {6, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, {view.vk_handle(), 0, sizeof(glm::mat4)}}};
+
+		return m_descriptors.cached(m_mesh_set_layout, writes);
+	}
+
+	VkDescriptorSetLayout MeshletCuller::mesh_set_layout() const
+	{
+		return m_mesh_set_layout;
+	}
+
+	std::uint32_t MeshletCuller::visible_count(std::uint32_t frame) const
+	{
+		if (m_mesh_shading)
+		{
+			VK_LOG(VK_THROW, "Visible meshlets are only counted on the indexed path.");
+		}
+
+		const Buffer& count = m_frames[frame].m_readback;
+		count.invalidate();
+
+		std::uint32_t visible = 0;
+		std::copy_n(count.mapped(), sizeof(visible), reinterpret_cast<std::byte*>(&visible));
+
+		return std::min(visible, m_settings.m_max_draws);
+	}
+
+	bool MeshletCuller::mesh_shading() const
+	{
+		return m_mesh_shading;
+	}
+
+	MeshletCullConstants MeshletCuller::constants(const MeshletCuller::MeshRange& mesh, const glm::mat4& model, const glm::mat4& view_projection, const glm::vec3& camera) const
+	{
+		MeshletCullConstants push {};
+
+		// A plane moves into the model's space through the transpose, since dot(plane, model * p) = dot(transpose(model) * plane, p).
+		const glm::mat4 to_model = glm::transpose(model);
+		const auto planes        = frustum_planes(view_projection);
+		for (std::size_t i = 0; i < planes.size(); i++)
+		{
+			push.m_planes[i] = to_model * planes[i];
+		}
+
+		push.m_camera        = glm::vec3 {glm::inverse(model) * glm::vec4 {camera, 1.0f}};
+		push.m_first_meshlet = mesh.m_first_meshlet;
+		push.m_meshlet_count = mesh.m_meshlet_count;
+		push.m_max_draws     = m_settings.m_max_draws;
+
+		return push;
+	}
+} // namespace vulkano
\ No newline at end of file
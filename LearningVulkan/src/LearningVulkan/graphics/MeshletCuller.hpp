@@ -0,0 +1,222 @@
+#ifndef VULKANO_GRAPHICS_MESHLETCULLER_HPP_
+#define VULKANO_GRAPHICS_MESHLETCULLER_HPP_
+
+#include <array>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "vulkano/assets/Meshlets.hpp"
+#include "vulkano/graphics/Buffer.hpp"
+
+namespace vulkano
+{
+	class BufferUploader;
+	class DescriptorAllocator;
+	class Pipeline;
+
+	///
+	/// A meshlet as meshlet_common.glsl declares it (std430).
+	///
+	struct GpuMeshlet final
+	{
+		///
+		/// Centre and radius.
+		///
+		glm::vec4 m_sphere;
+		glm::vec4 m_cone_apex;
+
+		///
+		/// Axis and cutoff.
+		///
+		glm::vec4 m_cone;
+
+		///
+		/// First index of the meshlet's triangles in the index buffer, for the indexed path.
+		///
+		std::uint32_t m_first_index;
+
+		///
+		/// Into the meshlet vertex and triangle buffers, for the mesh shading path.
+		///
+		std::uint32_t m_vertex_offset;
+		std::uint32_t m_triangle_offset;
+
+		///
+		/// Vertex count in the low 8 bits, triangle count above.
+		///
+		std::uint32_t m_counts;
+	};
+
+	///
+	/// Push constants of the culling compute and task shaders. Planes and camera are in the mesh's space.
+	///
+	struct MeshletCullConstants final
+	{
+		std::array<glm::vec4, 6> m_planes;
+		glm::vec3 m_camera;
+		std::uint32_t m_first_meshlet;
+		std::uint32_t m_meshlet_count;
+
+		///
+		/// firstInstance of the indexed path's draws. The mesh shading path's transform id instead.
+		///
+		std::uint32_t m_instance;
+		std::int32_t m_base_vertex;
+		std::uint32_t m_max_draws;
+	};
+
+	static_assert(sizeof(GpuMeshlet) == 64 && sizeof(MeshletCullConstants) == 128);
+
+	///
+	/// Frustum and normal cone culling of meshlets on the GPU.
+	///
+	/// Without mesh shaders, a compute pass tests each meshlet and appends a VkDrawIndexedIndirectCommand for every
+	/// survivor to a per-frame buffer, and draw() issues them all with one vkCmdDrawIndexedIndirectCount. Every
+	/// mesh culled in a frame shares that buffer, so the whole frame is a single draw call. Only core compute and
+	/// storage buffers are needed, so this path also runs on software rasterisers such as lavapipe.
+	///
+	/// With VK_EXT_mesh_shader, a task shader runs the same test and launches mesh shader workgroups for the visible
+	/// meshlets only, which read the split_quantized() vertex streams themselves and transform them by the instance's
+	/// world matrix and the view's view projection.
+	///
+	class MeshletCuller final
+	{
+	public:
+		struct Settings final
+		{
+			std::uint32_t m_frames_in_flight;
+			std::uint32_t m_max_meshlets;
+
+			///
+			/// Visible meshlets a frame can draw on the indexed path. Survivors beyond it are dropped.
+			///
+			std::uint32_t m_max_draws;
+
+			///
+			/// SPIR-V of meshlet_cull.comp.
+			///
+			std::string_view m_cull_shader;
+
+			///
+			/// Take the mesh shading path when the device supports it.
+			///
+			bool m_mesh_shaders = true;
+		};
+
+		///
+		/// Meshlets of one mesh, as returned by add().
+		///
+		struct MeshRange final
+		{
+			std::uint32_t m_first_meshlet;
+			std::uint32_t m_meshlet_count;
+		};
+
+		MeshletCuller(Instance* instance, DescriptorAllocator& descriptors, const MeshletCuller::Settings& settings);
+		~MeshletCuller();
+
+		///
+		/// Uploads a mesh's meshlets. first_index is where the mesh's indices start in the index buffer draw() reads.
+		///
+		[[nodiscard]] MeshletCuller::MeshRange add(const mesh::MeshletData& meshlets, std::uint32_t first_index, BufferUploader& uploader);
+
+		///
+		/// Starts recording frame, resetting its draws. Must be recorded outside a render pass.
+		///
+		void begin_frame(VkCommandBuffer cmd, std::uint32_t frame);
+
+		///
+		/// Culls one instance of a mesh on the indexed path, appending its visible meshlets to the frame's draws.
+		/// Assumes model scales uniformly, since the normal cones do not survive anything else.
+		///
+		void cull(VkCommandBuffer cmd, const MeshletCuller::MeshRange& mesh, const glm::mat4& model, const glm::mat4& view_projection, const glm::vec3& camera, std::uint32_t instance, std::int32_t base_vertex);
+
+		///
+		/// Makes the frame's draws readable by draw(), and its count by visible_count(). Call after the last cull()
+		/// and outside a render pass.
+		///
+		void end_frame(VkCommandBuffer cmd);
+
+		///
+		/// Draws everything culled this frame. The graphics pipeline, vertex buffers and index buffer must be bound.
+		///
+		void draw(VkCommandBuffer cmd) const;
+
+		///
+		/// Culls and draws one instance of a mesh on the mesh shading path. pipeline's first set must use
+		/// mesh_set_layout(), and its push constants MeshletCullConstants. model is the world matrix stored at
+		/// transform in the set's transforms, and view_projection the one in its view.
+		///
+		void draw_mesh_tasks(VkCommandBuffer cmd, const Pipeline& pipeline, VkDescriptorSet set, const MeshletCuller::MeshRange& mesh, const glm::mat4& model, std::uint32_t transform, const glm::mat4& view_projection, const glm::vec3& camera, std::int32_t base_vertex) const;
+
+		///
+		/// Set for the mesh shading path, reading vertices from the two split_quantized() streams. transforms holds
+		/// world matrices indexed by transform id (TransformSystem::world_buffer()), and view is a uniform buffer
+		/// starting with the view projection matrix. The set is cached, so invalidate() these buffers on the
+		/// DescriptorAllocator before releasing them.
+		///
+		[[nodiscard]] VkDescriptorSet mesh_set(const Buffer& positions, const Buffer& attributes, const Buffer& transforms, const Buffer& view);
+		[[nodiscard]] VkDescriptorSetLayout mesh_set_layout() const;
+
+		///
+		/// Meshlets that passed culling on the indexed path in frame, once its fence has signalled. Meant for
+		/// statistics and validation rather than anything the frame depends on. Throws on the mesh shading path,
+		/// which keeps no count.
+		///
+		[[nodiscard]] std::uint32_t visible_count(std::uint32_t frame) const;
+
+		[[nodiscard]] bool mesh_shading() const;
+
+	private:
+		MeshletCuller() = delete;
+		MeshletCuller(const MeshletCuller&) = delete;
+		MeshletCuller& operator=(const MeshletCuller&) = delete;
+
+		struct Frame final
+		{
+			Buffer m_draws;
+
+			///
+			/// Device memory, appended to by the culling shader and read by the indirect draw.
+			///
+			Buffer m_count;
+
+			///
+			/// Copy of the count in readback memory, for visible_count().
+			///
+			Buffer m_readback;
+			VkDescriptorSet m_set;
+		};
+
+		[[nodiscard]] MeshletCullConstants constants(const MeshletCuller::MeshRange& mesh, const glm::mat4& model, const glm::mat4& view_projection, const glm::vec3& camera) const;
+
+		Instance* m_instance;
+		DescriptorAllocator& m_descriptors;
+		MeshletCuller::Settings m_settings;
+		bool m_mesh_shading;
+
+		Buffer m_meshlets;
+		std::uint32_t m_meshlet_count;
+
+		///
+		/// Mesh shading path only: meshlet vertex indices, and triangles packed as three bytes per uint.
+		///
+		std::unique_ptr<Buffer> m_meshlet_vertices;
+		std::unique_ptr<Buffer> m_meshlet_triangles;
+		std::uint32_t m_vertex_count;
+		std::uint32_t m_triangle_count;
+
+		///
+		/// Indexed path only.
+		///
+		std::unique_ptr<Pipeline> m_cull_pipeline;
+		std::vector<Frame> m_frames;
+		std::uint32_t m_frame;
+
+		VkDescriptorSetLayout m_mesh_set_layout;
+		PFN_vkCmdDrawMeshTasksEXT m_draw_mesh_tasks;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,727 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <numbers>
+#include <numeric>
+
+#include <glm/gtc/packing.hpp>
+
+#include "vulkano/utils/CpuFeatures.hpp"
+
+#if defined(VULKANO_X86)
+	#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VULKANO_MIP_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define VULKANO_MIP_NEON
+	#include <arm_neon.h>
+#endif
+
+#include "vulkano/utils/Log.hpp"
+
+#include "MipChain.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Kaiser window shape and support, in destination texels.
+		///
+		constexpr float KAISER_ALPHA  = 4.0f;
+		constexpr float KAISER_RADIUS = 2.0f;
+
+		///
+		/// Rows are handed to worker threads in blocks this size, which keeps scheduling overhead low on small levels.
+		///
+		constexpr std::uint32_t ROWS_PER_TASK = 16;
+
+		///
+		/// Precomputed separable filter for one axis of one level.
+		/// Every destination texel has m_taps_per_texel (clamped) source indices and matching weights.
+		///
+		struct FilterTaps final
+		{
+			std::uint32_t m_taps_per_texel = 0;
+			std::vector<std::uint32_t> m_indices;
+			std::vector<float> m_weights;
+		};
+
+		[[nodiscard]] float bessel_i0(float x)
+		{
+			float sum  = 1.0f;
+			float term = 1.0f;
+			for (int k = 1; k < 32; k++)
+			{
+				const float half_x = x / (2.0f * static_cast<float>(k));
+				term *= half_x * half_x;
+				sum += term;
+
+				if (term < sum * 1e-8f)
+				{
+					break;
+				}
+			}
+
+			return sum;
+		}
+
+		[[nodiscard]] float sinc(float x)
+		{
+			if (std::abs(x) < 1e-5f)
+			{
+				return 1.0f;
+			}
+
+			const float pi_x = std::numbers::pi_v<float> * x;
+			return std::sin(pi_x) / pi_x;
+		}
+
+		[[nodiscard]] float kaiser_window(float x)
+		{
+			if (std::abs(x) >= 1.0f)
+			{
+				return 0.0f;
+			}
+
+			return bessel_i0(KAISER_ALPHA * std::sqrt(1.0f - x * x)) / bessel_i0(KAISER_ALPHA);
+		}
+
+		[[nodiscard]] FilterTaps build_taps(std::uint32_t src_size, std::uint32_t dst_size, MipFilter filter)
+		{
+			const float scale  = static_cast<float>(src_size) / static_cast<float>(dst_size);
+			const float radius = (filter == MipFilter::BOX) ? scale * 0.5f : KAISER_RADIUS * scale;
+
+			// Texel i covers [i, i + 1) in source space, so texel x of the destination reads [first, last].
+			const auto footprint = [&](std::uint32_t x) {
+				const float center = (static_cast<float>(x) + 0.5f) * scale;
+				const int first    = static_cast<int>(std::floor(center - radius));
+				const int last     = static_cast<int>(std::ceil(center + radius)) - 1;
+				return std::make_pair(first, last);
+			};
+
+			FilterTaps taps;
+			for (std::uint32_t x = 0; x < dst_size; x++)
+			{
+				const auto [first, last] = footprint(x);
+				taps.m_taps_per_texel    = std::max(taps.m_taps_per_texel, static_cast<std::uint32_t>(last - first + 1));
+			}
+
+			taps.m_indices.resize(static_cast<std::size_t>(dst_size) * taps.m_taps_per_texel, 0);
+			taps.m_weights.resize(static_cast<std::size_t>(dst_size) * taps.m_taps_per_texel, 0.0f);
+
+			for (std::uint32_t x = 0; x < dst_size; x++)
+			{
+				const float center = (static_cast<float>(x) + 0.5f) * scale;
+				const int first    = footprint(x).first;
+
+				float total = 0.0f;
+				for (std::uint32_t k = 0; k < taps.m_taps_per_texel; k++)
+				{
+					const int i = first + static_cast<int>(k);
+
+					float weight = 0.0f;
+					if (filter == MipFilter::BOX)
+					{
+						const float lo = std::max(static_cast<float>(i), center - radius);
+						const float hi = std::min(static_cast<float>(i + 1), center + radius);
+						weight         = std::max(0.0f, hi - lo);
+					}
+					else
+					{
+						const float t = (static_cast<float>(i) + 0.5f - center) / scale;
+						weight        = sinc(t) * kaiser_window(t / KAISER_RADIUS);
+					}
+
+					const std::size_t slot = static_cast<std::size_t>(x) * taps.m_taps_per_texel + k;
+					taps.m_indices[slot]   = static_cast<std::uint32_t>(std::clamp(i, 0, static_cast<int>(src_size) - 1));
+					taps.m_weights[slot]   = weight;
+					total += weight;
+				}
+
+				for (std::uint32_t k = 0; k < taps.m_taps_per_texel; k++)
+				{
+					taps.m_weights[static_cast<std::size_t>(x) * taps.m_taps_per_texel + k] /= total;
+				}
+			}
+
+			return taps;
+		}
+
+		///
+		/// sRGB transfer curve tables. Decoding is a direct lookup. Encoding starts from a coarse guess and walks the
+		/// linear values halfway between neighbouring codes, so it rounds exactly in sRGB space.
+		///
+		struct SrgbTables final
+		{
+			std::array<float, 256> m_to_linear;
+			std::array<float, 255> m_thresholds;
+			std::array<std::uint8_t, 4096> m_guess;
+
+			SrgbTables()
+			{
+				const auto decode = [](float srgb) {
+					return (srgb <= 0.04045f) ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+				};
+
+				for (std::size_t i = 0; i < m_to_linear.size(); i++)
+				{
+					m_to_linear[i] = decode(static_cast<float>(i) / 255.0f);
+				}
+
+				for (std::size_t i = 0; i < m_thresholds.size(); i++)
+				{
+					m_thresholds[i] = decode((static_cast<float>(i) + 0.5f) / 255.0f);
+				}
+
+				for (std::size_t i = 0; i < m_guess.size(); i++)
+				{
+					const float linear = static_cast<float>(i) / static_cast<float>(m_guess.size() - 1);
+					m_guess[i]         = static_cast<std::uint8_t>(std::lower_bound(m_thresholds.begin(), m_thresholds.end(), linear) - m_thresholds.begin());
+				}
+			}
+
+			[[nodiscard]] std::uint8_t to_srgb(float linear) const
+			{
+				linear = std::clamp(linear, 0.0f, 1.0f);
+
+				std::uint32_t code = m_guess[static_cast<std::size_t>(linear * static_cast<float>(m_guess.size() - 1))];
+				while (code < m_thresholds.size() && m_thresholds[code] < linear)
+				{
+					code++;
+				}
+
+				return static_cast<std::uint8_t>(code);
+			}
+		};
+
+		[[nodiscard]] const SrgbTables& srgb_tables()
+		{
+			static const SrgbTables s_tables;
+			return s_tables;
+		}
+
+#if defined(VULKANO_X86)
+		// Kernels beyond the SSE2 baseline, compiled for their own instruction set and only called once
+		// cpu_features() has found it. Each returns how many elements it covered, leaving the rest to the caller.
+
+		VULKANO_TARGET("avx,f16c") std::uint32_t decode_half_f16c(const std::byte* src, std::uint32_t width, float* dst)
+		{
+			std::uint32_t x = 0;
+			for (; x + 2 <= width; x += 2)
+			{
+				const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + static_cast<std::size_t>(x) * 8));
+				_mm256_storeu_ps(dst + x * 4, _mm256_cvtph_ps(halves));
+			}
+
+			return x;
+		}
+
+		VULKANO_TARGET("avx,f16c") std::uint32_t encode_half_f16c(const float* src, std::uint32_t width, std::byte* dst)
+		{
+			std::uint32_t x = 0;
+			for (; x + 2 <= width; x += 2)
+			{
+				const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(src + x * 4), _MM_FROUND_TO_NEAREST_INT);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + static_cast<std::size_t>(x) * 8), halves);
+			}
+
+			return x;
+		}
+
+		VULKANO_TARGET("avx2") std::size_t madd_avx2(float* acc, const float* src, float weight, std::size_t count)
+		{
+			std::size_t i   = 0;
+			const __m256 w8 = _mm256_set1_ps(weight);
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), w8)));
+			}
+
+			return i;
+		}
+
+		///
+		/// 8 output pixels at a time: widen 4 source pixels to 16 bits, sum the two rows, then fold pixel pairs.
+		///
+		VULKANO_TARGET("avx2") std::uint32_t box_row_avx2(const std::uint8_t* a, const std::uint8_t* b, std::uint8_t* out, std::uint32_t width)
+		{
+			std::uint32_t x      = 0;
+			const __m128i round8 = _mm_set1_epi16(2);
+			for (; x + 8 <= width; x += 8)
+			{
+				__m128i folded[4];
+				for (int i = 0; i < 4; i++)
+				{
+					const __m128i ra = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + (x * 2 + i * 4) * 4));
+					const __m128i rb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + (x * 2 + i * 4) * 4));
+
+					const __m256i sum  = _mm256_add_epi16(_mm256_cvtepu8_epi16(ra), _mm256_cvtepu8_epi16(rb));
+					const __m256i pair = _mm256_permute4x64_epi64(sum, 0b11011000);
+					folded[i]          = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm256_castsi256_si128(pair), _mm256_extracti128_si256(pair, 1)), round8), 2);
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4 + 0), _mm_packus_epi16(folded[0], folded[1]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4 + 16), _mm_packus_epi16(folded[2], folded[3]));
+			}
+
+			return x;
+		}
+#endif
+
+		///
+		/// Converts one row to linear RGBA floats.
+		///
+		void decode_row(const std::byte* src, VkFormat format, std::uint32_t width, float* dst)
+		{
+			if (format == VK_FORMAT_R8G8B8A8_SRGB)
+			{
+				const auto& tables = srgb_tables();
+				const auto* bytes  = reinterpret_cast<const std::uint8_t*>(src);
+				for (std::uint32_t i = 0; i < width * 4; i += 4)
+				{
+					dst[i + 0] = tables.m_to_linear[bytes[i + 0]];
+					dst[i + 1] = tables.m_to_linear[bytes[i + 1]];
+					dst[i + 2] = tables.m_to_linear[bytes[i + 2]];
+					dst[i + 3] = static_cast<float>(bytes[i + 3]) * (1.0f / 255.0f);
+				}
+			}
+			else if (format == VK_FORMAT_R8G8B8A8_UNORM)
+			{
+				const auto* bytes = reinterpret_cast<const std::uint8_t*>(src);
+				std::uint32_t x   = 0;
+
+#if defined(VULKANO_MIP_SSE2)
+				const __m128i zero  = _mm_setzero_si128();
+				const __m128 to_one = _mm_set1_ps(1.0f / 255.0f);
+				for (; x + 4 <= width; x += 4)
+				{
+					const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + x * 4));
+					const __m128i lo     = _mm_unpacklo_epi8(pixels, zero);
+					const __m128i hi     = _mm_unpackhi_epi8(pixels, zero);
+
+					_mm_storeu_ps(dst + x * 4 + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), to_one));
+					_mm_storeu_ps(dst + x * 4 + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), to_one));
+					_mm_storeu_ps(dst + x * 4 + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), to_one));
+					_mm_storeu_ps(dst + x * 4 + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), to_one));
+				}
+#elif defined(VULKANO_MIP_NEON)
+				const float32x4_t to_one = vdupq_n_f32(1.0f / 255.0f);
+				for (; x + 4 <= width; x += 4)
+				{
+					const uint8x16_t pixels = vld1q_u8(bytes + x * 4);
+					const uint16x8_t lo     = vmovl_u8(vget_low_u8(pixels));
+					const uint16x8_t hi     = vmovl_u8(vget_high_u8(pixels));
+
+					vst1q_f32(dst + x * 4 + 0, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), to_one));
+					vst1q_f32(dst + x * 4 + 4, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), to_one));
+					vst1q_f32(dst + x * 4 + 8, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), to_one));
+					vst1q_f32(dst + x * 4 + 12, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), to_one));
+				}
+#endif
+
+				for (std::uint32_t i = x * 4; i < width * 4; i++)
+				{
+					dst[i] = static_cast<float>(bytes[i]) * (1.0f / 255.0f);
+				}
+			}
+			else
+			{
+				std::uint32_t x = 0;
+
+#if defined(VULKANO_X86)
+				if (cpu_features().m_f16c)
+				{
+					x = decode_half_f16c(src, width, dst);
+				}
+#endif
+
+				const auto* halves = reinterpret_cast<const std::uint16_t*>(src);
+				for (std::uint32_t i = x * 4; i < width * 4; i++)
+				{
+					dst[i] = glm::unpackHalf1x16(halves[i]);
+				}
+			}
+		}
+
+		///
+		/// Converts one row of linear RGBA floats back into the chain format.
+		///
+		void encode_row(const float* src, VkFormat format, std::uint32_t width, std::byte* dst)
+		{
+			if (format == VK_FORMAT_R8G8B8A8_SRGB)
+			{
+				const auto& tables = srgb_tables();
+				auto* bytes        = reinterpret_cast<std::uint8_t*>(dst);
+				for (std::uint32_t i = 0; i < width * 4; i += 4)
+				{
+					bytes[i + 0] = tables.to_srgb(src[i + 0]);
+					bytes[i + 1] = tables.to_srgb(src[i + 1]);
+					bytes[i + 2] = tables.to_srgb(src[i + 2]);
+					bytes[i + 3] = static_cast<std::uint8_t>(std::clamp(src[i + 3], 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+			}
+			else if (format == VK_FORMAT_R8G8B8A8_UNORM)
+			{
+				auto* bytes     = reinterpret_cast<std::uint8_t*>(dst);
+				std::uint32_t x = 0;
+
+#if defined(VULKANO_MIP_SSE2)
+				const __m128 zero    = _mm_setzero_ps();
+				const __m128 one     = _mm_set1_ps(1.0f);
+				const __m128 to_byte = _mm_set1_ps(255.0f);
+				const __m128 half    = _mm_set1_ps(0.5f);
+				const auto quantize  = [&](const float* pixel) {
+					return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pixel), zero), one), to_byte), half));
+				};
+
+				for (; x + 4 <= width; x += 4)
+				{
+					const __m128i lo = _mm_packs_epi32(quantize(src + x * 4 + 0), quantize(src + x * 4 + 4));
+					const __m128i hi = _mm_packs_epi32(quantize(src + x * 4 + 8), quantize(src + x * 4 + 12));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + x * 4), _mm_packus_epi16(lo, hi));
+				}
+#endif
+
+				for (std::uint32_t i = x * 4; i < width * 4; i++)
+				{
+					bytes[i] = static_cast<std::uint8_t>(std::clamp(src[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+			}
+			else
+			{
+				std::uint32_t x = 0;
+
+#if defined(VULKANO_X86)
+				if (cpu_features().m_f16c)
+				{
+					x = encode_half_f16c(src, width, dst);
+				}
+#endif
+
+				auto* halves = reinterpret_cast<std::uint16_t*>(dst);
+				for (std::uint32_t i = x * 4; i < width * 4; i++)
+				{
+					halves[i] = glm::packHalf1x16(src[i]);
+				}
+			}
+		}
+
+		///
+		/// acc += src * weight over count floats.
+		///
+		void madd_row(float* acc, const float* src, float weight, std::size_t count)
+		{
+			std::size_t i = 0;
+
+#if defined(VULKANO_X86)
+			if (cpu_features().m_avx2)
+			{
+				i = madd_avx2(acc, src, weight, count);
+			}
+#endif
+
+#if defined(VULKANO_MIP_SSE2)
+			const __m128 w4 = _mm_set1_ps(weight);
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(src + i), w4)));
+			}
+#elif defined(VULKANO_MIP_NEON)
+			for (; i + 4 <= count; i += 4)
+			{
+				vst1q_f32(acc + i, vmlaq_n_f32(vld1q_f32(acc + i), vld1q_f32(src + i), weight));
+			}
+#endif
+
+			for (; i < count; i++)
+			{
+				acc[i] += src[i] * weight;
+			}
+		}
+
+		///
+		/// Applies the horizontal taps to a vertically filtered row. One RGBA pixel maps to one 4-wide vector.
+		///
+		void filter_horizontal(const float* src, const FilterTaps& taps, std::uint32_t width, float* dst)
+		{
+			for (std::uint32_t x = 0; x < width; x++)
+			{
+				const std::uint32_t* indices = taps.m_indices.data() + static_cast<std::size_t>(x) * taps.m_taps_per_texel;
+				const float* weights         = taps.m_weights.data() + static_cast<std::size_t>(x) * taps.m_taps_per_texel;
+
+#if defined(VULKANO_MIP_SSE2)
+				__m128 sum = _mm_setzero_ps();
+				for (std::uint32_t k = 0; k < taps.m_taps_per_texel; k++)
+				{
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + indices[k] * 4), _mm_set1_ps(weights[k])));
+				}
+				_mm_storeu_ps(dst + x * 4, sum);
+#elif defined(VULKANO_MIP_NEON)
+				float32x4_t sum = vdupq_n_f32(0.0f);
+				for (std::uint32_t k = 0; k < taps.m_taps_per_texel; k++)
+				{
+					sum = vmlaq_n_f32(sum, vld1q_f32(src + indices[k] * 4), weights[k]);
+				}
+				vst1q_f32(dst + x * 4, sum);
+#else
+				float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+				for (std::uint32_t k = 0; k < taps.m_taps_per_texel; k++)
+				{
+					for (std::uint32_t c = 0; c < 4; c++)
+					{
+						sum[c] += src[indices[k] * 4 + c] * weights[k];
+					}
+				}
+				std::memcpy(dst + x * 4, sum, sizeof(sum));
+#endif
+			}
+		}
+
+		///
+		/// Splits rows into blocks and processes them on the standard library's parallel backend.
+		///
+		template<typename Func>
+		void parallel_rows(std::uint32_t rows, Func&& func)
+		{
+			std::vector<std::uint32_t> tasks((rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK);
+			std::iota(tasks.begin(), tasks.end(), 0);
+
+			std::for_each(std::execution::par, tasks.begin(), tasks.end(), [&](std::uint32_t task) {
+				const std::uint32_t begin = task * ROWS_PER_TASK;
+				func(begin, std::min(rows, begin + ROWS_PER_TASK));
+			});
+		}
+	} // namespace
+
+	MipChain::MipChain(std::span<const std::byte> base, const MipChain::Settings& settings)
+	    : m_format {settings.m_format}, m_filter {settings.m_filter}, m_pixel_size {0}
+	{
+		if (!supports(m_format))
+		{
+			VK_LOG(VK_THROW, "Unsupported format for CPU mip generation: {0}.", static_cast<int>(m_format));
+		}
+
+		m_pixel_size = (m_format == VK_FORMAT_R16G16B16A16_SFLOAT) ? 8 : 4;
+
+		std::uint32_t count = full_level_count(settings.m_width, settings.m_height);
+		if (settings.m_max_levels != 0)
+		{
+			count = std::min(count, settings.m_max_levels);
+		}
+
+		std::size_t total = 0;
+		m_levels.reserve(count);
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			MipLevel level {
+			    .m_width  = std::max(1u, settings.m_width >> i),
+			    .m_height = std::max(1u, settings.m_height >> i),
+			    .m_offset = total,
+			    .m_size   = 0};
+			level.m_size = static_cast<std::size_t>(level.m_width) * level.m_height * m_pixel_size;
+
+			total += level.m_size;
+			m_levels.push_back(level);
+		}
+
+		if (base.size() != m_levels[0].m_size)
+		{
+			VK_LOG(VK_THROW, "Mip chain base image is {0} bytes, expected {1}.", base.size(), m_levels[0].m_size);
+		}
+
+		m_data.resize(total);
+		std::memcpy(m_data.data(), base.data(), base.size());
+
+		// Each level is filtered from the previous one, so levels run in order and rows within a level run in parallel.
+		for (std::uint32_t i = 1; i < count; i++)
+		{
+			const auto& src = m_levels[i - 1];
+			const auto& dst = m_levels[i];
+
+			const bool exact_half = (src.m_width == dst.m_width * 2) && (src.m_height == dst.m_height * 2);
+			if (m_filter == MipFilter::BOX && m_format == VK_FORMAT_R8G8B8A8_UNORM && exact_half)
+			{
+				box_rgba8(src, dst);
+			}
+			else
+			{
+				filter_level(src, dst);
+			}
+		}
+	}
+
+	VkFormat MipChain::format() const
+	{
+		return m_format;
+	}
+
+	std::uint32_t MipChain::level_count() const
+	{
+		return static_cast<std::uint32_t>(m_levels.size());
+	}
+
+	const MipLevel& MipChain::level(std::uint32_t index) const
+	{
+		return m_levels[index];
+	}
+
+	std::span<const std::byte> MipChain::level_data(std::uint32_t index) const
+	{
+		return {m_data.data() + m_levels[index].m_offset, m_levels[index].m_size};
+	}
+
+	std::span<const std::byte> MipChain::data() const
+	{
+		return m_data;
+	}
+
+	bool MipChain::supports(VkFormat format)
+	{
+		return format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_R16G16B16A16_SFLOAT;
+	}
+
+	std::uint32_t MipChain::full_level_count(std::uint32_t width, std::uint32_t height)
+	{
+		std::uint32_t count = 1;
+		for (std::uint32_t size = std::max(width, height); size > 1; size >>= 1)
+		{
+			count++;
+		}
+
+		return count;
+	}
+
+	void MipChain::box_rgba8(const MipLevel& src, const MipLevel& dst)
+	{
+		const std::size_t src_pitch = static_cast<std::size_t>(src.m_width) * 4;
+		const std::size_t dst_pitch = static_cast<std::size_t>(dst.m_width) * 4;
+
+		const auto* src_data = reinterpret_cast<const std::uint8_t*>(m_data.data() + src.m_offset);
+		auto* dst_data       = reinterpret_cast<std::uint8_t*>(m_data.data() + dst.m_offset);
+
+#if defined(VULKANO_X86)
+		const bool avx2 = cpu_features().m_avx2;
+#endif
+
+		parallel_rows(dst.m_height, [&](std::uint32_t begin, std::uint32_t end) {
+			for (std::uint32_t y = begin; y < end; y++)
+			{
+				const std::uint8_t* a = src_data + (static_cast<std::size_t>(y) * 2) * src_pitch;
+				const std::uint8_t* b = a + src_pitch;
+				std::uint8_t* out     = dst_data + y * dst_pitch;
+
+				std::uint32_t x = 0;
+
+#if defined(VULKANO_X86)
+				if (avx2)
+				{
+					x = box_row_avx2(a, b, out, dst.m_width);
+				}
+#endif
+
+#if defined(VULKANO_MIP_SSE2)
+				const __m128i zero   = _mm_setzero_si128();
+				const __m128i round4 = _mm_set1_epi16(2);
+				for (; x + 4 <= dst.m_width; x += 4)
+				{
+					const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x * 8));
+					const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x * 8 + 16));
+					const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x * 8));
+					const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x * 8 + 16));
+
+					// Each register holds two source pixels as 16-bit channels.
+					const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+					const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+					const __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+					const __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+					const __m128i q01 = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+					const __m128i q23 = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+
+					const __m128i lo = _mm_srli_epi16(_mm_add_epi16(q01, round4), 2);
+					const __m128i hi = _mm_srli_epi16(_mm_add_epi16(q23, round4), 2);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(lo, hi));
+				}
+#elif defined(VULKANO_MIP_NEON)
+				for (; x + 4 <= dst.m_width; x += 4)
+				{
+					const uint8x16_t a0 = vld1q_u8(a + x * 8);
+					const uint8x16_t a1 = vld1q_u8(a + x * 8 + 16);
+					const uint8x16_t b0 = vld1q_u8(b + x * 8);
+					const uint8x16_t b1 = vld1q_u8(b + x * 8 + 16);
+
+					const uint16x8_t s0 = vaddl_u8(vget_low_u8(a0), vget_low_u8(b0));
+					const uint16x8_t s1 = vaddl_u8(vget_high_u8(a0), vget_high_u8(b0));
+					const uint16x8_t s2 = vaddl_u8(vget_low_u8(a1), vget_low_u8(b1));
+					const uint16x8_t s3 = vaddl_u8(vget_high_u8(a1), vget_high_u8(b1));
+
+					const uint16x8_t q01 = vcombine_u16(vadd_u16(vget_low_u16(s0), vget_high_u16(s0)), vadd_u16(vget_low_u16(s1), vget_high_u16(s1)));
+					const uint16x8_t q23 = vcombine_u16(vadd_u16(vget_low_u16(s2), vget_high_u16(s2)), vadd_u16(vget_low_u16(s3), vget_high_u16(s3)));
+
+					vst1q_u8(out + x * 4, vcombine_u8(vrshrn_n_u16(q01, 2), vrshrn_n_u16(q23, 2)));
+				}
+#endif
+
+				for (; x < dst.m_width; x++)
+				{
+					for (std::uint32_t c = 0; c < 4; c++)
+					{
+						const std::uint32_t sum = a[x * 8 + c] + a[x * 8 + 4 + c] + b[x * 8 + c] + b[x * 8 + 4 + c];
+						out[x * 4 + c]          = static_cast<std::uint8_t>((sum + 2) >> 2);
+					}
+				}
+			}
+		});
+	}
+
+	void MipChain::filter_level(const MipLevel& src, const MipLevel& dst)
+	{
+		const FilterTaps horizontal = build_taps(src.m_width, dst.m_width, m_filter);
+		const FilterTaps vertical   = build_taps(src.m_height, dst.m_height, m_filter);
+
+		const std::size_t src_pitch  = static_cast<std::size_t>(src.m_width) * m_pixel_size;
+		const std::size_t dst_pitch  = static_cast<std::size_t>(dst.m_width) * m_pixel_size;
+		const std::size_t row_floats = static_cast<std::size_t>(src.m_width) * 4;
+
+		const std::byte* src_data = m_data.data() + src.m_offset;
+		std::byte* dst_data       = m_data.data() + dst.m_offset;
+
+		parallel_rows(dst.m_height, [&](std::uint32_t begin, std::uint32_t end) {
+			// Decode every source row this block touches once, rather than once per tap.
+			const auto first_tap   = vertical.m_indices.begin() + static_cast<std::ptrdiff_t>(begin) * vertical.m_taps_per_texel;
+			const auto last_tap    = vertical.m_indices.begin() + static_cast<std::ptrdiff_t>(end) * vertical.m_taps_per_texel;
+			const std::uint32_t lo = *std::min_element(first_tap, last_tap);
+			const std::uint32_t hi = *std::max_element(first_tap, last_tap);
+
+			std::vector<float> rows((hi - lo + 1) * row_floats);
+			for (std::uint32_t r = lo; r <= hi; r++)
+			{
+				decode_row(src_data + r * src_pitch, m_format, src.m_width, rows.data() + (r - lo) * row_floats);
+			}
+
+			std::vector<float> column(row_floats);
+			std::vector<float> out(static_cast<std::size_t>(dst.m_width) * 4);
+			for (std::uint32_t y = begin; y < end; y++)
+			{
+				std::fill(column.begin(), column.end(), 0.0f);
+				for (std::uint32_t k = 0; k < vertical.m_taps_per_texel; k++)
+				{
+					const std::size_t slot = static_cast<std::size_t>(y) * vertical.m_taps_per_texel + k;
+					if (vertical.m_weights[slot] != 0.0f)
+					{
+						madd_row(column.data(), rows.data() + (vertical.m_indices[slot] - lo) * row_floats, vertical.m_weights[slot], row_floats);
+					}
+				}
+
+				filter_horizontal(column.data(), horizontal, dst.m_width, out.data());
+				encode_row(out.data(), m_format, dst.m_width, dst_data + y * dst_pitch);
+			}
+		});
+	}
+} // namespace vulkano
\ No newline at end of file
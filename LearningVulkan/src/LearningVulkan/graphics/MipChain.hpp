@@ -0,0 +1,79 @@
+#ifndef VULKANO_GRAPHICS_MIPCHAIN_HPP_
+#define VULKANO_GRAPHICS_MIPCHAIN_HPP_
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	///
+	/// Downsampling kernel used when building a mip chain.
+	///
+	enum class MipFilter
+	{
+		BOX,
+		KAISER
+	};
+
+	///
+	/// Location and size of a single level inside a MipChain.
+	///
+	struct MipLevel final
+	{
+		std::uint32_t m_width;
+		std::uint32_t m_height;
+		std::size_t m_offset;
+		std::size_t m_size;
+	};
+
+	///
+	/// Builds a full mip chain on the CPU, for assets that are cooked offline or use formats that cannot be blitted.
+	/// Supports VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_SRGB (filtered in linear space) and VK_FORMAT_R16G16B16A16_SFLOAT.
+	///
+	class MipChain final
+	{
+	public:
+		struct Settings final
+		{
+			VkFormat m_format;
+			MipFilter m_filter;
+			std::uint32_t m_width;
+			std::uint32_t m_height;
+
+			///
+			/// Zero generates every level down to 1x1.
+			///
+			std::uint32_t m_max_levels = 0;
+		};
+
+		MipChain(std::span<const std::byte> base, const MipChain::Settings& settings);
+		~MipChain() = default;
+
+		[[nodiscard]] VkFormat format() const;
+		[[nodiscard]] std::uint32_t level_count() const;
+		[[nodiscard]] const MipLevel& level(std::uint32_t index) const;
+		[[nodiscard]] std::span<const std::byte> level_data(std::uint32_t index) const;
+		[[nodiscard]] std::span<const std::byte> data() const;
+
+		[[nodiscard]] static bool supports(VkFormat format);
+		[[nodiscard]] static std::uint32_t full_level_count(std::uint32_t width, std::uint32_t height);
+
+	private:
+		MipChain() = delete;
+
+		void box_rgba8(const MipLevel& src, const MipLevel& dst);
+		void filter_level(const MipLevel& src, const MipLevel& dst);
+
+		VkFormat m_format;
+		MipFilter m_filter;
+		std::size_t m_pixel_size;
+
+		std::vector<std::byte> m_data;
+		std::vector<MipLevel> m_levels;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include <algorithm>
+
+#include "vulkano/core/Shader.hpp"
+#include "vulkano/graphics/BufferUploader.hpp"
+#include "vulkano/graphics/FrustumCuller.hpp"
+#include "vulkano/graphics/MipChain.hpp"
+#include "vulkano/pipeline/DescriptorAllocator.hpp"
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/pipeline/Pipeline.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "OcclusionCuller.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Workgroup sizes of hiz_reduce.comp (square) and occlusion_cull.comp.
+		///
+		constexpr std::uint32_t REDUCE_GROUP_SIZE = 8;
+		constexpr std::uint32_t CULL_GROUP_SIZE   = 64;
+
+		[[nodiscard]] Buffer storage_buffer(Instance* instance, VkDeviceSize size, VkBufferUsageFlags usage = 0, MemoryUsage memory = MemoryUsage::GPU_ONLY)
+		{
+			// clang-format off
+			BufferInfo info
+			{
+				.m_size = std::max<VkDeviceSize>(size, 4),
+				.m_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+				.m_memory = memory
+			};
+			// clang-format on
+
+			return Buffer {instance, info};
+		}
+
+		[[nodiscard]] DescriptorWrite buffer_write(std::uint32_t binding, const Buffer& buffer, VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+		{
+			return {binding, type, {buffer.vk_handle(), 0, VK_WHOLE_SIZE}};
+		}
+
+		[[nodiscard]] DescriptorWrite sampled_write(std::uint32_t binding, VkSampler sampler, VkImageView view)
+		{
+			return {binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, {}, {sampler, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}};
+		}
+
+		[[nodiscard]] DescriptorWrite storage_image_write(std::uint32_t binding, VkImageView view)
+		{
+			return {binding, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, {}, {VK_NULL_HANDLE, view, VK_IMAGE_LAYOUT_GENERAL}};
+		}
+
+		[[nodiscard]] VkExtent2D pyramid_extent(const VkExtent2D& depth_extent)
+		{
+			return {std::max(depth_extent.width / 2, 1u), std::max(depth_extent.height / 2, 1u)};
+		}
+
+		[[nodiscard]] VkExtent2D level_extent(const VkExtent2D& extent, std::uint32_t level)
+		{
+			return {std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u)};
+		}
+	} // namespace
+
+	OcclusionCuller::OcclusionCuller(Instance* instance, DescriptorAllocator& descriptors, const OcclusionCuller::Settings& settings)
+	    : m_instance {instance}, m_descriptors {descriptors}, m_settings {settings}, m_instances {storage_buffer(instance, settings.m_max_instances * sizeof(GpuCullInstance))}, m_instance_count {0}, m_states {storage_buffer(instance, settings.m_max_instances * sizeof(std::uint32_t))}, m_pyramid {instance, {VK_FORMAT_R32_SFLOAT, VK_IMAGE_VIEW_TYPE_2D, pyramid_extent(settings.m_depth_extent), MipChain::full_level_count(pyramid_extent(settings.m_depth_extent).width, pyramid_extent(settings.m_depth_extent).height), 1, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT}}, m_sampler {VK_NULL_HANDLE}, m_pyramid_view_projection {1.0f}, m_pyramid_valid {false}, m_reduce_layout {VK_NULL_HANDLE}, m_frame {0}, m_view_projection {1.0f}
+	{
+		const VkDevice device = m_instance->logical_device();
+
+		// Instance requires multiDrawIndirect and drawIndirectFirstInstance, the draw count is still limited.
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(m_instance->physical_device(), &properties);
+		if (m_settings.m_max_instances > properties.limits.maxDrawIndirectCount)
+		{
+			VK_LOG(VK_THROW, "Occlusion culler draws up to {0} commands per phase, over the device's limit of {1}.", m_settings.m_max_instances, properties.limits.maxDrawIndirectCount);
+		}
+
+		// Shaders only use texelFetch, so filtering is irrelevant, but combined image samplers still need one.
+		// clang-format off
+		VkSamplerCreateInfo sampler_info
+		{
+			.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+			.magFilter = VK_FILTER_NEAREST,
+			.minFilter = VK_FILTER_NEAREST,
+			.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+			.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.maxLod = VK_LOD_CLAMP_NONE
+		};
+		// clang-format on
+
+		if (vkCreateSampler(device, &sampler_info, nullptr, &m_sampler) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create Hi-Z sampler.");
+		}
+
+		const std::uint32_t levels = m_pyramid.info().m_mip_levels;
+		m_pyramid_levels.reserve(levels);
+		for (std::uint32_t level = 0; level < levels; level++)
+		{
+			// clang-format off
+			VkImageViewCreateInfo view_info
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+				.image = m_pyramid.vk_handle(),
+				.viewType = VK_IMAGE_VIEW_TYPE_2D,
+				.format = VK_FORMAT_R32_SFLOAT,
+				.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1}
+			};
+			// clang-format on
+
+			VkImageView view = VK_NULL_HANDLE;
+			if (vkCreateImageView(device, &view_info, nullptr, &view) != VK_SUCCESS)
+			{
+				VK_LOG(VK_THROW, "Failed to create view of Hi-Z level {0}.", level);
+			}
+
+			m_pyramid_levels.push_back(view);
+		}
+
+		// clang-format off
+		const std::array<VkDescriptorSetLayoutBinding, 2> reduce_bindings
+		{
+			VkDescriptorSetLayoutBinding {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+		};
+
+		const std::array<VkDescriptorSetLayoutBinding, 6> cull_bindings
+		{
+			VkDescriptorSetLayoutBinding {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+			VkDescriptorSetLayoutBinding {5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+		};
+		// clang-format on
+
+		m_reduce_layout                  = m_descriptors.create_layout(reduce_bindings);
+		const VkDescriptorSetLayout cull = m_descriptors.create_layout(cull_bindings);
+
+		// Modules are only needed while the pipelines are created.
+		{
+			const std::array<ShaderStage, 1> stages {ShaderStage {VK_SHADER_STAGE_COMPUTE_BIT, settings.m_reduce_shader}};
+			const Shader shader {device, stages};
+			m_reduce_pipeline = std::make_unique<Pipeline>(m_instance, shader, std::span {&m_reduce_layout, 1});
+		}
+
+		{
+			const std::array<ShaderStage, 1> stages {ShaderStage {VK_SHADER_STAGE_COMPUTE_BIT, settings.m_cull_shader}};
+			const Shader shader {device, stages};
+			m_cull_pipeline = std::make_unique<Pipeline>(m_instance, shader, std::span {&cull, 1}, static_cast<std::uint32_t>(sizeof(std::uint32_t)));
+		}
+
+		m_reduce_sets.reserve(levels);
+		for (std::uint32_t level = 1; level < levels; level++)
+		{
+			const std::array<DescriptorWrite, 2> writes {sampled_write(0, m_sampler, m_pyramid_levels[level - 1]), storage_image_write(1, m_pyramid_levels[level])};
+			m_reduce_sets.push_back(m_descriptors.cached(m_reduce_layout, writes));
+		}
+
+		m_frames.reserve(settings.m_frames_in_flight);
+		for (std::uint32_t i = 0; i < settings.m_frames_in_flight; i++)
+		{
+			// clang-format off
+			Frame frame
+			{
+				.m_constants = Buffer {instance, BufferInfo {sizeof(FrameConstants), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryUsage::UPLOAD}},
+				.m_draws = storage_buffer(instance, 2 * settings.m_max_instances * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT),
+				.m_counts = storage_buffer(instance, 2 * sizeof(std::uint32_t), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT),
+				.m_readback = Buffer {instance, BufferInfo {2 * sizeof(std::uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::READBACK}},
+				.m_set = VK_NULL_HANDLE
+			};
+			// clang-format on
+
+			const std::array<DescriptorWrite, 6> writes {buffer_write(0, frame.m_constants, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER), buffer_write(1, m_instances), buffer_write(2, m_states), buffer_write(3, frame.m_draws), buffer_write(4, frame.m_counts), sampled_write(5, m_sampler, m_pyramid.vk_view())};
+			frame.m_set = m_descriptors.cached(cull, writes);
+
+			m_frames.push_back(std::move(frame));
+		}
+	}
+
+	OcclusionCuller::~OcclusionCuller()
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		for (const VkImageView view : m_pyramid_levels)
+		{
+			m_descriptors.invalidate(view);
+			deletion.release(view);
+		}
+
+		// Every culling set reads the instances.
+		m_descriptors.invalidate(m_instances.vk_handle());
+		deletion.release(m_sampler);
+	}
+
+	void OcclusionCuller::set_instances(std::span<const GpuCullInstance> instances, BufferUploader& uploader)
+	{
+		if (instances.size() > m_settings.m_max_instances)
+		{
+			VK_LOG(VK_THROW, "{0} instances do not fit in an occlusion culler sized for {1}.", instances.size(), m_settings.m_max_instances);
+		}
+
+		uploader.upload(m_instances, 0, instances);
+		m_instance_count = static_cast<std::uint32_t>(instances.size());
+	}
+
+	void OcclusionCuller::cull_early(VkCommandBuffer cmd, std::uint32_t frame, const glm::mat4& view_projection)
+	{
+		m_frame           = frame;
+		m_view_projection = view_projection;
+
+		Frame& current = m_frames[frame];
+
+		const auto pyramid_extent = m_pyramid.info().m_extent;
+
+		// clang-format off
+		const FrameConstants constants
+		{
+			.m_planes = frustum_planes(view_projection),
+			.m_view_projection = view_projection,
+			.m_pyramid_view_projection = m_pyramid_view_projection,
+			.m_pyramid_size = glm::vec2 {pyramid_extent.width, pyramid_extent.height},
+			.m_instance_count = m_instance_count,
+			.m_max_draws = m_settings.m_max_instances,
+			.m_pyramid_valid = m_pyramid_valid ? 1u : 0u
+		};
+		// clang-format on
+
+		current.m_constants.write(0, std::as_bytes(std::span {&constants, 1}));
+
+		BarrierBatch barriers;
+		barriers.buffer(current.m_counts.state(), ResourceUsage::TRANSFER_DST);
+		barriers.buffer(current.m_draws.state(), ResourceUsage::TRANSFER_DST);
+		barriers.flush(cmd);
+
+		vkCmdFillBuffer(cmd, current.m_counts.vk_handle(), 0, VK_WHOLE_SIZE, 0);
+
+		// Without an indirect count every command is drawn, and the unwritten ones have to be empty.
+		if (!m_instance->draw_indirect_count())
+		{
+			vkCmdFillBuffer(cmd, current.m_draws.vk_handle(), 0, VK_WHOLE_SIZE, 0);
+		}
+
+		// The pyramid is only sampled once it is valid, but the descriptor needs its layout either way.
+		barriers.buffer(m_instances.state(), ResourceUsage::STORAGE_READ);
+		barriers.buffer(m_states.state(), ResourceUsage::STORAGE_WRITE);
+		barriers.buffer(current.m_counts.state(), ResourceUsage::STORAGE_READ_WRITE);
+		barriers.buffer(current.m_draws.state(), ResourceUsage::STORAGE_WRITE);
+		barriers.image(m_pyramid, ResourceUsage::SAMPLED_COMPUTE);
+		barriers.flush(cmd);
+
+		const std::uint32_t phase = 0;
+		m_cull_pipeline->bind(cmd);
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cull_pipeline->layout(), 0, 1, &current.m_set, 0, nullptr);
+		vkCmdPushConstants(cmd, m_cull_pipeline->layout(), VK_SHADER_STAGE_ALL, 0, sizeof(phase), &phase);
+		vkCmdDispatch(cmd, (m_instance_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+		barriers.buffer(current.m_draws.state(), ResourceUsage::INDIRECT_BUFFER);
+		barriers.buffer(current.m_counts.state(), ResourceUsage::INDIRECT_BUFFER);
+		barriers.flush(cmd);
+	}
+
+	void OcclusionCuller::cull_late(VkCommandBuffer cmd, Image& depth)
+	{
+		build_pyramid(cmd, depth);
+
+		Frame& current = m_frames[m_frame];
+
+		BarrierBatch barriers;
+		barriers.buffer(m_states.state(), ResourceUsage::STORAGE_READ);
+		barriers.buffer(current.m_counts.state(), ResourceUsage::STORAGE_READ_WRITE);
+		barriers.buffer(current.m_draws.state(), ResourceUsage::STORAGE_WRITE);
+		barriers.flush(cmd);
+
+		const std::uint32_t phase = 1;
+		m_cull_pipeline->bind(cmd);
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cull_pipeline->layout(), 0, 1, &current.m_set, 0, nullptr);
+		vkCmdPushConstants(cmd, m_cull_pipeline->layout(), VK_SHADER_STAGE_ALL, 0, sizeof(phase), &phase);
+		vkCmdDispatch(cmd, (m_instance_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+		barriers.buffer(current.m_counts.state(), ResourceUsage::TRANSFER_SRC);
+		barriers.buffer(current.m_readback.state(), ResourceUsage::TRANSFER_DST);
+		barriers.flush(cmd);
+
+		const VkBufferCopy copy {0, 0, 2 * sizeof(std::uint32_t)};
+		vkCmdCopyBuffer(cmd, current.m_counts.vk_handle(), current.m_readback.vk_handle(), 1, &copy);
+
+		barriers.buffer(current.m_draws.state(), ResourceUsage::INDIRECT_BUFFER);
+		barriers.buffer(current.m_counts.state(), ResourceUsage::INDIRECT_BUFFER);
+		barriers.buffer(current.m_readback.state(), ResourceUsage::HOST_READ);
+		barriers.flush(cmd);
+	}
+
+	void OcclusionCuller::draw(VkCommandBuffer cmd, OcclusionCuller::Phase phase) const
+	{
+		const Frame& current = m_frames[m_frame];
+
+		const auto index               = static_cast<std::uint32_t>(phase);
+		const VkDeviceSize draw_offset = index * m_settings.m_max_instances * sizeof(VkDrawIndexedIndirectCommand);
+
+		if (m_instance->draw_indirect_count())
+		{
+			vkCmdDrawIndexedIndirectCount(cmd, current.m_draws.vk_handle(), draw_offset, current.m_counts.vk_handle(), index * sizeof(std::uint32_t), m_settings.m_max_instances, sizeof(VkDrawIndexedIndirectCommand));
+		}
+		else
+		{
+			vkCmdDrawIndexedIndirect(cmd, current.m_draws.vk_handle(), draw_offset, m_settings.m_max_instances, sizeof(VkDrawIndexedIndirectCommand));
+		}
+	}
+
+	std::uint32_t OcclusionCuller::visible_count(std::uint32_t frame, OcclusionCuller::Phase phase) const
+	{
+		const Buffer& counts = m_frames[frame].m_readback;
+		counts.invalidate();
+
+		std::uint32_t visible = 0;
+		std::copy_n(counts.mapped() + static_cast<std::size_t>(phase) * sizeof(visible), sizeof(visible), reinterpret_cast<std::byte*>(&visible));
+
+		return std::min(visible, m_settings.m_max_instances);
+	}
+
+	Image& OcclusionCuller::pyramid()
+	{
+		return m_pyramid;
+	}
+
+	void OcclusionCuller::build_pyramid(VkCommandBuffer cmd, Image& depth)
+	{
+		const std::uint32_t levels = m_pyramid.info().m_mip_levels;
+
+		// Level 0 reads the depth buffer, which the caller may swap, so its set is only kept for this frame.
+		const std::array<DescriptorWrite, 2> writes {sampled_write(0, m_sampler, depth.vk_view()), storage_image_write(1, m_pyramid_levels[0])};
+		const VkDescriptorSet first_set = m_descriptors.allocate(m_reduce_layout);
+		m_descriptors.update(first_set, writes);
+
+		BarrierBatch barriers;
+		barriers.image(depth, ResourceUsage::SAMPLED_COMPUTE);
+		barriers.image(m_pyramid, ResourceUsage::STORAGE_WRITE, 0, 1, true);
+		barriers.flush(cmd);
+
+		m_reduce_pipeline->bind(cmd);
+		for (std::uint32_t level = 0; level < levels; level++)
+		{
+			const VkDescriptorSet set = (level == 0) ? first_set : m_reduce_sets[level - 1];
+			const VkExtent2D extent   = level_extent(m_pyramid.info().m_extent, level);
+
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_reduce_pipeline->layout(), 0, 1, &set, 0, nullptr);
+			vkCmdDispatch(cmd, (extent.width + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE, (extent.height + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE, 1);
+
+			// Each level is sampled by the next, and by the culling pass.
+			barriers.image(m_pyramid, ResourceUsage::SAMPLED_COMPUTE, level, 1);
+			if (level + 1 < levels)
+			{
+				barriers.image(m_pyramid, ResourceUsage::STORAGE_WRITE, level + 1, 1, true);
+			}
+
+			barriers.flush(cmd);
+		}
+
+		m_pyramid_view_projection = m_view_projection;
+		m_pyramid_valid           = true;
+	}
+} // namespace vulkano
\ No newline at end of file
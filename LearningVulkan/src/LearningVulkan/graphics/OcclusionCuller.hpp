@@ -0,0 +1,198 @@
+#ifndef VULKANO_GRAPHICS_OCCLUSIONCULLER_HPP_
+#define VULKANO_GRAPHICS_OCCLUSIONCULLER_HPP_
+
+#include <array>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+
+#include "vulkano/graphics/Buffer.hpp"
+#include "vulkano/graphics/Image.hpp"
+
+namespace vulkano
+{
+	class BufferUploader;
+	class DescriptorAllocator;
+	class Pipeline;
+
+	///
+	/// An instance as occlusion_cull.comp declares it (std430). Its draw gets firstInstance set to its index, so the
+	/// vertex shader can find its transform.
+	///
+	struct GpuCullInstance final
+	{
+		///
+		/// World space centre and radius.
+		///
+		glm::vec4 m_sphere;
+		std::uint32_t m_index_count;
+		std::uint32_t m_first_index;
+		std::int32_t m_vertex_offset;
+		std::uint32_t m_padding;
+	};
+
+	static_assert(sizeof(GpuCullInstance) == 32);
+
+	///
+	/// Two phase occlusion culling of instances against a hierarchical depth buffer (Hi-Z), on the GPU.
+	///
+	/// The pyramid is an R32_SFLOAT image whose every texel holds the farthest depth of the texels it covers in the
+	/// level above, built from the depth buffer by one compute dispatch per level. A sphere is occluded when its
+	/// nearest depth is behind all of the (at most) 2x2 texels of the level its screen rectangle fits in.
+	///
+	/// The early phase tests instances against the frustum and last frame's pyramid, and draws what passes. Those
+	/// draws' depth builds this frame's pyramid, and the late phase retests only the instances the early phase
+	/// found occluded, drawing the ones now visible. Things hidden by last frame's depth that came into view are
+	/// therefore never lost, and the pyramid is ready for the next frame's early phase.
+	///
+	/// Depth is assumed to be standard: 0 at the near plane, 1 at the far plane, compared with LESS.
+	///
+	class OcclusionCuller final
+	{
+	public:
+		enum class Phase
+		{
+			EARLY,
+			LATE
+		};
+
+		struct Settings final
+		{
+			std::uint32_t m_frames_in_flight;
+			std::uint32_t m_max_instances;
+
+			///
+			/// Size of the depth buffer. The pyramid starts at half of it. Recreate the culler on resize.
+			///
+			VkExtent2D m_depth_extent;
+
+			///
+			/// SPIR-V of hiz_reduce.comp and occlusion_cull.comp.
+			///
+			std::string_view m_reduce_shader;
+			std::string_view m_cull_shader;
+		};
+
+		OcclusionCuller(Instance* instance, DescriptorAllocator& descriptors, const OcclusionCuller::Settings& settings);
+		~OcclusionCuller();
+
+		///
+		/// Replaces every instance. Record the uploader before the next cull_early().
+		///
+		void set_instances(std::span<const GpuCullInstance> instances, BufferUploader& uploader);
+
+		///
+		/// Culls against the frustum and last frame's pyramid, and makes the early draws ready for draw(). Must be
+		/// recorded outside a render pass.
+		///
+		void cull_early(VkCommandBuffer cmd, std::uint32_t frame, const glm::mat4& view_projection);
+
+		///
+		/// Builds this frame's pyramid from depth, once the early draws have been rendered into it, then retests
+		/// what the early phase found occluded. Must be recorded outside a render pass. depth is left sampled, so
+		/// transition it back to an attachment before the late draws. Its set comes from the DescriptorAllocator's
+		/// current frame.
+		///
+		void cull_late(VkCommandBuffer cmd, Image& depth);
+
+		///
+		/// Draws one phase's visible instances. The graphics pipeline, vertex buffers and index buffer must be bound.
+		///
+		void draw(VkCommandBuffer cmd, OcclusionCuller::Phase phase) const;
+
+		///
+		/// Instances drawn by a phase of frame, once its fence has signalled. For statistics and validation.
+		///
+		[[nodiscard]] std::uint32_t visible_count(std::uint32_t frame, OcclusionCuller::Phase phase) const;
+
+		[[nodiscard]] Image& pyramid();
+
+	private:
+		OcclusionCuller() = delete;
+		OcclusionCuller(const OcclusionCuller&) = delete;
+		OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+		///
+		/// Mirrors the Frame uniform block of occlusion_cull.comp (std140).
+		///
+		struct FrameConstants final
+		{
+			std::array<glm::vec4, 6> m_planes;
+			glm::mat4 m_view_projection;
+
+			///
+			/// The one the pyramid was built with, which the early phase projects into.
+			///
+			glm::mat4 m_pyramid_view_projection;
+			glm::vec2 m_pyramid_size;
+			std::uint32_t m_instance_count;
+			std::uint32_t m_max_draws;
+			std::uint32_t m_pyramid_valid;
+		};
+
+		struct Frame final
+		{
+			///
+			/// Constants written by the host each frame.
+			///
+			Buffer m_constants;
+
+			///
+			/// Early draws first, then late ones, each max_instances long.
+			///
+			Buffer m_draws;
+
+			///
+			/// Early and late draw counts, appended to by the culling shader and read by the indirect draws.
+			///
+			Buffer m_counts;
+
+			///
+			/// Copy of the counts in readback memory, for visible_count().
+			///
+			Buffer m_readback;
+			VkDescriptorSet m_set;
+		};
+
+		void build_pyramid(VkCommandBuffer cmd, Image& depth);
+
+		Instance* m_instance;
+		DescriptorAllocator& m_descriptors;
+		OcclusionCuller::Settings m_settings;
+
+		Buffer m_instances;
+		std::uint32_t m_instance_count;
+
+		///
+		/// Per instance: 1 when the early phase found it occluded, leaving it to the late phase.
+		///
+		Buffer m_states;
+
+		Image m_pyramid;
+
+		///
+		/// One view per level, written as a storage image and then sampled to build the next.
+		///
+		std::vector<VkImageView> m_pyramid_levels;
+		VkSampler m_sampler;
+		glm::mat4 m_pyramid_view_projection;
+		bool m_pyramid_valid;
+
+		std::unique_ptr<Pipeline> m_reduce_pipeline;
+		VkDescriptorSetLayout m_reduce_layout;
+
+		///
+		/// Reduce sets of levels 1 onwards, each reading the previous level. Level 0's reads the depth buffer.
+		///
+		std::vector<VkDescriptorSet> m_reduce_sets;
+
+		std::unique_ptr<Pipeline> m_cull_pipeline;
+		std::vector<Frame> m_frames;
+		std::uint32_t m_frame;
+		glm::mat4 m_view_projection;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "ResourceRegistry.hpp"
+
+namespace vulkano
+{
+	ResourceRegistry::ResourceRegistry(Instance* instance)
+	    : m_instance {instance}
+	{
+	}
+
+	ResourceRegistry::~ResourceRegistry()
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		for (const auto sampler : m_samplers.objects())
+		{
+			deletion.release(sampler);
+		}
+
+		for (const auto shader : m_shaders.objects())
+		{
+			deletion.release(shader);
+		}
+
+		for (const auto pipeline : m_pipelines.objects())
+		{
+			deletion.release(pipeline);
+		}
+
+		// Buffers and images release themselves when their pools are destroyed.
+	}
+
+	BufferHandle ResourceRegistry::create_buffer(const BufferInfo& info)
+	{
+		return m_buffers.emplace(m_instance, info);
+	}
+
+	ImageHandle ResourceRegistry::create_image(const ImageInfo& info)
+	{
+		return m_images.emplace(m_instance, info);
+	}
+
+	SamplerHandle ResourceRegistry::create_sampler(const VkSamplerCreateInfo& info)
+	{
+		VkSampler sampler = nullptr;
+		if (vkCreateSampler(m_instance->logical_device(), &info, nullptr, &sampler) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create sampler.");
+		}
+
+		return m_samplers.emplace(sampler);
+	}
+
+	ShaderHandle ResourceRegistry::create_shader(std::span<const std::uint32_t> spirv)
+	{
+		// clang-format off
+		VkShaderModuleCreateInfo module_info
+		{
+			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.codeSize = spirv.size_bytes(),
+			.pCode = spirv.data()
+		};
+		// clang-format on
+
+		VkShaderModule module = nullptr;
+		if (vkCreateShaderModule(m_instance->logical_device(), &module_info, nullptr, &module) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create shader module.");
+		}
+
+		return m_shaders.emplace(module);
+	}
+
+	PipelineHandle ResourceRegistry::add_pipeline(VkPipeline pipeline)
+	{
+		return m_pipelines.emplace(pipeline);
+	}
+
+	void ResourceRegistry::release(BufferHandle handle)
+	{
+		static_cast<void>(m_buffers.remove(handle, m_instance->deletion_queue().pending()));
+	}
+
+	void ResourceRegistry::release(ImageHandle handle)
+	{
+		// The moved out object queues its handles for deletion as the temporary is destroyed.
+		static_cast<void>(m_images.remove(handle, m_instance->deletion_queue().pending()));
+	}
+
+	void ResourceRegistry::release(SamplerHandle handle)
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		deletion.release(m_samplers.remove(handle, deletion.pending()));
+	}
+
+	void ResourceRegistry::release(ShaderHandle handle)
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		deletion.release(m_shaders.remove(handle, deletion.pending()));
+	}
+
+	void ResourceRegistry::release(PipelineHandle handle)
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		deletion.release(m_pipelines.remove(handle, deletion.pending()));
+	}
+
+	void ResourceRegistry::collect(std::uint64_t completed)
+	{
+		m_buffers.collect(completed);
+		m_images.collect(completed);
+		m_samplers.collect(completed);
+		m_shaders.collect(completed);
+		m_pipelines.collect(completed);
+	}
+
+	Buffer& ResourceRegistry::buffer(BufferHandle handle)
+	{
+		return m_buffers.get(handle);
+	}
+
+	Image& ResourceRegistry::image(ImageHandle handle)
+	{
+		return m_images.get(handle);
+	}
+
+	VkSampler ResourceRegistry::sampler(SamplerHandle handle) const
+	{
+		return m_samplers.get(handle);
+	}
+
+	VkShaderModule ResourceRegistry::shader(ShaderHandle handle) const
+	{
+		return m_shaders.get(handle);
+	}
+
+	VkPipeline ResourceRegistry::pipeline(PipelineHandle handle) const
+	{
+		return m_pipelines.get(handle);
+	}
+
+	ResourcePool<Buffer>& ResourceRegistry::buffers()
+	{
+		return m_buffers;
+	}
+
+	ResourcePool<Image>& ResourceRegistry::images()
+	{
+		return m_images;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef VULKANO_GRAPHICS_RESOURCEREGISTRY_HPP_
+#define VULKANO_GRAPHICS_RESOURCEREGISTRY_HPP_
+
+#include <span>
+
+#include "vulkano/graphics/Buffer.hpp"
+#include "vulkano/graphics/Image.hpp"
+#include "vulkano/utils/ResourcePool.hpp"
+
+namespace vulkano
+{
+	class Instance;
+
+	using BufferHandle   = Handle<Buffer>;
+	using ImageHandle    = Handle<Image>;
+	using SamplerHandle  = Handle<VkSampler>;
+	using PipelineHandle = Handle<VkPipeline>;
+	using ShaderHandle   = Handle<VkShaderModule>;
+
+	///
+	/// Owns GPU resources in contiguous pools and hands out generational handles to them.
+	///
+	/// Released objects go through the instance's DeletionQueue, and their slots are only reused once the queue's
+	/// pending value at release time has completed, so indices baked into in flight work stay unambiguous.
+	///
+	class ResourceRegistry final
+	{
+	public:
+		ResourceRegistry(Instance* instance);
+		~ResourceRegistry();
+
+		[[nodiscard]] BufferHandle create_buffer(const BufferInfo& info);
+		[[nodiscard]] ImageHandle create_image(const ImageInfo& info);
+		[[nodiscard]] SamplerHandle create_sampler(const VkSamplerCreateInfo& info);
+		[[nodiscard]] ShaderHandle create_shader(std::span<const std::uint32_t> spirv);
+
+		///
+		/// Takes ownership of a pipeline created elsewhere.
+		///
+		[[nodiscard]] PipelineHandle add_pipeline(VkPipeline pipeline);
+
+		void release(BufferHandle handle);
+		void release(ImageHandle handle);
+		void release(SamplerHandle handle);
+		void release(ShaderHandle handle);
+		void release(PipelineHandle handle);
+
+		///
+		/// Frees slots retired at or before completed. Call alongside DeletionQueue::collect().
+		///
+		void collect(std::uint64_t completed);
+
+		[[nodiscard]] Buffer& buffer(BufferHandle handle);
+		[[nodiscard]] Image& image(ImageHandle handle);
+		[[nodiscard]] VkSampler sampler(SamplerHandle handle) const;
+		[[nodiscard]] VkShaderModule shader(ShaderHandle handle) const;
+		[[nodiscard]] VkPipeline pipeline(PipelineHandle handle) const;
+
+		[[nodiscard]] ResourcePool<Buffer>& buffers();
+		[[nodiscard]] ResourcePool<Image>& images();
+
+	private:
+		ResourceRegistry() = delete;
+
+		Instance* m_instance;
+
+		ResourcePool<Buffer> m_buffers;
+		ResourcePool<Image> m_images;
+		ResourcePool<VkSampler> m_samplers;
+		ResourcePool<VkShaderModule> m_shaders;
+		ResourcePool<VkPipeline> m_pipelines;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "SceneIndex.hpp"
+
+namespace vulkano
+{
+	SceneIndex::SceneIndex(const Settings& settings, JobSystem* jobs)
+	    : m_settings {settings}, m_jobs {jobs}, m_static_dirty {false}, m_dynamic_dirty {false}, m_moved {false}, m_dynamic_version {0}, m_built_cost {0.0f}, m_frames_since_build {0}, m_rebuild_version {0}, m_rebuild_pending {false}
+	{
+	}
+
+	SceneIndex::~SceneIndex()
+	{
+		if (m_rebuild_pending)
+		{
+			// The result is thrown away, and so is anything the build threw.
+			try
+			{
+				m_jobs->wait(m_rebuild);
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+
+	std::uint32_t SceneIndex::add(const Aabb& bounds, Mobility mobility)
+	{
+		std::uint32_t object;
+		if (!m_free.empty())
+		{
+			object = m_free.back();
+			m_free.pop_back();
+
+			m_bounds[object]   = bounds;
+			m_mobility[object] = mobility;
+		}
+		else
+		{
+			object = static_cast<std::uint32_t>(m_bounds.size());
+			m_bounds.push_back(bounds);
+			m_mobility.push_back(mobility);
+		}
+
+		(mobility == Mobility::STATIC ? m_static_dirty : m_dynamic_dirty) = true;
+		return object;
+	}
+
+	void SceneIndex::remove(std::uint32_t object)
+	{
+		// The trees skip empty boxes, so the object vanishes from queries now and from its tree on the next update().
+		m_bounds[object] = Aabb::empty();
+		m_free.push_back(object);
+
+		(m_mobility[object] == Mobility::STATIC ? m_static_dirty : m_dynamic_dirty) = true;
+	}
+
+	void SceneIndex::move(std::uint32_t object, const Aabb& bounds)
+	{
+		m_bounds[object] = bounds;
+
+		if (m_mobility[object] == Mobility::STATIC)
+		{
+			m_static_dirty = true;
+		}
+		else
+		{
+			m_moved = true;
+		}
+	}
+
+	void SceneIndex::update()
+	{
+		if (m_rebuild_pending && m_rebuild.done())
+		{
+			finish_rebuild();
+		}
+
+		if (m_static_dirty)
+		{
+			m_static.build(m_bounds, objects(Mobility::STATIC));
+			m_static_dirty = false;
+		}
+
+		if (m_dynamic_dirty)
+		{
+			build_dynamic();
+			return;
+		}
+
+		if (m_moved)
+		{
+			m_dynamic.refit(m_bounds);
+			m_moved = false;
+		}
+
+		// Checking the cost walks every node, so it only happens every so often.
+		if (m_rebuild_pending || ++m_frames_since_build < m_settings.m_rebuild_interval)
+		{
+			return;
+		}
+
+		m_frames_since_build = 0;
+		if (m_dynamic.cost() > m_built_cost * m_settings.m_rebuild_threshold)
+		{
+			start_rebuild();
+		}
+	}
+
+	void SceneIndex::cull(const std::array<glm::vec4, 6>& planes, std::vector<std::uint32_t>& visible) const
+	{
+		m_static.cull(m_bounds, planes, visible);
+		m_dynamic.cull(m_bounds, planes, visible);
+	}
+
+	std::optional<BvhHit> SceneIndex::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+	{
+		const auto hit         = m_static.raycast(m_bounds, origin, direction, max_distance);
+		const auto dynamic_hit = m_dynamic.raycast(m_bounds, origin, direction, hit ? hit->m_distance : max_distance);
+
+		return dynamic_hit ? dynamic_hit : hit;
+	}
+
+	void SceneIndex::overlap(const glm::vec3& centre, float radius, std::vector<std::uint32_t>& objects) const
+	{
+		m_static.overlap(m_bounds, centre, radius, objects);
+		m_dynamic.overlap(m_bounds, centre, radius, objects);
+	}
+
+	bool SceneIndex::rebuilding() const
+	{
+		return m_rebuild_pending;
+	}
+
+	std::vector<std::uint32_t> SceneIndex::objects(Mobility mobility) const
+	{
+		std::vector<std::uint32_t> result;
+		for (std::uint32_t object = 0; object < m_bounds.size(); object++)
+		{
+			if (m_mobility[object] == mobility && !m_bounds[object].is_empty())
+			{
+				result.push_back(object);
+			}
+		}
+
+		return result;
+	}
+
+	void SceneIndex::build_dynamic()
+	{
+		m_dynamic.build(m_bounds, objects(Mobility::DYNAMIC));
+
+		m_dynamic_dirty      = false;
+		m_moved              = false;
+		m_built_cost         = m_dynamic.cost();
+		m_frames_since_build = 0;
+		m_dynamic_version++;
+	}
+
+	void SceneIndex::start_rebuild()
+	{
+		// A lone thread would only run the job when something waits on it, so just build here.
+		if (!m_jobs || m_jobs->thread_count() < 2)
+		{
+			build_dynamic();
+			return;
+		}
+
+		// The job reads only the snapshot, so objects carry on moving while it runs.
+		m_snapshot         = m_bounds;
+		m_snapshot_objects = objects(Mobility::DYNAMIC);
+		m_rebuild_version  = m_dynamic_version;
+		m_rebuild_pending  = true;
+
+		m_jobs->run([this]() { m_rebuilt.build(m_snapshot, std::move(m_snapshot_objects)); }, &m_rebuild);
+	}
+
+	void SceneIndex::finish_rebuild()
+	{
+		m_rebuild_pending = false;
+
+		// Already done, so this only rethrows a failed build, leaving the current tree in place.
+		m_jobs->wait(m_rebuild);
+
+		// Objects were added to or removed from the dynamic tree since the snapshot, so the result is missing some.
+		if (m_rebuild_version != m_dynamic_version)
+		{
+			return;
+		}
+
+		// Built on old boxes: refit to where the objects are now.
+		std::swap(m_dynamic, m_rebuilt);
+		m_dynamic.refit(m_bounds);
+		m_moved      = false;
+		m_built_cost = m_dynamic.cost();
+	}
+} // namespace vulkano
\ No newline at end of file
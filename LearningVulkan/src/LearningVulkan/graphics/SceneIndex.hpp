@@ -0,0 +1,128 @@
+#ifndef VULKANO_GRAPHICS_SCENEINDEX_HPP_
+#define VULKANO_GRAPHICS_SCENEINDEX_HPP_
+
+#include "vulkano/core/JobSystem.hpp"
+#include "vulkano/graphics/Bvh.hpp"
+
+namespace vulkano
+{
+	///
+	/// World space bounds of every object in the scene, split into two trees. The static tree is built once with
+	/// the full surface area heuristic and then left alone. The dynamic tree is refitted each frame objects move,
+	/// which keeps it correct but lets its quality drift, so once it costs noticeably more than when it was built
+	/// a replacement is built on the job system from a snapshot and swapped in when ready.
+	///
+	/// Frustum culling, picking and light assignment all query both trees.
+	///
+	class SceneIndex final
+	{
+	public:
+		enum class Mobility
+		{
+			STATIC,
+			DYNAMIC
+		};
+
+		struct Settings final
+		{
+			///
+			/// Frames between checks of the dynamic tree's quality.
+			///
+			std::uint32_t m_rebuild_interval = 60;
+
+			///
+			/// Rebuild once the dynamic tree's cost has grown by this factor since it was built.
+			///
+			float m_rebuild_threshold = 1.3f;
+		};
+
+		///
+		/// Without a job system, or with only one thread, rebuilds happen inside update().
+		///
+		SceneIndex(const Settings& settings, JobSystem* jobs = nullptr);
+
+		///
+		/// Waits for any rebuild still running.
+		///
+		~SceneIndex();
+
+		///
+		/// Returns the object's id. Ids of removed objects are reused. The object is queryable after the next
+		/// update().
+		///
+		std::uint32_t add(const Aabb& bounds, Mobility mobility);
+		void remove(std::uint32_t object);
+
+		///
+		/// Meant for dynamic objects. Moving a static one rebuilds the static tree on the next update().
+		///
+		void move(std::uint32_t object, const Aabb& bounds);
+
+		///
+		/// Once per frame, after objects have moved and before any query.
+		///
+		void update();
+
+		///
+		/// Appends the objects whose bounds intersect the frustum's inward facing planes, see frustum_planes().
+		///
+		void cull(const std::array<glm::vec4, 6>& planes, std::vector<std::uint32_t>& visible) const;
+
+		///
+		/// Nearest object whose bounds the ray enters within max_distance.
+		///
+		[[nodiscard]] std::optional<BvhHit> raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const;
+
+		///
+		/// Appends the objects whose bounds touch the sphere, e.g. a point light's range.
+		///
+		void overlap(const glm::vec3& centre, float radius, std::vector<std::uint32_t>& objects) const;
+
+		[[nodiscard]] bool rebuilding() const;
+
+	private:
+		SceneIndex() = delete;
+		SceneIndex(const SceneIndex&) = delete;
+		SceneIndex& operator=(const SceneIndex&) = delete;
+
+		[[nodiscard]] std::vector<std::uint32_t> objects(Mobility mobility) const;
+		void build_dynamic();
+		void start_rebuild();
+		void finish_rebuild();
+
+		Settings m_settings;
+		JobSystem* m_jobs;
+
+		///
+		/// Indexed by object id. Removed objects keep an empty box until their id is reused.
+		///
+		std::vector<Aabb> m_bounds;
+		std::vector<Mobility> m_mobility;
+		std::vector<std::uint32_t> m_free;
+
+		Bvh m_static;
+		Bvh m_dynamic;
+		bool m_static_dirty;
+		bool m_dynamic_dirty;
+		bool m_moved;
+
+		///
+		/// Bumped whenever the dynamic tree's set of objects changes, so a rebuild started before is discarded.
+		///
+		std::uint32_t m_dynamic_version;
+		float m_built_cost;
+		std::uint32_t m_frames_since_build;
+
+		///
+		/// Owned by the rebuild job while it runs.
+		///
+		std::vector<Aabb> m_snapshot;
+		std::vector<std::uint32_t> m_snapshot_objects;
+		Bvh m_rebuilt;
+		JobCounter m_rebuild;
+		std::uint32_t m_rebuild_version;
+		bool m_rebuild_pending;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
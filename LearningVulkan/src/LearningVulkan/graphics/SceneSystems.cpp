@@ -0,0 +1,74 @@
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+#include "vulkano/graphics/TransformSystem.hpp"
+
+#include "SceneSystems.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		template<typename... Components, typename Body>
+		void for_chunks(EntityWorld& world, JobSystem* jobs, Body&& body)
+		{
+			if (jobs)
+			{
+				world.each<Components...>(*jobs, body);
+			}
+			else
+			{
+				world.each<Components...>(body);
+			}
+		}
+	} // namespace
+
+	void update_world_bounds(EntityWorld& world, const TransformSystem& transforms, JobSystem* jobs)
+	{
+		for_chunks<const TransformComponent, const BoundsComponent, WorldBoundsComponent>(world, jobs, [&transforms](std::span<const Entity>, std::span<const TransformComponent> transform, std::span<const BoundsComponent> bounds, std::span<WorldBoundsComponent> world_bounds) {
+			for (std::size_t i = 0; i < transform.size(); i++)
+			{
+				const glm::mat4& matrix = transforms.world(transform[i].m_transform);
+
+				const float scale = std::max({glm::length(glm::vec3 {matrix[0]}), glm::length(glm::vec3 {matrix[1]}), glm::length(glm::vec3 {matrix[2]})});
+				world_bounds[i].m_sphere = glm::vec4 {glm::vec3 {matrix * glm::vec4 {bounds[i].m_centre, 1.0f}}, bounds[i].m_radius * scale};
+			}
+		});
+	}
+
+	DrawExtractor::DrawExtractor(JobSystem* jobs)
+	    : m_culler {jobs}
+	{
+	}
+
+	std::span<const DrawItem> DrawExtractor::extract(EntityWorld& world, const glm::mat4& view_projection, const glm::vec3& eye)
+	{
+		m_culler.clear();
+		m_candidates.clear();
+		m_centres.clear();
+
+		// Gathering only copies, the culler does the work across threads.
+		world.each<const TransformComponent, const WorldBoundsComponent, const MeshComponent>([this](std::span<const Entity>, std::span<const TransformComponent> transform, std::span<const WorldBoundsComponent> bounds, std::span<const MeshComponent> mesh) {
+			for (std::size_t i = 0; i < mesh.size(); i++)
+			{
+				const glm::vec3 centre {bounds[i].m_sphere};
+
+				m_culler.add(centre, bounds[i].m_sphere.w);
+				m_candidates.push_back({mesh[i], transform[i].m_transform, 0.0f});
+				m_centres.push_back(centre);
+			}
+		});
+
+		const std::span<const std::uint32_t> visible = m_culler.cull(view_projection);
+
+		m_draws.resize(visible.size());
+		for (std::size_t i = 0; i < visible.size(); i++)
+		{
+			m_draws[i]         = m_candidates[visible[i]];
+			m_draws[i].m_depth = glm::distance(eye, m_centres[visible[i]]);
+		}
+
+		return m_draws;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef VULKANO_GRAPHICS_SCENESYSTEMS_HPP_
+#define VULKANO_GRAPHICS_SCENESYSTEMS_HPP_
+
+#include <span>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "vulkano/core/EntityWorld.hpp"
+#include "vulkano/graphics/FrustumCuller.hpp"
+
+namespace vulkano
+{
+	class TransformSystem;
+
+	///
+	/// Id of the entity's transform in the TransformSystem.
+	///
+	struct TransformComponent final
+	{
+		std::uint32_t m_transform;
+	};
+
+	///
+	/// Bounding sphere in the entity's local space.
+	///
+	struct BoundsComponent final
+	{
+		glm::vec3 m_centre;
+		float m_radius;
+	};
+
+	///
+	/// World space centre and radius, written by update_world_bounds().
+	///
+	struct WorldBoundsComponent final
+	{
+		glm::vec4 m_sphere;
+	};
+
+	struct MeshComponent final
+	{
+		std::uint32_t m_index_count;
+		std::uint32_t m_first_index;
+		std::int32_t m_vertex_offset;
+		std::uint32_t m_material;
+	};
+
+	///
+	/// One visible mesh, as extracted for the frame.
+	///
+	struct DrawItem final
+	{
+		MeshComponent m_mesh;
+		std::uint32_t m_transform;
+
+		///
+		/// Distance from the eye to the bounds' centre.
+		///
+		float m_depth;
+	};
+
+	///
+	/// Moves the local bounds of every entity with a transform into world space, scaled by the transform's largest
+	/// axis. Run after TransformSystem::update().
+	///
+	void update_world_bounds(EntityWorld& world, const TransformSystem& transforms, JobSystem* jobs = nullptr);
+
+	///
+	/// Gathers the world bounds of every entity with a mesh into a FrustumCuller and turns its visible indices into
+	/// draws. Draws come out in chunk order, which changes as entities are created and destroyed; sort them before
+	/// recording.
+	///
+	class DrawExtractor final
+	{
+	public:
+		DrawExtractor(JobSystem* jobs = nullptr);
+		~DrawExtractor() = default;
+
+		///
+		/// Valid until the next call.
+		///
+		[[nodiscard]] std::span<const DrawItem> extract(EntityWorld& world, const glm::mat4& view_projection, const glm::vec3& eye);
+
+	private:
+		DrawExtractor(const DrawExtractor&) = delete;
+		DrawExtractor& operator=(const DrawExtractor&) = delete;
+
+		FrustumCuller m_culler;
+
+		///
+		/// Every entity gathered this frame, by culler index.
+		///
+		std::vector<DrawItem> m_candidates;
+		std::vector<glm::vec3> m_centres;
+
+		std::vector<DrawItem> m_draws;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
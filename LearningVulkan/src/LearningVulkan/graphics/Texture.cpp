@@ -0,0 +1,90 @@
+#include <cstring>
+
+#include "vulkano/graphics/BlockCompression.hpp"
+#include "vulkano/graphics/BufferUploader.hpp"
+#include "vulkano/graphics/TextureFile.hpp"
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "Texture.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		[[nodiscard]] bool can_sample(const Instance& instance, VkFormat format)
+		{
+			if (bc::is_block_compressed(format) && !instance.enabled_features().textureCompressionBC)
+			{
+				return false;
+			}
+
+			return instance.supports_format(format, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT);
+		}
+	} // namespace
+
+	Texture::Texture(Instance* instance, std::string_view path, BufferUploader& uploader)
+	    : m_instance {instance}, m_image {nullptr}, m_decompressed {false}
+	{
+		const TextureFile file {path};
+
+		VkFormat format = file.format();
+		if (!can_sample(*m_instance, format))
+		{
+			if (!bc::is_block_compressed(format) || !can_sample(*m_instance, bc::decompressed_format(format)))
+			{
+				VK_LOG(VK_THROW, "Device cannot sample texture format {0}: {1}.", static_cast<int>(format), path);
+			}
+
+			format         = bc::decompressed_format(format);
+			m_decompressed = true;
+		}
+
+		const TextureLevel& base = file.level(0);
+
+		// clang-format off
+		ImageInfo image_info
+		{
+			.m_format = format,
+			.m_type = VK_IMAGE_VIEW_TYPE_2D,
+			.m_extent = {base.m_width, base.m_height},
+			.m_mip_levels = file.level_count(),
+			.m_usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+		};
+		// clang-format on
+
+		m_image = std::make_unique<Image>(m_instance, image_info);
+
+		// Levels go straight from the mapped file (or the decoder) into staging memory, with no intermediate copy.
+		for (std::uint32_t i = 0; i < file.level_count(); i++)
+		{
+			const TextureLevel& level = file.level(i);
+			const VkDeviceSize size   = m_decompressed ? static_cast<VkDeviceSize>(level.m_width) * level.m_height * 4 : level.m_data.size();
+			const auto staging        = uploader.upload(*m_image, i, size);
+
+			if (m_decompressed)
+			{
+				bc::decompress(file.format(), level.m_data, level.m_width, level.m_height, staging);
+			}
+			else
+			{
+				std::memcpy(staging.data(), level.m_data.data(), level.m_data.size());
+			}
+		}
+	}
+
+	Image& Texture::image()
+	{
+		return *m_image;
+	}
+
+	const Image& Texture::image() const
+	{
+		return *m_image;
+	}
+
+	bool Texture::decompressed() const
+	{
+		return m_decompressed;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef VULKANO_GRAPHICS_TEXTURE_HPP_
+#define VULKANO_GRAPHICS_TEXTURE_HPP_
+
+#include <string_view>
+
+#include "vulkano/graphics/Image.hpp"
+
+namespace vulkano
+{
+	class BufferUploader;
+	class Instance;
+
+	///
+	/// Sampled texture loaded from a KTX2 or DDS file.
+	/// Block compressed levels are copied from the mapped file to staging memory as is, and only decoded on the CPU
+	/// when the device cannot sample the format.
+	///
+	class Texture final
+	{
+	public:
+		///
+		/// Stages every level in uploader. Record the uploader before the texture is first used, which leaves the
+		/// image in TRANSFER_DST, so declare its first use (i.e. SAMPLED_GRAPHICS) with a BarrierBatch.
+		///
+		Texture(Instance* instance, std::string_view path, BufferUploader& uploader);
+		~Texture() = default;
+
+		[[nodiscard]] Image& image();
+		[[nodiscard]] const Image& image() const;
+
+		///
+		/// True when the file was decoded to RGBA8 because the device lacks support for its format.
+		///
+		[[nodiscard]] bool decompressed() const;
+
+	private:
+		Texture() = delete;
+
+		Instance* m_instance;
+		std::unique_ptr<Image> m_image;
+		bool m_decompressed;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "vulkano/graphics/BlockCompression.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "TextureFile.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr std::array<std::uint8_t, 12> KTX2_IDENTIFIER {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+		///
+		/// Identifier, 9 header fields, then the dfd/kvd/sgd index.
+		///
+		constexpr std::size_t KTX2_LEVEL_INDEX_OFFSET = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+
+		constexpr std::uint32_t DDS_MAGIC       = 0x20534444;
+		constexpr std::size_t DDS_HEADER_SIZE   = 4 + 124;
+		constexpr std::size_t DDS_DX10_SIZE     = 20;
+
+		///
+		/// File offsets, counting the magic.
+		///
+		constexpr std::size_t DDS_SIZE_OFFSET   = 4;
+		constexpr std::size_t DDS_HEIGHT_OFFSET = 12;
+		constexpr std::size_t DDS_WIDTH_OFFSET  = 16;
+		constexpr std::size_t DDS_MIPS_OFFSET   = 28;
+		constexpr std::size_t DDS_FOURCC_OFFSET = 84;
+
+		[[nodiscard]] constexpr std::uint32_t fourcc(const char (&code)[5])
+		{
+			return static_cast<std::uint32_t>(code[0]) | (static_cast<std::uint32_t>(code[1]) << 8) | (static_cast<std::uint32_t>(code[2]) << 16) | (static_cast<std::uint32_t>(code[3]) << 24);
+		}
+
+		template<typename Type>
+		[[nodiscard]] Type read(std::span<const std::byte> data, std::size_t offset, std::string_view path)
+		{
+			if (offset + sizeof(Type) > data.size())
+			{
+				VK_LOG(VK_THROW, "Truncated texture file: {0}.", path);
+			}
+
+			Type value;
+			std::memcpy(&value, data.data() + offset, sizeof(Type));
+
+			return value;
+		}
+
+		[[nodiscard]] VkFormat from_dxgi(std::uint32_t dxgi)
+		{
+			switch (dxgi)
+			{
+				case 28:
+					return VK_FORMAT_R8G8B8A8_UNORM;
+				case 29:
+					return VK_FORMAT_R8G8B8A8_SRGB;
+				case 71:
+					return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+				case 72:
+					return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+				case 77:
+					return VK_FORMAT_BC3_UNORM_BLOCK;
+				case 78:
+					return VK_FORMAT_BC3_SRGB_BLOCK;
+				case 80:
+					return VK_FORMAT_BC4_UNORM_BLOCK;
+				case 83:
+					return VK_FORMAT_BC5_UNORM_BLOCK;
+				case 98:
+					return VK_FORMAT_BC7_UNORM_BLOCK;
+				case 99:
+					return VK_FORMAT_BC7_SRGB_BLOCK;
+				default:
+					return VK_FORMAT_UNDEFINED;
+			}
+		}
+
+		[[nodiscard]] VkFormat from_fourcc(std::uint32_t code)
+		{
+			if (code == fourcc("DXT1"))
+			{
+				return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			}
+			else if (code == fourcc("DXT5"))
+			{
+				return VK_FORMAT_BC3_UNORM_BLOCK;
+			}
+			else if (code == fourcc("ATI1") || code == fourcc("BC4U"))
+			{
+				return VK_FORMAT_BC4_UNORM_BLOCK;
+			}
+			else if (code == fourcc("ATI2") || code == fourcc("BC5U"))
+			{
+				return VK_FORMAT_BC5_UNORM_BLOCK;
+			}
+
+			return VK_FORMAT_UNDEFINED;
+		}
+
+		[[nodiscard]] bool is_supported(VkFormat format)
+		{
+			return bc::is_block_compressed(format) || format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB;
+		}
+
+		[[nodiscard]] std::size_t level_size(VkFormat format, std::uint32_t width, std::uint32_t height)
+		{
+			if (bc::is_block_compressed(format))
+			{
+				return bc::level_size(format, width, height);
+			}
+
+			return static_cast<std::size_t>(width) * height * 4;
+		}
+	} // namespace
+
+	TextureFile::TextureFile(std::string_view path)
+	    : m_file {path}, m_format {VK_FORMAT_UNDEFINED}
+	{
+		const auto data = m_file.data();
+		if (data.size() >= KTX2_IDENTIFIER.size() && std::memcmp(data.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size()) == 0)
+		{
+			parse_ktx2(path);
+		}
+		else if (data.size() >= DDS_HEADER_SIZE && read<std::uint32_t>(data, 0, path) == DDS_MAGIC)
+		{
+			parse_dds(path);
+		}
+		else
+		{
+			VK_LOG(VK_THROW, "Unrecognised texture container: {0}.", path);
+		}
+	}
+
+	VkFormat TextureFile::format() const
+	{
+		return m_format;
+	}
+
+	std::uint32_t TextureFile::level_count() const
+	{
+		return static_cast<std::uint32_t>(m_levels.size());
+	}
+
+	const TextureLevel& TextureFile::level(std::uint32_t index) const
+	{
+		return m_levels[index];
+	}
+
+	void TextureFile::parse_ktx2(std::string_view path)
+	{
+		const auto data = m_file.data();
+
+		m_format = static_cast<VkFormat>(read<std::uint32_t>(data, 12, path));
+
+		const auto width            = read<std::uint32_t>(data, 20, path);
+		const auto height           = read<std::uint32_t>(data, 24, path);
+		const auto depth            = read<std::uint32_t>(data, 28, path);
+		const auto layers           = read<std::uint32_t>(data, 32, path);
+		const auto faces            = read<std::uint32_t>(data, 36, path);
+		const auto levels           = std::max(read<std::uint32_t>(data, 40, path), 1u);
+		const auto supercompression = read<std::uint32_t>(data, 44, path);
+
+		if (supercompression != 0)
+		{
+			VK_LOG(VK_THROW, "Supercompressed KTX2 files are not supported: {0}.", path);
+		}
+
+		if (depth > 1 || layers > 1 || faces != 1 || height == 0)
+		{
+			VK_LOG(VK_THROW, "Only single layer 2D KTX2 textures are supported: {0}.", path);
+		}
+
+		if (!is_supported(m_format))
+		{
+			VK_LOG(VK_THROW, "Unsupported KTX2 format {0}: {1}.", static_cast<int>(m_format), path);
+		}
+
+		// Level 0 is always the base level, regardless of where its data is placed in the file.
+		m_levels.reserve(levels);
+		for (std::uint32_t i = 0; i < levels; i++)
+		{
+			const std::size_t entry = KTX2_LEVEL_INDEX_OFFSET + i * 3 * sizeof(std::uint64_t);
+			const auto offset       = read<std::uint64_t>(data, entry, path);
+			const auto length       = read<std::uint64_t>(data, entry + sizeof(std::uint64_t), path);
+
+			const std::uint32_t level_width  = std::max(width >> i, 1u);
+			const std::uint32_t level_height = std::max(height >> i, 1u);
+
+			if (offset + length > data.size() || length < level_size(m_format, level_width, level_height))
+			{
+				VK_LOG(VK_THROW, "KTX2 level {0} is out of bounds: {1}.", i, path);
+			}
+
+			m_levels.push_back({level_width, level_height, data.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(length))});
+		}
+	}
+
+	void TextureFile::parse_dds(std::string_view path)
+	{
+		const auto data = m_file.data();
+
+		if (read<std::uint32_t>(data, DDS_SIZE_OFFSET, path) != DDS_HEADER_SIZE - 4)
+		{
+			VK_LOG(VK_THROW, "Malformed DDS header: {0}.", path);
+		}
+
+		const auto height = read<std::uint32_t>(data, DDS_HEIGHT_OFFSET, path);
+		const auto width  = read<std::uint32_t>(data, DDS_WIDTH_OFFSET, path);
+		const auto levels = std::max(read<std::uint32_t>(data, DDS_MIPS_OFFSET, path), 1u);
+		const auto code   = read<std::uint32_t>(data, DDS_FOURCC_OFFSET, path);
+
+		std::size_t offset = DDS_HEADER_SIZE;
+		if (code == fourcc("DX10"))
+		{
+			m_format = from_dxgi(read<std::uint32_t>(data, DDS_HEADER_SIZE, path));
+
+			// Resource dimension 3 is TEXTURE2D, array size is the fourth field.
+			if (read<std::uint32_t>(data, DDS_HEADER_SIZE + 4, path) != 3 || read<std::uint32_t>(data, DDS_HEADER_SIZE + 12, path) > 1)
+			{
+				VK_LOG(VK_THROW, "Only single layer 2D DDS textures are supported: {0}.", path);
+			}
+
+			offset += DDS_DX10_SIZE;
+		}
+		else
+		{
+			m_format = from_fourcc(code);
+		}
+
+		if (!is_supported(m_format))
+		{
+			VK_LOG(VK_THROW, "Unsupported DDS format: {0}.", path);
+		}
+
+		// DDS levels are stored back to back, largest first.
+		m_levels.reserve(levels);
+		for (std::uint32_t i = 0; i < levels; i++)
+		{
+			const std::uint32_t level_width  = std::max(width >> i, 1u);
+			const std::uint32_t level_height = std::max(height >> i, 1u);
+			const std::size_t size           = level_size(m_format, level_width, level_height);
+
+			if (offset + size > data.size())
+			{
+				VK_LOG(VK_THROW, "DDS level {0} is out of bounds: {1}.", i, path);
+			}
+
+			m_levels.push_back({level_width, level_height, data.subspan(offset, size)});
+			offset += size;
+		}
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef VULKANO_GRAPHICS_TEXTUREFILE_HPP_
+#define VULKANO_GRAPHICS_TEXTUREFILE_HPP_
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "vulkano/utils/MappedFile.hpp"
+
+namespace vulkano
+{
+	///
+	/// One mip level of a TextureFile, pointing straight into the mapped file.
+	///
+	struct TextureLevel final
+	{
+		std::uint32_t m_width;
+		std::uint32_t m_height;
+		std::span<const std::byte> m_data;
+	};
+
+	///
+	/// Memory mapped KTX2 or DDS texture. Only the headers are parsed, level data is never copied or transcoded.
+	/// Supports single layer 2D textures in BC1, BC3, BC4, BC5, BC7 and RGBA8, with KTX2 supercompression disabled.
+	///
+	class TextureFile final
+	{
+	public:
+		TextureFile(std::string_view path);
+		~TextureFile() = default;
+
+		[[nodiscard]] VkFormat format() const;
+		[[nodiscard]] std::uint32_t level_count() const;
+		[[nodiscard]] const TextureLevel& level(std::uint32_t index) const;
+
+	private:
+		TextureFile() = delete;
+
+		void parse_ktx2(std::string_view path);
+		void parse_dds(std::string_view path);
+
+		MappedFile m_file;
+		VkFormat m_format;
+		std::vector<TextureLevel> m_levels;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
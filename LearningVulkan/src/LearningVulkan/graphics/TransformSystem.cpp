@@ -0,0 +1,437 @@
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define VULKANO_TRANSFORM_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define VULKANO_TRANSFORM_NEON
+	#include <arm_neon.h>
+#endif
+
+#include <glm/mat3x3.hpp>
+
+#include "vulkano/core/JobSystem.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "TransformSystem.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr std::uint32_t NONE = UINT32_MAX;
+
+		///
+		/// parent * local, where local is built from translation, rotation and scale. glm only vectorises with
+		/// aligned types forced globally, which would change the layout of every struct shared with shaders, so the
+		/// product is written out per column here.
+		///
+		void compose(const glm::mat4& parent, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& world)
+		{
+			const glm::mat3 basis = glm::mat3_cast(rotation);
+
+			const glm::mat4 local {glm::vec4 {basis[0] * scale.x, 0.0f}, glm::vec4 {basis[1] * scale.y, 0.0f}, glm::vec4 {basis[2] * scale.z, 0.0f}, glm::vec4 {translation, 1.0f}};
+
+#if defined(VULKANO_TRANSFORM_SSE2)
+			const __m128 p0 = _mm_loadu_ps(&parent[0].x);
+			const __m128 p1 = _mm_loadu_ps(&parent[1].x);
+			const __m128 p2 = _mm_loadu_ps(&parent[2].x);
+			const __m128 p3 = _mm_loadu_ps(&parent[3].x);
+
+			for (glm::length_t c = 0; c < 4; c++)
+			{
+				const __m128 xy = _mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(local[c].x)), _mm_mul_ps(p1, _mm_set1_ps(local[c].y)));
+				const __m128 zw = _mm_add_ps(_mm_mul_ps(p2, _mm_set1_ps(local[c].z)), _mm_mul_ps(p3, _mm_set1_ps(local[c].w)));
+				_mm_storeu_ps(&world[c].x, _mm_add_ps(xy, zw));
+			}
+#elif defined(VULKANO_TRANSFORM_NEON)
+			const float32x4_t p0 = vld1q_f32(&parent[0].x);
+			const float32x4_t p1 = vld1q_f32(&parent[1].x);
+			const float32x4_t p2 = vld1q_f32(&parent[2].x);
+			const float32x4_t p3 = vld1q_f32(&parent[3].x);
+
+			for (glm::length_t c = 0; c < 4; c++)
+			{
+				float32x4_t column = vmulq_n_f32(p0, local[c].x);
+				column             = vmlaq_n_f32(column, p1, local[c].y);
+				column             = vmlaq_n_f32(column, p2, local[c].z);
+				column             = vmlaq_n_f32(column, p3, local[c].w);
+				vst1q_f32(&world[c].x, column);
+			}
+#else
+			world = parent * local;
+#endif
+		}
+
+		///
+		/// Calls body(begin, end) over slots [first, last), split across the job system when there is one.
+		///
+		template<typename Body>
+		void for_slots(JobSystem* jobs, std::uint32_t first, std::uint32_t last, Body&& body)
+		{
+			if (!jobs)
+			{
+				body(first, last);
+				return;
+			}
+
+			jobs->parallel_for(last - first, TransformSystem::TRANSFORMS_PER_JOB, [first, &body](std::uint32_t begin, std::uint32_t end) { body(first + begin, first + end); });
+		}
+	} // namespace
+
+	TransformSystem::TransformSystem(Instance* instance, const TransformSystem::Settings& settings, JobSystem* jobs)
+	    : m_settings {settings}, m_jobs {jobs}, m_first_dirty_level {NONE}, m_pending_frames {0}, m_reorder {false}
+	{
+		if (settings.m_frames_in_flight > UINT8_MAX)
+		{
+			VK_LOG(VK_THROW, "Transforms count pending frame writes in a byte, so {0} frames in flight are too many.", settings.m_frames_in_flight);
+		}
+
+		m_buffers.reserve(settings.m_frames_in_flight);
+		for (std::uint32_t i = 0; i < settings.m_frames_in_flight; i++)
+		{
+			// clang-format off
+			BufferInfo info
+			{
+				.m_size = std::max<VkDeviceSize>(settings.m_max_transforms, 1) * sizeof(glm::mat4),
+				.m_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				.m_memory = MemoryUsage::UPLOAD
+			};
+			// clang-format on
+
+			m_buffers.emplace_back(instance, info);
+			if (!m_buffers.back().mapped())
+			{
+				VK_LOG(VK_THROW, "Transform buffers need host visible memory.");
+			}
+		}
+	}
+
+	std::uint32_t TransformSystem::create(std::uint32_t parent)
+	{
+		const auto slot = static_cast<std::uint32_t>(m_id.size());
+		if (slot == m_settings.m_max_transforms)
+		{
+			VK_LOG(VK_THROW, "All {0} transforms are in use.", m_settings.m_max_transforms);
+		}
+
+		std::uint32_t parent_slot = NONE;
+		std::uint32_t depth       = 0;
+		if (parent != NO_PARENT)
+		{
+			parent_slot = m_slot[parent];
+			if (parent_slot == NONE || m_destroyed[parent_slot])
+			{
+				VK_LOG(VK_THROW, "Transform {0} cannot be a parent: it was destroyed.", parent);
+			}
+
+			depth = m_depth[parent_slot] + 1;
+		}
+
+		std::uint32_t id;
+		if (!m_free.empty())
+		{
+			id = m_free.back();
+			m_free.pop_back();
+		}
+		else
+		{
+			id = static_cast<std::uint32_t>(m_slot.size());
+			m_slot.push_back(NONE);
+		}
+
+		m_slot[id] = slot;
+		m_translation.emplace_back(0.0f);
+		m_rotation.push_back(glm::identity<glm::quat>());
+		m_scale.emplace_back(1.0f);
+		m_world.emplace_back(1.0f);
+		m_parent.push_back(parent_slot);
+		m_depth.push_back(depth);
+		m_id.push_back(id);
+		m_dirty.push_back(0);
+		m_pending.push_back(0);
+		m_destroyed.push_back(0);
+
+		// Appending keeps the order unless the new transform is shallower than the deepest level.
+		if (depth + 1 == m_level_end.size())
+		{
+			m_level_end.back()++;
+		}
+		else if (depth == m_level_end.size())
+		{
+			m_level_end.push_back(slot + 1);
+		}
+		else
+		{
+			m_reorder = true;
+		}
+
+		mark_dirty(slot);
+		return id;
+	}
+
+	void TransformSystem::destroy(std::uint32_t transform)
+	{
+		m_destroyed[m_slot[transform]] = 1;
+		m_reorder                      = true;
+	}
+
+	void TransformSystem::set_parent(std::uint32_t transform, std::uint32_t parent)
+	{
+		const std::uint32_t slot  = m_slot[transform];
+		std::uint32_t parent_slot = NONE;
+
+		if (parent != NO_PARENT)
+		{
+			parent_slot = m_slot[parent];
+			for (std::uint32_t ancestor = parent_slot; ancestor != NONE; ancestor = m_parent[ancestor])
+			{
+				if (ancestor == slot)
+				{
+					VK_LOG(VK_THROW, "Transform {0} cannot be parented to {1}, which is below it.", transform, parent);
+				}
+			}
+		}
+
+		// Depths below change too, so the whole order is rebuilt.
+		m_parent[slot] = parent_slot;
+		m_reorder      = true;
+		mark_dirty(slot);
+	}
+
+	void TransformSystem::set_translation(std::uint32_t transform, const glm::vec3& translation)
+	{
+		const std::uint32_t slot = m_slot[transform];
+		m_translation[slot]      = translation;
+		mark_dirty(slot);
+	}
+
+	void TransformSystem::set_rotation(std::uint32_t transform, const glm::quat& rotation)
+	{
+		const std::uint32_t slot = m_slot[transform];
+		m_rotation[slot]         = rotation;
+		mark_dirty(slot);
+	}
+
+	void TransformSystem::set_scale(std::uint32_t transform, const glm::vec3& scale)
+	{
+		const std::uint32_t slot = m_slot[transform];
+		m_scale[slot]            = scale;
+		mark_dirty(slot);
+	}
+
+	const glm::vec3& TransformSystem::translation(std::uint32_t transform) const
+	{
+		return m_translation[m_slot[transform]];
+	}
+
+	const glm::quat& TransformSystem::rotation(std::uint32_t transform) const
+	{
+		return m_rotation[m_slot[transform]];
+	}
+
+	const glm::vec3& TransformSystem::scale(std::uint32_t transform) const
+	{
+		return m_scale[m_slot[transform]];
+	}
+
+	const glm::mat4& TransformSystem::world(std::uint32_t transform) const
+	{
+		return m_world[m_slot[transform]];
+	}
+
+	void TransformSystem::update(std::uint32_t frame)
+	{
+		if (m_reorder)
+		{
+			reorder();
+		}
+
+		const bool changed = m_first_dirty_level != NONE;
+
+		// Levels above the first dirty one are untouched. Below it, a transform is recomputed if it or its parent
+		// changed, and the parent's level has finished by then.
+		for (std::uint32_t level = changed ? m_first_dirty_level : static_cast<std::uint32_t>(m_level_end.size()); level < m_level_end.size(); level++)
+		{
+			const std::uint32_t begin = (level > 0) ? m_level_end[level - 1] : 0;
+			for_slots(m_jobs, begin, m_level_end[level], [this](std::uint32_t first, std::uint32_t last) {
+				for (std::uint32_t slot = first; slot < last; slot++)
+				{
+					const std::uint32_t parent = m_parent[slot];
+					if (parent != NONE)
+					{
+						m_dirty[slot] |= m_dirty[parent];
+					}
+
+					if (m_dirty[slot])
+					{
+						compose((parent != NONE) ? m_world[parent] : glm::mat4 {1.0f}, m_translation[slot], m_rotation[slot], m_scale[slot], m_world[slot]);
+					}
+				}
+			});
+		}
+
+		m_first_dirty_level = NONE;
+
+		// A matrix has to reach every frame's buffer, one frame at a time as each comes round.
+		if (changed)
+		{
+			m_pending_frames = m_settings.m_frames_in_flight;
+		}
+
+		if (m_pending_frames == 0)
+		{
+			return;
+		}
+
+		m_pending_frames--;
+
+		Buffer& buffer         = m_buffers[frame];
+		std::byte* destination = buffer.mapped();
+		const auto frames      = static_cast<std::uint8_t>(m_settings.m_frames_in_flight);
+
+		for_slots(m_jobs, 0, static_cast<std::uint32_t>(m_id.size()), [&](std::uint32_t first, std::uint32_t last) {
+			for (std::uint32_t slot = first; slot < last; slot++)
+			{
+				if (m_dirty[slot])
+				{
+					m_dirty[slot]   = 0;
+					m_pending[slot] = frames;
+				}
+
+				if (m_pending[slot])
+				{
+					std::memcpy(destination + m_id[slot] * sizeof(glm::mat4), &m_world[slot], sizeof(glm::mat4));
+					m_pending[slot]--;
+				}
+			}
+		});
+
+		buffer.flush();
+	}
+
+	const Buffer& TransformSystem::world_buffer(std::uint32_t frame) const
+	{
+		return m_buffers[frame];
+	}
+
+	std::uint32_t TransformSystem::size() const
+	{
+		return static_cast<std::uint32_t>(m_id.size());
+	}
+
+	void TransformSystem::mark_dirty(std::uint32_t slot)
+	{
+		m_dirty[slot]       = 1;
+		m_first_dirty_level = std::min(m_first_dirty_level, m_depth[slot]);
+	}
+
+	void TransformSystem::reorder()
+	{
+		const auto count = static_cast<std::uint32_t>(m_id.size());
+
+		// Resolve depth and destruction from the nearest resolved ancestor down, since parents may come after
+		// their children until the order is rebuilt.
+		std::vector<std::uint8_t> resolved(count, 0);
+		std::vector<std::uint32_t> chain;
+		for (std::uint32_t slot = 0; slot < count; slot++)
+		{
+			std::uint32_t current = slot;
+			while (current != NONE && !resolved[current])
+			{
+				chain.push_back(current);
+				current = m_parent[current];
+			}
+
+			std::uint32_t depth    = (current != NONE) ? m_depth[current] + 1 : 0;
+			std::uint8_t destroyed  = (current != NONE) ? m_destroyed[current] : 0;
+			for (auto link = chain.rbegin(); link != chain.rend(); ++link)
+			{
+				destroyed |= m_destroyed[*link];
+
+				m_depth[*link]     = depth++;
+				m_destroyed[*link] = destroyed;
+				resolved[*link]    = 1;
+			}
+
+			chain.clear();
+		}
+
+		// Counting sort by depth, stable so siblings keep their relative order.
+		std::vector<std::uint32_t> level_size;
+		for (std::uint32_t slot = 0; slot < count; slot++)
+		{
+			if (m_destroyed[slot])
+			{
+				m_slot[m_id[slot]] = NONE;
+				m_free.push_back(m_id[slot]);
+				continue;
+			}
+
+			if (m_depth[slot] >= level_size.size())
+			{
+				level_size.resize(m_depth[slot] + 1, 0);
+			}
+
+			level_size[m_depth[slot]]++;
+		}
+
+		m_level_end.resize(level_size.size());
+		std::vector<std::uint32_t> next(level_size.size());
+		for (std::uint32_t level = 0, end = 0; level < level_size.size(); level++)
+		{
+			next[level] = end;
+			end += level_size[level];
+			m_level_end[level] = end;
+		}
+
+		const std::uint32_t alive = m_level_end.empty() ? 0 : m_level_end.back();
+		std::vector<std::uint32_t> order(alive);
+		std::vector<std::uint32_t> new_slot(count, NONE);
+		for (std::uint32_t slot = 0; slot < count; slot++)
+		{
+			if (!m_destroyed[slot])
+			{
+				new_slot[slot]               = next[m_depth[slot]];
+				order[next[m_depth[slot]]++] = slot;
+			}
+		}
+
+		const auto gather = [&order](auto& values) {
+			std::remove_reference_t<decltype(values)> sorted;
+			sorted.reserve(order.size());
+			for (const std::uint32_t slot : order)
+			{
+				sorted.push_back(values[slot]);
+			}
+
+			values = std::move(sorted);
+		};
+
+		gather(m_translation);
+		gather(m_rotation);
+		gather(m_scale);
+		gather(m_world);
+		gather(m_parent);
+		gather(m_depth);
+		gather(m_id);
+		gather(m_dirty);
+		gather(m_pending);
+
+		m_destroyed.assign(alive, 0);
+		for (std::uint32_t slot = 0; slot < alive; slot++)
+		{
+			m_slot[m_id[slot]] = slot;
+			if (m_parent[slot] != NONE)
+			{
+				m_parent[slot] = new_slot[m_parent[slot]];
+			}
+		}
+
+		// Dirty transforms may have moved to any level.
+		m_first_dirty_level = 0;
+		m_reorder           = false;
+	}
+} // namespace vulkano
\ No newline at end of file
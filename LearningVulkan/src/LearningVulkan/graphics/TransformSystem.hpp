@@ -0,0 +1,141 @@
+#ifndef VULKANO_GRAPHICS_TRANSFORMSYSTEM_HPP_
+#define VULKANO_GRAPHICS_TRANSFORMSYSTEM_HPP_
+
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+
+#include "vulkano/graphics/Buffer.hpp"
+
+namespace vulkano
+{
+	class JobSystem;
+
+	///
+	/// Transform hierarchy without a pointer based scene graph. Local translation, rotation and scale live in one
+	/// array each, ordered by depth in the hierarchy, so every parent comes before its children and each level is a
+	/// contiguous range. update() walks the levels in order and splits each across the job system.
+	///
+	/// Setting a local value marks the transform dirty, and dirtiness flows down to children as the levels are
+	/// walked, so only changed subtrees are recomputed. World matrices are written straight into a persistently
+	/// mapped buffer per frame in flight, at the transform's id, so shaders can index them.
+	///
+	/// Ids are stable. Slots (positions in the arrays) change whenever the hierarchy is reordered.
+	///
+	class TransformSystem final
+	{
+	public:
+		static constexpr std::uint32_t NO_PARENT = UINT32_MAX;
+
+		///
+		/// Transforms each job updates or uploads.
+		///
+		static constexpr std::uint32_t TRANSFORMS_PER_JOB = 2048;
+
+		struct Settings final
+		{
+			std::uint32_t m_frames_in_flight;
+			std::uint32_t m_max_transforms;
+		};
+
+		TransformSystem(Instance* instance, const TransformSystem::Settings& settings, JobSystem* jobs = nullptr);
+		~TransformSystem() = default;
+
+		///
+		/// Returns the new transform's id. It starts as the identity.
+		///
+		[[nodiscard]] std::uint32_t create(std::uint32_t parent = NO_PARENT);
+
+		///
+		/// Destroys the transform and everything below it at the next update(), which frees their ids.
+		///
+		void destroy(std::uint32_t transform);
+
+		///
+		/// Keeps the local values, so the world transform changes with the new parent.
+		///
+		void set_parent(std::uint32_t transform, std::uint32_t parent);
+
+		void set_translation(std::uint32_t transform, const glm::vec3& translation);
+		void set_rotation(std::uint32_t transform, const glm::quat& rotation);
+		void set_scale(std::uint32_t transform, const glm::vec3& scale);
+
+		[[nodiscard]] const glm::vec3& translation(std::uint32_t transform) const;
+		[[nodiscard]] const glm::quat& rotation(std::uint32_t transform) const;
+		[[nodiscard]] const glm::vec3& scale(std::uint32_t transform) const;
+
+		///
+		/// As of the last update().
+		///
+		[[nodiscard]] const glm::mat4& world(std::uint32_t transform) const;
+
+		///
+		/// Recomputes changed world matrices and writes them, and any not yet in it, to frame's buffer. Call once per
+		/// frame, after the frame's fence has signalled.
+		///
+		void update(std::uint32_t frame);
+
+		///
+		/// World matrices indexed by transform id.
+		///
+		[[nodiscard]] const Buffer& world_buffer(std::uint32_t frame) const;
+
+		[[nodiscard]] std::uint32_t size() const;
+
+	private:
+		TransformSystem() = delete;
+		TransformSystem(const TransformSystem&) = delete;
+		TransformSystem& operator=(const TransformSystem&) = delete;
+
+		void mark_dirty(std::uint32_t slot);
+
+		///
+		/// Drops destroyed subtrees and sorts the rest by depth again.
+		///
+		void reorder();
+
+		Settings m_settings;
+		JobSystem* m_jobs;
+
+		///
+		/// Indexed by slot.
+		///
+		std::vector<glm::vec3> m_translation;
+		std::vector<glm::quat> m_rotation;
+		std::vector<glm::vec3> m_scale;
+		std::vector<glm::mat4> m_world;
+		std::vector<std::uint32_t> m_parent;
+		std::vector<std::uint32_t> m_depth;
+		std::vector<std::uint32_t> m_id;
+
+		///
+		/// Set by a local change or a changed parent, and cleared once the new world matrix is in the upload.
+		///
+		std::vector<std::uint8_t> m_dirty;
+
+		///
+		/// Frame buffers still missing the current world matrix.
+		///
+		std::vector<std::uint8_t> m_pending;
+		std::vector<std::uint8_t> m_destroyed;
+
+		///
+		/// Indexed by id, UINT32_MAX for free ids.
+		///
+		std::vector<std::uint32_t> m_slot;
+		std::vector<std::uint32_t> m_free;
+
+		///
+		/// One past the last slot of each level.
+		///
+		std::vector<std::uint32_t> m_level_end;
+		std::uint32_t m_first_dirty_level;
+		std::uint32_t m_pending_frames;
+		bool m_reorder;
+
+		std::vector<Buffer> m_buffers;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cstring>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/packing.hpp>
+
+#include "vulkano/core/ShaderReflection.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "VertexLayout.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Maps a unit vector onto the octahedron, then unfolds the lower half over the upper one.
+		///
+		[[nodiscard]] glm::vec2 oct_encode(glm::vec3 n)
+		{
+			n /= (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+
+			glm::vec2 e {n.x, n.y};
+			if (n.z < 0.0f)
+			{
+				e = {(1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)};
+			}
+
+			return e;
+		}
+
+		[[nodiscard]] glm::vec4 source(const Vertex& vertex, VertexAttribute attribute)
+		{
+			switch (attribute)
+			{
+				case VertexAttribute::POSITION:
+					return {vertex.m_position, 1.0f};
+
+				case VertexAttribute::NORMAL:
+					return {vertex.m_normal, 0.0f};
+
+				case VertexAttribute::TANGENT:
+					return vertex.m_tangent;
+
+				case VertexAttribute::UV:
+					return {vertex.m_uv, 0.0f, 0.0f};
+
+				default:
+					return vertex.m_colour;
+			}
+		}
+
+		template<typename Type>
+		void store(std::byte* destination, const Type& value)
+		{
+			std::memcpy(destination, &value, sizeof(Type));
+		}
+
+		void encode(std::byte* destination, VertexFormat format, const glm::vec4& value)
+		{
+			switch (format)
+			{
+				case VertexFormat::FLOAT2:
+					store(destination, glm::vec2 {value.x, value.y});
+					break;
+
+				case VertexFormat::FLOAT3:
+					store(destination, glm::vec3 {value.x, value.y, value.z});
+					break;
+
+				case VertexFormat::FLOAT4:
+					store(destination, value);
+					break;
+
+				case VertexFormat::HALF4:
+					store(destination, glm::packHalf4x16({value.x, value.y, value.z, 1.0f}));
+					break;
+
+				case VertexFormat::HALF2:
+					store(destination, glm::packHalf2x16({value.x, value.y}));
+					break;
+
+				case VertexFormat::OCT_SNORM16:
+					store(destination, glm::packSnorm2x16(oct_encode(glm::normalize(glm::vec3 {value.x, value.y, value.z}))));
+					break;
+
+				case VertexFormat::SNORM8X4:
+					store(destination, glm::packSnorm4x8(value));
+					break;
+
+				case VertexFormat::UNORM16X2:
+					store(destination, glm::packUnorm2x16({value.x, value.y}));
+					break;
+
+				case VertexFormat::UNORM8X4:
+					store(destination, glm::packUnorm4x8(value));
+					break;
+			}
+		}
+	} // namespace
+
+	VkPipelineVertexInputStateCreateInfo VertexInput::info() const
+	{
+		// clang-format off
+		return VkPipelineVertexInputStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.vertexBindingDescriptionCount = static_cast<std::uint32_t>(m_bindings.size()),
+			.pVertexBindingDescriptions = m_bindings.data(),
+			.vertexAttributeDescriptionCount = static_cast<std::uint32_t>(m_attributes.size()),
+			.pVertexAttributeDescriptions = m_attributes.data()
+		};
+		// clang-format on
+	}
+
+	VertexLayout& VertexLayout::add(VertexAttribute attribute, VertexFormat format, std::uint32_t stream)
+	{
+		if (stream >= MAX_STREAMS || has(attribute))
+		{
+			VK_LOG(VK_THROW, "Invalid vertex layout element: attribute {0} in stream {1}.", static_cast<int>(attribute), stream);
+		}
+
+		// Every format is a multiple of four bytes, so offsets stay aligned.
+		m_elements.push_back({attribute, format, stream, m_strides[stream]});
+		m_strides[stream] += format_size(format);
+
+		return *this;
+	}
+
+	VertexLayout VertexLayout::full_precision()
+	{
+		VertexLayout layout;
+		layout.add(VertexAttribute::POSITION, VertexFormat::FLOAT3)
+		    .add(VertexAttribute::NORMAL, VertexFormat::FLOAT3)
+		    .add(VertexAttribute::TANGENT, VertexFormat::FLOAT4)
+		    .add(VertexAttribute::UV, VertexFormat::FLOAT2)
+		    .add(VertexAttribute::COLOUR, VertexFormat::UNORM8X4);
+
+		return layout;
+	}
+
+	VertexLayout VertexLayout::quantized()
+	{
+		VertexLayout layout;
+		layout.add(VertexAttribute::POSITION, VertexFormat::HALF4)
+		    .add(VertexAttribute::NORMAL, VertexFormat::OCT_SNORM16)
+		    .add(VertexAttribute::TANGENT, VertexFormat::SNORM8X4)
+		    .add(VertexAttribute::UV, VertexFormat::UNORM16X2)
+		    .add(VertexAttribute::COLOUR, VertexFormat::UNORM8X4);
+
+		return layout;
+	}
+
+	VertexLayout VertexLayout::split_quantized()
+	{
+		VertexLayout layout;
+		layout.add(VertexAttribute::POSITION, VertexFormat::HALF4, 0)
+		    .add(VertexAttribute::NORMAL, VertexFormat::OCT_SNORM16, 1)
+		    .add(VertexAttribute::TANGENT, VertexFormat::SNORM8X4, 1)
+		    .add(VertexAttribute::UV, VertexFormat::UNORM16X2, 1)
+		    .add(VertexAttribute::COLOUR, VertexFormat::UNORM8X4, 1);
+
+		return layout;
+	}
+
+	VertexInput VertexLayout::input_state(const ShaderReflection& vertex_shader) const
+	{
+		VertexInput input;
+		std::array<bool, MAX_STREAMS> used = {};
+
+		for (const auto& shader_input : vertex_shader.inputs())
+		{
+			const auto element = std::find_if(m_elements.begin(), m_elements.end(), [&](const Element& entry) {
+				return static_cast<std::uint32_t>(entry.m_attribute) == shader_input.m_location;
+			});
+
+			if (element == m_elements.end())
+			{
+				VK_LOG(VK_THROW, "Vertex shader reads location {0} ({1}), which the vertex layout does not provide.", shader_input.m_location, shader_input.m_name);
+			}
+
+			input.m_attributes.push_back({shader_input.m_location, element->m_stream, vk_format(element->m_format), element->m_offset});
+			used[element->m_stream] = true;
+		}
+
+		for (std::uint32_t stream = 0; stream < MAX_STREAMS; stream++)
+		{
+			if (used[stream])
+			{
+				input.m_bindings.push_back({stream, m_strides[stream], VK_VERTEX_INPUT_RATE_VERTEX});
+			}
+		}
+
+		return input;
+	}
+
+	std::array<std::vector<std::byte>, VertexLayout::MAX_STREAMS> VertexLayout::pack(std::span<const Vertex> vertices) const
+	{
+		std::array<std::vector<std::byte>, MAX_STREAMS> streams;
+		for (std::uint32_t stream = 0; stream < MAX_STREAMS; stream++)
+		{
+			streams[stream].resize(static_cast<std::size_t>(m_strides[stream]) * vertices.size());
+		}
+
+		for (std::size_t i = 0; i < vertices.size(); i++)
+		{
+			for (const auto& element : m_elements)
+			{
+				std::byte* destination = streams[element.m_stream].data() + i * m_strides[element.m_stream] + element.m_offset;
+				encode(destination, element.m_format, source(vertices[i], element.m_attribute));
+			}
+		}
+
+		return streams;
+	}
+
+	bool VertexLayout::has(VertexAttribute attribute) const
+	{
+		return std::any_of(m_elements.begin(), m_elements.end(), [&](const Element& element) {
+			return element.m_attribute == attribute;
+		});
+	}
+
+	std::uint32_t VertexLayout::stride(std::uint32_t stream) const
+	{
+		return m_strides[stream];
+	}
+
+	std::uint32_t VertexLayout::stream_count() const
+	{
+		return static_cast<std::uint32_t>(std::count_if(m_strides.begin(), m_strides.end(), [](std::uint32_t stride) {
+			return stride > 0;
+		}));
+	}
+
+	VkFormat VertexLayout::vk_format(VertexFormat format)
+	{
+		switch (format)
+		{
+			case VertexFormat::FLOAT2:
+				return VK_FORMAT_R32G32_SFLOAT;
+
+			case VertexFormat::FLOAT3:
+				return VK_FORMAT_R32G32B32_SFLOAT;
+
+			case VertexFormat::FLOAT4:
+				return VK_FORMAT_R32G32B32A32_SFLOAT;
+
+			case VertexFormat::HALF4:
+				return VK_FORMAT_R16G16B16A16_SFLOAT;
+
+			case VertexFormat::HALF2:
+				return VK_FORMAT_R16G16_SFLOAT;
+
+			case VertexFormat::OCT_SNORM16:
+				return VK_FORMAT_R16G16_SNORM;
+
+			case VertexFormat::SNORM8X4:
+				return VK_FORMAT_R8G8B8A8_SNORM;
+
+			case VertexFormat::UNORM16X2:
+				return VK_FORMAT_R16G16_UNORM;
+
+			case VertexFormat::UNORM8X4:
+				return VK_FORMAT_R8G8B8A8_UNORM;
+		}
+
+		return VK_FORMAT_UNDEFINED;
+	}
+
+	std::uint32_t VertexLayout::format_size(VertexFormat format)
+	{
+		switch (format)
+		{
+			case VertexFormat::FLOAT2:
+			case VertexFormat::HALF4:
+				return 8;
+
+			case VertexFormat::FLOAT3:
+				return 12;
+
+			case VertexFormat::FLOAT4:
+				return 16;
+
+			default:
+				return 4;
+		}
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef VULKANO_GRAPHICS_VERTEXLAYOUT_HPP_
+#define VULKANO_GRAPHICS_VERTEXLAYOUT_HPP_
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class ShaderReflection;
+
+	///
+	/// What an attribute holds. The value is also the shader input location it is bound to.
+	///
+	enum class VertexAttribute
+	{
+		POSITION,
+		NORMAL,
+		TANGENT,
+		UV,
+		COLOUR,
+		COUNT
+	};
+
+	///
+	/// How an attribute is stored.
+	///
+	enum class VertexFormat
+	{
+		FLOAT2,
+		FLOAT3,
+		FLOAT4,
+
+		///
+		/// Half floats, w is 1. Enough for positions in a mesh's local space.
+		///
+		HALF4,
+		HALF2,
+
+		///
+		/// Octahedral encoded unit vector in two snorm16. Decode in the shader with:
+		///     vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+		///     if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+		///     n = normalize(n);
+		///
+		OCT_SNORM16,
+
+		///
+		/// Tangents, with the bitangent sign in w.
+		///
+		SNORM8X4,
+
+		///
+		/// UVs in [0, 1]. Use HALF2 or FLOAT2 for tiling UVs.
+		///
+		UNORM16X2,
+		UNORM8X4
+	};
+
+	///
+	/// Full precision vertex, the input to VertexLayout::pack().
+	///
+	struct Vertex final
+	{
+		glm::vec3 m_position = {0.0f, 0.0f, 0.0f};
+		glm::vec3 m_normal   = {0.0f, 0.0f, 1.0f};
+		glm::vec4 m_tangent  = {1.0f, 0.0f, 0.0f, 1.0f};
+		glm::vec2 m_uv       = {0.0f, 0.0f};
+		glm::vec4 m_colour   = {1.0f, 1.0f, 1.0f, 1.0f};
+	};
+
+	///
+	/// Bindings and attributes for VkPipelineVertexInputStateCreateInfo, owned so the info stays valid.
+	///
+	struct VertexInput final
+	{
+		std::vector<VkVertexInputBindingDescription> m_bindings;
+		std::vector<VkVertexInputAttributeDescription> m_attributes;
+
+		[[nodiscard]] VkPipelineVertexInputStateCreateInfo info() const;
+	};
+
+	///
+	/// Describes how vertex attributes are stored across one or more streams, each stream being its own vertex buffer
+	/// binding. Keeping positions alone in stream 0 means depth only passes fetch nothing else.
+	///
+	class VertexLayout final
+	{
+	public:
+		static constexpr std::uint32_t MAX_STREAMS = 2;
+
+		VertexLayout()  = default;
+		~VertexLayout() = default;
+
+		///
+		/// Appends an attribute to a stream. Each attribute may appear once.
+		///
+		VertexLayout& add(VertexAttribute attribute, VertexFormat format, std::uint32_t stream = 0);
+
+		///
+		/// 52 bytes per vertex, interleaved: floats throughout except unorm8 colours.
+		///
+		[[nodiscard]] static VertexLayout full_precision();
+
+		///
+		/// 24 bytes per vertex, interleaved: half positions, octahedral normals, snorm8 tangents, unorm16 UVs and
+		/// unorm8 colours.
+		///
+		[[nodiscard]] static VertexLayout quantized();
+
+		///
+		/// Same formats as quantized(), with positions in stream 0 (8 bytes) and the rest in stream 1 (16 bytes).
+		///
+		[[nodiscard]] static VertexLayout split_quantized();
+
+		///
+		/// Bindings and attributes for exactly the inputs the shader reads. Streams it reads nothing from are left
+		/// out. Throws if the shader reads an attribute the layout lacks.
+		///
+		[[nodiscard]] VertexInput input_state(const ShaderReflection& vertex_shader) const;
+
+		///
+		/// Encodes vertices into one byte array per stream, ready for upload.
+		///
+		[[nodiscard]] std::array<std::vector<std::byte>, MAX_STREAMS> pack(std::span<const Vertex> vertices) const;
+
+		[[nodiscard]] bool has(VertexAttribute attribute) const;
+		[[nodiscard]] std::uint32_t stride(std::uint32_t stream) const;
+		[[nodiscard]] std::uint32_t stream_count() const;
+
+		[[nodiscard]] static VkFormat vk_format(VertexFormat format);
+		[[nodiscard]] static std::uint32_t format_size(VertexFormat format);
+
+	private:
+		struct Element final
+		{
+			VertexAttribute m_attribute;
+			VertexFormat m_format;
+			std::uint32_t m_stream;
+			std::uint32_t m_offset;
+		};
+
+		std::vector<Element> m_elements;
+		std::array<std::uint32_t, MAX_STREAMS> m_strides = {};
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,432 @@
+#include <algorithm>
+
+#include "vulkano/graphics/Buffer.hpp"
+#include "vulkano/graphics/Image.hpp"
+
+#include "Barriers.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr VkAccessFlags2 WRITE_ACCESS = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+		///
+		/// A barrier is needed for layout changes, for writes after any earlier use, and for reads the last write has
+		/// not been made visible to yet. Unused resources have nothing to wait on.
+		///
+		[[nodiscard]] bool needs_barrier(const ResourceState& previous, const ResourceState& next)
+		{
+			if (previous.m_layout != next.m_layout)
+			{
+				return true;
+			}
+
+			if (next.m_access & WRITE_ACCESS)
+			{
+				return previous.m_stages != VK_PIPELINE_STAGE_2_NONE;
+			}
+
+			return previous.m_write_stages != VK_PIPELINE_STAGE_2_NONE && ((next.m_stages & ~previous.m_visible_stages) || (next.m_access & ~previous.m_visible_access));
+		}
+
+		///
+		/// Writes and layout transitions wait for every use since the last write, but only that write has to be made
+		/// available. Write-after-read hazards just need the execution dependency, unless a layout transition (itself
+		/// a write) has to become visible to the next user. A read waits on the last write alone.
+		///
+		void fill_scopes(const ResourceState& previous, const ResourceState& next, VkPipelineStageFlags2& src_stages, VkAccessFlags2& src_access, VkPipelineStageFlags2& dst_stages, VkAccessFlags2& dst_access)
+		{
+			const bool transition = previous.m_layout != next.m_layout;
+
+			dst_stages = next.m_stages;
+			src_access = previous.m_write_access;
+			if ((next.m_access & WRITE_ACCESS) || transition)
+			{
+				src_stages = previous.m_stages;
+				dst_access = (previous.m_write_access || transition) ? next.m_access : VK_ACCESS_2_NONE;
+			}
+			else
+			{
+				src_stages = previous.m_write_stages;
+				dst_access = next.m_access;
+			}
+		}
+
+		///
+		/// Moves state to next, once any barrier fill_scopes() asked for is recorded. An ownership acquire starts the
+		/// resource over on its new queue, like a layout transition does.
+		///
+		void record_use(ResourceState& state, const ResourceState& next, bool acquired = false)
+		{
+			const bool write = next.m_access & WRITE_ACCESS;
+			if (write || acquired || state.m_layout != next.m_layout)
+			{
+				// clang-format off
+				state =
+				{
+					.m_stages         = next.m_stages,
+					.m_access         = next.m_access,
+					.m_layout         = next.m_layout,
+					.m_write_stages   = next.m_stages,
+					.m_write_access   = next.m_access & WRITE_ACCESS,
+					.m_visible_stages = write ? VK_PIPELINE_STAGE_2_NONE : next.m_stages,
+					.m_visible_access = write ? VK_ACCESS_2_NONE : next.m_access
+				};
+				// clang-format on
+				return;
+			}
+
+			state.m_stages |= next.m_stages;
+			state.m_access |= next.m_access;
+			state.m_visible_stages |= next.m_stages;
+			state.m_visible_access |= next.m_access;
+		}
+
+		[[nodiscard]] bool can_merge(const VkImageMemoryBarrier2& a, const VkImageMemoryBarrier2& b)
+		{
+			return a.image == b.image && a.srcStageMask == b.srcStageMask && a.srcAccessMask == b.srcAccessMask && a.dstStageMask == b.dstStageMask && a.dstAccessMask == b.dstAccessMask && a.oldLayout == b.oldLayout && a.newLayout == b.newLayout && a.srcQueueFamilyIndex == b.srcQueueFamilyIndex && a.dstQueueFamilyIndex == b.dstQueueFamilyIndex;
+		}
+	} // namespace
+
+	ResourceState usage_state(ResourceUsage usage)
+	{
+		switch (usage)
+		{
+			case ResourceUsage::TRANSFER_SRC:
+				return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+
+			case ResourceUsage::TRANSFER_DST:
+				return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+
+			case ResourceUsage::HOST_WRITE:
+				return {VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+
+			case ResourceUsage::HOST_READ:
+				return {VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+
+			case ResourceUsage::VERTEX_BUFFER:
+				return {VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+
+			case ResourceUsage::INDEX_BUFFER:
+				return {VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+
+			case ResourceUsage::INDIRECT_BUFFER:
+				return {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+
+			case ResourceUsage::UNIFORM_BUFFER:
+				return {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_UNIFORM_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+
+			case ResourceUsage::SAMPLED_GRAPHICS:
+				return {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+			case ResourceUsage::SAMPLED_COMPUTE:
+				return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+			case ResourceUsage::STORAGE_READ:
+				return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+
+			case ResourceUsage::STORAGE_WRITE:
+				return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+
+			case ResourceUsage::STORAGE_READ_WRITE:
+				return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+
+			case ResourceUsage::MESH_STORAGE_READ:
+				// Only valid on devices with mesh shading enabled.
+				return {VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+
+			case ResourceUsage::COLOUR_ATTACHMENT:
+				return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+			case ResourceUsage::DEPTH_ATTACHMENT:
+				return {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+			case ResourceUsage::DEPTH_READ:
+				return {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+
+			case ResourceUsage::PRESENT:
+				// Presentation is ordered by semaphores. The colour output stage lets the transition out of this
+				// layout chain with a swapchain acquire semaphore waited on at that stage.
+				return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+
+			default:
+				return {};
+		}
+	}
+
+	BarrierBatch::BarrierBatch()
+	    : m_memory {}
+	{
+		m_memory.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	}
+
+	void BarrierBatch::image(Image& image, ResourceUsage usage, std::uint32_t base_mip, std::uint32_t mip_count, bool discard)
+	{
+		const ImageInfo& info    = image.info();
+		const ResourceState next = usage_state(usage);
+		const std::uint32_t end  = (mip_count == VK_REMAINING_MIP_LEVELS) ? info.m_mip_levels : std::min(info.m_mip_levels, base_mip + mip_count);
+
+		// Identical transitions of neighbouring mips share a barrier, and so do layers whose barriers all match.
+		std::size_t previous_begin = m_images.size();
+		std::size_t previous_count = 0;
+
+		std::vector<VkImageMemoryBarrier2> current;
+		for (std::uint32_t layer = 0; layer < info.m_array_layers; layer++)
+		{
+			current.clear();
+			for (std::uint32_t mip = base_mip; mip < end; mip++)
+			{
+				ResourceState& state = image.state(mip, layer);
+				if (!needs_barrier(state, next))
+				{
+					record_use(state, next);
+					continue;
+				}
+
+				// clang-format off
+				VkImageMemoryBarrier2 barrier
+				{
+					.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+					.pNext = nullptr,
+					.oldLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.m_layout,
+					.newLayout = next.m_layout,
+					.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+					.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+					.image = image.vk_handle(),
+					.subresourceRange = {info.m_aspect, mip, 1, layer, 1}
+				};
+				// clang-format on
+
+				fill_scopes(state, next, barrier.srcStageMask, barrier.srcAccessMask, barrier.dstStageMask, barrier.dstAccessMask);
+				record_use(state, next);
+
+				if (!current.empty() && can_merge(current.back(), barrier))
+				{
+					auto& range = current.back().subresourceRange;
+					if (range.baseMipLevel + range.levelCount == mip)
+					{
+						range.levelCount++;
+						continue;
+					}
+				}
+
+				current.push_back(barrier);
+			}
+
+			bool same_as_previous = previous_count > 0 && previous_count == current.size();
+			for (std::size_t i = 0; same_as_previous && i < current.size(); i++)
+			{
+				const auto& previous = m_images[previous_begin + i];
+				const auto& range    = previous.subresourceRange;
+
+				same_as_previous = can_merge(previous, current[i]) && range.baseMipLevel == current[i].subresourceRange.baseMipLevel && range.levelCount == current[i].subresourceRange.levelCount && range.baseArrayLayer + range.layerCount == layer;
+			}
+
+			if (same_as_previous)
+			{
+				for (std::size_t i = 0; i < current.size(); i++)
+				{
+					m_images[previous_begin + i].subresourceRange.layerCount++;
+				}
+			}
+			else
+			{
+				previous_begin = m_images.size();
+				previous_count = current.size();
+				m_images.insert(m_images.end(), current.begin(), current.end());
+			}
+		}
+	}
+
+	void BarrierBatch::buffer(ResourceState& state, ResourceUsage usage)
+	{
+		ResourceState next = usage_state(usage);
+		next.m_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		if (!needs_barrier(state, next))
+		{
+			record_use(state, next);
+			return;
+		}
+
+		VkPipelineStageFlags2 src_stages = 0;
+		VkAccessFlags2 src_access        = 0;
+		VkPipelineStageFlags2 dst_stages = 0;
+		VkAccessFlags2 dst_access        = 0;
+		fill_scopes(state, next, src_stages, src_access, dst_stages, dst_access);
+
+		m_memory.srcStageMask |= src_stages;
+		m_memory.srcAccessMask |= src_access;
+		m_memory.dstStageMask |= dst_stages;
+		m_memory.dstAccessMask |= dst_access;
+
+		record_use(state, next);
+	}
+
+	void BarrierBatch::release(Buffer& buffer, std::uint32_t src_family, std::uint32_t dst_family)
+	{
+		if (src_family == dst_family)
+		{
+			return;
+		}
+
+		// clang-format off
+		VkBufferMemoryBarrier2 barrier
+		{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+			.pNext = nullptr,
+			.srcStageMask = buffer.state().m_stages,
+			.srcAccessMask = buffer.state().m_write_access,
+			.dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+			.dstAccessMask = VK_ACCESS_2_NONE,
+			.srcQueueFamilyIndex = src_family,
+			.dstQueueFamilyIndex = dst_family,
+			.buffer = buffer.vk_handle(),
+			.offset = 0,
+			.size = VK_WHOLE_SIZE
+		};
+		// clang-format on
+
+		m_buffers.push_back(barrier);
+	}
+
+	void BarrierBatch::acquire(Buffer& buffer, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family)
+	{
+		if (src_family == dst_family)
+		{
+			this->buffer(buffer.state(), usage);
+			return;
+		}
+
+		ResourceState next = usage_state(usage);
+		next.m_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// clang-format off
+		VkBufferMemoryBarrier2 barrier
+		{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+			.pNext = nullptr,
+			.srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+			.srcAccessMask = VK_ACCESS_2_NONE,
+			.dstStageMask = next.m_stages,
+			.dstAccessMask = next.m_access,
+			.srcQueueFamilyIndex = src_family,
+			.dstQueueFamilyIndex = dst_family,
+			.buffer = buffer.vk_handle(),
+			.offset = 0,
+			.size = VK_WHOLE_SIZE
+		};
+		// clang-format on
+
+		m_buffers.push_back(barrier);
+		record_use(buffer.state(), next, true);
+	}
+
+	void BarrierBatch::release(Image& image, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family)
+	{
+		if (src_family != dst_family)
+		{
+			transfer(image, usage, src_family, dst_family, false);
+		}
+	}
+
+	void BarrierBatch::acquire(Image& image, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family)
+	{
+		if (src_family == dst_family)
+		{
+			this->image(image, usage);
+			return;
+		}
+
+		transfer(image, usage, src_family, dst_family, true);
+	}
+
+	void BarrierBatch::transfer(Image& image, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family, bool acquire)
+	{
+		const ImageInfo& info    = image.info();
+		const ResourceState next = usage_state(usage);
+
+		for (std::uint32_t layer = 0; layer < info.m_array_layers; layer++)
+		{
+			for (std::uint32_t mip = 0; mip < info.m_mip_levels; mip++)
+			{
+				ResourceState& state = image.state(mip, layer);
+
+				// Both halves carry the same layout transition. The release only makes the source's writes available,
+				// the acquire only makes them visible to the destination's use.
+				// clang-format off
+				VkImageMemoryBarrier2 barrier
+				{
+					.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+					.pNext = nullptr,
+					.srcStageMask = acquire ? VK_PIPELINE_STAGE_2_NONE : state.m_stages,
+					.srcAccessMask = acquire ? VK_ACCESS_2_NONE : state.m_write_access,
+					.dstStageMask = acquire ? next.m_stages : VK_PIPELINE_STAGE_2_NONE,
+					.dstAccessMask = acquire ? next.m_access : VK_ACCESS_2_NONE,
+					.oldLayout = state.m_layout,
+					.newLayout = next.m_layout,
+					.srcQueueFamilyIndex = src_family,
+					.dstQueueFamilyIndex = dst_family,
+					.image = image.vk_handle(),
+					.subresourceRange = {info.m_aspect, mip, 1, layer, 1}
+				};
+				// clang-format on
+
+				if (acquire)
+				{
+					record_use(state, next, true);
+				}
+
+				if (!m_images.empty() && can_merge(m_images.back(), barrier))
+				{
+					auto& range = m_images.back().subresourceRange;
+					if (range.baseArrayLayer == layer && range.baseMipLevel + range.levelCount == mip)
+					{
+						range.levelCount++;
+						continue;
+					}
+				}
+
+				m_images.push_back(barrier);
+			}
+		}
+	}
+
+	void BarrierBatch::flush(VkCommandBuffer cmd)
+	{
+		if (empty())
+		{
+			return;
+		}
+
+		const bool has_memory = m_memory.srcStageMask || m_memory.dstStageMask;
+
+		// clang-format off
+		VkDependencyInfo dependency
+		{
+			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+			.pNext = nullptr,
+			.dependencyFlags = 0,
+			.memoryBarrierCount = has_memory ? 1u : 0u,
+			.pMemoryBarriers = has_memory ? &m_memory : nullptr,
+			.bufferMemoryBarrierCount = static_cast<std::uint32_t>(m_buffers.size()),
+			.pBufferMemoryBarriers = m_buffers.data(),
+			.imageMemoryBarrierCount = static_cast<std::uint32_t>(m_images.size()),
+			.pImageMemoryBarriers = m_images.data()
+		};
+		// clang-format on
+
+		vkCmdPipelineBarrier2(cmd, &dependency);
+
+		m_buffers.clear();
+		m_images.clear();
+		m_memory       = {};
+		m_memory.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	}
+
+	bool BarrierBatch::empty() const
+	{
+		return m_buffers.empty() && m_images.empty() && !m_memory.srcStageMask && !m_memory.dstStageMask;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,125 @@
+#ifndef VULKANO_PIPELINE_BARRIERS_HPP_
+#define VULKANO_PIPELINE_BARRIERS_HPP_
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class Buffer;
+	class Image;
+
+	///
+	/// Ways a command can use a resource. Each one maps to the stages, access and (for images) layout it needs.
+	///
+	enum class ResourceUsage
+	{
+		UNDEFINED,
+		TRANSFER_SRC,
+		TRANSFER_DST,
+		HOST_WRITE,
+		HOST_READ,
+		VERTEX_BUFFER,
+		INDEX_BUFFER,
+		INDIRECT_BUFFER,
+		UNIFORM_BUFFER,
+		SAMPLED_GRAPHICS,
+		SAMPLED_COMPUTE,
+		STORAGE_READ,
+		STORAGE_WRITE,
+		STORAGE_READ_WRITE,
+		MESH_STORAGE_READ,
+		COLOUR_ATTACHMENT,
+		DEPTH_ATTACHMENT,
+		DEPTH_READ,
+		PRESENT
+	};
+
+	///
+	/// Synchronisation scope a resource (or image subresource) was last used in.
+	/// Every use since the last write accumulates in m_stages and m_access, so a later write waits for all of them.
+	///
+	struct ResourceState final
+	{
+		VkPipelineStageFlags2 m_stages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 m_access        = VK_ACCESS_2_NONE;
+		VkImageLayout m_layout         = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		///
+		/// Scope of the last write or layout transition, which later reads have to wait on.
+		///
+		VkPipelineStageFlags2 m_write_stages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 m_write_access        = VK_ACCESS_2_NONE;
+
+		///
+		/// Stages and accesses the last write has been made visible to. Reads outside them need a barrier.
+		///
+		VkPipelineStageFlags2 m_visible_stages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 m_visible_access        = VK_ACCESS_2_NONE;
+	};
+
+	[[nodiscard]] ResourceState usage_state(ResourceUsage usage);
+
+	///
+	/// Collects the barriers needed to move resources from their tracked state to a declared usage, then records them
+	/// all with a single vkCmdPipelineBarrier2. Reads in the same layout need no barrier once the last write has been
+	/// made visible to their stage and access.
+	/// Declare each resource at most once between flushes, since barriers in one call are not ordered.
+	///
+	class BarrierBatch final
+	{
+	public:
+		BarrierBatch();
+		~BarrierBatch() = default;
+
+		///
+		/// Declares the next use of mip levels [base_mip, base_mip + mip_count) across all layers of the image.
+		/// With discard set the previous contents may be dropped, so layout transitions start from UNDEFINED.
+		///
+		void image(Image& image, ResourceUsage usage, std::uint32_t base_mip = 0, std::uint32_t mip_count = VK_REMAINING_MIP_LEVELS, bool discard = false);
+
+		///
+		/// Declares the next use of a buffer whose state is owned by the caller.
+		/// Buffer dependencies are merged into one global memory barrier, which drivers handle at least as well as
+		/// per buffer barriers when no queue ownership transfer is involved.
+		///
+		void buffer(ResourceState& state, ResourceUsage usage);
+
+		///
+		/// Queue family ownership transfer of a whole exclusive resource used on more than one queue. Record release()
+		/// on the source queue and acquire(), with the same arguments, on the destination queue, whose submission has
+		/// to wait on the release's. Between the two nothing else may be declared for the resource. Buffers have no
+		/// layout, so their release() takes no usage.
+		/// With matching families release() does nothing and acquire() is a plain declaration, so shared queues need
+		/// no special casing.
+		///
+		void release(Buffer& buffer, std::uint32_t src_family, std::uint32_t dst_family);
+		void acquire(Buffer& buffer, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family);
+		void release(Image& image, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family);
+		void acquire(Image& image, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family);
+
+		///
+		/// Records every pending barrier in one call. Does nothing if no barrier is needed.
+		///
+		void flush(VkCommandBuffer cmd);
+
+		[[nodiscard]] bool empty() const;
+
+	private:
+		///
+		/// One barrier per subresource that differs from the previous mip's, for both halves of a transfer.
+		///
+		void transfer(Image& image, ResourceUsage usage, std::uint32_t src_family, std::uint32_t dst_family, bool acquire);
+
+		VkMemoryBarrier2 m_memory;
+
+		///
+		/// Only ownership transfers, other buffer dependencies go in m_memory.
+		///
+		std::vector<VkBufferMemoryBarrier2> m_buffers;
+		std::vector<VkImageMemoryBarrier2> m_images;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
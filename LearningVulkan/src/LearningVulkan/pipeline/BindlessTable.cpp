@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <array>
+
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "BindlessTable.hpp"
+
+namespace vulkano
+{
+	BindlessTable::BindlessTable(Instance* instance, const BindlessTable::Settings& settings)
+	    : m_instance {instance}, m_set_layout {nullptr}, m_pipeline_layout {nullptr}, m_pool {nullptr}, m_set {nullptr}
+	{
+		if (!m_instance->bindless())
+		{
+			VK_LOG(VK_THROW, "Device does not support the descriptor indexing features bindless tables need.");
+		}
+
+		const VkDevice device = m_instance->logical_device();
+
+		VkPhysicalDeviceDescriptorIndexingProperties indexing {};
+		indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+		VkPhysicalDeviceProperties2 properties2 {};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &indexing;
+		vkGetPhysicalDeviceProperties2(m_instance->physical_device(), &properties2);
+
+		const VkPhysicalDeviceProperties& properties = properties2.properties;
+
+		// Update after bind sets have their own limits, and every binding is visible to all stages, so the per stage
+		// limits apply as well as the per set ones.
+		m_textures.m_capacity = std::min({settings.m_max_textures, indexing.maxPerStageDescriptorUpdateAfterBindSampledImages, indexing.maxDescriptorSetUpdateAfterBindSampledImages});
+		m_samplers.m_capacity = std::min({settings.m_max_samplers, indexing.maxPerStageDescriptorUpdateAfterBindSamplers, indexing.maxDescriptorSetUpdateAfterBindSamplers});
+		m_buffers.m_capacity  = std::min({settings.m_max_buffers, indexing.maxPerStageDescriptorUpdateAfterBindStorageBuffers, indexing.maxDescriptorSetUpdateAfterBindStorageBuffers});
+
+		// All three also share one per stage resource limit. Shrink them in proportion to fit.
+		const std::uint64_t resources = std::uint64_t {m_textures.m_capacity} + m_samplers.m_capacity + m_buffers.m_capacity;
+		if (resources > indexing.maxPerStageUpdateAfterBindResources)
+		{
+			m_textures.m_capacity = static_cast<std::uint32_t>(m_textures.m_capacity * std::uint64_t {indexing.maxPerStageUpdateAfterBindResources} / resources);
+			m_samplers.m_capacity = static_cast<std::uint32_t>(m_samplers.m_capacity * std::uint64_t {indexing.maxPerStageUpdateAfterBindResources} / resources);
+			m_buffers.m_capacity  = static_cast<std::uint32_t>(m_buffers.m_capacity * std::uint64_t {indexing.maxPerStageUpdateAfterBindResources} / resources);
+		}
+
+		// clang-format off
+		const std::array<VkDescriptorSetLayoutBinding, 3> bindings
+		{
+			VkDescriptorSetLayoutBinding {TEXTURE_BINDING, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, m_textures.m_capacity, VK_SHADER_STAGE_ALL, nullptr},
+			VkDescriptorSetLayoutBinding {SAMPLER_BINDING, VK_DESCRIPTOR_TYPE_SAMPLER, m_samplers.m_capacity, VK_SHADER_STAGE_ALL, nullptr},
+			VkDescriptorSetLayoutBinding {BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_buffers.m_capacity, VK_SHADER_STAGE_ALL, nullptr}
+		};
+
+		// Slots may be empty, and may be written while the set is bound as long as pending work doesn't use them.
+		const VkDescriptorBindingFlags flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+		const std::array<VkDescriptorBindingFlags, 3> binding_flags {flags, flags, flags};
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+			.pNext = nullptr,
+			.bindingCount = static_cast<std::uint32_t>(binding_flags.size()),
+			.pBindingFlags = binding_flags.data()
+		};
+
+		VkDescriptorSetLayoutCreateInfo layout_info
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.pNext = &flags_info,
+			.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+			.bindingCount = static_cast<std::uint32_t>(bindings.size()),
+			.pBindings = bindings.data()
+		};
+		// clang-format on
+
+		if (vkCreateDescriptorSetLayout(device, &layout_info, nullptr, &m_set_layout) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create bindless descriptor set layout.");
+		}
+
+		// clang-format off
+		const VkPushConstantRange push_range
+		{
+			.stageFlags = VK_SHADER_STAGE_ALL,
+			.offset = 0,
+			.size = std::min(settings.m_push_constant_size, properties.limits.maxPushConstantsSize)
+		};
+
+		VkPipelineLayoutCreateInfo pipeline_layout_info
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.setLayoutCount = 1,
+			.pSetLayouts = &m_set_layout,
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &push_range
+		};
+		// clang-format on
+
+		if (vkCreatePipelineLayout(device, &pipeline_layout_info, nullptr, &m_pipeline_layout) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create bindless pipeline layout.");
+		}
+
+		// clang-format off
+		const std::array<VkDescriptorPoolSize, 3> sizes
+		{
+			VkDescriptorPoolSize {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, m_textures.m_capacity},
+			VkDescriptorPoolSize {VK_DESCRIPTOR_TYPE_SAMPLER, m_samplers.m_capacity},
+			VkDescriptorPoolSize {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_buffers.m_capacity}
+		};
+
+		VkDescriptorPoolCreateInfo pool_info
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+			.maxSets = 1,
+			.poolSizeCount = static_cast<std::uint32_t>(sizes.size()),
+			.pPoolSizes = sizes.data()
+		};
+		// clang-format on
+
+		if (vkCreateDescriptorPool(device, &pool_info, nullptr, &m_pool) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create bindless descriptor pool.");
+		}
+
+		// clang-format off
+		VkDescriptorSetAllocateInfo alloc_info
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.descriptorPool = m_pool,
+			.descriptorSetCount = 1,
+			.pSetLayouts = &m_set_layout
+		};
+		// clang-format on
+
+		if (vkAllocateDescriptorSets(device, &alloc_info, &m_set) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to allocate bindless descriptor set.");
+		}
+	}
+
+	BindlessTable::~BindlessTable()
+	{
+		// Freeing the pool frees the set.
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		deletion.release(m_pool);
+		deletion.release(m_pipeline_layout);
+		deletion.release(m_set_layout);
+	}
+
+	std::uint32_t BindlessTable::add_texture(VkImageView view, VkImageLayout layout)
+	{
+		const std::uint32_t index = acquire(m_textures, "texture");
+		update_texture(index, view, layout);
+
+		return index;
+	}
+
+	std::uint32_t BindlessTable::add_sampler(VkSampler sampler)
+	{
+		const std::uint32_t index = acquire(m_samplers, "sampler");
+
+		const VkDescriptorImageInfo info {sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED};
+		write(SAMPLER_BINDING, index, VK_DESCRIPTOR_TYPE_SAMPLER, &info, nullptr);
+
+		return index;
+	}
+
+	std::uint32_t BindlessTable::add_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+	{
+		const std::uint32_t index = acquire(m_buffers, "buffer");
+
+		const VkDescriptorBufferInfo info {buffer, offset, range};
+		write(BUFFER_BINDING, index, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &info);
+
+		return index;
+	}
+
+	void BindlessTable::update_texture(std::uint32_t index, VkImageView view, VkImageLayout layout)
+	{
+		const VkDescriptorImageInfo info {VK_NULL_HANDLE, view, layout};
+		write(TEXTURE_BINDING, index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &info, nullptr);
+	}
+
+	void BindlessTable::remove_texture(std::uint32_t index)
+	{
+		retire(m_textures, index);
+	}
+
+	void BindlessTable::remove_sampler(std::uint32_t index)
+	{
+		retire(m_samplers, index);
+	}
+
+	void BindlessTable::remove_buffer(std::uint32_t index)
+	{
+		retire(m_buffers, index);
+	}
+
+	void BindlessTable::collect(std::uint64_t completed)
+	{
+		for (auto* slots : {&m_textures, &m_samplers, &m_buffers})
+		{
+			while (!slots->m_retired.empty() && slots->m_retired.front().first <= completed)
+			{
+				slots->m_free.push_back(slots->m_retired.front().second);
+				slots->m_retired.pop_front();
+			}
+		}
+	}
+
+	void BindlessTable::bind(VkCommandBuffer cmd, VkPipelineBindPoint bind_point) const
+	{
+		vkCmdBindDescriptorSets(cmd, bind_point, m_pipeline_layout, 0, 1, &m_set, 0, nullptr);
+	}
+
+	VkDescriptorSetLayout BindlessTable::set_layout() const
+	{
+		return m_set_layout;
+	}
+
+	VkPipelineLayout BindlessTable::pipeline_layout() const
+	{
+		return m_pipeline_layout;
+	}
+
+	VkDescriptorSet BindlessTable::set() const
+	{
+		return m_set;
+	}
+
+	std::uint32_t BindlessTable::acquire(Slots& slots, const char* kind)
+	{
+		if (!slots.m_free.empty())
+		{
+			const std::uint32_t index = slots.m_free.back();
+			slots.m_free.pop_back();
+
+			return index;
+		}
+
+		if (slots.m_next == slots.m_capacity)
+		{
+			VK_LOG(VK_THROW, "Bindless {0} table is full ({1} entries).", kind, slots.m_capacity);
+		}
+
+		return slots.m_next++;
+	}
+
+	void BindlessTable::retire(Slots& slots, std::uint32_t index)
+	{
+		slots.m_retired.emplace_back(m_instance->deletion_queue().pending(), index);
+	}
+
+	void BindlessTable::write(std::uint32_t binding, std::uint32_t index, VkDescriptorType type, const VkDescriptorImageInfo* image, const VkDescriptorBufferInfo* buffer)
+	{
+		// clang-format off
+		VkWriteDescriptorSet write_info
+		{
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.pNext = nullptr,
+			.dstSet = m_set,
+			.dstBinding = binding,
+			.dstArrayElement = index,
+			.descriptorCount = 1,
+			.descriptorType = type,
+			.pImageInfo = image,
+			.pBufferInfo = buffer,
+			.pTexelBufferView = nullptr
+		};
+		// clang-format on
+
+		vkUpdateDescriptorSets(m_instance->logical_device(), 1, &write_info, 0, nullptr);
+	}
+} // namespace vulkano
\ No newline at end of file
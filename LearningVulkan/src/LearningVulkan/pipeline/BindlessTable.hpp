@@ -0,0 +1,107 @@
+#ifndef VULKANO_PIPELINE_BINDLESSTABLE_HPP_
+#define VULKANO_PIPELINE_BINDLESSTABLE_HPP_
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class Instance;
+
+	///
+	/// One global descriptor set holding every texture, sampler and storage buffer in large partially bound arrays,
+	/// bound once per command buffer. Resources are referred to by their array index, which shaders receive through
+	/// push constants (or inside other buffers) instead of through per material sets:
+	///
+	///     layout(set = 0, binding = 0) uniform texture2D g_textures[];
+	///     layout(set = 0, binding = 1) uniform sampler g_samplers[];
+	///     layout(set = 0, binding = 2) buffer Buffers { uint data[]; } g_buffers[];
+	///
+	/// Needs Instance::bindless(). Indices are stable while the resource is registered, and are not handed out again
+	/// until the GPU is past the point where they were removed.
+	///
+	class BindlessTable final
+	{
+	public:
+		struct Settings final
+		{
+			std::uint32_t m_max_textures = 16384;
+			std::uint32_t m_max_samplers = 64;
+			std::uint32_t m_max_buffers  = 16384;
+
+			///
+			/// Size of the push constant range in the shared pipeline layout, visible to all stages.
+			///
+			std::uint32_t m_push_constant_size = 128;
+		};
+
+		static constexpr std::uint32_t TEXTURE_BINDING = 0;
+		static constexpr std::uint32_t SAMPLER_BINDING = 1;
+		static constexpr std::uint32_t BUFFER_BINDING  = 2;
+
+		BindlessTable(Instance* instance, const BindlessTable::Settings& settings);
+		~BindlessTable();
+
+		[[nodiscard]] std::uint32_t add_texture(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		[[nodiscard]] std::uint32_t add_sampler(VkSampler sampler);
+		[[nodiscard]] std::uint32_t add_buffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+		///
+		/// Replaces what an index refers to, i.e. after a texture finished streaming in a higher resolution.
+		///
+		void update_texture(std::uint32_t index, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		///
+		/// The descriptor is left in place, and the index is reused once collect() passes the deletion queue's
+		/// current pending value.
+		///
+		void remove_texture(std::uint32_t index);
+		void remove_sampler(std::uint32_t index);
+		void remove_buffer(std::uint32_t index);
+
+		void collect(std::uint64_t completed);
+
+		///
+		/// Binds the table as set 0 for every pipeline created with pipeline_layout().
+		///
+		void bind(VkCommandBuffer cmd, VkPipelineBindPoint bind_point) const;
+
+		[[nodiscard]] VkDescriptorSetLayout set_layout() const;
+		[[nodiscard]] VkPipelineLayout pipeline_layout() const;
+		[[nodiscard]] VkDescriptorSet set() const;
+
+	private:
+		BindlessTable() = delete;
+
+		///
+		/// Hands out indices of one array.
+		///
+		struct Slots final
+		{
+			std::uint32_t m_capacity;
+			std::uint32_t m_next = 0;
+			std::vector<std::uint32_t> m_free;
+			std::deque<std::pair<std::uint64_t, std::uint32_t>> m_retired;
+		};
+
+		[[nodiscard]] std::uint32_t acquire(Slots& slots, const char* kind);
+		void retire(Slots& slots, std::uint32_t index);
+		void write(std::uint32_t binding, std::uint32_t index, VkDescriptorType type, const VkDescriptorImageInfo* image, const VkDescriptorBufferInfo* buffer);
+
+		Instance* m_instance;
+
+		VkDescriptorSetLayout m_set_layout;
+		VkPipelineLayout m_pipeline_layout;
+		VkDescriptorPool m_pool;
+		VkDescriptorSet m_set;
+
+		Slots m_textures;
+		Slots m_samplers;
+		Slots m_buffers;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "CommandPoolManager.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Free lists grow by this many buffers at a time to keep vkAllocateCommandBuffers calls rare.
+		///
+		constexpr std::uint32_t GROWTH = 8;
+	} // namespace
+
+	CommandPoolManager::CommandPoolManager(Instance* instance, const CommandPoolManager::Settings& settings)
+	    : m_instance {instance}, m_frames_in_flight {settings.m_frames_in_flight}, m_threads {settings.m_threads}, m_frame {0}, m_pools(settings.m_frames_in_flight * settings.m_threads)
+	{
+		// clang-format off
+		VkCommandPoolCreateInfo pool_info
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+			.queueFamilyIndex = settings.m_queue_family
+		};
+		// clang-format on
+
+		for (auto& pool : m_pools)
+		{
+			if (vkCreateCommandPool(m_instance->logical_device(), &pool_info, nullptr, &pool.m_pool) != VK_SUCCESS)
+			{
+				VK_LOG(VK_THROW, "Failed to create command pool for queue family {0}.", settings.m_queue_family);
+			}
+		}
+	}
+
+	CommandPoolManager::~CommandPoolManager()
+	{
+		// Destroying a pool frees its buffers.
+		for (auto& pool : m_pools)
+		{
+			vkDestroyCommandPool(m_instance->logical_device(), pool.m_pool, nullptr);
+		}
+	}
+
+	void CommandPoolManager::begin_frame(std::uint32_t frame, VkFence fence)
+	{
+		if (frame >= m_frames_in_flight)
+		{
+			VK_LOG(VK_THROW, "Frame {0} is outside the command pool manager's {1} frames in flight.", frame, m_frames_in_flight);
+		}
+
+		if (fence && vkWaitForFences(m_instance->logical_device(), 1, &fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to wait for command pool frame {0}.", frame);
+		}
+
+		m_frame = frame;
+		for (std::uint32_t thread = 0; thread < m_threads; thread++)
+		{
+			Pool& pool = m_pools[m_frame * m_threads + thread];
+			if (pool.m_primary.m_used == 0 && pool.m_secondary.m_used == 0)
+			{
+				continue;
+			}
+
+			// Buffers go back to the initial state but stay allocated, so the free lists can hand them out again.
+			vkResetCommandPool(m_instance->logical_device(), pool.m_pool, 0);
+			pool.m_primary.m_used   = 0;
+			pool.m_secondary.m_used = 0;
+		}
+	}
+
+	VkCommandBuffer CommandPoolManager::allocate(std::uint32_t thread, VkCommandBufferLevel level)
+	{
+		if (thread >= m_threads)
+		{
+			VK_LOG(VK_THROW, "Thread {0} is outside the command pool manager's {1} thread slots.", thread, m_threads);
+		}
+
+		Pool& pool     = m_pools[m_frame * m_threads + thread];
+		FreeList& list = (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY) ? pool.m_primary : pool.m_secondary;
+
+		if (list.m_used == list.m_buffers.size())
+		{
+			// clang-format off
+			VkCommandBufferAllocateInfo cmd_info
+			{
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				.pNext = nullptr,
+				.commandPool = pool.m_pool,
+				.level = level,
+				.commandBufferCount = GROWTH
+			};
+			// clang-format on
+
+			list.m_buffers.resize(list.m_buffers.size() + GROWTH);
+			if (vkAllocateCommandBuffers(m_instance->logical_device(), &cmd_info, list.m_buffers.data() + list.m_used) != VK_SUCCESS)
+			{
+				VK_LOG(VK_THROW, "Failed to allocate command buffers for thread {0}.", thread);
+			}
+		}
+
+		return list.m_buffers[list.m_used++];
+	}
+
+	std::uint32_t CommandPoolManager::frame() const
+	{
+		return m_frame;
+	}
+
+	std::uint32_t CommandPoolManager::thread_count() const
+	{
+		return m_threads;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef VULKANO_PIPELINE_COMMANDPOOLMANAGER_HPP_
+#define VULKANO_PIPELINE_COMMANDPOOLMANAGER_HPP_
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class Instance;
+
+	///
+	/// One transient VkCommandPool per (frame in flight, thread). Threads only ever touch their own pool so recording
+	/// needs no locks, and whole pools are reset once their frame has retired instead of freeing buffers one by one.
+	///
+	class CommandPoolManager final
+	{
+	public:
+		struct Settings final
+		{
+			std::uint32_t m_queue_family;
+			std::uint32_t m_frames_in_flight;
+			std::uint32_t m_threads;
+		};
+
+		CommandPoolManager(Instance* instance, const CommandPoolManager::Settings& settings);
+		~CommandPoolManager();
+
+		///
+		/// Makes frame, which must be below m_frames_in_flight, the current one. Waits on fence (if any) first, since
+		/// the GPU must be done with every buffer from the frame's pools before they are reset. Call from one thread
+		/// while no other thread is recording.
+		///
+		void begin_frame(std::uint32_t frame, VkFence fence = VK_NULL_HANDLE);
+
+		///
+		/// A command buffer from the calling thread's pool for the current frame, ready for vkBeginCommandBuffer.
+		/// Buffers handed out earlier in the frame stay valid until the frame comes round again. thread must be below
+		/// thread_count(); JobSystem::thread_index() is out of range on threads the job system does not own.
+		///
+		[[nodiscard]] VkCommandBuffer allocate(std::uint32_t thread, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+		[[nodiscard]] std::uint32_t frame() const;
+		[[nodiscard]] std::uint32_t thread_count() const;
+
+	private:
+		CommandPoolManager() = delete;
+
+		///
+		/// Recycled buffers of one level, handed out in order and rewound on reset.
+		///
+		struct FreeList final
+		{
+			std::vector<VkCommandBuffer> m_buffers;
+			std::size_t m_used = 0;
+		};
+
+		///
+		/// Cache line aligned, so threads bumping their own free lists don't share lines.
+		///
+		struct alignas(64) Pool final
+		{
+			VkCommandPool m_pool = VK_NULL_HANDLE;
+			FreeList m_primary;
+			FreeList m_secondary;
+		};
+
+		Instance* m_instance;
+		std::uint32_t m_frames_in_flight;
+		std::uint32_t m_threads;
+		std::uint32_t m_frame;
+
+		///
+		/// Indexed [frame * m_threads + thread].
+		///
+		std::vector<Pool> m_pools;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
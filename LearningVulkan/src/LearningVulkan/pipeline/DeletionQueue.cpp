@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <type_traits>
+
+#include "DeletionQueue.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Non-dispatchable handles are pointers on 64 bit targets but plain integers on 32 bit ones.
+		///
+		template<typename Handle>
+		[[nodiscard]] std::uint64_t to_bits(Handle handle)
+		{
+			if constexpr (std::is_pointer_v<Handle>)
+			{
+				return reinterpret_cast<std::uintptr_t>(handle);
+			}
+			else
+			{
+				return static_cast<std::uint64_t>(handle);
+			}
+		}
+
+		template<typename Handle>
+		[[nodiscard]] Handle from_bits(std::uint64_t bits)
+		{
+			if constexpr (std::is_pointer_v<Handle>)
+			{
+				return reinterpret_cast<Handle>(static_cast<std::uintptr_t>(bits));
+			}
+			else
+			{
+				return static_cast<Handle>(bits);
+			}
+		}
+	} // namespace
+
+	DeletionQueue::DeletionQueue(VkDevice device)
+	    : m_device {device}, m_pending {0}
+	{
+	}
+
+	DeletionQueue::~DeletionQueue()
+	{
+		flush();
+	}
+
+	void DeletionQueue::set_pending(std::uint64_t value)
+	{
+		std::lock_guard lock {m_mutex};
+		m_pending = std::max(m_pending, value);
+	}
+
+	std::uint64_t DeletionQueue::pending() const
+	{
+		std::lock_guard lock {m_mutex};
+		return m_pending;
+	}
+
+	void DeletionQueue::release(VkImage image)
+	{
+		push(Kind::IMAGE, image);
+	}
+
+	void DeletionQueue::release(VkImageView view)
+	{
+		push(Kind::IMAGE_VIEW, view);
+	}
+
+	void DeletionQueue::release(VkBuffer buffer)
+	{
+		push(Kind::BUFFER, buffer);
+	}
+
+	void DeletionQueue::release(VkDeviceMemory memory)
+	{
+		push(Kind::DEVICE_MEMORY, memory);
+	}
+
+	void DeletionQueue::release(VkSampler sampler)
+	{
+		push(Kind::SAMPLER, sampler);
+	}
+
+	void DeletionQueue::release(VkPipeline pipeline)
+	{
+		push(Kind::PIPELINE, pipeline);
+	}
+
+	void DeletionQueue::release(VkPipelineLayout layout)
+	{
+		push(Kind::PIPELINE_LAYOUT, layout);
+	}
+
+	void DeletionQueue::release(VkRenderPass render_pass)
+	{
+		push(Kind::RENDER_PASS, render_pass);
+	}
+
+	void DeletionQueue::release(VkFramebuffer framebuffer)
+	{
+		push(Kind::FRAMEBUFFER, framebuffer);
+	}
+
+	void DeletionQueue::release(VkDescriptorPool pool)
+	{
+		push(Kind::DESCRIPTOR_POOL, pool);
+	}
+
+	void DeletionQueue::release(VkDescriptorSetLayout layout)
+	{
+		push(Kind::DESCRIPTOR_SET_LAYOUT, layout);
+	}
+
+	void DeletionQueue::release(VkSwapchainKHR swapchain)
+	{
+		push(Kind::SWAPCHAIN, swapchain);
+	}
+
+	void DeletionQueue::release(VkShaderModule module)
+	{
+		push(Kind::SHADER_MODULE, module);
+	}
+
+	void DeletionQueue::release(std::function<void()> destroy)
+	{
+		std::lock_guard lock {m_mutex};
+		m_entries.push_back({m_pending, Kind::CALLBACK, 0, std::move(destroy)});
+	}
+
+	void DeletionQueue::collect(std::uint64_t completed)
+	{
+		// Values only grow, so everything that is due sits at the front.
+		std::deque<Entry> due;
+		{
+			std::lock_guard lock {m_mutex};
+			while (!m_entries.empty() && m_entries.front().m_value <= completed)
+			{
+				due.push_back(std::move(m_entries.front()));
+				m_entries.pop_front();
+			}
+		}
+
+		for (const auto& entry : due)
+		{
+			destroy(entry);
+		}
+	}
+
+	void DeletionQueue::flush()
+	{
+		collect(UINT64_MAX);
+	}
+
+	std::size_t DeletionQueue::size() const
+	{
+		std::lock_guard lock {m_mutex};
+		return m_entries.size();
+	}
+
+	template<typename Handle>
+	void DeletionQueue::push(Kind kind, Handle handle)
+	{
+		if (!handle)
+		{
+			return;
+		}
+
+		std::lock_guard lock {m_mutex};
+		m_entries.push_back({m_pending, kind, to_bits(handle), nullptr});
+	}
+
+	void DeletionQueue::destroy(const Entry& entry)
+	{
+		switch (entry.m_kind)
+		{
+			case Kind::IMAGE:
+				vkDestroyImage(m_device, from_bits<VkImage>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::IMAGE_VIEW:
+				vkDestroyImageView(m_device, from_bits<VkImageView>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::BUFFER:
+				vkDestroyBuffer(m_device, from_bits<VkBuffer>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::DEVICE_MEMORY:
+				vkFreeMemory(m_device, from_bits<VkDeviceMemory>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::SAMPLER:
+				vkDestroySampler(m_device, from_bits<VkSampler>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::PIPELINE:
+				vkDestroyPipeline(m_device, from_bits<VkPipeline>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::PIPELINE_LAYOUT:
+				vkDestroyPipelineLayout(m_device, from_bits<VkPipelineLayout>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::RENDER_PASS:
+				vkDestroyRenderPass(m_device, from_bits<VkRenderPass>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::FRAMEBUFFER:
+				vkDestroyFramebuffer(m_device, from_bits<VkFramebuffer>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::DESCRIPTOR_POOL:
+				vkDestroyDescriptorPool(m_device, from_bits<VkDescriptorPool>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::DESCRIPTOR_SET_LAYOUT:
+				vkDestroyDescriptorSetLayout(m_device, from_bits<VkDescriptorSetLayout>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::SWAPCHAIN:
+				vkDestroySwapchainKHR(m_device, from_bits<VkSwapchainKHR>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::SHADER_MODULE:
+				vkDestroyShaderModule(m_device, from_bits<VkShaderModule>(entry.m_handle), nullptr);
+				break;
+
+			case Kind::CALLBACK:
+				entry.m_callback();
+				break;
+		}
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,113 @@
+#ifndef VULKANO_PIPELINE_DELETIONQUEUE_HPP_
+#define VULKANO_PIPELINE_DELETIONQUEUE_HPP_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	///
+	/// Defers destruction of Vulkan objects until the GPU work that may still use them has finished.
+	///
+	/// Keyed by a monotonically increasing value, i.e. the graphics timeline value (see QueueSubmitter) or a frame
+	/// counter. Objects released while recording are tagged with the pending value, the one the work being recorded
+	/// will signal, and destroyed by collect() once the completed value reaches it.
+	///
+	/// release() may be called from any thread.
+	///
+	class DeletionQueue final
+	{
+	public:
+		DeletionQueue(VkDevice device);
+		~DeletionQueue();
+
+		///
+		/// Value newly released objects wait for. Must never decrease.
+		///
+		void set_pending(std::uint64_t value);
+
+		///
+		/// Value objects released now will wait for.
+		///
+		[[nodiscard]] std::uint64_t pending() const;
+
+		void release(VkImage image);
+		void release(VkImageView view);
+		void release(VkBuffer buffer);
+		void release(VkDeviceMemory memory);
+		void release(VkSampler sampler);
+		void release(VkPipeline pipeline);
+		void release(VkPipelineLayout layout);
+		void release(VkRenderPass render_pass);
+		void release(VkFramebuffer framebuffer);
+		void release(VkDescriptorPool pool);
+		void release(VkDescriptorSetLayout layout);
+		void release(VkSwapchainKHR swapchain);
+		void release(VkShaderModule module);
+
+		///
+		/// Anything without an overload above.
+		///
+		void release(std::function<void()> destroy);
+
+		///
+		/// Destroys everything released at or before completed.
+		///
+		void collect(std::uint64_t completed);
+
+		///
+		/// Destroys everything now. Only safe while the device is idle, i.e. at shutdown.
+		///
+		void flush();
+
+		[[nodiscard]] std::size_t size() const;
+
+	private:
+		DeletionQueue() = delete;
+
+		enum class Kind
+		{
+			IMAGE,
+			IMAGE_VIEW,
+			BUFFER,
+			DEVICE_MEMORY,
+			SAMPLER,
+			PIPELINE,
+			PIPELINE_LAYOUT,
+			RENDER_PASS,
+			FRAMEBUFFER,
+			DESCRIPTOR_POOL,
+			DESCRIPTOR_SET_LAYOUT,
+			SWAPCHAIN,
+			SHADER_MODULE,
+			CALLBACK
+		};
+
+		///
+		/// Plain handles avoid a heap allocated closure per object for the common cases.
+		///
+		struct Entry final
+		{
+			std::uint64_t m_value;
+			Kind m_kind;
+			std::uint64_t m_handle;
+			std::function<void()> m_callback;
+		};
+
+		template<typename Handle>
+		void push(Kind kind, Handle handle);
+
+		void destroy(const Entry& entry);
+
+		VkDevice m_device;
+		std::uint64_t m_pending;
+
+		mutable std::mutex m_mutex;
+		std::deque<Entry> m_entries;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <type_traits>
+
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "DescriptorAllocator.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		template<typename Handle>
+		[[nodiscard]] std::uint64_t to_bits(Handle handle)
+		{
+			if constexpr (std::is_pointer_v<Handle>)
+			{
+				return reinterpret_cast<std::uintptr_t>(handle);
+			}
+			else
+			{
+				return static_cast<std::uint64_t>(handle);
+			}
+		}
+
+		[[nodiscard]] bool is_buffer(VkDescriptorType type)
+		{
+			return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+		}
+	} // namespace
+
+	std::size_t DescriptorAllocator::KeyHash::operator()(const Key& key) const
+	{
+		// FNV-1a over whole values.
+		std::uint64_t hash = 14695981039346656037ull;
+		for (const auto value : key)
+		{
+			hash = (hash ^ value) * 1099511628211ull;
+		}
+
+		return static_cast<std::size_t>(hash);
+	}
+
+	DescriptorAllocator::DescriptorAllocator(Instance* instance, const DescriptorAllocator::Settings& settings)
+	    : m_instance {instance}, m_initial_sets {std::max(settings.m_initial_sets, 1u)}, m_frame {0}, m_frame_chains(settings.m_frames_in_flight)
+	{
+	}
+
+	DescriptorAllocator::~DescriptorAllocator()
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		for (const auto& chains : m_frame_chains)
+		{
+			for (const auto& chain : chains)
+			{
+				for (const auto pool : chain.m_pools)
+				{
+					deletion.release(pool);
+				}
+			}
+		}
+
+		for (const auto& chain : m_static_chains)
+		{
+			for (const auto pool : chain.m_pools)
+			{
+				deletion.release(pool);
+			}
+		}
+
+		for (const auto& layout : m_layouts)
+		{
+			deletion.release(layout.m_layout);
+		}
+	}
+
+	VkDescriptorSetLayout DescriptorAllocator::create_layout(std::span<const VkDescriptorSetLayoutBinding> bindings)
+	{
+		Key key;
+		key.reserve(bindings.size() * 4);
+		for (const auto& binding : bindings)
+		{
+			key.insert(key.end(), {binding.binding, static_cast<std::uint64_t>(binding.descriptorType), binding.descriptorCount, binding.stageFlags});
+			if (binding.pImmutableSamplers)
+			{
+				for (std::uint32_t i = 0; i < binding.descriptorCount; i++)
+				{
+					key.push_back(to_bits(binding.pImmutableSamplers[i]));
+				}
+			}
+		}
+
+		if (const auto it = m_layout_cache.find(key); it != m_layout_cache.end())
+		{
+			return m_layouts[it->second].m_layout;
+		}
+
+		// clang-format off
+		VkDescriptorSetLayoutCreateInfo layout_info
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.bindingCount = static_cast<std::uint32_t>(bindings.size()),
+			.pBindings = bindings.data()
+		};
+		// clang-format on
+
+		Layout layout {};
+		if (vkCreateDescriptorSetLayout(m_instance->logical_device(), &layout_info, nullptr, &layout.m_layout) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create descriptor set layout with {0} bindings.", bindings.size());
+		}
+
+		// Descriptor counts of one set, merged by type. Pools multiply these by their set count.
+		for (const auto& binding : bindings)
+		{
+			auto it = std::find_if(layout.m_sizes.begin(), layout.m_sizes.end(), [&](const VkDescriptorPoolSize& size) {
+				return size.type == binding.descriptorType;
+			});
+
+			if (it == layout.m_sizes.end())
+			{
+				layout.m_sizes.push_back({binding.descriptorType, binding.descriptorCount});
+			}
+			else
+			{
+				it->descriptorCount += binding.descriptorCount;
+			}
+		}
+
+		m_layouts.push_back(std::move(layout));
+		m_layout_cache.emplace(std::move(key), m_layouts.size() - 1);
+
+		for (auto& chains : m_frame_chains)
+		{
+			chains.emplace_back();
+		}
+
+		m_static_chains.push_back(PoolChain {{}, 0, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT});
+
+		return m_layouts.back().m_layout;
+	}
+
+	void DescriptorAllocator::begin_frame(std::uint32_t frame, VkFence fence)
+	{
+		if (frame >= m_frame_chains.size())
+		{
+			VK_LOG(VK_THROW, "Frame {0} is outside the descriptor allocator's {1} frames in flight.", frame, m_frame_chains.size());
+		}
+
+		if (fence && vkWaitForFences(m_instance->logical_device(), 1, &fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to wait for descriptor frame {0}.", frame);
+		}
+
+		m_frame = frame;
+		for (auto& chain : m_frame_chains[m_frame])
+		{
+			// Only pools up to the current one have handed out sets.
+			const std::size_t used = std::min(chain.m_current + 1, chain.m_pools.size());
+			for (std::size_t i = 0; i < used; i++)
+			{
+				vkResetDescriptorPool(m_instance->logical_device(), chain.m_pools[i], 0);
+			}
+
+			chain.m_current = 0;
+		}
+	}
+
+	VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout)
+	{
+		const std::size_t index = layout_index(layout);
+		return allocate_from(m_frame_chains[m_frame][index], m_layouts[index]);
+	}
+
+	VkDescriptorSet DescriptorAllocator::cached(VkDescriptorSetLayout layout, std::span<const DescriptorWrite> writes)
+	{
+		Key key;
+		key.reserve(1 + writes.size() * 6);
+		key.push_back(to_bits(layout));
+
+		std::vector<std::uint64_t> handles;
+		for (const auto& write : writes)
+		{
+			key.insert(key.end(), {write.m_binding, write.m_array_element, static_cast<std::uint64_t>(write.m_type)});
+			if (is_buffer(write.m_type))
+			{
+				key.insert(key.end(), {to_bits(write.m_buffer.buffer), write.m_buffer.offset, write.m_buffer.range});
+				handles.push_back(to_bits(write.m_buffer.buffer));
+			}
+			else
+			{
+				key.insert(key.end(), {to_bits(write.m_image.sampler), to_bits(write.m_image.imageView), static_cast<std::uint64_t>(write.m_image.imageLayout)});
+				handles.insert(handles.end(), {to_bits(write.m_image.sampler), to_bits(write.m_image.imageView)});
+			}
+		}
+
+		if (const auto it = m_set_cache.find(key); it != m_set_cache.end())
+		{
+			return it->second.m_set;
+		}
+
+		const std::size_t index   = layout_index(layout);
+		PoolChain& chain          = m_static_chains[index];
+		const VkDescriptorSet set = allocate_from(chain, m_layouts[index]);
+		update(set, writes);
+
+		m_set_cache.emplace(std::move(key), CachedSet {set, chain.m_pools[chain.m_current], std::move(handles)});
+		return set;
+	}
+
+	void DescriptorAllocator::invalidate(VkBuffer buffer)
+	{
+		invalidate_handle(to_bits(buffer));
+	}
+
+	void DescriptorAllocator::invalidate(VkImageView view)
+	{
+		invalidate_handle(to_bits(view));
+	}
+
+	void DescriptorAllocator::invalidate(VkSampler sampler)
+	{
+		invalidate_handle(to_bits(sampler));
+	}
+
+	void DescriptorAllocator::update(VkDescriptorSet set, std::span<const DescriptorWrite> writes) const
+	{
+		std::vector<VkWriteDescriptorSet> vk_writes;
+		vk_writes.reserve(writes.size());
+
+		// Infos of merged writes have to be contiguous. Reserved up front so the pointers into them stay valid.
+		std::vector<VkDescriptorBufferInfo> buffer_infos;
+		std::vector<VkDescriptorImageInfo> image_infos;
+		buffer_infos.reserve(writes.size());
+		image_infos.reserve(writes.size());
+
+		for (const auto& write : writes)
+		{
+			const bool buffer = is_buffer(write.m_type);
+			if (buffer)
+			{
+				buffer_infos.push_back(write.m_buffer);
+			}
+			else
+			{
+				image_infos.push_back(write.m_image);
+			}
+
+			if (!vk_writes.empty())
+			{
+				VkWriteDescriptorSet& previous = vk_writes.back();
+
+				const bool same_infos = buffer ? (previous.pBufferInfo != nullptr) : (previous.pImageInfo != nullptr);
+				if (same_infos && previous.dstBinding == write.m_binding && previous.descriptorType == write.m_type && previous.dstArrayElement + previous.descriptorCount == write.m_array_element)
+				{
+					previous.descriptorCount++;
+					continue;
+				}
+			}
+
+			// clang-format off
+			vk_writes.push_back(VkWriteDescriptorSet
+			{
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.pNext = nullptr,
+				.dstSet = set,
+				.dstBinding = write.m_binding,
+				.dstArrayElement = write.m_array_element,
+				.descriptorCount = 1,
+				.descriptorType = write.m_type,
+				.pImageInfo = buffer ? nullptr : &image_infos.back(),
+				.pBufferInfo = buffer ? &buffer_infos.back() : nullptr,
+				.pTexelBufferView = nullptr
+			});
+			// clang-format on
+		}
+
+		vkUpdateDescriptorSets(m_instance->logical_device(), static_cast<std::uint32_t>(vk_writes.size()), vk_writes.data(), 0, nullptr);
+	}
+
+	std::size_t DescriptorAllocator::pool_count() const
+	{
+		std::size_t count = 0;
+		for (const auto& chains : m_frame_chains)
+		{
+			for (const auto& chain : chains)
+			{
+				count += chain.m_pools.size();
+			}
+		}
+
+		for (const auto& chain : m_static_chains)
+		{
+			count += chain.m_pools.size();
+		}
+
+		return count;
+	}
+
+	std::size_t DescriptorAllocator::cached_count() const
+	{
+		return m_set_cache.size();
+	}
+
+	std::size_t DescriptorAllocator::layout_index(VkDescriptorSetLayout layout) const
+	{
+		const auto it = std::find_if(m_layouts.begin(), m_layouts.end(), [&](const Layout& entry) {
+			return entry.m_layout == layout;
+		});
+
+		if (it == m_layouts.end())
+		{
+			VK_LOG(VK_THROW, "Descriptor set layout was not created by this allocator.");
+		}
+
+		return static_cast<std::size_t>(it - m_layouts.begin());
+	}
+
+	void DescriptorAllocator::invalidate_handle(std::uint64_t handle)
+	{
+		const VkDevice device   = m_instance->logical_device();
+		DeletionQueue& deletion = m_instance->deletion_queue();
+
+		std::erase_if(m_set_cache, [&](const auto& entry) {
+			const CachedSet& cached = entry.second;
+			if (std::find(cached.m_handles.begin(), cached.m_handles.end(), handle) == cached.m_handles.end())
+			{
+				return false;
+			}
+
+			deletion.release([device, pool = cached.m_pool, set = cached.m_set]() {
+				vkFreeDescriptorSets(device, pool, 1, &set);
+			});
+
+			return true;
+		});
+	}
+
+	VkDescriptorSet DescriptorAllocator::allocate_from(PoolChain& chain, const Layout& layout)
+	{
+		while (true)
+		{
+			if (chain.m_current == chain.m_pools.size())
+			{
+				const std::uint32_t sets = std::min(m_initial_sets << std::min<std::size_t>(chain.m_pools.size(), 12), MAX_SETS_PER_POOL);
+
+				std::vector<VkDescriptorPoolSize> sizes = layout.m_sizes;
+				for (auto& size : sizes)
+				{
+					size.descriptorCount *= sets;
+				}
+
+				// clang-format off
+				VkDescriptorPoolCreateInfo pool_info
+				{
+					.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+					.pNext = nullptr,
+					.flags = chain.m_flags,
+					.maxSets = sets,
+					.poolSizeCount = static_cast<std::uint32_t>(sizes.size()),
+					.pPoolSizes = sizes.data()
+				};
+				// clang-format on
+
+				VkDescriptorPool pool = nullptr;
+				if (vkCreateDescriptorPool(m_instance->logical_device(), &pool_info, nullptr, &pool) != VK_SUCCESS)
+				{
+					VK_LOG(VK_THROW, "Failed to create descriptor pool for {0} sets.", sets);
+				}
+
+				chain.m_pools.push_back(pool);
+			}
+
+			// clang-format off
+			VkDescriptorSetAllocateInfo alloc_info
+			{
+				.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+				.pNext = nullptr,
+				.descriptorPool = chain.m_pools[chain.m_current],
+				.descriptorSetCount = 1,
+				.pSetLayouts = &layout.m_layout
+			};
+			// clang-format on
+
+			VkDescriptorSet set   = nullptr;
+			const VkResult result = vkAllocateDescriptorSets(m_instance->logical_device(), &alloc_info, &set);
+			if (result == VK_SUCCESS)
+			{
+				return set;
+			}
+
+			if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+			{
+				VK_LOG(VK_THROW, "Failed to allocate descriptor set ({0}).", static_cast<int>(result));
+			}
+
+			// Full, move on to the next (or a new) pool.
+			chain.m_current++;
+		}
+	}
+} // namespace vulkano
\ No newline at end of file
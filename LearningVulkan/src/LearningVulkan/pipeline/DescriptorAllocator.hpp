@@ -0,0 +1,162 @@
+#ifndef VULKANO_PIPELINE_DESCRIPTORALLOCATOR_HPP_
+#define VULKANO_PIPELINE_DESCRIPTORALLOCATOR_HPP_
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class Instance;
+
+	///
+	/// One descriptor's contents. Only the info matching m_type is read. Arrays take a write per element.
+	///
+	struct DescriptorWrite final
+	{
+		std::uint32_t m_binding;
+		VkDescriptorType m_type;
+		VkDescriptorBufferInfo m_buffer = {};
+		VkDescriptorImageInfo m_image   = {};
+		std::uint32_t m_array_element   = 0;
+	};
+
+	///
+	/// Owns descriptor set layouts and the pools sets are allocated from.
+	///
+	/// Every layout gets its own chain of pools sized for whole sets of it, so pools never fragment. A chain grows a
+	/// new, larger pool when the current one runs out. Sets from allocate() live for one frame and their pools are
+	/// reset wholesale when the frame comes round again. Sets from cached() are written once and shared by every
+	/// request with the same contents, until invalidate() drops them.
+	///
+	/// Not thread safe.
+	///
+	class DescriptorAllocator final
+	{
+	public:
+		struct Settings final
+		{
+			std::uint32_t m_frames_in_flight;
+
+			///
+			/// Sets in the first pool of a chain. Each new pool doubles, up to MAX_SETS_PER_POOL.
+			///
+			std::uint32_t m_initial_sets = 16;
+		};
+
+		static constexpr std::uint32_t MAX_SETS_PER_POOL = 4096;
+
+		DescriptorAllocator(Instance* instance, const DescriptorAllocator::Settings& settings);
+		~DescriptorAllocator();
+
+		///
+		/// Returns the existing layout when one was already created from identical bindings.
+		///
+		[[nodiscard]] VkDescriptorSetLayout create_layout(std::span<const VkDescriptorSetLayoutBinding> bindings);
+
+		///
+		/// Makes frame, which must be below m_frames_in_flight, the current one, waiting on fence (if any) first, and
+		/// resets every pool its sets came from.
+		///
+		void begin_frame(std::uint32_t frame, VkFence fence = VK_NULL_HANDLE);
+
+		///
+		/// Unwritten set valid for the current frame only. Layout must come from create_layout().
+		///
+		[[nodiscard]] VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+		///
+		/// Set with these contents, allocated and written on first request only. Meant for static bindings such as
+		/// materials; anything bound per frame should use allocate(). Sets are found by handle, so invalidate()
+		/// every buffer, view and sampler written here before releasing it, or a later object given the same handle
+		/// would be handed the stale set.
+		///
+		[[nodiscard]] VkDescriptorSet cached(VkDescriptorSetLayout layout, std::span<const DescriptorWrite> writes);
+
+		///
+		/// Drops every cached set that refers to the object. The sets are freed once the GPU is done with them.
+		///
+		void invalidate(VkBuffer buffer);
+		void invalidate(VkImageView view);
+		void invalidate(VkSampler sampler);
+
+		///
+		/// Writes every descriptor in one vkUpdateDescriptorSets call. Writes to consecutive elements of the same
+		/// array binding are merged.
+		///
+		void update(VkDescriptorSet set, std::span<const DescriptorWrite> writes) const;
+
+		[[nodiscard]] std::size_t pool_count() const;
+		[[nodiscard]] std::size_t cached_count() const;
+
+	private:
+		DescriptorAllocator() = delete;
+
+		///
+		/// Pools for one layout. Pools before m_current are full.
+		///
+		struct PoolChain final
+		{
+			std::vector<VkDescriptorPool> m_pools;
+			std::size_t m_current = 0;
+
+			///
+			/// Cached sets can be freed one at a time, frame sets are only ever reset.
+			///
+			VkDescriptorPoolCreateFlags m_flags = 0;
+		};
+
+		struct Layout final
+		{
+			VkDescriptorSetLayout m_layout;
+			std::vector<VkDescriptorPoolSize> m_sizes;
+		};
+
+		///
+		/// Raw values of everything that makes two layouts or sets interchangeable.
+		///
+		using Key = std::vector<std::uint64_t>;
+
+		struct KeyHash final
+		{
+			[[nodiscard]] std::size_t operator()(const Key& key) const;
+		};
+
+		struct CachedSet final
+		{
+			VkDescriptorSet m_set;
+			VkDescriptorPool m_pool;
+
+			///
+			/// Buffers, views and samplers written to the set, for invalidate().
+			///
+			std::vector<std::uint64_t> m_handles;
+		};
+
+		[[nodiscard]] std::size_t layout_index(VkDescriptorSetLayout layout) const;
+		[[nodiscard]] VkDescriptorSet allocate_from(PoolChain& chain, const Layout& layout);
+		void invalidate_handle(std::uint64_t handle);
+
+		Instance* m_instance;
+		std::uint32_t m_initial_sets;
+		std::uint32_t m_frame;
+
+		std::vector<Layout> m_layouts;
+		std::unordered_map<Key, std::size_t, KeyHash> m_layout_cache;
+
+		///
+		/// Indexed [frame][layout].
+		///
+		std::vector<std::vector<PoolChain>> m_frame_chains;
+
+		///
+		/// Indexed [layout].
+		///
+		std::vector<PoolChain> m_static_chains;
+		std::unordered_map<Key, CachedSet, KeyHash> m_set_cache;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
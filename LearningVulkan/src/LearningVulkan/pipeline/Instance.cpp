@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 
 #include "vulkano/utils/Log.hpp"
@@ -12,7 +13,7 @@ namespace vulkano
 	}
 
 	Instance::Instance(const Instance::Settings& settings)
-	    : m_debug_mode {settings.m_debug_mode}, m_vk_instance {nullptr}, m_debug_messenger {nullptr}, m_gpu {nullptr}, m_gpu_interface {nullptr}, m_graphics_queue {nullptr}, m_surface {nullptr}, m_surface_queue {nullptr}
+	    : m_debug_mode {settings.m_debug_mode}, m_vk_instance {nullptr}, m_debug_messenger {nullptr}, m_gpu {nullptr}, m_gpu_interface {nullptr}, m_graphics_queue {nullptr}, m_surface {nullptr}, m_surface_queue {nullptr}, m_compute_queue {nullptr}, m_transfer_queue {nullptr}, m_enabled_features {}, m_enabled_features12 {}, m_enabled_features13 {}, m_mesh_shader_features {}, m_memory_properties {}
 	{
 		// clang-format off
 		VkInstanceCreateInfo info
@@ -108,17 +109,20 @@ namespace vulkano
 					vkEnumeratePhysicalDevices(m_vk_instance, &device_count, device_list.data());
 
 					// Required Extensions.
-					std::array<const char*, 1> req_extensions =
+					std::vector<const char*> req_extensions =
 					{
 						VK_KHR_SWAPCHAIN_EXTENSION_NAME
 					};
 
+					// Best scoring valid device, so a discrete GPU wins when there is one but integrated GPUs still run.
+					std::uint32_t best_score = 0;
 					for (const auto& device : device_list)
 					{
-						if (valid_device(device, req_extensions))
+						const std::uint32_t score = device_score(device);
+						if (score > best_score && valid_device(device, req_extensions))
 						{
-							m_gpu = device;
-							break;
+							m_gpu      = device;
+							best_score = score;
 						}
 					}
 
@@ -130,41 +134,96 @@ namespace vulkano
 					{
 						m_qfi = get_family_indexs(m_gpu);
 
+						// One queue per distinct family, asking for the same family twice is invalid.
 						const constexpr float priority = 1.0f;
-						const std::array<VkDeviceQueueCreateInfo, 2> queue_infos =
+						std::vector<std::uint32_t> families = {m_qfi.m_graphics.value(), m_qfi.m_present_to_surface.value(), m_qfi.m_compute.value(), m_qfi.m_transfer.value()};
+						std::sort(families.begin(), families.end());
+						families.erase(std::unique(families.begin(), families.end()), families.end());
+
+						std::vector<VkDeviceQueueCreateInfo> queue_infos;
+						for (const auto family : families)
 						{
-							VkDeviceQueueCreateInfo
-							{
-								.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-								.pNext = nullptr,
-								.flags = VK_NULL_HANDLE,
-								.queueFamilyIndex = m_qfi.m_graphics.value(),
-								.queueCount = 1,
-								.pQueuePriorities = &priority
-							},
-							VkDeviceQueueCreateInfo
+							queue_infos.push_back(VkDeviceQueueCreateInfo
 							{
 								.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
 								.pNext = nullptr,
 								.flags = VK_NULL_HANDLE,
-								.queueFamilyIndex = m_qfi.m_present_to_surface.value(),
+								.queueFamilyIndex = family,
 								.queueCount = 1,
 								.pQueuePriorities = &priority
-							}
-						};
+							});
+						}
+
+						vkGetPhysicalDeviceMemoryProperties(m_gpu, &m_memory_properties);
+
+						// Only opt in to optional features the GPU actually has, so callers can query them later.
+						VkPhysicalDeviceFeatures supported_features;
+						vkGetPhysicalDeviceFeatures(m_gpu, &supported_features);
+						m_enabled_features.textureCompressionBC = supported_features.textureCompressionBC;
+						m_enabled_features.samplerAnisotropy    = supported_features.samplerAnisotropy;
+
+						// Bindless descriptor tables, enabled as a set when the GPU has all of them (see bindless()).
+						VkPhysicalDeviceVulkan12Features supported12 {};
+						supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+						VkPhysicalDeviceMeshShaderFeaturesEXT supported_mesh {};
+						supported_mesh.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+
+						const bool has_mesh_extension = has_extension(m_gpu, VK_EXT_MESH_SHADER_EXTENSION_NAME);
+						if (has_mesh_extension)
+						{
+							supported12.pNext = &supported_mesh;
+						}
+
+						VkPhysicalDeviceFeatures2 supported2 {};
+						supported2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+						supported2.pNext = &supported12;
+						vkGetPhysicalDeviceFeatures2(m_gpu, &supported2);
+
+						const VkBool32 has_bindless = supported12.descriptorIndexing && supported12.runtimeDescriptorArray && supported12.descriptorBindingPartiallyBound && supported12.descriptorBindingUpdateUnusedWhilePending && supported12.descriptorBindingSampledImageUpdateAfterBind && supported12.descriptorBindingStorageBufferUpdateAfterBind && supported12.shaderSampledImageArrayNonUniformIndexing && supported12.shaderStorageBufferArrayNonUniformIndexing;
+
+						m_enabled_features12.descriptorIndexing                            = has_bindless;
+						m_enabled_features12.runtimeDescriptorArray                        = has_bindless;
+						m_enabled_features12.descriptorBindingPartiallyBound               = has_bindless;
+						m_enabled_features12.descriptorBindingUpdateUnusedWhilePending     = has_bindless;
+						m_enabled_features12.descriptorBindingSampledImageUpdateAfterBind  = has_bindless;
+						m_enabled_features12.descriptorBindingStorageBufferUpdateAfterBind = has_bindless;
+						m_enabled_features12.shaderSampledImageArrayNonUniformIndexing     = has_bindless;
+						m_enabled_features12.shaderStorageBufferArrayNonUniformIndexing    = has_bindless;
+
+						// GPU culling compacts its draws and reads the count back on the GPU when it can (see draw_indirect_count()).
+						m_enabled_features12.drawIndirectCount = supported12.drawIndirectCount;
+
+						// Meshlets go through task and mesh shaders when both are there (see mesh_shading()).
+						m_mesh_shader_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+						if (has_mesh_extension && supported_mesh.taskShader && supported_mesh.meshShader)
+						{
+							m_mesh_shader_features.taskShader = VK_TRUE;
+							m_mesh_shader_features.meshShader = VK_TRUE;
+							m_enabled_features13.pNext        = &m_mesh_shader_features;
+							req_extensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+						}
+
+						// Required, checked by valid_device().
+						m_enabled_features.multiDrawIndirect         = VK_TRUE;
+						m_enabled_features.drawIndirectFirstInstance = VK_TRUE;
+						m_enabled_features12.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+						m_enabled_features12.pNext             = &m_enabled_features13;
+						m_enabled_features12.timelineSemaphore = VK_TRUE;
+						m_enabled_features13.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+						m_enabled_features13.synchronization2  = VK_TRUE;
 
 						// Layers are depreciated in Vulkan 1.2 for VkDeviceCreateInfo.
-						VkPhysicalDeviceFeatures gpu_features = {};
 						VkDeviceCreateInfo gpu_device_info
 						{
 							.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-							.pNext = nullptr,
+							.pNext = &m_enabled_features12,
 							.flags = VK_NULL_HANDLE,
 							.queueCreateInfoCount = static_cast<std::uint32_t>(queue_infos.size()),
 							.pQueueCreateInfos = queue_infos.data(),
 							.enabledExtensionCount = static_cast<std::uint32_t>(req_extensions.size()),
 							.ppEnabledExtensionNames = req_extensions.data(),
-							.pEnabledFeatures = &gpu_features
+							.pEnabledFeatures = &m_enabled_features
 						};
 
 						if (m_debug_mode)
@@ -186,6 +245,11 @@ namespace vulkano
 						{
 							vkGetDeviceQueue(m_gpu_interface, m_qfi.m_graphics.value(), 0, &m_graphics_queue);
 							vkGetDeviceQueue(m_gpu_interface, m_qfi.m_present_to_surface.value(), 0, &m_surface_queue);
+							vkGetDeviceQueue(m_gpu_interface, m_qfi.m_compute.value(), 0, &m_compute_queue);
+							vkGetDeviceQueue(m_gpu_interface, m_qfi.m_transfer.value(), 0, &m_transfer_queue);
+
+							m_allocator      = std::make_unique<MemoryAllocator>(m_gpu_interface, m_gpu);
+							m_deletion_queue = std::make_unique<DeletionQueue>(m_gpu_interface);
 						}
 					}
 				}
@@ -195,6 +259,13 @@ namespace vulkano
 
 	Instance::~Instance()
 	{
+		// The one place waiting for the whole device is fine, everything still deferred goes now.
+		vkDeviceWaitIdle(m_gpu_interface);
+		m_deletion_queue.reset();
+
+		// After the deletion queue, which hands allocations back to it.
+		m_allocator.reset();
+
 		vkDestroyDevice(m_gpu_interface, nullptr);
 
 		if (m_debug_mode)
@@ -230,11 +301,98 @@ namespace vulkano
 		return m_gpu_interface;
 	}
 
+	VkQueue Instance::graphics_queue() const
+	{
+		return m_graphics_queue;
+	}
+
+	VkQueue Instance::present_queue() const
+	{
+		return m_surface_queue;
+	}
+
+	VkQueue Instance::compute_queue() const
+	{
+		return m_compute_queue;
+	}
+
+	VkQueue Instance::transfer_queue() const
+	{
+		return m_transfer_queue;
+	}
+
 	const QueueFamilyIndexs& Instance::qfi() const
 	{
 		return m_qfi;
 	}
 
+	const VkPhysicalDeviceFeatures& Instance::enabled_features() const
+	{
+		return m_enabled_features;
+	}
+
+	const VkPhysicalDeviceVulkan12Features& Instance::enabled_features12() const
+	{
+		return m_enabled_features12;
+	}
+
+	bool Instance::bindless() const
+	{
+		return m_enabled_features12.descriptorIndexing == VK_TRUE;
+	}
+
+	const VkPhysicalDeviceVulkan13Features& Instance::enabled_features13() const
+	{
+		return m_enabled_features13;
+	}
+
+	bool Instance::draw_indirect_count() const
+	{
+		return m_enabled_features12.drawIndirectCount == VK_TRUE;
+	}
+
+	bool Instance::mesh_shading() const
+	{
+		return m_mesh_shader_features.meshShader == VK_TRUE;
+	}
+
+	std::uint32_t Instance::find_memory_type(std::uint32_t type_bits, VkMemoryPropertyFlags properties) const
+	{
+		for (std::uint32_t i = 0; i < m_memory_properties.memoryTypeCount; i++)
+		{
+			if ((type_bits & (1u << i)) && (m_memory_properties.memoryTypes[i].propertyFlags & properties) == properties)
+			{
+				return i;
+			}
+		}
+
+		VK_LOG(VK_THROW, "Failed to find a suitable memory type.");
+		return 0;
+	}
+
+	const VkPhysicalDeviceMemoryProperties& Instance::memory_properties() const
+	{
+		return m_memory_properties;
+	}
+
+	bool Instance::supports_format(VkFormat format, VkFormatFeatureFlags features) const
+	{
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(m_gpu, format, &properties);
+
+		return (properties.optimalTilingFeatures & features) == features;
+	}
+
+	DeletionQueue& Instance::deletion_queue()
+	{
+		return *m_deletion_queue;
+	}
+
+	MemoryAllocator& Instance::allocator()
+	{
+		return *m_allocator;
+	}
+
 	QueueFamilyIndexs Instance::get_family_indexs(VkPhysicalDevice device)
 	{
 		std::uint32_t queue_family_count = 0;
@@ -247,7 +405,8 @@ namespace vulkano
 		QueueFamilyIndexs qfi;
 		for (const auto& queue_family : queue_families)
 		{
-			if (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+			const VkQueueFlags flags = queue_family.queueFlags;
+			if ((flags & VK_QUEUE_GRAPHICS_BIT) && !qfi.m_graphics)
 			{
 				qfi.m_graphics = std::make_optional(index);
 			}
@@ -255,22 +414,60 @@ namespace vulkano
 			VkBool32 surface_present_supported = false;
 			vkGetPhysicalDeviceSurfaceSupportKHR(device, index, m_surface, &surface_present_supported);
 
-			if (surface_present_supported)
+			if (surface_present_supported && !qfi.m_present_to_surface)
 			{
 				qfi.m_present_to_surface = index;
 			}
 
-			if (qfi.has_all_required())
+			// Async compute: compute without graphics. Copy engine: transfer without either.
+			if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) && !qfi.m_compute)
 			{
-				break;
+				qfi.m_compute = index;
+			}
+
+			if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) && !qfi.m_transfer)
+			{
+				qfi.m_transfer = index;
 			}
 
 			index++;
 		}
 
+		// Graphics families always support compute and transfer.
+		if (!qfi.m_compute)
+		{
+			qfi.m_compute = qfi.m_graphics;
+		}
+
+		if (!qfi.m_transfer)
+		{
+			qfi.m_transfer = qfi.m_compute;
+		}
+
 		return std::move(qfi);
 	}
 
+	std::uint32_t Instance::device_score(VkPhysicalDevice device) const
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(device, &properties);
+
+		switch (properties.deviceType)
+		{
+			case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+				return 4;
+
+			case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+				return 3;
+
+			case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+				return 2;
+
+			default:
+				return 1;
+		}
+	}
+
 	const bool Instance::valid_device(VkPhysicalDevice device, std::span<const char*> req_extensions)
 	{
 		bool result = true;
@@ -282,25 +479,41 @@ namespace vulkano
 
 		result = get_family_indexs(device).has_all_required();
 
-		// Cannot be integrated GPU.
-		if (device_properties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+		// Barriers are recorded with synchronization2, which is core in Vulkan 1.3, and submissions are ordered
+		// with timeline semaphores.
+		VkPhysicalDeviceVulkan13Features features13 {};
+		features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+		VkPhysicalDeviceVulkan12Features features12 {};
+		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		features12.pNext = &features13;
+
+		VkPhysicalDeviceFeatures2 features2 {};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &features12;
+
+		if (device_properties.apiVersion < VK_API_VERSION_1_3)
 		{
 			result = false;
 		}
+		else
+		{
+			vkGetPhysicalDeviceFeatures2(device, &features2);
+			if (!features13.synchronization2 || !features12.timelineSemaphore)
+			{
+				result = false;
+			}
+		}
 
-		std::uint32_t extension_count;
-		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
-
-		std::vector<VkExtensionProperties> found_extensions(extension_count);
-		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, found_extensions.data());
+		// GPU culling writes many indirect draws, each naming its instance through firstInstance.
+		if (!device_features.multiDrawIndirect || !device_features.drawIndirectFirstInstance)
+		{
+			result = false;
+		}
 
 		for (const char* req_extension : req_extensions)
 		{
-			auto found = std::find_if(found_extensions.begin(), found_extensions.end(), [&](const auto& extension) {
-				return std::string{ extension.extensionName } == std::string{ req_extension };
-				});
-
-			if (found == found_extensions.end())
+			if (!has_extension(device, req_extension))
 			{
 				result = false;
 				break; // Can break early since all extensions are required.
@@ -309,4 +522,17 @@ namespace vulkano
 
 		return result;
 	}
+
+	bool Instance::has_extension(VkPhysicalDevice device, std::string_view name) const
+	{
+		std::uint32_t extension_count;
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+
+		std::vector<VkExtensionProperties> found_extensions(extension_count);
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, found_extensions.data());
+
+		return std::any_of(found_extensions.begin(), found_extensions.end(), [&](const auto& extension) {
+			return std::string_view {extension.extensionName} == name;
+		});
+	}
 } // namespace vulkano
\ No newline at end of file
@@ -1,12 +1,17 @@
 #ifndef VULKANO_PIPELINE_INSTANCE_HPP_
 #define VULKANO_PIPELINE_INSTANCE_HPP_
 
+#include <memory>
 #include <optional>
 #include <span>
+#include <string_view>
 #include <vector>
 
 #include <GLFW/glfw3.h>
 
+#include "vulkano/graphics/MemoryAllocator.hpp"
+#include "vulkano/pipeline/DeletionQueue.hpp"
+
 namespace vulkano
 {
 	///
@@ -17,6 +22,12 @@ namespace vulkano
 		std::optional<std::uint32_t> m_graphics           = std::nullopt;
 		std::optional<std::uint32_t> m_present_to_surface = std::nullopt;
 
+		///
+		/// Prefer dedicated families so async work runs alongside graphics. Fall back to the graphics family.
+		///
+		std::optional<std::uint32_t> m_compute  = std::nullopt;
+		std::optional<std::uint32_t> m_transfer = std::nullopt;
+
 		///
 		/// Checks all queue familys and makes sure they are set.
 		///
@@ -44,11 +55,56 @@ namespace vulkano
 		[[nodiscard]] VkSurfaceKHR surface() const;
 		[[nodiscard]] VkPhysicalDevice physical_device() const;
 		[[nodiscard]] VkDevice logical_device() const;
+		[[nodiscard]] VkQueue graphics_queue() const;
+		[[nodiscard]] VkQueue present_queue() const;
+		[[nodiscard]] VkQueue compute_queue() const;
+		[[nodiscard]] VkQueue transfer_queue() const;
 		[[nodiscard]] const QueueFamilyIndexs& qfi() const;
+		[[nodiscard]] const VkPhysicalDeviceFeatures& enabled_features() const;
+		[[nodiscard]] const VkPhysicalDeviceVulkan12Features& enabled_features12() const;
+		[[nodiscard]] const VkPhysicalDeviceVulkan13Features& enabled_features13() const;
+
+		///
+		/// True when the descriptor indexing features BindlessTable needs were enabled.
+		///
+		[[nodiscard]] bool bindless() const;
+
+		///
+		/// True when vkCmdDrawIndexedIndirectCount may be used.
+		///
+		[[nodiscard]] bool draw_indirect_count() const;
+
+		///
+		/// True when VK_EXT_mesh_shader was enabled with task and mesh shaders.
+		///
+		[[nodiscard]] bool mesh_shading() const;
+
+		///
+		/// Finds a memory type allowed by type_bits that has all the requested property flags.
+		///
+		[[nodiscard]] std::uint32_t find_memory_type(std::uint32_t type_bits, VkMemoryPropertyFlags properties) const;
+		[[nodiscard]] const VkPhysicalDeviceMemoryProperties& memory_properties() const;
+
+		///
+		/// Checks vkGetPhysicalDeviceFormatProperties for optimal tiling support of all the requested features.
+		///
+		[[nodiscard]] bool supports_format(VkFormat format, VkFormatFeatureFlags features) const;
+
+		///
+		/// Where objects go instead of being destroyed while the GPU may still use them.
+		///
+		[[nodiscard]] DeletionQueue& deletion_queue();
+
+		///
+		/// Device memory for buffers.
+		///
+		[[nodiscard]] MemoryAllocator& allocator();
 
 	private:
 		[[nodiscard]] QueueFamilyIndexs get_family_indexs(VkPhysicalDevice device);
+		[[nodiscard]] std::uint32_t device_score(VkPhysicalDevice device) const;
 		[[nodiscard]] const bool valid_device(VkPhysicalDevice device, std::span<const char*> req_extensions);
+		[[nodiscard]] bool has_extension(VkPhysicalDevice device, std::string_view name) const;
 
 		bool m_debug_mode;
 
@@ -59,8 +115,18 @@ namespace vulkano
 		VkQueue m_graphics_queue;
 		VkSurfaceKHR m_surface;
 		VkQueue m_surface_queue;
+		VkQueue m_compute_queue;
+		VkQueue m_transfer_queue;
 
 		QueueFamilyIndexs m_qfi;
+		VkPhysicalDeviceFeatures m_enabled_features;
+		VkPhysicalDeviceVulkan12Features m_enabled_features12;
+		VkPhysicalDeviceVulkan13Features m_enabled_features13;
+		VkPhysicalDeviceMeshShaderFeaturesEXT m_mesh_shader_features;
+		VkPhysicalDeviceMemoryProperties m_memory_properties;
+
+		std::unique_ptr<MemoryAllocator> m_allocator;
+		std::unique_ptr<DeletionQueue> m_deletion_queue;
 	};
 } // namespace vulkano
 
@@ -0,0 +1,80 @@
+#include <algorithm>
+
+#include "vulkano/core/JobSystem.hpp"
+#include "vulkano/pipeline/CommandPoolManager.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "ParallelRecorder.hpp"
+
+namespace vulkano
+{
+	ParallelRecorder::ParallelRecorder(JobSystem& jobs, CommandPoolManager& pools)
+	    : m_jobs {jobs}, m_pools {pools}
+	{
+		if (m_pools.thread_count() < m_jobs.thread_count())
+		{
+			VK_LOG(VK_THROW, "Command pool manager has {0} thread slots but the job system runs {1} threads.", m_pools.thread_count(), m_jobs.thread_count());
+		}
+	}
+
+	void ParallelRecorder::record(VkCommandBuffer primary, const ParallelRecorder::Target& target, std::uint32_t draw_count, std::uint32_t chunk_size, const RecordChunk& record_chunk)
+	{
+		if (JobSystem::thread_index() >= m_jobs.thread_count())
+		{
+			VK_LOG(VK_THROW, "Draws can only be recorded from the thread that created the job system or from a job.");
+		}
+
+		if (draw_count == 0)
+		{
+			return;
+		}
+
+		chunk_size                 = std::max(chunk_size, 1u);
+		const std::uint32_t chunks = (draw_count + chunk_size - 1) / chunk_size;
+		m_secondaries.assign(chunks, VK_NULL_HANDLE);
+
+		// clang-format off
+		const VkCommandBufferInheritanceInfo inheritance
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+			.pNext = nullptr,
+			.renderPass = target.m_render_pass,
+			.subpass = target.m_subpass,
+			.framebuffer = target.m_framebuffer,
+			.occlusionQueryEnable = VK_FALSE,
+			.queryFlags = 0,
+			.pipelineStatistics = 0
+		};
+
+		const VkCommandBufferBeginInfo begin_info
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.pNext = nullptr,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+			.pInheritanceInfo = &inheritance
+		};
+		// clang-format on
+
+		// Each chunk owns its slot, so which thread records it does not change the order they are executed in.
+		m_jobs.parallel_for(chunks, 1, [&](std::uint32_t first, std::uint32_t last) {
+			for (std::uint32_t chunk = first; chunk < last; chunk++)
+			{
+				VkCommandBuffer cmd = m_pools.allocate(JobSystem::thread_index(), VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+				vkBeginCommandBuffer(cmd, &begin_info);
+
+				const std::uint32_t begin = chunk * chunk_size;
+				const std::uint32_t end   = std::min(draw_count, begin + chunk_size);
+				record_chunk(cmd, begin, end);
+
+				if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
+				{
+					VK_LOG(VK_THROW, "Failed to record secondary command buffer for draws [{0}, {1}).", begin, end);
+				}
+
+				m_secondaries[chunk] = cmd;
+			}
+		});
+
+		vkCmdExecuteCommands(primary, chunks, m_secondaries.data());
+	}
+} // namespace vulkano
\ No newline at end of file
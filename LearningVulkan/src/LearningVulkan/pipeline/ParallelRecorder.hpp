@@ -0,0 +1,64 @@
+#ifndef VULKANO_PIPELINE_PARALLELRECORDER_HPP_
+#define VULKANO_PIPELINE_PARALLELRECORDER_HPP_
+
+#include <functional>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class CommandPoolManager;
+	class JobSystem;
+
+	///
+	/// Splits a pass' draw list into chunks, records each chunk into a secondary command buffer on a worker thread,
+	/// then executes them from the primary in chunk order, so the result matches recording everything serially.
+	///
+	class ParallelRecorder final
+	{
+	public:
+		///
+		/// Render pass instance the secondaries continue. The framebuffer is optional, but lets drivers optimise.
+		///
+		struct Target final
+		{
+			VkRenderPass m_render_pass;
+			std::uint32_t m_subpass     = 0;
+			VkFramebuffer m_framebuffer = VK_NULL_HANDLE;
+		};
+
+		///
+		/// Records draws [begin, end) into cmd. Secondaries inherit no state, so each chunk binds its own pipeline and
+		/// descriptors and sets any dynamic state (viewport, scissor) itself. Called concurrently from several threads.
+		///
+		using RecordChunk = std::function<void(VkCommandBuffer cmd, std::uint32_t begin, std::uint32_t end)>;
+
+		///
+		/// pools needs at least one thread slot per job system thread.
+		///
+		ParallelRecorder(JobSystem& jobs, CommandPoolManager& pools);
+		~ParallelRecorder() = default;
+
+		///
+		/// Call between vkCmdBeginRenderPass with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS and the next
+		/// vkCmdNextSubpass or vkCmdEndRenderPass. Returns once every chunk is recorded and executed into primary.
+		/// If record_chunk throws, the first exception is rethrown here once every chunk has finished, and nothing is
+		/// executed into primary.
+		///
+		void record(VkCommandBuffer primary, const ParallelRecorder::Target& target, std::uint32_t draw_count, std::uint32_t chunk_size, const RecordChunk& record_chunk);
+
+	private:
+		ParallelRecorder() = delete;
+
+		JobSystem& m_jobs;
+		CommandPoolManager& m_pools;
+
+		///
+		/// Reused between calls, indexed by chunk.
+		///
+		std::vector<VkCommandBuffer> m_secondaries;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -8,11 +8,13 @@
 namespace vulkano
 {
 	Pipeline::Pipeline(std::shared_ptr<SwapChain> swapchain, const Pipeline::Settings& settings)
-	    : m_instance {nullptr}, m_layout {nullptr}
+	    : m_instance {nullptr}, m_render_pass {nullptr}, m_layout {nullptr}, m_pipeline {nullptr}, m_bind_point {VK_PIPELINE_BIND_POINT_GRAPHICS}
 	{
 		const auto* swap_extent = swapchain->extent();
 		m_instance              = swapchain->instance_used();
 
+		// The render pass leaves layouts alone. Transitions in and out of it are recorded by BarrierBatch from the
+		// state tracked on each Image, so they can be merged with the other barriers of the frame.
 		// clang-format off
 		VkAttachmentDescription colour_attachment
 		{
@@ -23,8 +25,8 @@ namespace vulkano
 			.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
 			.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
 			.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-			.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-			.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+			.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
 		};
 
 		VkAttachmentReference colour_attachment_ref
@@ -185,31 +187,132 @@ namespace vulkano
 		};
 		*/
 
-		VkPipelineLayoutCreateInfo layout_info
+		// clang-format on
+
+		create_layout(settings.m_set_layouts, settings.m_push_constant_size);
+
+		// Mesh shaders fetch their own vertices and assemble their own primitives.
+		const bool mesh_shading      = settings.m_shader->has_stage(VK_SHADER_STAGE_MESH_BIT_EXT);
+		const auto stages            = settings.m_shader->stages();
+		const auto vertex_input      = mesh_shading ? VertexInput {} : settings.m_vertex_layout->input_state(settings.m_shader->vertex_reflection());
+		const auto vertex_input_info = vertex_input.info();
+
+		// clang-format off
+		VkGraphicsPipelineCreateInfo pipeline_info
 		{
-			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+			.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
 			.pNext = nullptr,
 			.flags = VK_NULL_HANDLE,
-			.setLayoutCount = 0,
-			.pSetLayouts = nullptr,
-			.pushConstantRangeCount = 0,
-			.pPushConstantRanges = nullptr,
+			.stageCount = static_cast<std::uint32_t>(stages.size()),
+			.pStages = stages.data(),
+			.pVertexInputState = mesh_shading ? nullptr : &vertex_input_info,
+			.pInputAssemblyState = mesh_shading ? nullptr : &input_assembly,
+			.pTessellationState = nullptr,
+			.pViewportState = &viewport_state_info,
+			.pRasterizationState = &rasterizer_info,
+			.pMultisampleState = &multisampling_info,
+			.pDepthStencilState = nullptr,
+			.pColorBlendState = &blending_info,
+			.pDynamicState = nullptr,
+			.layout = m_layout,
+			.renderPass = m_render_pass,
+			.subpass = 0,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1
 		};
 		// clang-format on
 
-		if (vkCreatePipelineLayout(m_instance->logical_device(), &layout_info, nullptr, &m_layout) != VK_SUCCESS)
+		if (vkCreateGraphicsPipelines(m_instance->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &m_pipeline) != VK_SUCCESS)
 		{
-			VK_LOG(VK_THROW, "Failed to create pipeline layout.");
+			VK_LOG(VK_THROW, "Failed to create graphics pipeline.");
+		}
+	}
+
+	Pipeline::Pipeline(Instance* instance, const Shader& compute, std::span<const VkDescriptorSetLayout> set_layouts, std::uint32_t push_constant_size)
+	    : m_instance {instance}, m_viewport {}, m_viewport_scissor {}, m_render_pass {nullptr}, m_layout {nullptr}, m_pipeline {nullptr}, m_bind_point {VK_PIPELINE_BIND_POINT_COMPUTE}
+	{
+		if (compute.stages().size() != 1 || !compute.has_stage(VK_SHADER_STAGE_COMPUTE_BIT))
+		{
+			VK_LOG(VK_THROW, "Compute pipelines take exactly one compute stage.");
+		}
+
+		create_layout(set_layouts, push_constant_size);
+
+		// clang-format off
+		VkComputePipelineCreateInfo pipeline_info
+		{
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = VK_NULL_HANDLE,
+			.stage = compute.stages()[0],
+			.layout = m_layout,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1
+		};
+		// clang-format on
+
+		if (vkCreateComputePipelines(m_instance->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &m_pipeline) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create compute pipeline.");
 		}
 	}
 
 	Pipeline::~Pipeline()
 	{
-		vkDestroyPipelineLayout(m_instance->logical_device(), m_layout, nullptr);
-		vkDestroyRenderPass(m_instance->logical_device(), m_render_pass, nullptr);
+		m_instance->deletion_queue().release(m_pipeline);
+		m_instance->deletion_queue().release(m_layout);
+		m_instance->deletion_queue().release(m_render_pass);
+	}
+
+	void Pipeline::bind(VkCommandBuffer cmd) const
+	{
+		vkCmdBindPipeline(cmd, m_bind_point, m_pipeline);
 	}
 
 	void Pipeline::reconfigure(const Pipeline::UpdatedSettings& new_settings)
 	{
 	}
+
+	VkRenderPass Pipeline::render_pass() const
+	{
+		return m_render_pass;
+	}
+
+	VkPipelineLayout Pipeline::layout() const
+	{
+		return m_layout;
+	}
+
+	VkPipeline Pipeline::vk_handle() const
+	{
+		return m_pipeline;
+	}
+
+	VkPipelineBindPoint Pipeline::bind_point() const
+	{
+		return m_bind_point;
+	}
+
+	void Pipeline::create_layout(std::span<const VkDescriptorSetLayout> set_layouts, std::uint32_t push_constant_size)
+	{
+		const VkPushConstantRange push_constants {VK_SHADER_STAGE_ALL, 0, push_constant_size};
+
+		// clang-format off
+		VkPipelineLayoutCreateInfo layout_info
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = VK_NULL_HANDLE,
+			.setLayoutCount = static_cast<std::uint32_t>(set_layouts.size()),
+			.pSetLayouts = set_layouts.data(),
+			.pushConstantRangeCount = (push_constant_size > 0) ? 1u : 0u,
+			.pPushConstantRanges = &push_constants,
+		};
+		// clang-format on
+
+		if (vkCreatePipelineLayout(m_instance->logical_device(), &layout_info, nullptr, &m_layout) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create pipeline layout.");
+		}
+	}
 } // namespace vulkano
\ No newline at end of file
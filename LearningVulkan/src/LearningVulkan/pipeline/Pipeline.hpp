@@ -1,6 +1,8 @@
 #ifndef VULKANO_GRAPHICS_PIPELINE_HPP_
 #define VULKANO_GRAPHICS_PIPELINE_HPP_
 
+#include "vulkano/core/Shader.hpp"
+#include "vulkano/graphics/VertexLayout.hpp"
 #include "vulkano/pipeline/SwapChain.hpp"
 
 namespace vulkano
@@ -15,6 +17,19 @@ namespace vulkano
 			VkFrontFace m_front_facing;
 			VkBool32 m_enable_msaa;
 			VkSampleCountFlagBits m_msaa_level;
+			std::span<const VkDescriptorSetLayout> m_set_layouts;
+
+			///
+			/// Vertex input is built from the attributes the vertex shader reads, in the format the layout stores.
+			/// Ignored when the shader has a mesh stage, which pulls its own vertices.
+			///
+			const Shader* m_shader;
+			const VertexLayout* m_vertex_layout;
+
+			///
+			/// Bytes of push constants, visible to every stage.
+			///
+			std::uint32_t m_push_constant_size = 0;
 		};
 
 		struct UpdatedSettings
@@ -24,17 +39,33 @@ namespace vulkano
 		};
 
 		Pipeline(std::shared_ptr<SwapChain> swapchain, const Pipeline::Settings& settings);
+
+		///
+		/// Compute pipeline from a shader with a single compute stage.
+		///
+		Pipeline(Instance* instance, const Shader& compute, std::span<const VkDescriptorSetLayout> set_layouts, std::uint32_t push_constant_size = 0);
 		~Pipeline();
 
+		void bind(VkCommandBuffer cmd) const;
+
 		void reconfigure(const Pipeline::UpdatedSettings& new_settings);
 
+		[[nodiscard]] VkRenderPass render_pass() const;
+		[[nodiscard]] VkPipelineLayout layout() const;
+		[[nodiscard]] VkPipeline vk_handle() const;
+		[[nodiscard]] VkPipelineBindPoint bind_point() const;
+
 	private:
-		std::shared_ptr<Instance> m_instance;
+		void create_layout(std::span<const VkDescriptorSetLayout> set_layouts, std::uint32_t push_constant_size);
+
+		Instance* m_instance;
 
 		VkViewport m_viewport;
 		VkRect2D m_viewport_scissor;
 		VkRenderPass m_render_pass;
 		VkPipelineLayout m_layout;
+		VkPipeline m_pipeline;
+		VkPipelineBindPoint m_bind_point;
 	};
 } // namespace vulkano
 
@@ -0,0 +1,243 @@
+#include <algorithm>
+
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "QueueSubmitter.hpp"
+
+namespace vulkano
+{
+	QueueSubmitter::QueueSubmitter(Instance* instance)
+	    : m_instance {instance}, m_queue_index {}
+	{
+		const QueueFamilyIndexs& qfi = m_instance->qfi();
+
+		const std::array<VkQueue, 3> queues        = {m_instance->graphics_queue(), m_instance->compute_queue(), m_instance->transfer_queue()};
+		const std::array<std::uint32_t, 3> families = {qfi.m_graphics.value(), qfi.m_compute.value(), qfi.m_transfer.value()};
+
+		// clang-format off
+		VkSemaphoreTypeCreateInfo type_info
+		{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+			.pNext = nullptr,
+			.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+			.initialValue = 0
+		};
+
+		VkSemaphoreCreateInfo semaphore_info
+		{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+			.pNext = &type_info,
+			.flags = 0
+		};
+		// clang-format on
+
+		for (std::size_t type = 0; type < queues.size(); type++)
+		{
+			auto found = std::find_if(m_queues.begin(), m_queues.end(), [&](const Queue& queue) { return queue.m_queue == queues[type]; });
+			if (found == m_queues.end())
+			{
+				Queue queue {queues[type], families[type], VK_NULL_HANDLE, 0, 0, {}};
+				if (vkCreateSemaphore(m_instance->logical_device(), &semaphore_info, nullptr, &queue.m_timeline) != VK_SUCCESS)
+				{
+					VK_LOG(VK_THROW, "Failed to create timeline semaphore.");
+				}
+
+				m_queues.push_back(std::move(queue));
+				found = m_queues.end() - 1;
+			}
+
+			m_queue_index[type] = static_cast<std::uint32_t>(found - m_queues.begin());
+		}
+	}
+
+	QueueSubmitter::~QueueSubmitter()
+	{
+		for (const auto& queue : m_queues)
+		{
+			vkDestroySemaphore(m_instance->logical_device(), queue.m_timeline, nullptr);
+		}
+	}
+
+	TimelinePoint QueueSubmitter::submit(QueueType type, const Submission& submission)
+	{
+		Queue& queue = m_queues[m_queue_index[static_cast<std::size_t>(type)]];
+
+		// Folding into a batch with waits would hold this work back on them too, and folding into one that signals
+		// a binary semaphore would delay presentation behind it.
+		const bool has_waits = !submission.m_waits.empty() || submission.m_wait_binary;
+		if (queue.m_batches.empty() || has_waits || !queue.m_batches.back().m_waits.empty() || queue.m_batches.back().m_signals.size() > 1)
+		{
+			queue.m_batches.emplace_back();
+		}
+
+		Batch& batch = queue.m_batches.back();
+		for (const auto& point : submission.m_waits)
+		{
+			const Queue& source = m_queues[m_queue_index[static_cast<std::size_t>(point.m_queue)]];
+
+			// Same queue: submission order already covers it.
+			if (&source == &queue)
+			{
+				continue;
+			}
+
+			batch.m_waits.push_back({VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO, nullptr, source.m_timeline, point.m_value, submission.m_wait_stages, 0});
+		}
+
+		if (submission.m_wait_binary)
+		{
+			batch.m_waits.push_back({VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO, nullptr, submission.m_wait_binary, 0, submission.m_wait_binary_stages, 0});
+		}
+
+		for (const auto cmd : submission.m_command_buffers)
+		{
+			batch.m_command_buffers.push_back({VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, nullptr, cmd, 0});
+		}
+
+		// The batch only signals its latest value, the timeline signal is kept first so it is easy to bump.
+		queue.m_value++;
+		if (batch.m_signals.empty())
+		{
+			batch.m_signals.push_back({VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO, nullptr, queue.m_timeline, queue.m_value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 0});
+		}
+		else
+		{
+			batch.m_signals.front().value = queue.m_value;
+		}
+
+		if (submission.m_signal_binary)
+		{
+			batch.m_signals.push_back({VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO, nullptr, submission.m_signal_binary, 0, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 0});
+		}
+
+		return {type, queue.m_value};
+	}
+
+	std::uint32_t QueueSubmitter::flush()
+	{
+		std::uint32_t calls = 0;
+
+		std::vector<VkSubmitInfo2> infos;
+		for (auto& queue : m_queues)
+		{
+			if (queue.m_batches.empty())
+			{
+				continue;
+			}
+
+			infos.clear();
+			for (const auto& batch : queue.m_batches)
+			{
+				// clang-format off
+				infos.push_back(VkSubmitInfo2
+				{
+					.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+					.pNext = nullptr,
+					.flags = 0,
+					.waitSemaphoreInfoCount = static_cast<std::uint32_t>(batch.m_waits.size()),
+					.pWaitSemaphoreInfos = batch.m_waits.data(),
+					.commandBufferInfoCount = static_cast<std::uint32_t>(batch.m_command_buffers.size()),
+					.pCommandBufferInfos = batch.m_command_buffers.data(),
+					.signalSemaphoreInfoCount = static_cast<std::uint32_t>(batch.m_signals.size()),
+					.pSignalSemaphoreInfos = batch.m_signals.data()
+				});
+				// clang-format on
+			}
+
+			if (vkQueueSubmit2(queue.m_queue, static_cast<std::uint32_t>(infos.size()), infos.data(), VK_NULL_HANDLE) != VK_SUCCESS)
+			{
+				VK_LOG(VK_THROW, "Failed to submit {0} batches.", infos.size());
+			}
+
+			queue.m_batches.clear();
+			queue.m_submitted = queue.m_value;
+			calls++;
+		}
+
+		return calls;
+	}
+
+	std::uint32_t QueueSubmitter::family(QueueType type) const
+	{
+		return queue(type).m_family;
+	}
+
+	bool QueueSubmitter::reached(const TimelinePoint& point) const
+	{
+		return completed(point.m_queue) >= point.m_value;
+	}
+
+	std::uint64_t QueueSubmitter::completed(QueueType type) const
+	{
+		std::uint64_t value = 0;
+		vkGetSemaphoreCounterValue(m_instance->logical_device(), queue(type).m_timeline, &value);
+
+		return value;
+	}
+
+	bool QueueSubmitter::wait(const TimelinePoint& point, std::uint64_t timeout)
+	{
+		const Queue& target = queue(point.m_queue);
+		if (point.m_value > target.m_value)
+		{
+			VK_LOG(VK_THROW, "Timeline value {0} has not been handed out, the latest is {1}.", point.m_value, target.m_value);
+		}
+
+		if (point.m_value > target.m_submitted)
+		{
+			flush();
+		}
+
+		// clang-format off
+		VkSemaphoreWaitInfo wait_info
+		{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.semaphoreCount = 1,
+			.pSemaphores = &target.m_timeline,
+			.pValues = &point.m_value
+		};
+		// clang-format on
+
+		return vkWaitSemaphores(m_instance->logical_device(), &wait_info, timeout) == VK_SUCCESS;
+	}
+
+	void QueueSubmitter::wait_idle()
+	{
+		flush();
+
+		std::vector<VkSemaphore> semaphores;
+		std::vector<std::uint64_t> values;
+		for (const auto& queue : m_queues)
+		{
+			semaphores.push_back(queue.m_timeline);
+			values.push_back(queue.m_value);
+		}
+
+		// clang-format off
+		VkSemaphoreWaitInfo wait_info
+		{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.semaphoreCount = static_cast<std::uint32_t>(semaphores.size()),
+			.pSemaphores = semaphores.data(),
+			.pValues = values.data()
+		};
+		// clang-format on
+
+		vkWaitSemaphores(m_instance->logical_device(), &wait_info, UINT64_MAX);
+	}
+
+	TimelinePoint QueueSubmitter::last(QueueType type) const
+	{
+		return {type, queue(type).m_value};
+	}
+
+	const QueueSubmitter::Queue& QueueSubmitter::queue(QueueType type) const
+	{
+		return m_queues[m_queue_index[static_cast<std::size_t>(type)]];
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,137 @@
+#ifndef VULKANO_PIPELINE_QUEUESUBMITTER_HPP_
+#define VULKANO_PIPELINE_QUEUESUBMITTER_HPP_
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class Instance;
+
+	enum class QueueType
+	{
+		GRAPHICS,
+		COMPUTE,
+		TRANSFER
+	};
+
+	///
+	/// A point on a queue's timeline. Reached once everything submitted to the queue up to it has finished.
+	///
+	struct TimelinePoint final
+	{
+		QueueType m_queue;
+		std::uint64_t m_value;
+	};
+
+	///
+	/// Work for one queue. Binary semaphores are only for the swapchain, everything else waits on timeline points.
+	///
+	struct Submission final
+	{
+		std::span<const VkCommandBuffer> m_command_buffers;
+		std::span<const TimelinePoint> m_waits = {};
+		VkPipelineStageFlags2 m_wait_stages    = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+		VkSemaphore m_wait_binary                  = VK_NULL_HANDLE;
+		VkPipelineStageFlags2 m_wait_binary_stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+		VkSemaphore m_signal_binary                = VK_NULL_HANDLE;
+	};
+
+	///
+	/// Orders work across the graphics, compute and transfer queues with one timeline semaphore per queue.
+	/// submit() only queues work, flush() hands everything to the driver with one vkQueueSubmit2 per queue.
+	/// Submissions without waits are folded into the previous batch when it has none either, since a later timeline
+	/// value implies every earlier one. The CPU waits on any returned point directly, so no per frame fences are
+	/// needed.
+	///
+	/// Types that share a VkQueue (no dedicated family) share a timeline too. Resources are exclusive to one queue
+	/// family, so work that hands one to a queue of another family() transfers ownership with
+	/// BarrierBatch::release() and acquire().
+	///
+	class QueueSubmitter final
+	{
+	public:
+		QueueSubmitter(Instance* instance);
+		~QueueSubmitter();
+
+		///
+		/// Queues work and returns the point signalled when it completes. Cross queue waits may name points whose
+		/// work is submitted later in the same flush.
+		///
+		[[nodiscard]] TimelinePoint submit(QueueType queue, const Submission& submission);
+
+		///
+		/// Submits all queued work. Returns the number of vkQueueSubmit2 calls made.
+		///
+		std::uint32_t flush();
+
+		///
+		/// Queue family index of the queue, for ownership transfers.
+		///
+		[[nodiscard]] std::uint32_t family(QueueType queue) const;
+
+		[[nodiscard]] bool reached(const TimelinePoint& point) const;
+
+		///
+		/// Latest value the GPU has finished on a queue, i.e. for DeletionQueue::collect.
+		///
+		[[nodiscard]] std::uint64_t completed(QueueType queue) const;
+
+		///
+		/// Blocks until the point is reached, or timeout nanoseconds pass. Returns false on timeout.
+		/// Flushes first if the point's work is still queued, since it would never be reached otherwise.
+		///
+		bool wait(const TimelinePoint& point, std::uint64_t timeout = UINT64_MAX);
+
+		///
+		/// Flushes, then blocks until everything submitted so far has finished, on every queue.
+		///
+		void wait_idle();
+
+		///
+		/// Point of the most recently queued work on a queue.
+		///
+		[[nodiscard]] TimelinePoint last(QueueType queue) const;
+
+	private:
+		QueueSubmitter() = delete;
+
+		///
+		/// One vkQueueSubmit2 worth of VkSubmitInfo2, kept as plain data until flush.
+		///
+		struct Batch final
+		{
+			std::vector<VkCommandBufferSubmitInfo> m_command_buffers;
+			std::vector<VkSemaphoreSubmitInfo> m_waits;
+			std::vector<VkSemaphoreSubmitInfo> m_signals;
+		};
+
+		struct Queue final
+		{
+			VkQueue m_queue;
+			std::uint32_t m_family;
+			VkSemaphore m_timeline;
+
+			///
+			/// Latest value handed out, and the latest handed to the driver.
+			///
+			std::uint64_t m_value;
+			std::uint64_t m_submitted;
+
+			std::vector<Batch> m_batches;
+		};
+
+		[[nodiscard]] const Queue& queue(QueueType type) const;
+
+		Instance* m_instance;
+
+		std::vector<Queue> m_queues;
+		std::array<std::uint32_t, 3> m_queue_index;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
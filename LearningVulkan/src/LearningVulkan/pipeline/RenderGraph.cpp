@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "RenderGraph.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Image usage flags a transient needs for a declared use, so passes don't have to repeat them in the ImageInfo.
+		///
+		[[nodiscard]] VkImageUsageFlags image_usage_flags(ResourceUsage usage)
+		{
+			switch (usage)
+			{
+				case ResourceUsage::TRANSFER_SRC:
+					return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+				case ResourceUsage::TRANSFER_DST:
+					return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+				case ResourceUsage::SAMPLED_GRAPHICS:
+				case ResourceUsage::SAMPLED_COMPUTE:
+					return VK_IMAGE_USAGE_SAMPLED_BIT;
+
+				case ResourceUsage::STORAGE_READ:
+				case ResourceUsage::STORAGE_WRITE:
+				case ResourceUsage::STORAGE_READ_WRITE:
+					return VK_IMAGE_USAGE_STORAGE_BIT;
+
+				case ResourceUsage::COLOUR_ATTACHMENT:
+					return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+				case ResourceUsage::DEPTH_ATTACHMENT:
+					return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+				case ResourceUsage::DEPTH_READ:
+					return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+				default:
+					return 0;
+			}
+		}
+
+		[[nodiscard]] bool overlaps(const std::pair<std::uint32_t, std::uint32_t>& a, std::uint32_t first, std::uint32_t last)
+		{
+			return a.first <= last && first <= a.second;
+		}
+	} // namespace
+
+	RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, std::uint32_t pass)
+	    : m_graph {graph}, m_pass {pass}
+	{
+	}
+
+	void RenderGraph::PassBuilder::read(ResourceId resource, ResourceUsage usage)
+	{
+		auto& accesses = m_graph.m_passes[m_pass].m_accesses;
+		if (std::any_of(accesses.begin(), accesses.end(), [&](const Access& access) { return access.m_resource == resource; }))
+		{
+			VK_LOG(VK_THROW, "Pass '{0}' declared resource '{1}' more than once.", m_graph.m_passes[m_pass].m_name, m_graph.m_resources[resource].m_name);
+		}
+
+		accesses.push_back({resource, usage, false});
+	}
+
+	void RenderGraph::PassBuilder::write(ResourceId resource, ResourceUsage usage)
+	{
+		read(resource, usage);
+		m_graph.m_passes[m_pass].m_accesses.back().m_write = true;
+	}
+
+	RenderGraph::ResourceId RenderGraph::PassBuilder::create(std::string_view name, const ImageInfo& info, ResourceUsage usage)
+	{
+		Resource resource;
+		resource.m_name      = name;
+		resource.m_info      = info;
+		resource.m_transient = true;
+
+		const auto id = static_cast<ResourceId>(m_graph.m_resources.size());
+		m_graph.m_resources.push_back(std::move(resource));
+
+		write(id, usage);
+		return id;
+	}
+
+	void RenderGraph::PassBuilder::side_effect()
+	{
+		m_graph.m_passes[m_pass].m_side_effect = true;
+	}
+
+	RenderGraph::RenderGraph(Instance* instance)
+	    : m_instance {instance}
+	{
+	}
+
+	RenderGraph::~RenderGraph()
+	{
+		free_transients();
+	}
+
+	void RenderGraph::reset()
+	{
+		m_passes.clear();
+		m_resources.clear();
+		m_order.clear();
+	}
+
+	RenderGraph::ResourceId RenderGraph::import_image(std::string_view name, Image& image, std::optional<ResourceUsage> final_usage)
+	{
+		Resource resource;
+		resource.m_name  = name;
+		resource.m_info  = image.info();
+		resource.m_image = &image;
+		resource.m_final = final_usage;
+
+		m_resources.push_back(std::move(resource));
+		return static_cast<ResourceId>(m_resources.size() - 1);
+	}
+
+	RenderGraph::ResourceId RenderGraph::import_buffer(std::string_view name, ResourceState& state)
+	{
+		Resource resource;
+		resource.m_name   = name;
+		resource.m_buffer = &state;
+
+		m_resources.push_back(std::move(resource));
+		return static_cast<ResourceId>(m_resources.size() - 1);
+	}
+
+	void RenderGraph::add_pass(std::string_view name, const Setup& setup, Execute execute)
+	{
+		Pass pass;
+		pass.m_name    = name;
+		pass.m_execute = std::move(execute);
+		m_passes.push_back(std::move(pass));
+
+		PassBuilder builder {*this, static_cast<std::uint32_t>(m_passes.size() - 1)};
+		setup(builder);
+	}
+
+	void RenderGraph::compile()
+	{
+		cull_and_sort();
+		allocate_transients();
+	}
+
+	void RenderGraph::execute(VkCommandBuffer cmd)
+	{
+		BarrierBatch batch;
+		for (std::uint32_t position = 0; position < m_order.size(); position++)
+		{
+			Pass& pass = m_passes[m_order[position]];
+			for (const auto& access : pass.m_accesses)
+			{
+				Resource& resource = m_resources[access.m_resource];
+				if (resource.m_buffer)
+				{
+					batch.buffer(*resource.m_buffer, access.m_usage);
+					continue;
+				}
+
+				const bool first_use = resource.m_transient && resource.m_first == position;
+				if (first_use)
+				{
+					// Another image may have used this memory last. Its work has to finish before the new occupant's
+					// layout transition, so seed the new image's state with the old occupant's scope.
+					MemoryBlock& block = m_blocks[resource.m_block];
+					if (block.m_occupant && block.m_occupant != resource.m_image)
+					{
+						ResourceState previous;
+						const ImageInfo& info = block.m_occupant->info();
+						for (std::uint32_t layer = 0; layer < info.m_array_layers; layer++)
+						{
+							for (std::uint32_t mip = 0; mip < info.m_mip_levels; mip++)
+							{
+								const ResourceState& occupant = block.m_occupant->state(mip, layer);
+
+								previous.m_stages |= occupant.m_stages;
+								previous.m_access |= occupant.m_access;
+								previous.m_write_access |= occupant.m_write_access;
+							}
+						}
+
+						for (std::uint32_t layer = 0; layer < resource.m_info.m_array_layers; layer++)
+						{
+							for (std::uint32_t mip = 0; mip < resource.m_info.m_mip_levels; mip++)
+							{
+								resource.m_image->state(mip, layer) = previous;
+							}
+						}
+					}
+
+					block.m_occupant = resource.m_image;
+				}
+
+				batch.image(*resource.m_image, access.m_usage, 0, VK_REMAINING_MIP_LEVELS, first_use);
+			}
+
+			batch.flush(cmd);
+			pass.m_execute(cmd, *this);
+		}
+
+		for (auto& resource : m_resources)
+		{
+			if (resource.m_final)
+			{
+				batch.image(*resource.m_image, *resource.m_final);
+			}
+		}
+
+		batch.flush(cmd);
+	}
+
+	Image& RenderGraph::image(ResourceId resource)
+	{
+		if (!m_resources[resource].m_image)
+		{
+			VK_LOG(VK_THROW, "Resource '{0}' has no image, it is a buffer or was culled.", m_resources[resource].m_name);
+		}
+
+		return *m_resources[resource].m_image;
+	}
+
+	std::uint32_t RenderGraph::pass_count() const
+	{
+		return static_cast<std::uint32_t>(m_order.size());
+	}
+
+	std::uint32_t RenderGraph::culled_count() const
+	{
+		return static_cast<std::uint32_t>(m_passes.size() - m_order.size());
+	}
+
+	VkDeviceSize RenderGraph::transient_memory() const
+	{
+		VkDeviceSize total = 0;
+		for (const auto& block : m_blocks)
+		{
+			total += block.m_size;
+		}
+
+		return total;
+	}
+
+	void RenderGraph::cull_and_sort()
+	{
+		const auto pass_total = static_cast<std::uint32_t>(m_passes.size());
+
+		// Walk each resource's accesses in declaration order. A read depends on the last write, a write on the last
+		// write and every read since it. Only the first kind makes a producer necessary, the others just order passes.
+		std::vector<std::vector<std::uint32_t>> producers(pass_total);
+		std::vector<std::vector<std::uint32_t>> successors(pass_total);
+		std::vector<std::uint32_t> last_writer(m_resources.size(), UINT32_MAX);
+		std::vector<std::vector<std::uint32_t>> readers(m_resources.size());
+
+		for (std::uint32_t pass = 0; pass < pass_total; pass++)
+		{
+			for (const auto& access : m_passes[pass].m_accesses)
+			{
+				const std::uint32_t writer = last_writer[access.m_resource];
+				if (writer != UINT32_MAX)
+				{
+					producers[pass].push_back(writer);
+					successors[writer].push_back(pass);
+				}
+
+				if (access.m_write)
+				{
+					for (const auto reader : readers[access.m_resource])
+					{
+						successors[reader].push_back(pass);
+					}
+
+					readers[access.m_resource].clear();
+					last_writer[access.m_resource] = pass;
+				}
+				else
+				{
+					readers[access.m_resource].push_back(pass);
+				}
+			}
+		}
+
+		// Passes with side effects or writing imported resources are roots, everything they depend on stays.
+		std::vector<bool> alive(pass_total, false);
+		std::vector<std::uint32_t> stack;
+		for (std::uint32_t pass = 0; pass < pass_total; pass++)
+		{
+			const auto& accesses = m_passes[pass].m_accesses;
+			if (m_passes[pass].m_side_effect || std::any_of(accesses.begin(), accesses.end(), [&](const Access& access) { return access.m_write && !m_resources[access.m_resource].m_transient; }))
+			{
+				alive[pass] = true;
+				stack.push_back(pass);
+			}
+		}
+
+		while (!stack.empty())
+		{
+			const std::uint32_t pass = stack.back();
+			stack.pop_back();
+
+			for (const auto producer : producers[pass])
+			{
+				if (!alive[producer])
+				{
+					alive[producer] = true;
+					stack.push_back(producer);
+				}
+			}
+		}
+
+		// Kahn's algorithm over the surviving passes. Ties go to the earliest declared pass so the order is stable.
+		std::vector<std::uint32_t> in_degree(pass_total, 0);
+		for (std::uint32_t pass = 0; pass < pass_total; pass++)
+		{
+			if (!alive[pass])
+			{
+				continue;
+			}
+
+			for (const auto successor : successors[pass])
+			{
+				if (alive[successor])
+				{
+					in_degree[successor]++;
+				}
+			}
+		}
+
+		std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<std::uint32_t>> ready;
+		for (std::uint32_t pass = 0; pass < pass_total; pass++)
+		{
+			if (alive[pass] && in_degree[pass] == 0)
+			{
+				ready.push(pass);
+			}
+		}
+
+		m_order.clear();
+		while (!ready.empty())
+		{
+			const std::uint32_t pass = ready.top();
+			ready.pop();
+			m_order.push_back(pass);
+
+			for (const auto successor : successors[pass])
+			{
+				if (alive[successor] && --in_degree[successor] == 0)
+				{
+					ready.push(successor);
+				}
+			}
+		}
+
+		// Lifetimes of transients in execution order, plus the usage flags every declared use needs.
+		for (std::uint32_t position = 0; position < m_order.size(); position++)
+		{
+			for (const auto& access : m_passes[m_order[position]].m_accesses)
+			{
+				Resource& resource = m_resources[access.m_resource];
+				if (resource.m_transient)
+				{
+					resource.m_first = std::min(resource.m_first, position);
+					resource.m_last  = std::max(resource.m_last, position);
+					resource.m_info.m_usage |= image_usage_flags(access.m_usage);
+				}
+			}
+		}
+	}
+
+	void RenderGraph::allocate_transients()
+	{
+		std::vector<ResourceId> transients;
+		std::vector<std::uint32_t> signature;
+		for (ResourceId id = 0; id < m_resources.size(); id++)
+		{
+			const Resource& resource = m_resources[id];
+			if (!resource.m_transient || resource.m_first == UINT32_MAX)
+			{
+				continue;
+			}
+
+			const ImageInfo& info = resource.m_info;
+			transients.push_back(id);
+			signature.insert(signature.end(), {static_cast<std::uint32_t>(info.m_format), static_cast<std::uint32_t>(info.m_type), info.m_extent.width, info.m_extent.height, info.m_mip_levels, info.m_array_layers, info.m_usage, info.m_aspect, resource.m_first, resource.m_last});
+		}
+
+		// Same images with the same lifetimes as last frame, so the same placement is still valid.
+		if (signature != m_signature)
+		{
+			// In flight frames may still use the old placement, the deletion queue holds it until they retire.
+			free_transients();
+
+			// Largest first, each into the first block of the same memory type that is big enough and whose occupants
+			// never overlap its lifetime. Images alias at offset zero so alignment is always met.
+			std::vector<std::pair<ResourceId, VkMemoryRequirements>> requirements;
+			for (const auto id : transients)
+			{
+				requirements.emplace_back(id, Image::memory_requirements(*m_instance, m_resources[id].m_info));
+			}
+
+			std::stable_sort(requirements.begin(), requirements.end(), [](const auto& a, const auto& b) { return a.second.size > b.second.size; });
+
+			std::vector<std::uint32_t> blocks(m_resources.size(), UINT32_MAX);
+			for (const auto& [id, requirement] : requirements)
+			{
+				const Resource& resource = m_resources[id];
+				const std::uint32_t type = m_instance->find_memory_type(requirement.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+				const auto found = std::find_if(m_blocks.begin(), m_blocks.end(), [&](const MemoryBlock& block) {
+					return block.m_type == type && block.m_size >= requirement.size && std::none_of(block.m_lifetimes.begin(), block.m_lifetimes.end(), [&](const auto& lifetime) { return overlaps(lifetime, resource.m_first, resource.m_last); });
+				});
+
+				if (found != m_blocks.end())
+				{
+					found->m_lifetimes.emplace_back(resource.m_first, resource.m_last);
+					blocks[id] = static_cast<std::uint32_t>(found - m_blocks.begin());
+					continue;
+				}
+
+				// clang-format off
+				VkMemoryAllocateInfo alloc_info
+				{
+					.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+					.pNext = nullptr,
+					.allocationSize = requirement.size,
+					.memoryTypeIndex = type
+				};
+				// clang-format on
+
+				MemoryBlock block {nullptr, requirement.size, type, {{resource.m_first, resource.m_last}}, nullptr};
+				if (vkAllocateMemory(m_instance->logical_device(), &alloc_info, nullptr, &block.m_memory) != VK_SUCCESS)
+				{
+					VK_LOG(VK_THROW, "Failed to allocate {0} bytes of transient memory for '{1}'.", requirement.size, resource.m_name);
+				}
+
+				blocks[id] = static_cast<std::uint32_t>(m_blocks.size());
+				m_blocks.push_back(std::move(block));
+			}
+
+			// Stored in declaration order, which is what a matching signature next frame will look them up by.
+			for (const auto id : transients)
+			{
+				m_transients.push_back(std::make_unique<Image>(m_instance, m_resources[id].m_info, m_blocks[blocks[id]].m_memory, 0));
+				m_transient_blocks.push_back(blocks[id]);
+			}
+
+			m_signature = std::move(signature);
+		}
+
+		for (std::size_t i = 0; i < transients.size(); i++)
+		{
+			m_resources[transients[i]].m_image = m_transients[i].get();
+			m_resources[transients[i]].m_block = m_transient_blocks[i];
+		}
+	}
+
+	void RenderGraph::free_transients()
+	{
+		m_transients.clear();
+		m_transient_blocks.clear();
+		for (const auto& block : m_blocks)
+		{
+			m_instance->deletion_queue().release(block.m_memory);
+		}
+
+		m_blocks.clear();
+		m_signature.clear();
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,159 @@
+#ifndef VULKANO_PIPELINE_RENDERGRAPH_HPP_
+#define VULKANO_PIPELINE_RENDERGRAPH_HPP_
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "vulkano/graphics/Image.hpp"
+
+namespace vulkano
+{
+	class Instance;
+
+	///
+	/// Frame graph. Passes declare the images and buffers they read and write, then each frame the graph culls passes
+	/// whose results are never used, orders the rest by their dependencies, records the minimal barriers between them
+	/// and places transient images with non-overlapping lifetimes in the same memory.
+	///
+	/// Usage per frame: reset(), import/create resources and add passes, compile(), then execute() into a command buffer.
+	///
+	class RenderGraph final
+	{
+	public:
+		using ResourceId = std::uint32_t;
+
+		///
+		/// Handed to a pass' setup callback to declare what the pass touches.
+		///
+		class PassBuilder final
+		{
+		public:
+			void read(ResourceId resource, ResourceUsage usage);
+			void write(ResourceId resource, ResourceUsage usage);
+
+			///
+			/// Declares a transient image that lives only as long as the passes using it. Its first use discards contents.
+			///
+			[[nodiscard]] ResourceId create(std::string_view name, const ImageInfo& info, ResourceUsage usage);
+
+			///
+			/// Keeps the pass even if nothing reads its results, i.e. for readbacks or debug output.
+			///
+			void side_effect();
+
+		private:
+			friend class RenderGraph;
+
+			PassBuilder(RenderGraph& graph, std::uint32_t pass);
+
+			RenderGraph& m_graph;
+			std::uint32_t m_pass;
+		};
+
+		using Setup   = std::function<void(PassBuilder&)>;
+		using Execute = std::function<void(VkCommandBuffer, RenderGraph&)>;
+
+		RenderGraph(Instance* instance);
+		~RenderGraph();
+
+		///
+		/// Clears passes and resources for the next frame. Transient memory is kept and reused while the frame's
+		/// transient images and their lifetimes stay the same.
+		///
+		void reset();
+
+		///
+		/// Imports an image that outlives the graph. Writing to it keeps a pass alive. With final_usage set the image
+		/// is transitioned to it after the last pass, i.e. PRESENT for swapchain images.
+		///
+		[[nodiscard]] ResourceId import_image(std::string_view name, Image& image, std::optional<ResourceUsage> final_usage = std::nullopt);
+
+		///
+		/// Imports a buffer by its caller owned synchronisation state.
+		///
+		[[nodiscard]] ResourceId import_buffer(std::string_view name, ResourceState& state);
+
+		void add_pass(std::string_view name, const Setup& setup, Execute execute);
+
+		///
+		/// Culls, orders and allocates. Must be called after the last add_pass and before execute.
+		///
+		void compile();
+
+		///
+		/// Records every surviving pass in order, each preceded by one batched barrier.
+		///
+		void execute(VkCommandBuffer cmd);
+
+		///
+		/// Image behind a resource. Transient images are only valid between compile() and the next reset().
+		///
+		[[nodiscard]] Image& image(ResourceId resource);
+
+		[[nodiscard]] std::uint32_t pass_count() const;
+		[[nodiscard]] std::uint32_t culled_count() const;
+		[[nodiscard]] VkDeviceSize transient_memory() const;
+
+	private:
+		struct Access final
+		{
+			ResourceId m_resource;
+			ResourceUsage m_usage;
+			bool m_write;
+		};
+
+		struct Pass final
+		{
+			std::string m_name;
+			Execute m_execute;
+			std::vector<Access> m_accesses;
+			bool m_side_effect = false;
+		};
+
+		struct Resource final
+		{
+			std::string m_name;
+			ImageInfo m_info;
+			Image* m_image                       = nullptr;
+			ResourceState* m_buffer              = nullptr;
+			std::optional<ResourceUsage> m_final = std::nullopt;
+			bool m_transient                     = false;
+			std::uint32_t m_first                = UINT32_MAX;
+			std::uint32_t m_last                 = 0;
+			std::uint32_t m_block                = UINT32_MAX;
+		};
+
+		///
+		/// Device memory shared by transient images. The last occupant's state is what the next one has to wait on.
+		///
+		struct MemoryBlock final
+		{
+			VkDeviceMemory m_memory;
+			VkDeviceSize m_size;
+			std::uint32_t m_type;
+			std::vector<std::pair<std::uint32_t, std::uint32_t>> m_lifetimes;
+			Image* m_occupant;
+		};
+
+		void cull_and_sort();
+		void allocate_transients();
+		void free_transients();
+
+		Instance* m_instance;
+
+		std::vector<Pass> m_passes;
+		std::vector<Resource> m_resources;
+		std::vector<std::uint32_t> m_order;
+
+		std::vector<MemoryBlock> m_blocks;
+		std::vector<std::unique_ptr<Image>> m_transients;
+		std::vector<std::uint32_t> m_transient_blocks;
+		std::vector<std::uint32_t> m_signature;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -12,7 +12,7 @@ namespace vulkano
 		return (!m_formats.empty()) && (!m_present_modes.empty());
 	}
 
-	SwapChain::SwapChain(std::shared_ptr<Instance> instance, const glm::vec2& framebuffer_size)
+	SwapChain::SwapChain(Instance* instance, const glm::vec2& framebuffer_size)
 	    : m_instance {instance}, m_swap_chain {nullptr}, m_framebuffer_size {framebuffer_size}
 	{
 		auto swap_chain_info = query_swap_chain();
@@ -86,7 +86,7 @@ namespace vulkano
 						.m_format = m_image_format,
 						.m_type = VK_IMAGE_VIEW_TYPE_2D
 					};
-					m_images[i] = std::make_unique<Image>(info, swap_imgs[i]);
+					m_images[i] = std::make_unique<Image>(m_instance, info, swap_imgs[i]);
 				}
 			}
 		}
@@ -95,7 +95,7 @@ namespace vulkano
 	SwapChain::~SwapChain()
 	{
 		m_images.clear();
-		vkDestroySwapchainKHR(m_instance->logical_device(), m_swap_chain, nullptr);
+		m_instance->deletion_queue().release(m_swap_chain);
 	}
 
 	void SwapChain::recreate()
@@ -107,7 +107,7 @@ namespace vulkano
 		return &m_extent;
 	}
 
-	std::shared_ptr<Instance> SwapChain::instance_used()
+	Instance* SwapChain::instance_used()
 	{
 		return m_instance;
 	}
@@ -31,13 +31,13 @@ namespace vulkano
 	class SwapChain final
 	{
 	public:
-		SwapChain(std::shared_ptr<Instance> instance, const glm::vec2& framebuffer_size);
+		SwapChain(Instance* instance, const glm::vec2& framebuffer_size);
 		~SwapChain();
 
 		void recreate();
 
 		[[nodiscard]] const VkExtent2D* extent();
-		[[nodiscard]] std::shared_ptr<Instance> instance_used();
+		[[nodiscard]] Instance* instance_used();
 		[[nodiscard]] const VkFormat image_format() const;
 
 	private:
@@ -46,7 +46,7 @@ namespace vulkano
 		[[nodiscard]] VkPresentModeKHR choose_swap_mode(std::span<VkPresentModeKHR> avaliable);
 		[[nodiscard]] VkExtent2D choose_swap_extent(const VkSurfaceCapabilitiesKHR& capabilities);
 
-		std::shared_ptr<Instance> m_instance;
+		Instance* m_instance;
 		VkSwapchainKHR m_swap_chain;
 		VkSurfaceFormatKHR m_format;
 		VkPresentModeKHR m_mode;
@@ -0,0 +1,186 @@
+#include <algorithm>
+
+#include "vulkano/pipeline/Instance.hpp"
+#include "vulkano/utils/Log.hpp"
+
+#include "UploadRing.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		constexpr VkMemoryPropertyFlags HOST_FLAGS = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+		///
+		/// Picks device local host visible memory when its heap can hold the ring, otherwise any host visible memory.
+		///
+		[[nodiscard]] std::uint32_t choose_memory_type(const Instance& instance, const VkMemoryRequirements& requirements, bool& device_local)
+		{
+			const VkPhysicalDeviceMemoryProperties& properties = instance.memory_properties();
+			const VkMemoryPropertyFlags wanted                 = HOST_FLAGS | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+			for (std::uint32_t i = 0; i < properties.memoryTypeCount; i++)
+			{
+				const VkMemoryType& type = properties.memoryTypes[i];
+				if ((requirements.memoryTypeBits & (1u << i)) && (type.propertyFlags & wanted) == wanted && properties.memoryHeaps[type.heapIndex].size >= requirements.size)
+				{
+					device_local = true;
+					return i;
+				}
+			}
+
+			device_local = false;
+			return instance.find_memory_type(requirements.memoryTypeBits, HOST_FLAGS);
+		}
+
+		[[nodiscard]] VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	} // namespace
+
+	std::uint32_t UploadRing::Allocation::dynamic_offset() const
+	{
+		return static_cast<std::uint32_t>(m_offset);
+	}
+
+	UploadRing::UploadRing(Instance* instance, const UploadRing::Settings& settings)
+	    : m_instance {instance}, m_buffer {nullptr}, m_memory {nullptr}, m_mapped {nullptr}, m_device_local {false}, m_alignment {0}, m_segment_size {0}, m_frames_in_flight {settings.m_frames_in_flight}, m_frame {0}, m_head {0}
+	{
+		const VkDevice device = m_instance->logical_device();
+
+		if (m_frames_in_flight == 0)
+		{
+			VK_LOG(VK_THROW, "Upload ring needs at least one frame in flight.");
+		}
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(m_instance->physical_device(), &properties);
+
+		// Both limits are powers of two, so the larger one satisfies both.
+		m_alignment    = std::max(properties.limits.minUniformBufferOffsetAlignment, properties.limits.minStorageBufferOffsetAlignment);
+		m_segment_size = align_up(settings.m_size / settings.m_frames_in_flight, m_alignment);
+
+		// Dynamic offsets are 32 bit.
+		if (m_segment_size * settings.m_frames_in_flight > UINT32_MAX)
+		{
+			VK_LOG(VK_THROW, "Upload ring of {0} bytes is too large for dynamic offsets.", settings.m_size);
+		}
+
+		// clang-format off
+		VkBufferCreateInfo buffer_info
+		{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.size = m_segment_size * settings.m_frames_in_flight,
+			.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+			.queueFamilyIndexCount = 0,
+			.pQueueFamilyIndices = nullptr
+		};
+		// clang-format on
+
+		if (vkCreateBuffer(device, &buffer_info, nullptr, &m_buffer) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to create upload ring buffer.");
+		}
+
+		VkMemoryRequirements requirements;
+		vkGetBufferMemoryRequirements(device, m_buffer, &requirements);
+
+		// clang-format off
+		VkMemoryAllocateInfo alloc_info
+		{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.allocationSize = requirements.size,
+			.memoryTypeIndex = choose_memory_type(*m_instance, requirements, m_device_local)
+		};
+		// clang-format on
+
+		if (vkAllocateMemory(device, &alloc_info, nullptr, &m_memory) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to allocate upload ring memory.");
+		}
+
+		if (vkBindBufferMemory(device, m_buffer, m_memory, 0) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to bind upload ring memory.");
+		}
+
+		// Mapped for the ring's whole life. Freeing the memory unmaps it.
+		void* mapped = nullptr;
+		if (vkMapMemory(device, m_memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to map upload ring memory.");
+		}
+
+		m_mapped = static_cast<std::byte*>(mapped);
+	}
+
+	UploadRing::~UploadRing()
+	{
+		DeletionQueue& deletion = m_instance->deletion_queue();
+		deletion.release(m_buffer);
+		deletion.release(m_memory);
+	}
+
+	void UploadRing::begin_frame(std::uint32_t frame, VkFence fence)
+	{
+		if (frame >= m_frames_in_flight)
+		{
+			VK_LOG(VK_THROW, "Frame {0} is outside the upload ring's {1} frames in flight.", frame, m_frames_in_flight);
+		}
+
+		if (fence && vkWaitForFences(m_instance->logical_device(), 1, &fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+		{
+			VK_LOG(VK_THROW, "Failed to wait for upload ring frame {0}.", frame);
+		}
+
+		m_frame = frame;
+		m_head.store(0, std::memory_order_relaxed);
+	}
+
+	UploadRing::Allocation UploadRing::allocate(VkDeviceSize size, VkDeviceSize alignment)
+	{
+		alignment = std::max(alignment, m_alignment);
+
+		// Segments only start on m_alignment, so a larger alignment has to be applied to the offset in the buffer.
+		const VkDeviceSize base = m_frame * m_segment_size;
+
+		VkDeviceSize head  = m_head.load(std::memory_order_relaxed);
+		VkDeviceSize begin = 0;
+		do
+		{
+			begin = align_up(base + head, alignment) - base;
+			if (begin + size > m_segment_size)
+			{
+				VK_LOG(VK_THROW, "Upload ring segment of {0} bytes is full ({1} requested).", m_segment_size, size);
+			}
+		} while (!m_head.compare_exchange_weak(head, begin + size, std::memory_order_relaxed));
+
+		const VkDeviceSize offset = base + begin;
+		return {m_mapped + offset, offset};
+	}
+
+	VkBuffer UploadRing::buffer() const
+	{
+		return m_buffer;
+	}
+
+	VkDeviceSize UploadRing::segment_size() const
+	{
+		return m_segment_size;
+	}
+
+	VkDeviceSize UploadRing::used() const
+	{
+		return m_head.load(std::memory_order_relaxed);
+	}
+
+	bool UploadRing::device_local() const
+	{
+		return m_device_local;
+	}
+} // namespace vulkano
\ No newline at end of file
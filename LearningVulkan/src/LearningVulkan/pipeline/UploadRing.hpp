@@ -0,0 +1,102 @@
+#ifndef VULKANO_PIPELINE_UPLOADRING_HPP_
+#define VULKANO_PIPELINE_UPLOADRING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+#include <vulkan/vulkan.h>
+
+namespace vulkano
+{
+	class Instance;
+
+	///
+	/// Linear allocator over one persistently mapped, host coherent buffer, split into one segment per frame in flight.
+	/// Device local memory is used when the whole buffer fits in a host visible heap of it (resizable BAR), otherwise
+	/// plain host memory.
+	///
+	/// Allocating is an atomic bump of the current frame's segment, so any thread may allocate while recording.
+	/// A segment is rewound by begin_frame() once its fence shows the GPU has read everything written to it.
+	///
+	class UploadRing final
+	{
+	public:
+		struct Settings final
+		{
+			VkDeviceSize m_size;
+			std::uint32_t m_frames_in_flight;
+		};
+
+		///
+		/// Space in the ring for the current frame. Valid until the frame comes round again.
+		///
+		struct Allocation final
+		{
+			void* m_data;
+			VkDeviceSize m_offset;
+
+			///
+			/// Offset for vkCmdBindDescriptorSets when the buffer is bound as a dynamic uniform or storage buffer.
+			///
+			[[nodiscard]] std::uint32_t dynamic_offset() const;
+		};
+
+		UploadRing(Instance* instance, const UploadRing::Settings& settings);
+		~UploadRing();
+
+		///
+		/// Makes frame, which must be below m_frames_in_flight, the current one, waiting on fence (if any) first. Call
+		/// from one thread while no other thread is allocating.
+		///
+		void begin_frame(std::uint32_t frame, VkFence fence = VK_NULL_HANDLE);
+
+		///
+		/// Aligned to at least minUniformBufferOffsetAlignment, so any allocation can back a dynamic uniform buffer.
+		/// alignment must be a power of two, and applies to the offset in the whole buffer. Throws when the frame's
+		/// segment is full.
+		///
+		[[nodiscard]] Allocation allocate(VkDeviceSize size, VkDeviceSize alignment = 0);
+
+		///
+		/// Copies data into a new allocation and returns its dynamic offset.
+		///
+		template<typename Type>
+		[[nodiscard]] std::uint32_t push(const Type& data);
+
+		[[nodiscard]] VkBuffer buffer() const;
+		[[nodiscard]] VkDeviceSize segment_size() const;
+		[[nodiscard]] VkDeviceSize used() const;
+		[[nodiscard]] bool device_local() const;
+
+	private:
+		UploadRing() = delete;
+
+		Instance* m_instance;
+		VkBuffer m_buffer;
+		VkDeviceMemory m_memory;
+		std::byte* m_mapped;
+		bool m_device_local;
+
+		VkDeviceSize m_alignment;
+		VkDeviceSize m_segment_size;
+		std::uint32_t m_frames_in_flight;
+		std::uint32_t m_frame;
+
+		///
+		/// Bytes used in the current segment.
+		///
+		std::atomic<VkDeviceSize> m_head;
+	};
+
+	template<typename Type>
+	inline std::uint32_t UploadRing::push(const Type& data)
+	{
+		const Allocation allocation = allocate(sizeof(Type), alignof(Type));
+		std::memcpy(allocation.m_data, &data, sizeof(Type));
+
+		return allocation.dynamic_offset();
+	}
+} // namespace vulkano
+
+#endif
\ No newline at end of file
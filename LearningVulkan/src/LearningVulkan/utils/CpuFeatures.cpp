@@ -0,0 +1,89 @@
+#include "CpuFeatures.hpp"
+
+#if defined(VULKANO_X86)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace vulkano
+{
+	namespace
+	{
+#if defined(VULKANO_X86)
+		///
+		/// EAX, EBX, ECX and EDX of a CPUID leaf.
+		///
+		void cpuid(unsigned int leaf, unsigned int (&registers)[4])
+		{
+	#if defined(_MSC_VER)
+			int values[4];
+			__cpuidex(values, static_cast<int>(leaf), 0);
+			for (int i = 0; i < 4; i++)
+			{
+				registers[i] = static_cast<unsigned int>(values[i]);
+			}
+	#else
+			__cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+	#endif
+		}
+
+		///
+		/// True when the OS saves the XMM and YMM registers on context switches.
+		///
+		[[nodiscard]] bool os_saves_ymm()
+		{
+	#if defined(_MSC_VER)
+			const unsigned long long xcr0 = _xgetbv(0);
+	#else
+			unsigned int eax = 0;
+			unsigned int edx = 0;
+			__asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			const unsigned long long xcr0 = (static_cast<unsigned long long>(edx) << 32) | eax;
+	#endif
+
+			return (xcr0 & 0x6) == 0x6;
+		}
+
+		[[nodiscard]] CpuFeatures detect()
+		{
+			CpuFeatures features {false, false};
+
+			unsigned int registers[4];
+			cpuid(0, registers);
+			const unsigned int max_leaf = registers[0];
+
+			cpuid(1, registers);
+			const bool osxsave = registers[2] & (1u << 27);
+			const bool avx     = registers[2] & (1u << 28);
+			const bool f16c    = registers[2] & (1u << 29);
+			if (!osxsave || !avx || !os_saves_ymm())
+			{
+				return features;
+			}
+
+			features.m_f16c = f16c;
+			if (max_leaf >= 7)
+			{
+				cpuid(7, registers);
+				features.m_avx2 = registers[1] & (1u << 5);
+			}
+
+			return features;
+		}
+#else
+		[[nodiscard]] CpuFeatures detect()
+		{
+			return {false, false};
+		}
+#endif
+	} // namespace
+
+	const CpuFeatures& cpu_features()
+	{
+		static const CpuFeatures features = detect();
+		return features;
+	}
+} // namespace vulkano
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef VULKANO_UTILS_CPUFEATURES_HPP_
+#define VULKANO_UTILS_CPUFEATURES_HPP_
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define VULKANO_X86
+#endif
+
+///
+/// Lets one function use instructions beyond what the translation unit is compiled for. MSVC allows any intrinsic
+/// anywhere, so it needs no attribute.
+///
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define VULKANO_TARGET(isa)
+#else
+	#define VULKANO_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace vulkano
+{
+	///
+	/// x86 extensions above the SSE2 baseline the project is built for. Kernels that use them are compiled with
+	/// VULKANO_TARGET and only called when the CPU, and the OS for the wider registers, supports them.
+	///
+	struct CpuFeatures final
+	{
+		bool m_avx2;
+		bool m_f16c;
+	};
+
+	///
+	/// Checked once, on first call. All false on other architectures.
+	///
+	[[nodiscard]] const CpuFeatures& cpu_features();
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef VULKANO_UTILS_HANDLE_HPP_
+#define VULKANO_UTILS_HANDLE_HPP_
+
+#include <cstdint>
+
+///
+/// Generation checks on every pool lookup. On by default in debug builds only.
+///
+#ifndef VULKANO_HANDLE_CHECKS
+	#ifdef NDEBUG
+		#define VULKANO_HANDLE_CHECKS 0
+	#else
+		#define VULKANO_HANDLE_CHECKS 1
+	#endif
+#endif
+
+namespace vulkano
+{
+	///
+	/// Typed 32 bit reference into a ResourcePool: a slot index plus the generation the slot had when the object was
+	/// created. Releasing the object bumps the generation, so stale handles can be told apart from live ones.
+	/// The default constructed handle is null, since generations start at 1.
+	///
+	template<typename T>
+	class Handle final
+	{
+	public:
+		static constexpr std::uint32_t INDEX_BITS      = 20;
+		static constexpr std::uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+		static constexpr std::uint32_t MAX_INDEX       = (1u << INDEX_BITS) - 1;
+		static constexpr std::uint32_t MAX_GENERATION  = (1u << GENERATION_BITS) - 1;
+
+		constexpr Handle() = default;
+
+		constexpr Handle(std::uint32_t index, std::uint32_t generation)
+		    : m_bits {(generation << INDEX_BITS) | (index & MAX_INDEX)}
+		{
+		}
+
+		[[nodiscard]] constexpr std::uint32_t index() const
+		{
+			return m_bits & MAX_INDEX;
+		}
+
+		[[nodiscard]] constexpr std::uint32_t generation() const
+		{
+			return m_bits >> INDEX_BITS;
+		}
+
+		///
+		/// Packed value, i.e. for hashing or passing to shaders.
+		///
+		[[nodiscard]] constexpr std::uint32_t bits() const
+		{
+			return m_bits;
+		}
+
+		[[nodiscard]] constexpr explicit operator bool() const
+		{
+			return m_bits != 0;
+		}
+
+		[[nodiscard]] constexpr bool operator==(const Handle&) const = default;
+
+	private:
+		std::uint32_t m_bits = 0;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
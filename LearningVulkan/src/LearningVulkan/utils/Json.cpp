@@ -0,0 +1,393 @@
+#include <charconv>
+
+#include "vulkano/utils/Log.hpp"
+
+#include "Json.hpp"
+
+namespace vulkano
+{
+	namespace
+	{
+		///
+		/// Guards the recursion against hostile input.
+		///
+		constexpr std::uint32_t MAX_DEPTH = 256;
+
+		void append_utf8(std::string& out, std::uint32_t code_point)
+		{
+			if (code_point < 0x80)
+			{
+				out.push_back(static_cast<char>(code_point));
+			}
+			else if (code_point < 0x800)
+			{
+				out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+				out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+			}
+			else if (code_point < 0x10000)
+			{
+				out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+				out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+			}
+			else
+			{
+				out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+				out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+			}
+		}
+	} // namespace
+
+	JsonValue::JsonValue(const JsonDocument* document, std::uint32_t node)
+	    : m_document {document}, m_node {node}
+	{
+	}
+
+	JsonType JsonValue::type() const
+	{
+		return m_document ? m_document->m_nodes[m_node].m_type : JsonType::NULL_VALUE;
+	}
+
+	bool JsonValue::is_null() const
+	{
+		return type() == JsonType::NULL_VALUE;
+	}
+
+	bool JsonValue::boolean(bool fallback) const
+	{
+		return (type() == JsonType::BOOLEAN) ? (m_document->m_nodes[m_node].m_number != 0.0) : fallback;
+	}
+
+	double JsonValue::number(double fallback) const
+	{
+		return (type() == JsonType::NUMBER) ? m_document->m_nodes[m_node].m_number : fallback;
+	}
+
+	std::uint32_t JsonValue::uint(std::uint32_t fallback) const
+	{
+		const double value = number(-1.0);
+		return (value >= 0.0 && value <= static_cast<double>(UINT32_MAX)) ? static_cast<std::uint32_t>(value) : fallback;
+	}
+
+	std::string_view JsonValue::string(std::string_view fallback) const
+	{
+		return (type() == JsonType::STRING) ? m_document->m_nodes[m_node].m_string : fallback;
+	}
+
+	std::uint32_t JsonValue::size() const
+	{
+		const JsonType t = type();
+		return (t == JsonType::ARRAY || t == JsonType::OBJECT) ? m_document->m_nodes[m_node].m_size : 0;
+	}
+
+	JsonValue JsonValue::operator[](std::uint32_t index) const
+	{
+		if (type() != JsonType::ARRAY)
+		{
+			return {};
+		}
+
+		JsonValue element = first();
+		for (std::uint32_t i = 0; i < index && element.m_document; i++)
+		{
+			element = element.next();
+		}
+
+		return element;
+	}
+
+	JsonValue JsonValue::operator[](std::string_view key) const
+	{
+		if (type() != JsonType::OBJECT)
+		{
+			return {};
+		}
+
+		for (JsonValue member = first(); member.m_document; member = member.next())
+		{
+			if (member.key() == key)
+			{
+				return member;
+			}
+		}
+
+		return {};
+	}
+
+	JsonValue JsonValue::first() const
+	{
+		if (size() == 0)
+		{
+			return {};
+		}
+
+		return {m_document, m_document->m_nodes[m_node].m_first_child};
+	}
+
+	JsonValue JsonValue::next() const
+	{
+		if (!m_document || m_document->m_nodes[m_node].m_next_sibling == JsonDocument::NONE)
+		{
+			return {};
+		}
+
+		return {m_document, m_document->m_nodes[m_node].m_next_sibling};
+	}
+
+	std::string_view JsonValue::key() const
+	{
+		return m_document ? m_document->m_nodes[m_node].m_key : std::string_view {};
+	}
+
+	JsonDocument::JsonDocument(std::string_view text)
+	    : m_text {text}, m_cursor {0}
+	{
+		// Roughly one value per 16 bytes of typical glTF, so the node array rarely grows.
+		m_nodes.reserve(text.size() / 16 + 1);
+
+		skip_whitespace();
+		parse_value(0);
+		skip_whitespace();
+
+		if (m_cursor != m_text.size())
+		{
+			fail("trailing characters");
+		}
+	}
+
+	JsonValue JsonDocument::root() const
+	{
+		return {this, 0};
+	}
+
+	std::uint32_t JsonDocument::parse_value(std::uint32_t depth)
+	{
+		if (depth > MAX_DEPTH)
+		{
+			fail("nesting too deep");
+		}
+
+		if (m_cursor >= m_text.size())
+		{
+			fail("unexpected end");
+		}
+
+		const auto index = static_cast<std::uint32_t>(m_nodes.size());
+		m_nodes.push_back({JsonType::NULL_VALUE, 0, NONE, NONE, {}, {}, 0.0});
+
+		const char c = m_text[m_cursor];
+		if (c == '{' || c == '[')
+		{
+			const bool object = (c == '{');
+			const char close  = object ? '}' : ']';
+
+			m_nodes[index].m_type = object ? JsonType::OBJECT : JsonType::ARRAY;
+			m_cursor++;
+			skip_whitespace();
+
+			std::uint32_t previous = NONE;
+			std::uint32_t count    = 0;
+			while (m_cursor < m_text.size() && m_text[m_cursor] != close)
+			{
+				if (count > 0)
+				{
+					expect(',');
+					skip_whitespace();
+				}
+
+				std::string_view key;
+				if (object)
+				{
+					key = parse_string();
+					skip_whitespace();
+					expect(':');
+					skip_whitespace();
+				}
+
+				// Children are appended after the parent, so the parent is found again by index, never by reference.
+				const std::uint32_t child = parse_value(depth + 1);
+				m_nodes[child].m_key      = key;
+
+				if (previous == NONE)
+				{
+					m_nodes[index].m_first_child = child;
+				}
+				else
+				{
+					m_nodes[previous].m_next_sibling = child;
+				}
+
+				previous = child;
+				count++;
+				skip_whitespace();
+			}
+
+			expect(close);
+			m_nodes[index].m_size = count;
+		}
+		else if (c == '"')
+		{
+			const std::string_view value = parse_string();
+			m_nodes[index].m_type        = JsonType::STRING;
+			m_nodes[index].m_string      = value;
+		}
+		else if (m_text.substr(m_cursor, 4) == "true")
+		{
+			m_nodes[index].m_type   = JsonType::BOOLEAN;
+			m_nodes[index].m_number = 1.0;
+			m_cursor += 4;
+		}
+		else if (m_text.substr(m_cursor, 5) == "false")
+		{
+			m_nodes[index].m_type = JsonType::BOOLEAN;
+			m_cursor += 5;
+		}
+		else if (m_text.substr(m_cursor, 4) == "null")
+		{
+			m_cursor += 4;
+		}
+		else
+		{
+			const char* begin = m_text.data() + m_cursor;
+			const char* end   = m_text.data() + m_text.size();
+
+			double value      = 0.0;
+			const auto result = std::from_chars(begin, end, value);
+			if (result.ec != std::errc {} || result.ptr == begin)
+			{
+				fail("invalid value");
+			}
+
+			m_nodes[index].m_type   = JsonType::NUMBER;
+			m_nodes[index].m_number = value;
+			m_cursor += static_cast<std::size_t>(result.ptr - begin);
+		}
+
+		return index;
+	}
+
+	std::string_view JsonDocument::parse_string()
+	{
+		expect('"');
+
+		const std::size_t begin = m_cursor;
+		bool escaped            = false;
+		while (m_cursor < m_text.size() && m_text[m_cursor] != '"')
+		{
+			if (m_text[m_cursor] == '\\')
+			{
+				escaped = true;
+				m_cursor++;
+			}
+
+			m_cursor++;
+		}
+
+		if (m_cursor >= m_text.size())
+		{
+			fail("unterminated string");
+		}
+
+		const std::string_view raw = m_text.substr(begin, m_cursor - begin);
+		m_cursor++;
+
+		if (!escaped)
+		{
+			return raw;
+		}
+
+		std::string& out = m_unescaped.emplace_back();
+		out.reserve(raw.size());
+
+		for (std::size_t i = 0; i < raw.size(); i++)
+		{
+			if (raw[i] != '\\')
+			{
+				out.push_back(raw[i]);
+				continue;
+			}
+
+			const char e = raw[++i];
+			switch (e)
+			{
+				case 'b':
+					out.push_back('\b');
+					break;
+
+				case 'f':
+					out.push_back('\f');
+					break;
+
+				case 'n':
+					out.push_back('\n');
+					break;
+
+				case 'r':
+					out.push_back('\r');
+					break;
+
+				case 't':
+					out.push_back('\t');
+					break;
+
+				case 'u':
+				{
+					const auto read_hex = [&](std::size_t at) {
+						std::uint32_t value = 0;
+						if (at + 4 > raw.size() || std::from_chars(raw.data() + at, raw.data() + at + 4, value, 16).ptr != raw.data() + at + 4)
+						{
+							fail("invalid unicode escape");
+						}
+
+						return value;
+					};
+
+					std::uint32_t code_point = read_hex(i + 1);
+					i += 4;
+
+					// A high surrogate must be followed by an escaped low one.
+					if (code_point >= 0xD800 && code_point < 0xDC00 && raw.substr(i + 1, 2) == "\\u")
+					{
+						const std::uint32_t low = read_hex(i + 3);
+						code_point              = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+						i += 6;
+					}
+
+					append_utf8(out, code_point);
+					break;
+				}
+
+				default:
+					out.push_back(e);
+					break;
+			}
+		}
+
+		return out;
+	}
+
+	void JsonDocument::skip_whitespace()
+	{
+		while (m_cursor < m_text.size() && (m_text[m_cursor] == ' ' || m_text[m_cursor] == '\n' || m_text[m_cursor] == '\r' || m_text[m_cursor] == '\t'))
+		{
+			m_cursor++;
+		}
+	}
+
+	void JsonDocument::expect(char c)
+	{
+		if (m_cursor >= m_text.size() || m_text[m_cursor] != c)
+		{
+			VK_LOG(VK_THROW, "Invalid JSON at offset {0}: expected '{1}'.", m_cursor, c);
+		}
+
+		m_cursor++;
+	}
+
+	void JsonDocument::fail(std::string_view what) const
+	{
+		VK_LOG(VK_THROW, "Invalid JSON at offset {0}: {1}.", m_cursor, what);
+	}
+} // namespace vulkano
\ No newline at end of file
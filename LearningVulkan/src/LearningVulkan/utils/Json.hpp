@@ -0,0 +1,114 @@
+#ifndef VULKANO_UTILS_JSON_HPP_
+#define VULKANO_UTILS_JSON_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vulkano
+{
+	class JsonDocument;
+
+	enum class JsonType : std::uint8_t
+	{
+		NULL_VALUE,
+		BOOLEAN,
+		NUMBER,
+		STRING,
+		ARRAY,
+		OBJECT
+	};
+
+	///
+	/// Read-only view of one value in a JsonDocument. Lookups that miss return a null value rather than throwing,
+	/// so optional fields can be read with a default.
+	///
+	class JsonValue final
+	{
+	public:
+		JsonValue() = default;
+
+		[[nodiscard]] JsonType type() const;
+		[[nodiscard]] bool is_null() const;
+
+		[[nodiscard]] bool boolean(bool fallback = false) const;
+		[[nodiscard]] double number(double fallback = 0.0) const;
+		[[nodiscard]] std::uint32_t uint(std::uint32_t fallback = 0) const;
+		[[nodiscard]] std::string_view string(std::string_view fallback = {}) const;
+
+		///
+		/// Element count of an array or member count of an object, zero otherwise.
+		///
+		[[nodiscard]] std::uint32_t size() const;
+
+		///
+		/// Linear in the index, so iterate with first()/next() over large arrays.
+		///
+		[[nodiscard]] JsonValue operator[](std::uint32_t index) const;
+		[[nodiscard]] JsonValue operator[](std::string_view key) const;
+
+		[[nodiscard]] JsonValue first() const;
+		[[nodiscard]] JsonValue next() const;
+		[[nodiscard]] std::string_view key() const;
+
+	private:
+		friend class JsonDocument;
+
+		JsonValue(const JsonDocument* document, std::uint32_t node);
+
+		const JsonDocument* m_document = nullptr;
+		std::uint32_t m_node           = 0;
+	};
+
+	///
+	/// Single pass recursive descent parser into a flat node array. Strings are views into the source text unless
+	/// they contain escapes, so the text must outlive the document.
+	///
+	class JsonDocument final
+	{
+	public:
+		JsonDocument(std::string_view text);
+		~JsonDocument() = default;
+
+		[[nodiscard]] JsonValue root() const;
+
+	private:
+		friend class JsonValue;
+
+		JsonDocument() = delete;
+		JsonDocument(const JsonDocument&) = delete;
+		JsonDocument& operator=(const JsonDocument&) = delete;
+
+		static constexpr std::uint32_t NONE = UINT32_MAX;
+
+		struct Node final
+		{
+			JsonType m_type;
+			std::uint32_t m_size;
+			std::uint32_t m_first_child;
+			std::uint32_t m_next_sibling;
+			std::string_view m_key;
+			std::string_view m_string;
+			double m_number;
+		};
+
+		std::uint32_t parse_value(std::uint32_t depth);
+		std::string_view parse_string();
+		void skip_whitespace();
+		void expect(char c);
+		void fail(std::string_view what) const;
+
+		std::string_view m_text;
+		std::size_t m_cursor;
+		std::vector<Node> m_nodes;
+
+		///
+		/// Decoded copies of strings that contained escapes. A deque so views into earlier ones stay valid.
+		///
+		std::deque<std::string> m_unescaped;
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
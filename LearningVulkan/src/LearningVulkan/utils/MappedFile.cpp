@@ -0,0 +1,122 @@
+#include <filesystem>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "vulkano/utils/Log.hpp"
+
+#include "MappedFile.hpp"
+
+namespace vulkano
+{
+#ifdef _WIN32
+	MappedFile::MappedFile(std::string_view path)
+	    : m_data {nullptr}, m_size {0}, m_file {INVALID_HANDLE_VALUE}, m_mapping {nullptr}
+	{
+		const auto file = std::filesystem::path {path};
+
+		m_file = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+		{
+			VK_LOG(VK_THROW, "Failed to open file: {0}.", path);
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_file, &size))
+		{
+			CloseHandle(m_file);
+			VK_LOG(VK_THROW, "Failed to read file size: {0}.", path);
+		}
+
+		m_size = static_cast<std::size_t>(size.QuadPart);
+
+		if (m_size > 0)
+		{
+			m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!m_mapping)
+			{
+				CloseHandle(m_file);
+				VK_LOG(VK_THROW, "Failed to map file: {0}.", path);
+			}
+
+			m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+			if (!m_data)
+			{
+				CloseHandle(m_mapping);
+				CloseHandle(m_file);
+				VK_LOG(VK_THROW, "Failed to map view of file: {0}.", path);
+			}
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+		}
+
+		if (m_mapping)
+		{
+			CloseHandle(m_mapping);
+		}
+
+		CloseHandle(m_file);
+	}
+#else
+	MappedFile::MappedFile(std::string_view path)
+	    : m_data {nullptr}, m_size {0}, m_file {-1}
+	{
+		const auto file = std::filesystem::path {path};
+
+		m_file = open(file.c_str(), O_RDONLY);
+		if (m_file == -1)
+		{
+			VK_LOG(VK_THROW, "Failed to open file: {0}.", path);
+		}
+
+		struct stat info;
+		if (fstat(m_file, &info) != 0)
+		{
+			close(m_file);
+			VK_LOG(VK_THROW, "Failed to read file size: {0}.", path);
+		}
+
+		m_size = static_cast<std::size_t>(info.st_size);
+
+		if (m_size > 0)
+		{
+			void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+			if (mapping == MAP_FAILED)
+			{
+				close(m_file);
+				VK_LOG(VK_THROW, "Failed to map file: {0}.", path);
+			}
+
+			m_data = static_cast<const std::byte*>(mapping);
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_data)
+		{
+			munmap(const_cast<std::byte*>(m_data), m_size);
+		}
+
+		close(m_file);
+	}
+#endif
+
+	std::span<const std::byte> MappedFile::data() const
+	{
+		return {m_data, m_size};
+	}
+} // namespace vulkano
\ No newline at end of file
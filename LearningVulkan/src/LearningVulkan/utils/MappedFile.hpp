@@ -0,0 +1,40 @@
+#ifndef VULKANO_UTILS_MAPPEDFILE_HPP_
+#define VULKANO_UTILS_MAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace vulkano
+{
+	///
+	/// Read-only memory mapping of a whole file. Pages are loaded by the OS on first touch, so large assets can be
+	/// streamed straight out of the mapping without an intermediate copy.
+	///
+	class MappedFile final
+	{
+	public:
+		MappedFile(std::string_view path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		[[nodiscard]] std::span<const std::byte> data() const;
+
+	private:
+		MappedFile() = delete;
+
+		const std::byte* m_data;
+		std::size_t m_size;
+
+#ifdef _WIN32
+		void* m_file;
+		void* m_mapping;
+#else
+		int m_file;
+#endif
+	};
+} // namespace vulkano
+
+#endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#ifndef VULKANO_UTILS_RESOURCEPOOL_HPP_
+#define VULKANO_UTILS_RESOURCEPOOL_HPP_
+
+#include <deque>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "vulkano/utils/Handle.hpp"
+#include "vulkano/utils/Log.hpp"
+
+namespace vulkano
+{
+	///
+	/// Slot map. Objects live packed in one array so iterating them is a linear walk, and are reached through
+	/// Handles via an indirection table of slots. Removing an object moves the last one into its place.
+	///
+	/// Removed slots are not reused until the GPU has passed a given point (see DeletionQueue), because GPU side
+	/// references such as bindless indices use the slot index and must not see a new object too early.
+	///
+	template<typename T>
+	class ResourcePool final
+	{
+	public:
+		ResourcePool()  = default;
+		~ResourcePool() = default;
+
+		template<typename... Args>
+		[[nodiscard]] Handle<T> emplace(Args&&... args);
+
+		///
+		/// Takes the object out of the pool and invalidates every handle to it. The slot becomes reusable once
+		/// collect() is called with a value of at least retire_at.
+		///
+		[[nodiscard]] T remove(Handle<T> handle, std::uint64_t retire_at);
+
+		///
+		/// Makes slots retired at or before completed available again.
+		///
+		void collect(std::uint64_t completed);
+
+		[[nodiscard]] T& get(Handle<T> handle);
+		[[nodiscard]] const T& get(Handle<T> handle) const;
+		[[nodiscard]] bool valid(Handle<T> handle) const;
+
+		///
+		/// Live objects, packed. Order changes when objects are removed.
+		///
+		[[nodiscard]] std::span<T> objects();
+		[[nodiscard]] std::span<const T> objects() const;
+
+		///
+		/// Handle of the object at a position in objects().
+		///
+		[[nodiscard]] Handle<T> handle_at(std::size_t position) const;
+
+		[[nodiscard]] std::size_t size() const;
+
+	private:
+		ResourcePool(const ResourcePool&) = delete;
+		ResourcePool& operator=(const ResourcePool&) = delete;
+
+		struct Slot final
+		{
+			std::uint32_t m_position;
+			std::uint32_t m_generation;
+		};
+
+		[[nodiscard]] std::uint32_t position(Handle<T> handle) const;
+
+		std::vector<T> m_objects;
+		std::vector<std::uint32_t> m_owners;
+
+		std::vector<Slot> m_slots;
+		std::vector<std::uint32_t> m_free;
+		std::deque<std::pair<std::uint64_t, std::uint32_t>> m_retired;
+	};
+
+	template<typename T>
+	template<typename... Args>
+	inline Handle<T> ResourcePool<T>::emplace(Args&&... args)
+	{
+		std::uint32_t slot = 0;
+		if (!m_free.empty())
+		{
+			slot = m_free.back();
+			m_free.pop_back();
+		}
+		else
+		{
+			if (m_slots.size() > Handle<T>::MAX_INDEX)
+			{
+				VK_LOG(VK_THROW, "Resource pool is full ({0} slots).", m_slots.size());
+			}
+
+			slot = static_cast<std::uint32_t>(m_slots.size());
+			m_slots.push_back({0, 1});
+		}
+
+		m_objects.emplace_back(std::forward<Args>(args)...);
+		m_owners.push_back(slot);
+		m_slots[slot].m_position = static_cast<std::uint32_t>(m_objects.size() - 1);
+
+		return {slot, m_slots[slot].m_generation};
+	}
+
+	template<typename T>
+	inline T ResourcePool<T>::remove(Handle<T> handle, std::uint64_t retire_at)
+	{
+		if (!valid(handle))
+		{
+			VK_LOG(VK_THROW, "Removing stale resource handle (slot {0}, generation {1}).", handle.index(), handle.generation());
+		}
+
+		Slot& slot                = m_slots[handle.index()];
+		const std::uint32_t moved = slot.m_position;
+		const std::uint32_t last  = static_cast<std::uint32_t>(m_objects.size() - 1);
+
+		T object = std::move(m_objects[moved]);
+		if (moved != last)
+		{
+			m_objects[moved]                    = std::move(m_objects[last]);
+			m_owners[moved]                     = m_owners[last];
+			m_slots[m_owners[moved]].m_position = moved;
+		}
+
+		m_objects.pop_back();
+		m_owners.pop_back();
+
+		// Zero is reserved for null handles.
+		slot.m_generation = (slot.m_generation == Handle<T>::MAX_GENERATION) ? 1 : slot.m_generation + 1;
+		m_retired.emplace_back(retire_at, handle.index());
+
+		return object;
+	}
+
+	template<typename T>
+	inline void ResourcePool<T>::collect(std::uint64_t completed)
+	{
+		while (!m_retired.empty() && m_retired.front().first <= completed)
+		{
+			m_free.push_back(m_retired.front().second);
+			m_retired.pop_front();
+		}
+	}
+
+	template<typename T>
+	inline T& ResourcePool<T>::get(Handle<T> handle)
+	{
+		return m_objects[position(handle)];
+	}
+
+	template<typename T>
+	inline const T& ResourcePool<T>::get(Handle<T> handle) const
+	{
+		return m_objects[position(handle)];
+	}
+
+	template<typename T>
+	inline bool ResourcePool<T>::valid(Handle<T> handle) const
+	{
+		return handle && handle.index() < m_slots.size() && m_slots[handle.index()].m_generation == handle.generation();
+	}
+
+	template<typename T>
+	inline std::span<T> ResourcePool<T>::objects()
+	{
+		return m_objects;
+	}
+
+	template<typename T>
+	inline std::span<const T> ResourcePool<T>::objects() const
+	{
+		return m_objects;
+	}
+
+	template<typename T>
+	inline Handle<T> ResourcePool<T>::handle_at(std::size_t position) const
+	{
+		const std::uint32_t slot = m_owners[position];
+		return {slot, m_slots[slot].m_generation};
+	}
+
+	template<typename T>
+	inline std::size_t ResourcePool<T>::size() const
+	{
+		return m_objects.size();
+	}
+
+	template<typename T>
+	inline std::uint32_t ResourcePool<T>::position(Handle<T> handle) const
+	{
+#if VULKANO_HANDLE_CHECKS
+		if (!valid(handle))
+		{
+			VK_LOG(VK_THROW, "Use of stale or null resource handle (slot {0}, generation {1}).", handle.index(), handle.generation());
+		}
+#endif
+
+		return m_slots[handle.index()].m_position;
+	}
+} // namespace vulkano
+
+#endif
\ No newline at end of file
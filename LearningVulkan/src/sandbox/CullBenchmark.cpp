@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <fmt/format.h>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "vulkano/core/JobSystem.hpp"
+#include "vulkano/graphics/FrustumCuller.hpp"
+
+#include "CullBenchmark.hpp"
+
+namespace
+{
+	constexpr std::uint32_t INSTANCES = 1000000;
+	constexpr std::uint32_t REPEATS   = 50;
+
+	///
+	/// Share of a 60 Hz frame culling should take on the job system. Only reported, since whether it is met depends
+	/// on the machine more than on the code.
+	///
+	constexpr double BUDGET_MS = 1.0;
+
+	///
+	/// Kernels sum the plane equation in their own order, so spheres this close to touching a plane may go either
+	/// way.
+	///
+	constexpr float TOLERANCE = 1e-3f;
+
+	///
+	/// Best of REPEATS, in milliseconds, to keep scheduler noise out of the numbers.
+	///
+	double time_cull(vulkano::FrustumCuller& culler, const glm::mat4& view_projection)
+	{
+		double best = 1e30;
+		for (std::uint32_t repeat = 0; repeat < REPEATS; repeat++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			std::ignore      = culler.cull(view_projection);
+
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			best = std::min(best, elapsed.count());
+		}
+
+		return best;
+	}
+} // namespace
+
+int run_cull_benchmark()
+{
+	vulkano::JobSystem jobs;
+	vulkano::FrustumCuller single;
+	vulkano::FrustumCuller parallel {&jobs};
+
+	// A fixed seed keeps the visible count the same from run to run.
+	std::mt19937 random {1};
+	std::uniform_real_distribution<float> position {-500.0f, 500.0f};
+	std::uniform_real_distribution<float> size {0.5f, 5.0f};
+
+	std::vector<glm::vec4> spheres(INSTANCES);
+	for (auto& sphere : spheres)
+	{
+		sphere = {position(random), position(random), position(random), size(random)};
+
+		single.add(sphere, sphere.w);
+		parallel.add(sphere, sphere.w);
+	}
+
+	const glm::mat4 view_projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f) * glm::lookAt(glm::vec3 {0.0f}, glm::vec3 {1.0f, 0.2f, 0.3f}, glm::vec3 {0.0f, 1.0f, 0.0f});
+	const auto planes               = vulkano::frustum_planes(view_projection);
+
+	// Spheres clearly visible must be in every list, and nothing outside the loose set may be.
+	std::vector<bool> required(INSTANCES);
+	std::vector<bool> allowed(INSTANCES);
+	for (std::uint32_t i = 0; i < INSTANCES; i++)
+	{
+		const glm::vec4& sphere = spheres[i];
+
+		required[i] = std::all_of(planes.begin(), planes.end(), [&sphere](const glm::vec4& plane) {
+			return glm::dot(glm::vec3 {plane}, glm::vec3 {sphere}) + plane.w >= -sphere.w + TOLERANCE;
+		});
+		allowed[i]  = std::all_of(planes.begin(), planes.end(), [&sphere](const glm::vec4& plane) {
+			return glm::dot(glm::vec3 {plane}, glm::vec3 {sphere}) + plane.w >= -sphere.w - TOLERANCE;
+		});
+	}
+
+	const auto required_count = static_cast<std::size_t>(std::count(required.begin(), required.end(), true));
+
+	bool passed = true;
+
+	std::cout << fmt::format("{0:>8} {1:>10} {2:>10} {3:>8}", "threads", "visible", "ms", "budget") << std::endl;
+	for (auto* culler : {&single, &parallel})
+	{
+		const auto visible = culler->cull(view_projection);
+
+		const bool ascending = std::is_sorted(visible.begin(), visible.end()) && std::adjacent_find(visible.begin(), visible.end()) == visible.end();
+		const bool in_range  = std::all_of(visible.begin(), visible.end(), [&allowed](std::uint32_t i) { return i < INSTANCES && allowed[i]; });
+		const auto found     = static_cast<std::size_t>(std::count_if(visible.begin(), visible.end(), [&required](std::uint32_t i) { return i < INSTANCES && required[i]; }));
+		if (!ascending || !in_range || found != required_count)
+		{
+			std::cout << fmt::format("Visible list of {0} does not match the scalar loop's {1} (within {2}).", visible.size(), required_count, TOLERANCE) << std::endl;
+			passed = false;
+		}
+
+		const std::uint32_t threads = (culler == &single) ? 1 : jobs.thread_count();
+		const double ms             = time_cull(*culler, view_projection);
+		const bool in_budget        = ms <= BUDGET_MS;
+
+		std::cout << fmt::format("{0:>8} {1:>10} {2:>10.3f} {3:>8}", threads, visible.size(), ms, in_budget ? "ok" : "over") << std::endl;
+	}
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
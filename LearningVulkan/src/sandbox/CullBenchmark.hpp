@@ -0,0 +1,11 @@
+#ifndef SANDBOX_CULLBENCHMARK_HPP_
+#define SANDBOX_CULLBENCHMARK_HPP_
+
+///
+/// Frustum culls a million random spheres on one thread and on the job system, checks both against a plain scalar
+/// loop and prints their times against a per frame budget. Fails only on a mismatch. Run the sandbox with
+/// --bench-cull.
+///
+int run_cull_benchmark();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "vulkano/core/JobSystem.hpp"
+
+#include "JobBenchmark.hpp"
+
+namespace
+{
+	constexpr std::uint32_t ITEMS      = 1 << 22;
+	constexpr std::uint32_t GRAIN      = 4096;
+	constexpr std::uint32_t REPEATS    = 5;
+	constexpr std::uint32_t ITERATIONS = 32;
+
+	///
+	/// Best of REPEATS, in milliseconds, to keep scheduler noise out of the numbers.
+	///
+	double time_parallel_for(vulkano::JobSystem& jobs, std::vector<float>& output)
+	{
+		double best = 1e30;
+		for (std::uint32_t repeat = 0; repeat < REPEATS; repeat++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+
+			jobs.parallel_for(ITEMS, GRAIN, [&](std::uint32_t begin, std::uint32_t end) {
+				for (std::uint32_t i = begin; i < end; i++)
+				{
+					float x = static_cast<float>(i) * 1e-6f;
+					for (std::uint32_t n = 0; n < ITERATIONS; n++)
+					{
+						x = std::sin(x) + std::sqrt(x + 1.0f);
+					}
+
+					output[i] = x;
+				}
+			});
+
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			best = std::min(best, elapsed.count());
+		}
+
+		return best;
+	}
+} // namespace
+
+int run_job_benchmark()
+{
+	std::vector<float> output(ITEMS);
+
+	const std::uint32_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	std::vector<std::uint32_t> counts;
+	for (std::uint32_t threads = 1; threads < max_threads; threads *= 2)
+	{
+		counts.push_back(threads);
+	}
+	counts.push_back(max_threads);
+
+	double single = 0.0;
+	std::cout << fmt::format("{0:>8} {1:>10} {2:>8}", "threads", "ms", "speedup") << std::endl;
+	for (const auto threads : counts)
+	{
+		vulkano::JobSystem jobs {threads};
+
+		const double ms = time_parallel_for(jobs, output);
+		if (threads == 1)
+		{
+			single = ms;
+		}
+
+		std::cout << fmt::format("{0:>8} {1:>10.2f} {2:>7.2f}x", threads, ms, single / ms) << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef SANDBOX_JOBBENCHMARK_HPP_
+#define SANDBOX_JOBBENCHMARK_HPP_
+
+///
+/// Times a compute bound parallel_for on 1 to N threads and prints the speedup of each thread count over one.
+/// Run the sandbox with --bench-jobs.
+///
+int run_job_benchmark();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+#include <fmt/format.h>
+#include <stb/stb_image_resize.h>
+
+#include "vulkano/graphics/MipChain.hpp"
+
+#include "MipBenchmark.hpp"
+
+namespace
+{
+	constexpr std::uint32_t REPEATS = 10;
+
+	struct Case final
+	{
+		std::uint32_t m_width;
+		std::uint32_t m_height;
+		VkFormat m_format;
+		vulkano::MipFilter m_filter;
+
+		///
+		/// Largest difference allowed in any channel of any level. Boxes are the same filter in both, but each level
+		/// is rounded to 8 bits and decoded again with slightly different sRGB curves. stb has no Kaiser filter,
+		/// and Catmull-Rom, the closest it has, rings a little less.
+		///
+		int m_tolerance;
+	};
+
+	///
+	/// Smooth colour waves over a gradient, so the two filters' differing tails stay small, with a hard edge
+	/// through the middle to make them show.
+	///
+	std::vector<std::byte> make_image(std::uint32_t width, std::uint32_t height)
+	{
+		std::vector<std::byte> pixels(static_cast<std::size_t>(width) * height * 4);
+		for (std::uint32_t y = 0; y < height; y++)
+		{
+			for (std::uint32_t x = 0; x < width; x++)
+			{
+				const float u = static_cast<float>(x) / static_cast<float>(width);
+				const float v = static_cast<float>(y) / static_cast<float>(height);
+
+				const float channels[4] = {0.5f + 0.5f * std::sin(u * 20.0f), 0.5f + 0.5f * std::cos(v * 13.0f), (u + v) * 0.5f, (x < width / 2) ? 1.0f : 0.25f};
+				for (std::uint32_t c = 0; c < 4; c++)
+				{
+					pixels[(static_cast<std::size_t>(y) * width + x) * 4 + c] = static_cast<std::byte>(channels[c] * 255.0f + 0.5f);
+				}
+			}
+		}
+
+		return pixels;
+	}
+
+	///
+	/// The same chain with stb_image_resize: every level in one buffer, laid out like MipChain's.
+	///
+	std::vector<std::byte> stb_chain(std::span<const std::byte> base, const vulkano::MipChain& reference, const Case& test)
+	{
+		std::vector<std::byte> data(reference.data().size());
+		std::copy(base.begin(), base.end(), data.begin());
+
+		const stbir_filter filter    = (test.m_filter == vulkano::MipFilter::BOX) ? STBIR_FILTER_BOX : STBIR_FILTER_CATMULLROM;
+		const stbir_colorspace space = (test.m_format == VK_FORMAT_R8G8B8A8_SRGB) ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
+
+		for (std::uint32_t i = 1; i < reference.level_count(); i++)
+		{
+			const vulkano::MipLevel& src = reference.level(i - 1);
+			const vulkano::MipLevel& dst = reference.level(i);
+
+			// clang-format off
+			stbir_resize_uint8_generic(reinterpret_cast<const unsigned char*>(data.data() + src.m_offset), static_cast<int>(src.m_width), static_cast<int>(src.m_height), 0,
+			                           reinterpret_cast<unsigned char*>(data.data() + dst.m_offset), static_cast<int>(dst.m_width), static_cast<int>(dst.m_height), 0,
+			                           4, 3, STBIR_FLAG_ALPHA_PREMULTIPLIED, STBIR_EDGE_CLAMP, filter, space, nullptr);
+			// clang-format on
+		}
+
+		return data;
+	}
+
+	///
+	/// Best of REPEATS, in milliseconds.
+	///
+	template<typename Func>
+	double best_time(Func&& func)
+	{
+		double best = 1e30;
+		for (std::uint32_t repeat = 0; repeat < REPEATS; repeat++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			func();
+
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			best = std::min(best, elapsed.count());
+		}
+
+		return best;
+	}
+} // namespace
+
+int run_mip_benchmark()
+{
+	// clang-format off
+	const Case cases[] = {
+		{2048, 2048, VK_FORMAT_R8G8B8A8_UNORM, vulkano::MipFilter::BOX,    4},
+		{2048, 2048, VK_FORMAT_R8G8B8A8_SRGB,  vulkano::MipFilter::BOX,    4},
+		{2048, 2048, VK_FORMAT_R8G8B8A8_UNORM, vulkano::MipFilter::KAISER, 24},
+		{2048, 2048, VK_FORMAT_R8G8B8A8_SRGB,  vulkano::MipFilter::KAISER, 24},
+		{1000, 600,  VK_FORMAT_R8G8B8A8_SRGB,  vulkano::MipFilter::BOX,    4},
+		{1000, 600,  VK_FORMAT_R8G8B8A8_SRGB,  vulkano::MipFilter::KAISER, 24}
+	};
+	// clang-format on
+
+	bool passed = true;
+
+	std::cout << fmt::format("{0:>11} {1:>6} {2:>7} {3:>9} {4:>10} {5:>10}", "size", "format", "filter", "max diff", "ours ms", "stb ms") << std::endl;
+	for (const Case& test : cases)
+	{
+		const std::vector<std::byte> base = make_image(test.m_width, test.m_height);
+		const vulkano::MipChain::Settings settings {test.m_format, test.m_filter, test.m_width, test.m_height};
+
+		const vulkano::MipChain chain {base, settings};
+		const std::vector<std::byte> expected = stb_chain(base, chain, test);
+
+		int max_difference = 0;
+		for (std::uint32_t i = 1; i < chain.level_count(); i++)
+		{
+			const auto ours   = chain.level_data(i);
+			const auto theirs = std::span {expected}.subspan(chain.level(i).m_offset, ours.size());
+			for (std::size_t b = 0; b < ours.size(); b++)
+			{
+				max_difference = std::max(max_difference, std::abs(static_cast<int>(ours[b]) - static_cast<int>(theirs[b])));
+			}
+		}
+
+		passed = passed && max_difference <= test.m_tolerance;
+
+		const double ours_ms = best_time([&] {
+			const vulkano::MipChain timed {base, settings};
+		});
+		const double stb_ms  = best_time([&] {
+			std::ignore = stb_chain(base, chain, test);
+		});
+
+		// clang-format off
+		std::cout << fmt::format("{0:>11} {1:>6} {2:>7} {3:>9} {4:>10.2f} {5:>10.2f}",
+		                         fmt::format("{0}x{1}", test.m_width, test.m_height),
+		                         (test.m_format == VK_FORMAT_R8G8B8A8_SRGB) ? "srgb" : "unorm",
+		                         (test.m_filter == vulkano::MipFilter::BOX) ? "box" : "kaiser",
+		                         max_difference, ours_ms, stb_ms) << std::endl;
+		// clang-format on
+	}
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef SANDBOX_MIPBENCHMARK_HPP_
+#define SANDBOX_MIPBENCHMARK_HPP_
+
+///
+/// Builds full mip chains of a synthetic image with MipChain and with stb_image_resize, resizing each level from
+/// the one above, and prints the largest channel difference on every level and both times. Fails when a level
+/// differs by more than the filter's tolerance. Run the sandbox with --bench-mips.
+///
+int run_mip_benchmark();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "vulkano/graphics/TextureFile.hpp"
+
+#include "TextureCheck.hpp"
+
+namespace
+{
+	///
+	/// Non square, so swapped width and height show up.
+	///
+	constexpr std::uint32_t WIDTH  = 64;
+	constexpr std::uint32_t HEIGHT = 16;
+	constexpr std::uint32_t LEVELS = 3;
+
+	///
+	/// Bytes per 4x4 block of BC1 and BC7.
+	///
+	constexpr std::uint32_t BC1_BLOCK = 8;
+	constexpr std::uint32_t BC7_BLOCK = 16;
+
+	struct Expected final
+	{
+		const char* m_name;
+		VkFormat m_format;
+		std::uint32_t m_block_size;
+		bool m_dx10;
+	};
+
+	void put(std::vector<std::uint8_t>& file, std::size_t offset, std::uint32_t value)
+	{
+		std::memcpy(file.data() + offset, &value, sizeof(value));
+	}
+
+	[[nodiscard]] std::uint32_t level_size(std::uint32_t level, std::uint32_t block_size)
+	{
+		const std::uint32_t width  = std::max(WIDTH >> level, 1u);
+		const std::uint32_t height = std::max(HEIGHT >> level, 1u);
+
+		return ((width + 3) / 4) * ((height + 3) / 4) * block_size;
+	}
+
+	///
+	/// DDS_HEADER fields at their documented offsets from the start of the file (after the 4 byte magic), with each
+	/// level filled with its index so the level spans can be checked.
+	///
+	[[nodiscard]] std::vector<std::uint8_t> make_dds(const Expected& expected)
+	{
+		std::vector<std::uint8_t> file(4 + 124 + (expected.m_dx10 ? 20 : 0), 0);
+
+		put(file, 0, 0x20534444);
+		put(file, 4, 124);
+		put(file, 8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000);
+		put(file, 12, HEIGHT);
+		put(file, 16, WIDTH);
+		put(file, 20, level_size(0, expected.m_block_size));
+		put(file, 28, LEVELS);
+
+		// DDS_PIXELFORMAT: size, DDPF_FOURCC, fourCC.
+		put(file, 76, 32);
+		put(file, 80, 0x4);
+		std::memcpy(file.data() + 84, expected.m_dx10 ? "DX10" : "DXT1", 4);
+		put(file, 108, 0x1000 | 0x400000 | 0x8);
+
+		if (expected.m_dx10)
+		{
+			// DXGI_FORMAT_BC7_UNORM, TEXTURE2D, no flags, one element.
+			put(file, 128, 98);
+			put(file, 132, 3);
+			put(file, 140, 1);
+		}
+
+		for (std::uint32_t level = 0; level < LEVELS; level++)
+		{
+			file.insert(file.end(), level_size(level, expected.m_block_size), static_cast<std::uint8_t>(level + 1));
+		}
+
+		return file;
+	}
+
+	[[nodiscard]] bool check(const Expected& expected)
+	{
+		const std::vector<std::uint8_t> file = make_dds(expected);
+		const std::filesystem::path path     = std::filesystem::temp_directory_path() / fmt::format("vulkano_check_{0}.dds", expected.m_name);
+
+		std::ofstream {path, std::ios::binary}.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+
+		bool passed = true;
+		{
+			const vulkano::TextureFile texture {path.string()};
+
+			passed = texture.format() == expected.m_format && texture.level_count() == LEVELS;
+			for (std::uint32_t level = 0; passed && level < LEVELS; level++)
+			{
+				const vulkano::TextureLevel& data = texture.level(level);
+
+				passed = data.m_width == std::max(WIDTH >> level, 1u) && data.m_height == std::max(HEIGHT >> level, 1u) && data.m_data.size() == level_size(level, expected.m_block_size) && data.m_data.front() == static_cast<std::byte>(level + 1) && data.m_data.back() == static_cast<std::byte>(level + 1);
+			}
+		}
+
+		std::filesystem::remove(path);
+		std::cout << fmt::format("{0:>6} {1}", expected.m_name, passed ? "ok" : "FAILED") << std::endl;
+
+		return passed;
+	}
+} // namespace
+
+int run_texture_check()
+{
+	// clang-format off
+	const bool passed = check({
+		.m_name       = "dxt1",
+		.m_format     = VK_FORMAT_BC1_RGBA_UNORM_BLOCK,
+		.m_block_size = BC1_BLOCK,
+		.m_dx10       = false
+	}) & check({
+		.m_name       = "bc7",
+		.m_format     = VK_FORMAT_BC7_UNORM_BLOCK,
+		.m_block_size = BC7_BLOCK,
+		.m_dx10       = true
+	});
+	// clang-format on
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef SANDBOX_TEXTURECHECK_HPP_
+#define SANDBOX_TEXTURECHECK_HPP_
+
+///
+/// Writes DDS files laid out as the DirectX documentation describes, loads them with TextureFile and checks the
+/// parsed size, format and levels. Run the sandbox with --check-textures.
+///
+int run_texture_check();
+
+#endif
\ No newline at end of file
@@ -1,10 +1,16 @@
 #include <iostream>
 #include <stdexcept>
+#include <string_view>
 
 #include <GLFW/glfw3.h>
 
 #include "vulkano/core/Window.hpp"
 
+#include "CullBenchmark.hpp"
+#include "JobBenchmark.hpp"
+#include "MipBenchmark.hpp"
+#include "TextureCheck.hpp"
+
 class Sandbox
 {
 public:
@@ -34,8 +40,28 @@ private:
 	vulkano::Window m_window;
 };
 
-int main()
+int main(int argc, char** argv)
 {
+	if (argc > 1 && std::string_view {argv[1]} == "--bench-jobs")
+	{
+		return run_job_benchmark();
+	}
+
+	if (argc > 1 && std::string_view {argv[1]} == "--bench-cull")
+	{
+		return run_cull_benchmark();
+	}
+
+	if (argc > 1 && std::string_view {argv[1]} == "--bench-mips")
+	{
+		return run_mip_benchmark();
+	}
+
+	if (argc > 1 && std::string_view {argv[1]} == "--check-textures")
+	{
+		return run_texture_check();
+	}
+
 	// clang-format off
 	int result = 0;
 
@@ -54,7 +80,7 @@ int main()
 		    .applicationVersion = VK_MAKE_VERSION(0, 1, 0),
 		    .pEngineName        = "No Engine",
 		    .engineVersion      = VK_MAKE_VERSION(1, 0, 0),
-		    .apiVersion         = VK_API_VERSION_1_2
+		    .apiVersion         = VK_API_VERSION_1_3
 		});
 		
 		result = sandbox.run();
@@ -1,2 +1,7 @@
-D:\Vulkan\1.2.154.1\Bin32\glslc.exe basic.vert -o basic_vert.spv
-D:\Vulkan\1.2.154.1\Bin32\glslc.exe basic.frag -o basic_frag.spv
\ No newline at end of file
+%VULKAN_SDK%\Bin\glslc.exe basic.vert -o basic_vert.spv
+%VULKAN_SDK%\Bin\glslc.exe basic.frag -o basic_frag.spv
+%VULKAN_SDK%\Bin\glslc.exe --target-env=vulkan1.3 meshlet_cull.comp -o meshlet_cull_comp.spv
+%VULKAN_SDK%\Bin\glslc.exe --target-env=vulkan1.3 meshlet.task -o meshlet_task.spv
+%VULKAN_SDK%\Bin\glslc.exe --target-env=vulkan1.3 meshlet.mesh -o meshlet_mesh.spv
+%VULKAN_SDK%\Bin\glslc.exe hiz_reduce.comp -o hiz_reduce_comp.spv
+%VULKAN_SDK%\Bin\glslc.exe occlusion_cull.comp -o occlusion_cull_comp.spv
\ No newline at end of file
@@ -0,0 +1,46 @@
+// Shared by meshlet_cull.comp and meshlet.task. Mirrors vulkano::GpuMeshlet and vulkano::MeshletCullConstants.
+
+struct Meshlet
+{
+    vec4 sphere;
+    vec4 cone_apex;
+    vec4 cone;
+    uint first_index;
+    uint vertex_offset;
+    uint triangle_offset;
+    uint counts;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Meshlets
+{
+    Meshlet meshlets[];
+};
+
+// Planes and camera are in the mesh's space.
+layout(push_constant) uniform Constants
+{
+    vec4 planes[6];
+    vec3 camera;
+    uint first_meshlet;
+    uint meshlet_count;
+    uint instance;
+    int base_vertex;
+    uint max_draws;
+} constants;
+
+// Same test as vulkano::mesh::meshlet_visible().
+bool meshlet_visible(Meshlet meshlet)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        vec4 plane = constants.planes[i];
+        if (dot(plane.xyz, meshlet.sphere.xyz) + plane.w < -meshlet.sphere.w * length(plane.xyz))
+        {
+            return false;
+        }
+    }
+
+    vec3 view = meshlet.cone_apex.xyz - constants.camera;
+    float distance = length(view);
+    return distance <= 0.0 || dot(view / distance, meshlet.cone.xyz) < meshlet.cone.w;
+}
\ No newline at end of file